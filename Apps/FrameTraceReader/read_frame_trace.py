@@ -0,0 +1,130 @@
+#!/usr/bin/env python
+"""read_frame_trace.py — Load a Komondor frame trace (--frame-trace) without converting it to text.
+
+Usage
+-----
+  py read_frame_trace.py <frames.bin> [--csv <frames.csv>]
+
+  Prints the number of frames and the share of decoded frames per packet type. With --csv, the trace is
+  also written as a semicolon-delimited CSV (as ./komondor_main --decode-frames does).
+
+  From Python, read_frame_trace(path) returns a dict {column name: list of values}, and
+  iter_frame_blocks(path) yields the same dict per block, so that long traces can be streamed.
+
+File format (mirrors frame_trace_methods.h)
+-------------------------------------------
+  "KOMFRAME", int32 version, int32 num_columns, per column: int32 type, int32 name length, name
+  'B' int32 num_rows, int32 node_id, per column: int32 length, LEB128 varints
+  'E' int64 total number of rows
+  Column types: 0 integer and 1 time (zig-zag deltas, times in ps), 2 double (XOR with the previous bits)
+"""
+
+import argparse
+import struct
+import sys
+from collections import defaultdict
+
+MAGIC = b"KOMFRAME"
+VERSION = 1
+COLUMN_INT, COLUMN_TIME, COLUMN_DOUBLE = 0, 1, 2
+PACKET_TYPES = {0: "DATA", 1: "ACK", 4: "RTS", 5: "CTS"}
+
+
+def _decode_column(column_type, data, num_rows):
+    values = []
+    previous = 0
+    position = 0
+    for _ in range(num_rows):
+        encoded, shift = 0, 0
+        while True:
+            byte = data[position]
+            position += 1
+            encoded |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                break
+        if column_type == COLUMN_DOUBLE:
+            bits = encoded ^ previous
+            previous = bits
+            values.append(struct.unpack("<d", struct.pack("<Q", bits))[0])
+        else:
+            previous = (previous + ((encoded >> 1) ^ -(encoded & 1))) & 0xFFFFFFFFFFFFFFFF
+            value = previous - (1 << 64) if previous >= (1 << 63) else previous
+            values.append(value * 1e-12 if column_type == COLUMN_TIME else value)
+    if position != len(data):
+        raise ValueError("corrupted column")
+    return values
+
+
+def iter_frame_blocks(path):
+    """Yield one dict {column name: values} per block of the trace."""
+    with open(path, "rb") as trace:
+        if trace.read(8) != MAGIC:
+            raise ValueError("%s is not a Komondor frame trace" % path)
+        version, num_columns = struct.unpack("<ii", trace.read(8))
+        if version != VERSION:
+            raise ValueError("unsupported frame trace version %d" % version)
+        columns = []
+        for _ in range(num_columns):
+            column_type, length = struct.unpack("<ii", trace.read(8))
+            columns.append((trace.read(length).decode(), column_type))
+        num_rows = 0
+        while True:
+            tag = trace.read(1)
+            if tag == b"E":
+                if struct.unpack("<q", trace.read(8))[0] != num_rows:
+                    raise ValueError("truncated frame trace")
+                return
+            if tag != b"B":
+                raise ValueError("corrupted or truncated frame trace")
+            block_rows, _node_id = struct.unpack("<ii", trace.read(8))
+            block = {}
+            for name, column_type in columns:
+                length = struct.unpack("<i", trace.read(4))[0]
+                block[name] = _decode_column(column_type, bytearray(trace.read(length)), block_rows)
+            num_rows += block_rows
+            yield block
+
+
+def read_frame_trace(path):
+    """Return the whole trace as a dict {column name: values}."""
+    frames = defaultdict(list)
+    for block in iter_frame_blocks(path):
+        for name, values in block.items():
+            frames[name].extend(values)
+    return dict(frames)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Read a Komondor frame trace")
+    parser.add_argument("trace")
+    parser.add_argument("--csv", help="write the trace as CSV")
+    args = parser.parse_args()
+
+    csv = open(args.csv, "w") if args.csv else None
+    frames, decoded = defaultdict(int), defaultdict(int)
+    header = True
+    for block in iter_frame_blocks(args.trace):
+        names = list(block.keys())
+        if csv and header:
+            csv.write(";".join(names) + "\n")
+            header = False
+        for r in range(len(block["packet_type"])):
+            packet_type = PACKET_TYPES.get(block["packet_type"][r], str(block["packet_type"][r]))
+            frames[packet_type] += 1
+            decoded[packet_type] += block["decoded"][r]
+            if csv:
+                csv.write(";".join("%.12f" % block[n][r] if n in ("start_time", "end_time", "delay")
+                                   else "%.2f" % block[n][r] if n == "sinr_db"
+                                   else str(block[n][r]) for n in names) + "\n")
+    if csv:
+        csv.close()
+
+    print("%d frames" % sum(frames.values()))
+    for packet_type in sorted(frames):
+        print("  %-5s %10d frames, %6.2f %% decoded" % (packet_type, frames[packet_type],
+                                                       100.0 * decoded[packet_type] / frames[packet_type]))
+
+
+if __name__ == "__main__":
+    sys.exit(main())
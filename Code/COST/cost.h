@@ -24,15 +24,23 @@
 *************************************************************************/
 
 #ifndef queue_t
-#define queue_t SimpleQueue
+#define queue_t SelectableQueue
 #endif
 
 #include <stdarg.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 #include <math.h>
 #include <sys/time.h>
+#include <time.h>
+#include <pthread.h>
+#include <string>
 #include <deque>
 #include <vector>
+#include <map>
+#include <algorithm>
+#include <typeinfo>
 #include <assert.h>
 
 #include "priority_q.h"
@@ -41,6 +49,40 @@
 class trigger_t {};
 typedef double simtime_t;
 
+/* counter-based random number streams. Draw "i" of a stream is a hash
+ * (SplitMix64 finalizer) of the stream key and "i", so every component draws
+ * from its own sequence whatever the others do, draws have no serial
+ * dependency and the state is just two words (one stream per component and
+ * engine, hence nothing is shared between concurrent engines). */
+
+class CostRandomStream
+{
+ public:
+  CostRandomStream() : m_key( 0), m_counter( 0) {}
+  void		Seed( long seed, int stream, uint64_t id)
+      {
+        m_key = Mix( Mix( Mix( (uint64_t) seed) ^ (uint64_t) stream) ^ id);
+        m_counter = 0;
+      }
+  uint64_t	Next()		{ return Mix( m_key + ( ++m_counter) * 0x9e3779b97f4a7c15ULL); }
+  double	Uniform()	{ return ( Next() >> 11) * ( 1.0 / 9007199254740992.0); }	// [0,1)
+  int		Rand()		{ return (int) ( Next() >> 33); }			// [0,2^31-1], as rand()
+  double	Exponential( double mean)	{ return -mean * log( 1.0 - Uniform()); }
+  // the whole state of the stream (see CheckpointFile)
+  uint64_t	Key() const	{ return m_key; }
+  uint64_t	Counter() const	{ return m_counter; }
+  void		Restore( uint64_t key, uint64_t counter)	{ m_key = key; m_counter = counter; }
+ private:
+  static uint64_t	Mix( uint64_t z)
+      {
+        z = ( z ^ ( z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = ( z ^ ( z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ ( z >> 31);
+      }
+  uint64_t	m_key;
+  uint64_t	m_counter;
+};
+
 #ifdef COST_DEBUG
 #define Printf(x) Print x
 #else
@@ -64,6 +106,8 @@ struct CostEvent
   TimerBase* object;
   int index;
   unsigned char active;
+  long seq;  // tie-breaking order among events with the same time
+  unsigned char wheel;  // queued in the timer wheel (see SelectableQueue)
 };
 
 /* this virtual function is called by the simulation engine */
@@ -71,8 +115,119 @@ struct CostEvent
 class TimerBase
 {
  public:
+  TimerBase() : m_profile_name( NULL) {}
   virtual void activate(CostEvent*) = 0;
   inline virtual ~TimerBase() {}	//mwl required by gcc 4.0
+  // name of the handler of the timer in the engine profile (see CostProfiler)
+  void ProfileName( const char* name)	{ m_profile_name = name; }
+  const char* ProfileName() const
+      {
+        return m_profile_name != NULL ? m_profile_name : typeid( *this).name();
+      }
+ private:
+  const char* m_profile_name;
+};
+
+/* engine profiler (opt-in, see CostSimEng::Profile). Every event handler
+ * (named after the target of its timer) and every profiled scope (see
+ * COST_PROFILE_SCOPE, e.g., the inports that components call each other
+ * while handling an event) has an entry with its number of calls, its
+ * cycles with and without those of the nested scopes ("self") and, for
+ * timers, the number of events scheduled and cancelled. The length of the
+ * event list is sampled at every event. Cycles are read from the time stamp
+ * counter where available (nanoseconds elsewhere) and converted to seconds
+ * with the rate measured over the whole run. */
+
+inline uint64_t CostCycles()
+{
+#if defined(__i386__) || defined(__x86_64__)
+  uint32_t lo, hi;
+  __asm__ __volatile__( "rdtsc" : "=a"( lo), "=d"( hi));
+  return ( (uint64_t) hi << 32) | lo;
+#else
+  struct timespec t;
+  clock_gettime( CLOCK_MONOTONIC, &t);
+  return (uint64_t) t.tv_sec * 1000000000ULL + t.tv_nsec;
+#endif
+}
+
+struct CostProfileEntry
+{
+  const char*	name;
+  const char*	kind;		// "timer" or "scope"
+  long		count;		// events handled or calls of the scope
+  long		scheduled;	// events scheduled (timers)
+  long		cancelled;	// events cancelled before being handled (timers)
+  uint64_t	cycles;		// cycles, nested scopes included
+  uint64_t	self_cycles;	// cycles, nested scopes excluded
+};
+
+class CostProfiler
+{
+ public:
+  struct Frame { int entry; uint64_t start; uint64_t child_cycles; };
+  CostProfiler()
+      : m_child_cycles( 0), m_queue_length( 0), m_queue_peak( 0),
+	m_queue_samples( 0), m_queue_sum( 0.0) {}
+  int		Entry( const char* name, const char* kind)
+      {
+        std::map<const char*,int>::iterator it = m_index.find( name);
+        if( it != m_index.end())
+	  return it->second;
+        CostProfileEntry entry = { name, kind, 0, 0, 0, 0, 0 };
+        m_entries.push_back( entry);
+        m_index[name] = m_entries.size() - 1;
+        return m_entries.size() - 1;
+      }
+  void		Enter( Frame& f, int entry)
+      {
+        f.entry = entry;
+        f.child_cycles = m_child_cycles;
+        m_child_cycles = 0;
+        f.start = CostCycles();
+      }
+  void		Leave( Frame& f)
+      {
+        uint64_t elapsed = CostCycles() - f.start;
+        CostProfileEntry& entry = m_entries[f.entry];
+        entry.count++;
+        entry.cycles += elapsed;
+        entry.self_cycles += elapsed - m_child_cycles;
+        m_child_cycles = f.child_cycles + elapsed;
+      }
+  void		Scheduled( CostEvent* e)
+      {
+        if( ++m_queue_length > m_queue_peak)
+	  m_queue_peak = m_queue_length;
+        m_entries[ Entry( e->object->ProfileName(), "timer")].scheduled++;
+      }
+  void		Cancelled( CostEvent* e)
+      {
+        m_queue_length--;
+        m_entries[ Entry( e->object->ProfileName(), "timer")].cancelled++;
+      }
+  // handle a dequeued event
+  void		Activate( CostEvent* e)
+      {
+        m_queue_samples++;
+        m_queue_sum += m_queue_length--;
+        Frame f;
+        Enter( f, Entry( e->object->ProfileName(), "timer"));
+        e->object->activate( e);
+        Leave( f);
+      }
+  void		Merge( const CostProfiler& p);
+  void		Print() const;
+  bool		Write( const char* filename, const char* scheduler, double running_time,
+		       double cycles_per_second) const;
+ private:
+  std::vector<CostProfileEntry>	m_entries;
+  std::map<const char*,int>	m_index;
+  uint64_t	m_child_cycles;	// cycles of the scopes nested in the current one
+  long		m_queue_length;
+  long		m_queue_peak;
+  long		m_queue_samples;
+  double	m_queue_sum;
 };
 
 class TypeII;
@@ -86,18 +241,33 @@ class CostSimEng
   class seed_t
       {
        public:
-	void operator = (long seed) { srand48(seed); };
+	void operator = (long seed) { CostSimEng::Instance()->random_stream.Seed( seed, 0, 0); };
       };
   seed_t		Seed;
   CostSimEng()
-      : stopTime( 0), clearStatsTime( 0), m_clock( 0.0)
+      : stopTime( 0), clearStatsTime( 0), checkpointTime( 0), observationPeriod( 0), m_clock( 0.0), m_seq( 0), m_threads( 1), m_profiler( NULL)
       {
         if( m_instance == NULL)
 	  m_instance = this;
         else
 	  printf("Error: only one simulation engine can be created\n");
       }
-  virtual		~CostSimEng()	{ }
+  // engines and components start zero-filled, as in a fresh process, so that
+  // consecutive simulations in a thread do not depend on the memory left by
+  // the previous ones
+  static void*	operator new( size_t size)
+      {
+        void* p = ::operator new( size);
+        memset( p, 0, size);
+        return p;
+      }
+  static void	operator delete( void* p)	{ ::operator delete( p); }
+  virtual		~CostSimEng()
+      {
+        delete m_profiler;
+        if( m_instance == this)
+	  m_instance = NULL;
+      }
   static CostSimEng	*Instance()
       {
         if(m_instance==NULL)
@@ -129,35 +299,121 @@ class CostSimEng
 	if( e->time < m_clock)
 	  assert(e->time>=m_clock);
         //printf("scheduled event-> time: %f, object: %p\n",e->time,e->object);
+        // SimpleQueue puts a new event right after the head if both have the
+        // same time, and before any other event with its time otherwise.
+        // Stamping "seq" accordingly gives every queue that same order.
+        CostEvent* head = m_queue.NextEvent();
+        e->seq = --m_seq;
+        if( head != NULL && head->time == e->time)
+          head->seq = --m_seq;
         m_queue.EnQueue(e);
+        if( m_profiler != NULL)
+          m_profiler->Scheduled(e);
+      }
+  // put back an event of a restored checkpoint, with the time and "seq" it
+  // had when it was saved (see Timer::Restore)
+  void		RestoreEvent(CostEvent*e)
+      {
+        m_queue.EnQueue(e);
+        if( m_profiler != NULL)
+          m_profiler->Scheduled(e);
       }
   void		CancelEvent(CostEvent*e)
       {
         //printf("cancel event-> time: %f, object: %p\n",e->time,e->object);
         m_queue.Delete(e);
+        if( m_profiler != NULL)
+          m_profiler->Cancelled(e);
       }
-  double	Random( double v=1.0)	{ return v*drand48();}
-  int		Random( int v)		{ return (int)(v*drand48()); }
-  double	Exponential(double mean)	{ return -mean*log(Random());}
+  bool		Scheduler( const char* name)
+      {
+        if( !m_queue.SetType( name))
+          return false;
+        m_scheduler = name;
+        return true;
+      }
+  void		Threads( int n)	{ m_threads = n; }
+  // profile the run and write the profile to "filename" (JSON if it ends
+  // with ".json", CSV otherwise) once it is over
+  void		Profile( const char* filename)
+      {
+        m_profile_filename = filename;
+        if( m_profiler == NULL)
+          m_profiler = new CostProfiler;
+      }
+  CostProfiler*	Profiler()	{ return m_profiler; }
+  double	Random( double v=1.0)	{ return v*random_stream.Uniform();}
+  int		Random( int v)		{ return (int)(v*random_stream.Uniform()); }
+  double	Exponential(double mean)	{ return random_stream.Exponential(mean);}
+  CostRandomStream	random_stream;
   virtual void	Start()		{}
   virtual void	Stop()		{}
   void		Run();
   double	SimTime()	{ return m_clock; } 
+  // clock and last "seq" stamped, i.e., the state of the engine besides its
+  // event list (restored, with the events, once the components have started)
+  long		EventSeq() const	{ return m_seq; }
+  void		RestoreClock( double clock, long seq)	{ m_clock = clock; m_seq = seq; }
   void		StopTime( double t)	{ stopTime = t; }
   double	StopTime() const	{ return stopTime; }
   void		ClearStatsTime( double t)	{ clearStatsTime = t; }
   double	ClearStatsTime() const	{ return clearStatsTime; }
-  virtual void	ClearStats()	{}
+  // zero the statistics of the components of the engine (or logical process)
+  virtual void	ClearStats();
+  // the event list is paused at the checkpoint time (before the events
+  // scheduled at it) to call Checkpoint(), and then resumed
+  void		CheckpointTime( double t)	{ checkpointTime = t; }
+  double	CheckpointTime() const	{ return checkpointTime; }
+  virtual void	Checkpoint()	{}
+  // called once the components have started and before the events are run,
+  // so that the model can replace its state (e.g., by a saved checkpoint)
+  virtual void	Restore()	{}
+  // logical processes of a partitioned run (while the components start, are
+  // restored or checkpointed), and engine of the running thread. Process -1
+  // (or any process of a run that is not partitioned) is the engine itself
+  int		Processes() const	{ return m_processes.size(); }
+  CostSimEng*	Process( int p)	{ return ( p < 0 || m_processes.empty()) ? this : m_processes[p]; }
+  void		SelectProcess( int p)	{ m_instance = Process( p); }
+  // the event list is also paused every observation period to call Observe(),
+  // which ends the run at that time if it returns true (e.g., once the
+  // statistics have converged)
+  void		ObservationPeriod( double t)	{ observationPeriod = t; }
+  double	ObservationPeriod() const	{ return observationPeriod; }
+  virtual bool	Observe()	{ return false; }
+  // alternative to processing events once the components have started (e.g., an
+  // analytical or slotted engine); returns false to run the event list
+  virtual bool	RunFastPath()	{ return false; }
  private:
+  // logical process of a partitioned run: same stop time, statistics clearing
+  // and event list as its parent
+  CostSimEng( CostSimEng* parent)
+      : stopTime( parent->stopTime), clearStatsTime( parent->clearStatsTime), checkpointTime( 0),
+	observationPeriod( 0), m_clock( 0.0), m_seq( 0), m_threads( 1),
+	m_profiler( parent->m_profiler != NULL ? new CostProfiler : NULL)
+      {
+        if( !parent->m_scheduler.empty())
+          m_queue.SetType( parent->m_scheduler.c_str());
+      }
+  void		RunEvents();
+  void		RunPartitions( int num_partitions);
+  static void*	RunPartitionsWorker( void* arg);
   double	stopTime;
   double	clearStatsTime;	// time to zero stats
+  double	checkpointTime;	// time to call Checkpoint()
+  double	observationPeriod;	// time between two calls to Observe() (0: never)
   double	eventRate;
   double	runningTime;
   long		eventsProcessed;
   double	m_clock;
+  long		m_seq;
   queue_t<CostEvent>	m_queue;
+  std::string	m_scheduler;
+  int		m_threads;	// threads running the logical processes of a partitioned run
+  CostProfiler*	m_profiler;	// NULL unless the run is profiled
+  std::string	m_profile_filename;
   std::vector<TypeII*>	m_components;
-  static CostSimEng	*m_instance;
+  std::vector<CostSimEng*>	m_processes;	// logical processes of a partitioned run
+  static __thread CostSimEng	*m_instance;	// one engine per thread
   std::vector<CorsaAllocator*>	m_allocators;
 };
 
@@ -169,24 +425,35 @@ class TypeII
  public: 
   virtual void Start() {};
   virtual void Stop() {};
+  virtual void ClearStats() {};	// statistics collected from now on only
   inline virtual ~TypeII() {}		//mwl required by gcc 4.0
+  static void* operator new(size_t size) { return CostSimEng::operator new(size); }
+  static void operator delete(void* p) { CostSimEng::operator delete(p); }
   TypeII()
       {
         m_simeng=CostSimEng::Instance();
         m_simeng->AddComponent(this);
+        m_partition=0;
       }
 
 #ifdef COST_DEBUG
   void Print(const bool, const char*, ...);
 #endif
     
-  double Random(double v=1.0) { return v*drand48();}
-  int Random(int v) { return (int)(v*drand48());}
-  double Exponential(double mean) { return -mean*log(Random());}
-  inline double SimTime() const { return m_simeng->SimTime(); }
+  double Random(double v=1.0) { return v*random_stream.Uniform();}
+  int Random(int v) { return (int)(v*random_stream.Uniform());}
+  double Exponential(double mean) { return random_stream.Exponential(mean);}
+  CostRandomStream random_stream;	// own stream of the component (seeded by the model)
+  // the engine of the running thread, i.e., that of the logical process of the component
+  inline double SimTime() const { return CostSimEng::Instance()->SimTime(); }
   inline double StopTime() const { return m_simeng->StopTime(); }
+  // logical process of the component. Components of different logical processes must
+  // not interact, as they may run concurrently (see CostSimEng::RunPartitions)
+  inline void Partition(int p) { m_partition = p; }
+  inline int Partition() const { return m_partition; }
  private:
   CostSimEng* m_simeng;
+  int m_partition;
 }; 
 
 #ifdef COST_DEBUG
@@ -201,43 +468,169 @@ void TypeII::Print(const bool flag, const char* format, ...)
 }
 #endif
 
-CostSimEng* CostSimEng::m_instance = NULL;
+__thread CostSimEng* CostSimEng::m_instance = NULL;
 
-void CostSimEng::Run()
+/* profiled scope: COST_PROFILE_SCOPE("Component::Method") at the beginning of
+ * a method accounts for its calls in the profile of the running engine, if any */
+
+class CostProfileScope
+{
+ public:
+  CostProfileScope( const char* name)
+      : m_profiler( CostSimEng::Instance()->Profiler())
+      {
+        if( m_profiler != NULL)
+          m_profiler->Enter( m_frame, m_profiler->Entry( name, "scope"));
+      }
+  ~CostProfileScope()
+      {
+        if( m_profiler != NULL)
+          m_profiler->Leave( m_frame);
+      }
+ private:
+  CostProfiler*		m_profiler;
+  CostProfiler::Frame	m_frame;
+};
+
+#define COST_PROFILE_SCOPE(name)	CostProfileScope cost_profile_scope( name)
+
+// add the profile of a logical process (partitioned runs)
+void CostProfiler::Merge( const CostProfiler& p)
 {
-  double	nextTime = (clearStatsTime != 0.0 && clearStatsTime < stopTime) ? clearStatsTime : stopTime;
+  for( unsigned int i = 0; i < p.m_entries.size(); i++)
+  {
+    const CostProfileEntry& from = p.m_entries[i];
+    CostProfileEntry& to = m_entries[ Entry( from.name, from.kind)];
+    to.count += from.count;
+    to.scheduled += from.scheduled;
+    to.cancelled += from.cancelled;
+    to.cycles += from.cycles;
+    to.self_cycles += from.self_cycles;
+  }
+  if( p.m_queue_peak > m_queue_peak)
+    m_queue_peak = p.m_queue_peak;
+  m_queue_samples += p.m_queue_samples;
+  m_queue_sum += p.m_queue_sum;
+}
+
+static bool CostProfileBySelfCycles( const CostProfileEntry& a, const CostProfileEntry& b)
+{
+  return a.self_cycles > b.self_cycles;
+}
+
+// summary of the event list and of the most expensive handlers
+void CostProfiler::Print() const
+{
+  long scheduled = 0, cancelled = 0;
+  uint64_t self_cycles = 0;
+  for( unsigned int i = 0; i < m_entries.size(); i++)
+  {
+    scheduled += m_entries[i].scheduled;
+    cancelled += m_entries[i].cancelled;
+    self_cycles += m_entries[i].self_cycles;
+  }
+  printf("# event list: peak %ld, average %.1f events; %ld of %ld scheduled events cancelled (%.1f %%)\n",
+	 m_queue_peak, m_queue_samples > 0 ? m_queue_sum / m_queue_samples : 0.0,
+	 cancelled, scheduled, scheduled > 0 ? 100.0 * cancelled / scheduled : 0.0);
+  std::vector<CostProfileEntry> entries( m_entries);
+  std::sort( entries.begin(), entries.end(), CostProfileBySelfCycles);
+  for( unsigned int i = 0; i < entries.size() && i < 5; i++)
+    printf("#   %-40s %10ld calls, %5.1f %% of the time (self)\n", entries[i].name, entries[i].count,
+	   self_cycles > 0 ? 100.0 * entries[i].self_cycles / self_cycles : 0.0);
+}
 
+// per-handler table, sorted by self time (JSON if "filename" ends with ".json", CSV otherwise)
+bool CostProfiler::Write( const char* filename, const char* scheduler, double running_time,
+			  double cycles_per_second) const
+{
+  FILE* file = fopen( filename, "w");
+  if( file == NULL)
+    return false;
+
+  long events = 0, scheduled = 0, cancelled = 0;
+  uint64_t self_cycles = 0;
+  for( unsigned int i = 0; i < m_entries.size(); i++)
+  {
+    if( m_entries[i].kind[0] == 't')
+      events += m_entries[i].count;
+    scheduled += m_entries[i].scheduled;
+    cancelled += m_entries[i].cancelled;
+    self_cycles += m_entries[i].self_cycles;
+  }
+  double queue_average = m_queue_samples > 0 ? m_queue_sum / m_queue_samples : 0.0;
+  std::vector<CostProfileEntry> entries( m_entries);
+  std::sort( entries.begin(), entries.end(), CostProfileBySelfCycles);
+
+  size_t length = strlen( filename);
+  bool json = length >= 5 && strcmp( filename + length - 5, ".json") == 0;
+  if( json)
+  {
+    fprintf( file, "{\n  \"scheduler\": \"%s\",\n  \"running_time\": %f,\n  \"cycles_per_second\": %.0f,\n",
+	     scheduler, running_time, cycles_per_second);
+    fprintf( file, "  \"events\": %ld,\n  \"queue_peak\": %ld,\n  \"queue_average\": %f,\n", events,
+	     m_queue_peak, queue_average);
+    fprintf( file, "  \"scheduled\": %ld,\n  \"cancelled\": %ld,\n  \"handlers\": [", scheduled, cancelled);
+  }
+  else
+  {
+    fprintf( file, "# scheduler: %s; running time: %f s; cycles per second: %.0f\n", scheduler, running_time,
+	     cycles_per_second);
+    fprintf( file, "# events: %ld; event list peak: %ld; event list average: %f; scheduled: %ld; cancelled: %ld\n",
+	     events, m_queue_peak, queue_average, scheduled, cancelled);
+    fprintf( file, "handler;kind;calls;time;self_time;self_share;cycles_per_call;self_cycles_per_call;"
+	     "scheduled;cancelled;cancel_ratio\n");
+  }
+  for( unsigned int i = 0; i < entries.size(); i++)
+  {
+    const CostProfileEntry& e = entries[i];
+    double calls = e.count > 0 ? e.count : 1;
+    double self_share = self_cycles > 0 ? (double) e.self_cycles / self_cycles : 0.0;
+    double cancel_ratio = e.scheduled > 0 ? (double) e.cancelled / e.scheduled : 0.0;
+    if( json)
+      fprintf( file, "%s\n    {\"handler\": \"%s\", \"kind\": \"%s\", \"calls\": %ld, \"time\": %f, "
+	       "\"self_time\": %f, \"self_share\": %f, \"cycles_per_call\": %.1f, \"self_cycles_per_call\": %.1f, "
+	       "\"scheduled\": %ld, \"cancelled\": %ld, \"cancel_ratio\": %f}", i > 0 ? "," : "", e.name, e.kind,
+	       e.count, e.cycles / cycles_per_second, e.self_cycles / cycles_per_second, self_share,
+	       e.cycles / calls, e.self_cycles / calls, e.scheduled, e.cancelled, cancel_ratio);
+    else
+      fprintf( file, "%s;%s;%ld;%f;%f;%f;%.1f;%.1f;%ld;%ld;%f\n", e.name, e.kind, e.count,
+	       e.cycles / cycles_per_second, e.self_cycles / cycles_per_second, self_share,
+	       e.cycles / calls, e.self_cycles / calls, e.scheduled, e.cancelled, cancel_ratio);
+  }
+  if( json)
+    fprintf( file, "\n  ]\n}\n");
+  fclose( file);
+  return true;
+}
+
+void CostSimEng::Run()
+{
   m_clock = 0.0;
   eventsProcessed = 0l;
   std::vector<TypeII*>::iterator iter;
       
   struct timeval start_time;    
   gettimeofday( &start_time, NULL);
+  uint64_t start_cycles = CostCycles();
 
   Start();
 
+  int num_partitions = 1;
   for( iter = m_components.begin(); iter != m_components.end(); iter++)
-    (*iter)->Start();
+    if( (*iter)->Partition() >= num_partitions)
+      num_partitions = (*iter)->Partition() + 1;
 
-  CostEvent* e=m_queue.DeQueue();
-  while( e != NULL)
+  if( num_partitions > 1)
+    RunPartitions( num_partitions);
+  else
   {
-    if( e->time >= nextTime)
-    {
-      if( nextTime == stopTime)
-	break;
-      // otherwise, nextTime == clearStatsTime
-      printf( "Clearing statistics @ %f\n", nextTime);
-      nextTime = stopTime;
-      ClearStats();
-    }
-    //printf("time: %f, event: %p\n", e->time, e); 
-    assert( e->time >= m_clock);
-    m_clock = e->time;
-    e->object->activate( e);
-    eventsProcessed++;
-    e = m_queue.DeQueue();
+    for( iter = m_components.begin(); iter != m_components.end(); iter++)
+      (*iter)->Start();
+    Restore();
+    if( !RunFastPath())
+      RunEvents();
   }
+
   m_clock = stopTime;
   for(iter = m_components.begin(); iter != m_components.end(); iter++)
     (*iter)->Stop();
@@ -250,17 +643,225 @@ void CostSimEng::Run()
   runningTime = stop_time.tv_sec - start_time.tv_sec +
       (stop_time.tv_usec - start_time.tv_usec) / 1000000.0;
   eventRate = eventsProcessed/runningTime;
+  double cyclesPerSecond = ( CostCycles() - start_cycles) / runningTime;
   
   //#ifndef VIZ
   printf("# -------------------------------------------------------------------------\n");	
   printf("# CostSimEng with %s, stopped at %f\n", m_queue.GetName(), stopTime);	
+  if( num_partitions > 1)
+    printf("# %d logical processes run on %d threads\n", num_partitions,
+	   m_threads < num_partitions ? m_threads : num_partitions);
   printf("# %ld events processed in %.3f seconds, event processing rate: %.0f\n",	
   eventsProcessed, runningTime, eventRate);
+  if( m_profiler != NULL)
+  {
+    m_profiler->Print();
+    if( m_profiler->Write( m_profile_filename.c_str(), m_queue.GetName(), runningTime, cyclesPerSecond))
+      printf("# profile written to %s\n", m_profile_filename.c_str());
+    else
+      printf("Error: profile file %s could not be written\n", m_profile_filename.c_str());
+  }
   //#endif //VIZ
 }
 
+void CostSimEng::ClearStats()
+{
+  std::vector<TypeII*>::iterator iter;
+  for( iter = m_components.begin(); iter != m_components.end(); iter++)
+    (*iter)->ClearStats();
+}
+
+void CostSimEng::RunEvents()
+{
+  // pauses still due: statistics clearing, checkpoint and observation (0 if none).
+  // The clock is not 0 if the run resumes a checkpoint (see Restore), in which
+  // case the checkpoint is not taken again, but the pauses at its time are
+  double	clearTime = (clearStatsTime != 0.0 && clearStatsTime >= m_clock && clearStatsTime < stopTime) ?
+	  clearStatsTime : 0.0;
+  double	pauseTime = (checkpointTime != 0.0 && checkpointTime > m_clock && checkpointTime < stopTime) ?
+	  checkpointTime : 0.0;
+  long		numObservations = 1;
+  while( observationPeriod > 0.0 && (double) numObservations * observationPeriod < m_clock)
+    numObservations++;
+  double	observeTime = (observationPeriod > 0.0 && (double) numObservations * observationPeriod < stopTime) ?
+	  (double) numObservations * observationPeriod : 0.0;
+  double	nextTime = stopTime;
+  if( clearTime != 0.0 && clearTime < nextTime)
+    nextTime = clearTime;
+  if( pauseTime != 0.0 && pauseTime < nextTime)
+    nextTime = pauseTime;
+  if( observeTime != 0.0 && observeTime < nextTime)
+    nextTime = observeTime;
+
+  CostEvent* e=m_queue.DeQueue();
+  while( e != NULL)
+  {
+    while( e->time >= nextTime && nextTime != stopTime)
+    {
+      m_clock = nextTime;
+      if( nextTime == pauseTime)
+      {
+	// the event goes back to the list, which is thus complete while the
+	// model checkpoints it (and may re-arm the checkpoint time)
+	m_queue.EnQueue( e);
+	Checkpoint();
+	pauseTime = (checkpointTime > m_clock && checkpointTime < stopTime) ? checkpointTime : 0.0;
+	e = m_queue.DeQueue();
+      }
+      else if( nextTime == clearTime)
+      {
+	clearTime = 0.0;
+	printf( "Clearing statistics @ %f\n", nextTime);
+	ClearStats();
+      }
+      else
+      {
+	observeTime = (double) ++numObservations * observationPeriod;
+	if( observeTime >= stopTime)
+	  observeTime = 0.0;
+	if( Observe())
+	{
+	  printf( "Run ended by the model @ %f\n", nextTime);
+	  stopTime = nextTime;
+	  break;
+	}
+      }
+      nextTime = stopTime;
+      if( clearTime != 0.0 && clearTime < nextTime)
+	nextTime = clearTime;
+      if( pauseTime != 0.0 && pauseTime < nextTime)
+	nextTime = pauseTime;
+      if( observeTime != 0.0 && observeTime < nextTime)
+	nextTime = observeTime;
+    }
+    if( e->time >= stopTime)
+    {
+      m_queue.EnQueue( e);	// still due (e.g., in the next phase of a partitioned run)
+      break;
+    }
+    //printf("time: %f, event: %p\n", e->time, e); 
+    assert( e->time >= m_clock);
+    m_clock = e->time;
+    if( m_profiler == NULL)
+      e->object->activate( e);
+    else
+      m_profiler->Activate( e);
+    eventsProcessed++;
+    e = m_queue.DeQueue();
+  }
+  m_clock = stopTime;
+  // a checkpoint at the stop time pauses the run before the components stop
+  if( checkpointTime != 0.0 && checkpointTime == stopTime)
+    Checkpoint();
+}
+
+/* partitioned run. Components are grouped into logical processes that never
+ * interact (e.g., groups of nodes out of the sensing range of each other), so
+ * the lookahead between them is unbounded and the conservative condition holds
+ * without any synchronization: every logical process has its own engine and
+ * event list (its components schedule their timers in the engine of the running
+ * thread) and is simulated up to the stop time by one of the worker threads.
+ * Components are started and stopped by the calling thread, in their creation
+ * order, so that results do not depend on the number of threads. */
+
+struct CostPartitionsBatch
+{
+  std::vector<CostSimEng*>	processes;
+  unsigned int			next;
+  pthread_mutex_t		mutex;
+};
+
+void* CostSimEng::RunPartitionsWorker( void* arg)
+{
+  CostPartitionsBatch* batch = (CostPartitionsBatch*) arg;
+  while( true)
+  {
+    pthread_mutex_lock( &batch->mutex);
+    unsigned int p = batch->next++;
+    pthread_mutex_unlock( &batch->mutex);
+    if( p >= batch->processes.size())
+      break;
+    m_instance = batch->processes[p];
+    m_instance->RunEvents();
+  }
+  m_instance = NULL;
+  return NULL;
+}
+
+void CostSimEng::RunPartitions( int num_partitions)
+{
+  if( m_queue.NextEvent() != NULL)
+  {
+    printf("Error: events scheduled before a partitioned run\n");
+    exit(-1);
+  }
+
+  CostPartitionsBatch batch;
+  batch.next = 0;
+  pthread_mutex_init( &batch.mutex, NULL);
+  for( int p = 0; p < num_partitions; p++)
+    batch.processes.push_back( new CostSimEng( this));
+  std::vector<TypeII*>::iterator iter;
+  for( iter = m_components.begin(); iter != m_components.end(); iter++)
+    batch.processes[ (*iter)->Partition()]->m_components.push_back( *iter);
+
+  // start the components within their logical processes
+  for( int p = 0; p < num_partitions; p++)
+  {
+    m_instance = batch.processes[p];
+    for( iter = m_instance->m_components.begin(); iter != m_instance->m_components.end(); iter++)
+      (*iter)->Start();
+  }
+  m_instance = this;
+  m_processes = batch.processes;
+  Restore();
 
+  // the logical processes are run up to the checkpoint time (if any), where
+  // the calling thread checkpoints them all, and then up to the stop time
+  int num_threads = m_threads < num_partitions ? m_threads : num_partitions;
+  double until;
+  do
+  {
+    until = (checkpointTime != 0.0 && checkpointTime > m_clock && checkpointTime < stopTime) ?
+	checkpointTime : stopTime;
+    for( int p = 0; p < num_partitions; p++)
+      batch.processes[p]->stopTime = until;
+    batch.next = 0;
+    if( num_threads <= 1)
+    {
+      RunPartitionsWorker( &batch);
+      m_instance = this;
+    }
+    else
+    {
+      std::vector<pthread_t> threads( num_threads);
+      for( int t = 0; t < num_threads; t++)
+	if( pthread_create( &threads[t], NULL, RunPartitionsWorker, &batch) != 0)
+	{
+	  printf("Error: thread %d of the partitioned run could not be created\n", t);
+	  exit(-1);
+	}
+      for( int t = 0; t < num_threads; t++)
+	pthread_join( threads[t], NULL);
+    }
+    m_clock = until;
+    if( until != stopTime)
+      Checkpoint();
+  }
+  while( until != stopTime);
+  if( checkpointTime != 0.0 && checkpointTime == stopTime)
+    Checkpoint();
 
+  for( int p = 0; p < num_partitions; p++)
+  {
+    eventsProcessed += batch.processes[p]->eventsProcessed;
+    if( m_profiler != NULL)
+      m_profiler->Merge( *batch.processes[p]->m_profiler);
+    delete batch.processes[p];
+  }
+  m_processes.clear();
+  pthread_mutex_destroy( &batch.mutex);
+}
 
 /* timer is defined as a special component */
 
@@ -268,20 +869,23 @@ template <class T> component Timer : public TimerBase
 {
  public:
   struct event_t : public CostEvent { T data; };
-  /* the pointer to the simulation engine is passed
-     in the configuration function */
-  Timer() { m_simeng = CostSimEng::Instance(); m_event.active= false; }
+  /* events are scheduled in the engine of the running thread,
+     i.e., that of the logical process of the component */
+  Timer() { m_event.active= false; }
   inline void Set(T const &, double );
   inline void Set(double );
   inline double GetTime() { return m_event.time; }
   inline bool Active() { return m_event.active; }
+  inline long GetSeq() { return m_event.seq; }
   inline T& GetData() { return m_event.data; }
   inline void SetData(T const &d) { m_event.data = d; }
   void Cancel();
+  // state of a restored checkpoint (the time of an inactive timer is kept too,
+  // as the model may read it)
+  void Restore(bool active, double time, long seq);
   outport void to_component(T&);
   void activate(CostEvent*);
  private:
-  CostSimEng* m_simeng;
   event_t m_event;
 };
 
@@ -289,33 +893,46 @@ template <class T>
 void Timer<T>::Set(T const & data, double time)
 {
   if(m_event.active)
-    m_simeng->CancelEvent(&m_event);
+    CostSimEng::Instance()->CancelEvent(&m_event);
   m_event.time = time;
   m_event.data = data;
   m_event.object = this;
   m_event.active=true;
-  m_simeng->ScheduleEvent(&m_event);
+  CostSimEng::Instance()->ScheduleEvent(&m_event);
 }
 
 template <class T>
 void Timer<T>::Set(double time)
 {
   if(m_event.active)
-    m_simeng->CancelEvent(&m_event);
+    CostSimEng::Instance()->CancelEvent(&m_event);
   m_event.time = time;
   m_event.object = this;
   m_event.active=true;
-  m_simeng->ScheduleEvent(&m_event);
+  CostSimEng::Instance()->ScheduleEvent(&m_event);
 }
 
 template <class T>
 void Timer<T>::Cancel()
 {
   if(m_event.active)
-    m_simeng->CancelEvent(&m_event);
+    CostSimEng::Instance()->CancelEvent(&m_event);
   m_event.active = false;
 }
 
+template <class T>
+void Timer<T>::Restore(bool active, double time, long seq)
+{
+  Cancel();
+  m_event.time = time;
+  m_event.seq = seq;
+  if(!active)
+    return;
+  m_event.object = this;
+  m_event.active=true;
+  CostSimEng::Instance()->RestoreEvent(&m_event);
+}
+
 template <class T>
 void Timer<T>::activate(CostEvent*e)
 {
@@ -349,13 +966,11 @@ template <class T> component MultiTimer : public TimerBase
 				 
  private:
   std::vector<event_t*> m_events;
-  CostSimEng* m_simeng;
 };
 
 template <class T>
 MultiTimer<T>::MultiTimer()
 {
-  m_simeng = CostSimEng::Instance(); 
   GetEvent(0);
 }
 
@@ -385,23 +1000,23 @@ template <class T>
 void MultiTimer<T>::Set(T const & data, double time, unsigned int index)
 {
   event_t * e = GetEvent(index);
-  if(e->active)m_simeng->CancelEvent(e);
+  if(e->active)CostSimEng::Instance()->CancelEvent(e);
   e->time = time;
   e->data = data;
   e->object = this;
   e->active = true;
-  m_simeng->ScheduleEvent(e);
+  CostSimEng::Instance()->ScheduleEvent(e);
 }
 
 template <class T>
 void MultiTimer<T>::Set(double time, unsigned int index)
 {
   event_t * e = GetEvent(index);
-  if(e->active)m_simeng->CancelEvent(e);
+  if(e->active)CostSimEng::Instance()->CancelEvent(e);
   e->time = time;
   e->object = this;
   e->active = true;
-  m_simeng->ScheduleEvent(e);
+  CostSimEng::Instance()->ScheduleEvent(e);
 }
 
 template <class T>
@@ -409,7 +1024,7 @@ void MultiTimer<T>::Cancel(unsigned int index)
 {
   event_t * e = GetEvent(index);
   if(e->active)
-    m_simeng->CancelEvent(e);
+    CostSimEng::Instance()->CancelEvent(e);
   e->active = false;
 }
 
@@ -497,7 +1112,7 @@ unsigned int InfiTimer<T>::Set(T const & data, double time)
   e->data = data;
   e->object = this;
   e->active = true;
-  m_simeng->ScheduleEvent(e);
+  CostSimEng::Instance()->ScheduleEvent(e);
   return index;
 }
 
@@ -510,7 +1125,7 @@ unsigned int InfiTimer<T>::Set(double time)
   e->time = time;
   e->object = this;
   e->active = true;
-  m_simeng->ScheduleEvent(e);
+  CostSimEng::Instance()->ScheduleEvent(e);
   return index;
 }
 
@@ -519,7 +1134,7 @@ void InfiTimer<T>::Cancel(unsigned int index)
 {
   event_t * e = GetEvent(index);
   assert(e->active);
-  m_simeng->CancelEvent(e);
+  CostSimEng::Instance()->CancelEvent(e);
   ReleaseSlot(index);
   e->active = false;
 }
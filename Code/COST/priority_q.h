@@ -25,20 +25,40 @@
 #define PRIORITY_QUEUE_H
 #include <stdio.h>
 #include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include <vector>
+#include <algorithm>
 
 /*
-  Five Priority Queues:
+  Eight Priority Queues:
 
   SimpleQueue: Double Linked list
   GuardedQueue: Derived from SimpleQueue, checks before EnQueue() and Delete()
   ErrorQueue: Derived from SimpleQueue, only correct half of the time (for debugging)
   HeadQueue: Implicit Heap
   CalendarQueue: The fastest
+  LadderQueue: Multi-tier calendar, O(1) amortized for skewed/bursty timestamps
+  TimerWheel: O(1) slots for the events of the near future, in front of another queue
+  SelectableQueue: Dispatches to any of the above, chosen at run time
 
   Last Modified: Nov 18, 2002 by Gilbert Chen 
 
+  HeapQueue, CalendarQueue and LadderQueue order events by (time, seq), where
+  "seq" is stamped by the simulation engine (see CostSimEng::ScheduleEvent).
+  This makes their dequeue order identical to the one of SimpleQueue, also
+  for events scheduled at exactly the same time. SimpleQueue orders them by
+  (time, seq) too, which is the order it would give them anyway, so that the
+  events of a restored checkpoint also keep it (see CostSimEng::RestoreEvent).
+
 */
 
+template <class ITEM>
+inline bool EventBefore(const ITEM* a, const ITEM* b)
+{
+  return a->time < b->time || (a->time == b->time && a->seq < b->seq);
+}
+
 template < class ITEM >
 class SimpleQueue 
 {
@@ -63,7 +83,7 @@ const char* SimpleQueue<ITEM>::GetName()
 template <class ITEM>
 void SimpleQueue<ITEM>::EnQueue(ITEM* item)
 {
-  if( m_head==NULL || item->time < m_head->time )
+  if( m_head==NULL || EventBefore(item, m_head) )
   {
     if(m_head!=NULL)m_head->prev=item;
     item->next=m_head;
@@ -73,7 +93,7 @@ void SimpleQueue<ITEM>::EnQueue(ITEM* item)
   }
     
   ITEM* i=m_head;
-  while( i->next!=NULL && item->time > i->next->time)
+  while( i->next!=NULL && EventBefore(i->next, item))
     i=i->next;
   item->next=i->next;
   if(i->next!=NULL)i->next->prev=item;
@@ -257,8 +277,8 @@ void HeapQueue<ITEM>::Validate(const char* s)
   int i,j;
   char out[1000],buff[100];
   for(i=0;i<num_of_elems;i++)
-    if(  ((2*i+1)<num_of_elems&&elems[i]->time>elems[2*i+1]->time) ||
-	 ((2*i+2)<num_of_elems&&elems[i]->time>elems[2*i+2]->time) )
+    if(  ((2*i+1)<num_of_elems&&EventBefore(elems[2*i+1],elems[i])) ||
+	 ((2*i+2)<num_of_elems&&EventBefore(elems[2*i+2],elems[i])) )
     {
       sprintf(out,"queue error %s : ",s);
       for(j=0;j<num_of_elems;j++)
@@ -295,9 +315,9 @@ void HeapQueue<ITEM>::SiftDown(int node)
     k=i;
     c1=c2=2*i+1;
     c2++;
-    if(c1<num_of_elems && elems[c1]->time < elems[i]->time)
+    if(c1<num_of_elems && EventBefore(elems[c1],elems[i]))
       i=c1;
-    if(c2<num_of_elems && elems[c2]->time < elems[i]->time)
+    if(c2<num_of_elems && EventBefore(elems[c2],elems[i]))
       i=c2;
     if(k!=i)
     {
@@ -320,7 +340,7 @@ void HeapQueue<ITEM>::PercolateUp(int node)
     if( (p=(i+1)/2) != 0)
     {
       --p;
-      if(elems[i]->time < elems[p]->time)
+      if(EventBefore(elems[i],elems[p]))
       {
 	i=p;
 	temp=elems[i];
@@ -536,7 +556,7 @@ ITEM* CalendarQueue<ITEM>::dequeue()
     if(buckets[i]==NULL)
       continue;
     else
-      if(buckets[i]->time<buckets[smallest]->time)
+      if(EventBefore(buckets[i],buckets[smallest]))
 	smallest=i;
   }
   ITEM * item=buckets[smallest];
@@ -557,7 +577,7 @@ void CalendarQueue<ITEM>::EnQueue(ITEM* item)
     m_head=item;
     return;
   }
-  if(m_head->time>item->time)
+  if(EventBefore(item,m_head))
   {
     enqueue(m_head);
     m_head=item;
@@ -586,7 +606,7 @@ void CalendarQueue<ITEM>::enqueue(ITEM* item)
         
   /*Insert into buckets[i] */
 
-  if(buckets[i]==NULL||item->time<buckets[i]->time)
+  if(buckets[i]==NULL||EventBefore(item,buckets[i]))
   {
     item->next=buckets[i];
     buckets[i]=item;
@@ -595,7 +615,7 @@ void CalendarQueue<ITEM>::enqueue(ITEM* item)
   {
 
     ITEM* pos=buckets[i];
-    while(pos->next!=NULL&&item->time>pos->next->time)
+    while(pos->next!=NULL&&EventBefore(pos->next,item))
     {
       pos=pos->next;
     }
@@ -722,4 +742,597 @@ double CalendarQueue<ITEM>::NewWidth()
   return avg2;
 }
 
+
+/*
+  LadderQueue (Tang, Goh and Thng, 2005).
+
+  Events are kept in three tiers: an unsorted Top list holding the far
+  future, a Ladder of up to LQ_MAX_RUNGS rungs of buckets, and a sorted
+  Bottom list from which events are dequeued. A bucket holding more than
+  LQ_THRES events is split into a finer rung instead of being sorted, so
+  bursts of events scheduled close to each other are spread over buckets
+  whose width adapts to them. Every list is circular and doubly linked
+  around a sentinel, so Delete() is a plain O(1) unlink. As in
+  CalendarQueue, the earliest event is kept apart in m_head.
+*/
+
+#define LQ_THRES 50
+#define LQ_MAX_RUNGS 8
+
+template <class ITEM>
+class LadderQueue
+{
+ public:
+  LadderQueue();
+  ~LadderQueue();
+  const char* GetName();
+  void EnQueue(ITEM*);
+  ITEM* DeQueue();
+  ITEM* NextEvent() const { return m_head; }
+  void Delete(ITEM*);
+ private:
+  struct Rung
+  {
+    ITEM* buckets;	// bucket sentinels
+    long capacity;	// number of allocated sentinels
+    long number;	// number of buckets in use
+    long current;	// first bucket not yet transferred to Bottom
+    double start;
+    double width;
+  };
+
+  void enqueue(ITEM*);
+  ITEM* dequeue();
+  bool RefillBottom();
+  bool TopToRung();
+  void SpawnRung(ITEM*, long, double, double);
+  void SortIntoBottom(ITEM*);
+  void InsertBottom(ITEM*);
+  long RungIndex(const Rung&, double) const;
+
+  static void ListInit(ITEM* s) { s->next=s; s->prev=s; }
+  static bool ListEmpty(const ITEM* s) { return s->next==s; }
+  static void ListUnlink(ITEM* item)
+  {
+    item->prev->next=item->next;
+    item->next->prev=item->prev;
+  }
+  static void ListInsertAfter(ITEM* pos, ITEM* item)
+  {
+    item->prev=pos;
+    item->next=pos->next;
+    pos->next->prev=item;
+    pos->next=item;
+  }
+
+  ITEM m_top;
+  double m_top_start;
+  Rung m_rungs[LQ_MAX_RUNGS];
+  int m_num_rungs;
+  ITEM m_bottom;
+  ITEM* m_head;
+  std::vector<ITEM*> m_sort;
+  char m_name[100];
+};
+
+template <class ITEM>
+LadderQueue<ITEM>::LadderQueue()
+{
+  ListInit(&m_top);
+  ListInit(&m_bottom);
+  m_top_start=0.0;
+  m_num_rungs=0;
+  for(int i=0;i<LQ_MAX_RUNGS;i++)
+  {
+    m_rungs[i].buckets=NULL;
+    m_rungs[i].capacity=0;
+    m_rungs[i].number=0;
+    m_rungs[i].current=0;
+  }
+  m_head=NULL;
+}
+
+template <class ITEM>
+LadderQueue<ITEM>::~LadderQueue()
+{
+  for(int i=0;i<LQ_MAX_RUNGS;i++)
+    delete [] m_rungs[i].buckets;
+}
+
+template <class ITEM>
+const char* LadderQueue<ITEM>::GetName()
+{
+  sprintf(m_name,"LadderQueue (rungs: %d)",m_num_rungs);
+  return m_name;
+}
+
+template <class ITEM>
+void LadderQueue<ITEM>::EnQueue(ITEM* item)
+{
+  if(m_head==NULL)
+  {
+    m_head=item;
+    return;
+  }
+  if(EventBefore(item,m_head))
+  {
+    enqueue(m_head);
+    m_head=item;
+  }
+  else
+    enqueue(item);
+}
+
+template <class ITEM>
+ITEM* LadderQueue<ITEM>::DeQueue()
+{
+  ITEM* head=m_head;
+  m_head=dequeue();
+  return head;
+}
+
+template <class ITEM>
+void LadderQueue<ITEM>::Delete(ITEM* item)
+{
+  if(item==m_head)
+  {
+    m_head=dequeue();
+    return;
+  }
+  ListUnlink(item);
+}
+
+template <class ITEM>
+long LadderQueue<ITEM>::RungIndex(const Rung& r, double time) const
+{
+  if(time<r.start)
+    return -1;
+  double k=(time-r.start)/r.width;
+  if(k>=(double)(r.number-1))
+    return r.number-1;
+  return (long)k;
+}
+
+template <class ITEM>
+void LadderQueue<ITEM>::enqueue(ITEM* item)
+{
+  if(m_num_rungs==0)
+  {
+    // Bottom (if any) was filled straight from Top: keep it a prefix
+    if(!ListEmpty(&m_bottom)&&EventBefore(item,m_bottom.prev))
+      InsertBottom(item);
+    else
+      ListInsertAfter(m_top.prev,item);
+    return;
+  }
+  if(item->time>=m_top_start)
+  {
+    ListInsertAfter(m_top.prev,item);
+    return;
+  }
+  for(int i=0;i<m_num_rungs;i++)
+  {
+    Rung& r=m_rungs[i];
+    long k=RungIndex(r,item->time);
+    if(k>=r.current)
+    {
+      ListInsertAfter(r.buckets[k].prev,item);
+      return;
+    }
+  }
+  InsertBottom(item);
+}
+
+template <class ITEM>
+ITEM* LadderQueue<ITEM>::dequeue()
+{
+  if(ListEmpty(&m_bottom)&&!RefillBottom())
+    return NULL;
+  ITEM* item=m_bottom.next;
+  ListUnlink(item);
+  return item;
+}
+
+template <class ITEM>
+void LadderQueue<ITEM>::InsertBottom(ITEM* item)
+{
+  ITEM* pos=m_bottom.prev;
+  while(pos!=&m_bottom&&EventBefore(item,pos))
+    pos=pos->prev;
+  ListInsertAfter(pos,item);
+}
+
+template <class ITEM>
+void LadderQueue<ITEM>::SortIntoBottom(ITEM* list)
+{
+  m_sort.clear();
+  for(ITEM* i=list->next;i!=list;i=i->next)
+    m_sort.push_back(i);
+  ListInit(list);
+  std::sort(m_sort.begin(),m_sort.end(),EventBefore<ITEM>);
+  for(unsigned int i=0;i<m_sort.size();i++)
+    ListInsertAfter(m_bottom.prev,m_sort[i]);
+}
+
+/* Spread the events of "list" (count of them, within [lo, hi]) over a new rung */
+template <class ITEM>
+void LadderQueue<ITEM>::SpawnRung(ITEM* list, long count, double lo, double hi)
+{
+  Rung& r=m_rungs[m_num_rungs];
+  r.number=count+1;
+  r.current=0;
+  r.start=lo;
+  r.width=(hi-lo)/count;
+  // the rung must end strictly after its latest event
+  while(r.start+r.number*r.width<=hi)
+    r.width*=2;
+  if(r.capacity<r.number)
+  {
+    delete [] r.buckets;
+    r.capacity=r.number;
+    r.buckets=new ITEM[r.capacity];
+  }
+  for(long i=0;i<r.number;i++)
+    ListInit(&r.buckets[i]);
+  m_num_rungs++;
+
+  ITEM* item=list->next;
+  while(item!=list)
+  {
+    ITEM* next=item->next;
+    ListInsertAfter(r.buckets[RungIndex(r,item->time)].prev,item);
+    item=next;
+  }
+  ListInit(list);
+}
+
+/* Move Top into the first rung. Returns false if all its events share the same time */
+template <class ITEM>
+bool LadderQueue<ITEM>::TopToRung()
+{
+  long count=0;
+  double lo=m_top.next->time,hi=lo;
+  for(ITEM* i=m_top.next;i!=&m_top;i=i->next)
+  {
+    count++;
+    if(i->time<lo) lo=i->time;
+    if(i->time>hi) hi=i->time;
+  }
+  if(lo==hi)
+  {
+    SortIntoBottom(&m_top);
+    return false;
+  }
+  SpawnRung(&m_top,count,lo,hi);
+  m_top_start=m_rungs[0].start+m_rungs[0].number*m_rungs[0].width;
+  return true;
+}
+
+template <class ITEM>
+bool LadderQueue<ITEM>::RefillBottom()
+{
+  while(true)
+  {
+    if(m_num_rungs==0)
+    {
+      if(ListEmpty(&m_top))
+	return false;
+      if(!TopToRung())
+	return true;
+    }
+    Rung& r=m_rungs[m_num_rungs-1];
+    while(r.current<r.number&&ListEmpty(&r.buckets[r.current]))
+      r.current++;
+    if(r.current==r.number)
+    {
+      m_num_rungs--;
+      continue;
+    }
+    ITEM* bucket=&r.buckets[r.current];
+    r.current++;
+
+    long count=0;
+    double lo=bucket->next->time,hi=lo;
+    for(ITEM* i=bucket->next;i!=bucket;i=i->next)
+    {
+      count++;
+      if(i->time<lo) lo=i->time;
+      if(i->time>hi) hi=i->time;
+    }
+    if(count>LQ_THRES&&m_num_rungs<LQ_MAX_RUNGS&&lo<hi)
+    {
+      SpawnRung(bucket,count,lo,hi);
+      continue;
+    }
+    SortIntoBottom(bucket);
+    return true;
+  }
+}
+
+
+/*
+  TimerWheel: hashed timing wheel kept in front of another queue.
+
+  Time is quantised into slots of TW_GRANULARITY seconds (the PHY time
+  resolution is well below the SIFS/slot/timeout durations) and the wheel
+  covers TW_SLOTS slots from the slot of the last dequeued event. Events
+  falling inside that horizon are linked into an unsorted, doubly linked
+  per-slot list, so EnQueue() and Delete() are O(1) whatever
+  the number of pending events: this is what the cancel-and-rearm pattern
+  of the node timers (backoff freezing, ACK/CTS/NAV timeouts, SIFS) pays
+  on every channel state change. Events beyond the horizon are left to the
+  queue behind the wheel (see SelectableQueue). The earliest event is found
+  through an occupancy bitmap and a scan of its slot, comparing by (time,
+  seq) as the other queues do, and it is cached until it is removed.
+*/
+
+#define TW_GRANULARITY 1E-6
+#define TW_SLOTS 16384
+#define TW_WORDS (TW_SLOTS/64)
+
+template <class ITEM>
+class TimerWheel
+{
+ public:
+  TimerWheel();
+  ~TimerWheel();
+  const char* GetName();
+  bool Accepts(const ITEM* item) const { return Slot(item->time)<m_cursor+TW_SLOTS; }
+  void EnQueue(ITEM*);
+  void Delete(ITEM*);
+  void Advance(double time) { m_cursor=Slot(time); }
+  ITEM* NextEvent() const;
+ private:
+  static long long Slot(double time) { return (long long)(time/TW_GRANULARITY); }
+  ITEM* FindFirst() const;
+
+  ITEM** m_slots;	// first event of every slot
+  uint64_t m_occupied[TW_WORDS];
+  long long m_cursor;
+  long m_count;
+  mutable ITEM* m_head;
+  mutable bool m_head_valid;
+};
+
+template <class ITEM>
+TimerWheel<ITEM>::TimerWheel()
+{
+  m_slots=new ITEM*[TW_SLOTS];
+  memset(m_slots,0,TW_SLOTS*sizeof(ITEM*));
+  memset(m_occupied,0,sizeof(m_occupied));
+  m_cursor=0;
+  m_count=0;
+  m_head=NULL;
+  m_head_valid=true;
+}
+
+template <class ITEM>
+TimerWheel<ITEM>::~TimerWheel()
+{
+  delete [] m_slots;
+}
+
+template <class ITEM>
+const char* TimerWheel<ITEM>::GetName()
+{
+  static const char* name = "TimerWheel";
+  return name;
+}
+
+template <class ITEM>
+void TimerWheel<ITEM>::EnQueue(ITEM* item)
+{
+  int slot=(int)(Slot(item->time)&(TW_SLOTS-1));
+  item->prev=NULL;
+  item->next=m_slots[slot];
+  if(item->next!=NULL)
+    item->next->prev=item;
+  m_slots[slot]=item;
+  m_occupied[slot>>6]|=(uint64_t)1<<(slot&63);
+  if(m_count++==0)
+  {
+    m_head=item;
+    m_head_valid=true;
+  }
+  else if(m_head_valid&&EventBefore(item,m_head))
+    m_head=item;
+}
+
+template <class ITEM>
+void TimerWheel<ITEM>::Delete(ITEM* item)
+{
+  int slot=(int)(Slot(item->time)&(TW_SLOTS-1));
+  if(item->prev!=NULL)
+    item->prev->next=item->next;
+  else
+    m_slots[slot]=item->next;
+  if(item->next!=NULL)
+    item->next->prev=item->prev;
+  if(m_slots[slot]==NULL)
+    m_occupied[slot>>6]&=~((uint64_t)1<<(slot&63));
+  if(--m_count==0)
+  {
+    m_head=NULL;
+    m_head_valid=true;
+  }
+  else if(item==m_head)
+    m_head_valid=false;
+}
+
+template <class ITEM>
+ITEM* TimerWheel<ITEM>::NextEvent() const
+{
+  if(!m_head_valid)
+  {
+    m_head=FindFirst();
+    m_head_valid=true;
+  }
+  return m_head;
+}
+
+template <class ITEM>
+ITEM* TimerWheel<ITEM>::FindFirst() const
+{
+  // Slots are visited from the cursor onwards, wrapping around once: all
+  // the events are within one turn of the cursor, so the first occupied
+  // slot holds the earliest ones.
+  int start=(int)(m_cursor&(TW_SLOTS-1));
+  int word=start>>6;
+  uint64_t bits=m_occupied[word]&(~(uint64_t)0<<(start&63));
+  for(int n=0;n<=TW_WORDS;n++)
+  {
+    if(bits)
+    {
+      ITEM* first=m_slots[(word<<6)+__builtin_ctzll(bits)];
+      for(ITEM* i=first->next;i!=NULL;i=i->next)
+	if(EventBefore(i,first))
+	  first=i;
+      return first;
+    }
+    word=(word+1)&(TW_WORDS-1);
+    bits=m_occupied[word];
+  }
+  return NULL;
+}
+
+
+/*
+  SelectableQueue: the event list used by CostSimEng. The actual priority
+  queue is chosen by name ("simple", "heap", "calendar", "ladder" or
+  "wheel") before the first event is scheduled. "wheel" keeps a TimerWheel
+  in front of a HeapQueue that holds the events beyond its horizon; the
+  item flag "wheel" tells in which of both an event is queued.
+*/
+
+enum { QUEUE_SIMPLE, QUEUE_HEAP, QUEUE_CALENDAR, QUEUE_LADDER, QUEUE_WHEEL };
+
+template <class ITEM>
+class SelectableQueue
+{
+ public:
+  SelectableQueue() : m_type(QUEUE_HEAP), m_wheel(NULL) {}
+  ~SelectableQueue() { delete m_wheel; }
+  bool SetType(const char*);
+  int GetType() const { return m_type; }
+  void EnQueue(ITEM*);
+  ITEM* DeQueue();
+  void Delete(ITEM*);
+  ITEM* NextEvent() const;
+  const char* GetName();
+ private:
+  int m_type;
+  SimpleQueue<ITEM> m_simple;
+  HeapQueue<ITEM> m_heap;
+  CalendarQueue<ITEM> m_calendar;
+  LadderQueue<ITEM> m_ladder;
+  TimerWheel<ITEM>* m_wheel;
+};
+
+template <class ITEM>
+bool SelectableQueue<ITEM>::SetType(const char* name)
+{
+  assert(NextEvent()==NULL);
+  if(strcmp(name,"simple")==0) m_type=QUEUE_SIMPLE;
+  else if(strcmp(name,"heap")==0) m_type=QUEUE_HEAP;
+  else if(strcmp(name,"calendar")==0) m_type=QUEUE_CALENDAR;
+  else if(strcmp(name,"ladder")==0) m_type=QUEUE_LADDER;
+  else if(strcmp(name,"wheel")==0) m_type=QUEUE_WHEEL;
+  else return false;
+  if(m_type==QUEUE_WHEEL&&m_wheel==NULL)
+    m_wheel=new TimerWheel<ITEM>;
+  return true;
+}
+
+template <class ITEM>
+void SelectableQueue<ITEM>::EnQueue(ITEM* item)
+{
+  switch(m_type)
+  {
+  case QUEUE_SIMPLE: m_simple.EnQueue(item); break;
+  case QUEUE_CALENDAR: m_calendar.EnQueue(item); break;
+  case QUEUE_LADDER: m_ladder.EnQueue(item); break;
+  case QUEUE_WHEEL:
+    item->wheel=m_wheel->Accepts(item);
+    if(item->wheel)
+      m_wheel->EnQueue(item);
+    else
+      m_heap.EnQueue(item);
+    break;
+  default: m_heap.EnQueue(item); break;
+  }
+}
+
+template <class ITEM>
+ITEM* SelectableQueue<ITEM>::DeQueue()
+{
+  switch(m_type)
+  {
+  case QUEUE_SIMPLE: return m_simple.DeQueue();
+  case QUEUE_CALENDAR: return m_calendar.DeQueue();
+  case QUEUE_LADDER: return m_ladder.DeQueue();
+  case QUEUE_WHEEL:
+    {
+      ITEM* item=m_wheel->NextEvent();
+      ITEM* far=m_heap.NextEvent();
+      if(item==NULL||(far!=NULL&&EventBefore(far,item)))
+	item=m_heap.DeQueue();
+      else
+	m_wheel->Delete(item);
+      if(item!=NULL)
+	m_wheel->Advance(item->time);
+      return item;
+    }
+  default: return m_heap.DeQueue();
+  }
+}
+
+template <class ITEM>
+void SelectableQueue<ITEM>::Delete(ITEM* item)
+{
+  switch(m_type)
+  {
+  case QUEUE_SIMPLE: m_simple.Delete(item); break;
+  case QUEUE_CALENDAR: m_calendar.Delete(item); break;
+  case QUEUE_LADDER: m_ladder.Delete(item); break;
+  case QUEUE_WHEEL:
+    if(item->wheel)
+      m_wheel->Delete(item);
+    else
+      m_heap.Delete(item);
+    break;
+  default: m_heap.Delete(item); break;
+  }
+}
+
+template <class ITEM>
+ITEM* SelectableQueue<ITEM>::NextEvent() const
+{
+  switch(m_type)
+  {
+  case QUEUE_SIMPLE: return m_simple.NextEvent();
+  case QUEUE_CALENDAR: return m_calendar.NextEvent();
+  case QUEUE_LADDER: return m_ladder.NextEvent();
+  case QUEUE_WHEEL:
+    {
+      ITEM* item=m_wheel->NextEvent();
+      ITEM* far=m_heap.NextEvent();
+      return item==NULL||(far!=NULL&&EventBefore(far,item))?far:item;
+    }
+  default: return m_heap.NextEvent();
+  }
+}
+
+template <class ITEM>
+const char* SelectableQueue<ITEM>::GetName()
+{
+  switch(m_type)
+  {
+  case QUEUE_SIMPLE: return m_simple.GetName();
+  case QUEUE_CALENDAR: return m_calendar.GetName();
+  case QUEUE_LADDER: return m_ladder.GetName();
+  case QUEUE_WHEEL: return "TimerWheel+HeapQueue";
+  default: return m_heap.GetName();
+  }
+}
+
 #endif /*PRIORITY_QUEUE_H*/
@@ -0,0 +1,242 @@
+/* Kom8ndor IEEE 802.11bn Simulator
+ *
+ * Copyright (c) 2026, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+ *
+ * -----------------------------------------------------------------
+ * Author  : Francesc Wilhelmi
+ * -----------------------------------------------------------------
+ */
+
+/**
+ * external_model_batch.h: shared-memory transport for an external ML server (--ml-transport shm)
+ *
+ * All the agents of a simulation that use the same socket path share one ExternalModelBatch. Instead of a
+ * round trip over the socket per decision, every agent writes its features into the next slot of a ring
+ * buffer mapped by both processes, and the pending slots are handed to the server at once, so that it can
+ * run a single (vectorised) inference for the whole batch. The agents whose decision timers fire at the
+ * same simulated instant submit before the first of them posts the batch (see Agent::ComputeNewConfiguration),
+ * so that they end up in the same batch. Posting a batch does not wait for it: with --decision-latency, the
+ * outputs are only waited for when the decisions are applied, and several batches may be in flight.
+ *
+ * Ring buffer (file in /dev/shm, or /tmp, mapped with MAP_SHARED; native-endian, same host):
+ *   header : uint32_t magic, num_slots, max_features, max_outputs
+ *   slot   : int32_t agent_id, uint32_t n_feat, n_out, reserved, float features[max_features], float out[max_outputs]
+ *
+ * Socket protocol (the socket of ExternalModelClient only carries the doorbells):
+ *   C++ → Python : uint32_t EXTERNAL_BATCH_MAGIC, uint32_t path length, path of the ring buffer
+ *   Python → C++ : uint32_t EXTERNAL_BATCH_MAGIC once the ring buffer is mapped
+ *   C++ → Python : uint32_t count, uint32_t first_slot (slots first_slot, first_slot + 1, ... modulo num_slots)
+ *   Python → C++ : uint32_t count once the outputs of the batch are written (batches are answered in order)
+ *   C++ → Python : uint32_t 0 (as ExternalModelClient::Close())
+ * The magic is larger than any n_feat of the per-query protocol, so a server can serve both kinds of clients.
+ *
+ * C++98 compatible — no lambdas, no auto, no in-class member initializers.
+ */
+
+#ifndef _EXTERNAL_MODEL_BATCH_H_
+#define _EXTERNAL_MODEL_BATCH_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <deque>
+#include <string>
+
+#include "external_model_client.h"
+
+#define EXTERNAL_BATCH_MAGIC		0x4B4D4C42	///> "KMLB": first word sent by a shared-memory client
+#define EXTERNAL_BATCH_NUM_SLOTS	256			///> Slots of the ring buffer (requests per batch at most)
+#define EXTERNAL_BATCH_MAX_FEATURES	64			///> Features per request at most
+#define EXTERNAL_BATCH_MAX_OUTPUTS	4			///> Outputs per request at most
+
+struct ExternalModelRingHeader {
+	uint32_t magic;
+	uint32_t num_slots;
+	uint32_t max_features;
+	uint32_t max_outputs;
+};
+
+struct ExternalModelRingSlot {
+	int32_t agent_id;
+	uint32_t n_feat;
+	uint32_t n_out;
+	uint32_t reserved;
+	float features[EXTERNAL_BATCH_MAX_FEATURES];
+	float out[EXTERNAL_BATCH_MAX_OUTPUTS];
+};
+
+struct ExternalModelBatch {
+
+	std::string socket_path;
+	ExternalModelClient client;			/* Doorbells */
+	ExternalModelRingHeader *ring;		/* Mapped ring buffer (header followed by the slots) */
+	ExternalModelRingSlot *slots;
+	size_t ring_size;
+
+	int first_busy;						/* Oldest slot whose output has not been received yet */
+	int num_in_flight;					/* Slots handed to the server, output not received yet */
+	int num_pending;					/* Slots not handed to the server yet (they follow the ones in flight) */
+	std::deque<int> in_flight_sizes;	/* Size of every batch in flight, oldest first */
+	float *pending_out[EXTERNAL_BATCH_NUM_SLOTS];	/* Where the outputs of every busy slot are copied */
+	pthread_mutex_t mutex;				/* Agents of concurrent logical processes (--partition) share the batch */
+
+	/* Statistics */
+	long long num_requests;				/* Also the ticket of the next request */
+	long long num_completed;			/* Requests whose output has been received */
+	long long num_batches;
+	int max_batch_size;
+
+	ExternalModelBatch() : ring(NULL), slots(NULL), ring_size(0), first_busy(0), num_in_flight(0), num_pending(0),
+		num_requests(0), num_completed(0), num_batches(0), max_batch_size(0) {
+		pthread_mutex_init(&mutex, NULL);
+	}
+
+	~ExternalModelBatch() {
+		pthread_mutex_destroy(&mutex);
+	}
+
+	/* Create the ring buffer and hand it to the server listening at socket_path.
+	 * Aborts if the server is not listening or does not support shared memory. */
+	void Open(const char* socket_path_console) {
+		socket_path = socket_path_console;
+		client.Connect(socket_path_console);
+
+		struct stat dir_status;
+		const char *dir = (stat("/dev/shm", &dir_status) == 0) ? "/dev/shm" : "/tmp";
+		char ring_path[256];
+		snprintf(ring_path, sizeof(ring_path), "%s/komondor_ml_%d_%d", dir, (int) getpid(), client.sockfd);
+		ring_size = sizeof(ExternalModelRingHeader) + EXTERNAL_BATCH_NUM_SLOTS * sizeof(ExternalModelRingSlot);
+		int fd = open(ring_path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+		if (fd < 0 || ftruncate(fd, ring_size) != 0) {
+			perror("[ExternalModelBatch] ring buffer");
+			exit(EXIT_FAILURE);
+		}
+		void *map = mmap(NULL, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		syscall(SYS_close, fd);  /* 'close' may also conflict with COST */
+		if (map == MAP_FAILED) {
+			perror("[ExternalModelBatch] mmap");
+			exit(EXIT_FAILURE);
+		}
+		ring = (ExternalModelRingHeader *) map;
+		slots = (ExternalModelRingSlot *) ((char *) map + sizeof(ExternalModelRingHeader));
+		ring->magic = EXTERNAL_BATCH_MAGIC;
+		ring->num_slots = EXTERNAL_BATCH_NUM_SLOTS;
+		ring->max_features = EXTERNAL_BATCH_MAX_FEATURES;
+		ring->max_outputs = EXTERNAL_BATCH_MAX_OUTPUTS;
+
+		/* --- handshake: magic, path of the ring buffer, and magic back --- */
+		uint32_t words[2];
+		words[0] = EXTERNAL_BATCH_MAGIC;
+		words[1] = (uint32_t) strlen(ring_path);
+		uint32_t ack = 0;
+		if (client.SendAll(words, (int)sizeof(words)) < 0 || client.SendAll(ring_path, (int) words[1]) < 0
+				|| client.RecvAll(&ack, (int)sizeof(uint32_t)) < 0 || ack != EXTERNAL_BATCH_MAGIC) {
+			fprintf(stderr, "[ExternalModelBatch] %s does not support shared memory (use --ml-transport socket)\n",
+				socket_path_console);
+			exit(EXIT_FAILURE);
+		}
+		unlink(ring_path);	/* Mapped by both sides: no longer needed */
+		printf("[ExternalModelBatch] Ring buffer of %d slots shared with %s\n", EXTERNAL_BATCH_NUM_SLOTS,
+			socket_path_console);
+	}
+
+	/* Write a request into the next free slot; out (n_out floats) is filled once its batch is done.
+	 * If the ring buffer is full, the oldest batch is waited for first.
+	 * Returns the ticket of the request (see Wait()). */
+	long long Submit(int agent_id, const float* features, int n_feat, float* out, int n_out) {
+		if (n_feat > EXTERNAL_BATCH_MAX_FEATURES || n_out > EXTERNAL_BATCH_MAX_OUTPUTS) {
+			fprintf(stderr, "[ExternalModelBatch] request larger than a slot\n");
+			exit(EXIT_FAILURE);
+		}
+		pthread_mutex_lock(&mutex);
+		if (num_in_flight + num_pending == EXTERNAL_BATCH_NUM_SLOTS) {
+			PostPending();
+			ReceiveOldest();
+		}
+		int s = (first_busy + num_in_flight + num_pending) % EXTERNAL_BATCH_NUM_SLOTS;
+		slots[s].agent_id = agent_id;
+		slots[s].n_feat = (uint32_t) n_feat;
+		slots[s].n_out = (uint32_t) n_out;
+		memcpy(slots[s].features, features, n_feat * sizeof(float));
+		pending_out[s] = out;
+		++ num_pending;
+		long long ticket = num_requests++;
+		pthread_mutex_unlock(&mutex);
+		return ticket;
+	}
+
+	/* Hand the pending requests to the server as one batch, without waiting for it (no-op if none is pending). */
+	void Post() {
+		pthread_mutex_lock(&mutex);
+		PostPending();
+		pthread_mutex_unlock(&mutex);
+	}
+
+	/* Wait until the output of a request has been copied (its batch is posted first if still pending). */
+	void Wait(long long ticket) {
+		pthread_mutex_lock(&mutex);
+		if (ticket >= num_completed + num_in_flight) PostPending();
+		while (num_completed <= ticket) ReceiveOldest();
+		pthread_mutex_unlock(&mutex);
+	}
+
+	/* Unmap the ring buffer and close the socket, once every request is done. Safe to call more than once. */
+	void Close() {
+		if (ring != NULL) {
+			if (num_requests > 0) Wait(num_requests - 1);
+			client.Close();
+			munmap(ring, ring_size);
+			ring = NULL;
+			slots = NULL;
+		}
+	}
+
+private:
+
+	/* Doorbell for the pending slots (mutex held). */
+	void PostPending() {
+		if (num_pending == 0) return;
+		uint32_t words[2];
+		words[0] = (uint32_t) num_pending;
+		words[1] = (uint32_t) ((first_busy + num_in_flight) % EXTERNAL_BATCH_NUM_SLOTS);
+		if (client.SendAll(words, (int)sizeof(words)) < 0) {
+			fprintf(stderr, "[ExternalModelBatch] batch of %d requests failed\n", num_pending);
+			exit(EXIT_FAILURE);
+		}
+		in_flight_sizes.push_back(num_pending);
+		num_in_flight += num_pending;
+		++ num_batches;
+		if (num_pending > max_batch_size) max_batch_size = num_pending;
+		num_pending = 0;
+	}
+
+	/* Wait for the oldest batch in flight and copy its outputs (mutex held). */
+	void ReceiveOldest() {
+		int size = in_flight_sizes.front();
+		uint32_t done = 0;
+		if (client.RecvAll(&done, (int)sizeof(uint32_t)) < 0 || done != (uint32_t) size) {
+			fprintf(stderr, "[ExternalModelBatch] batch of %d requests failed\n", size);
+			exit(EXIT_FAILURE);
+		}
+		for (int i = 0; i < size; ++i) {
+			int s = (first_busy + i) % EXTERNAL_BATCH_NUM_SLOTS;
+			memcpy(pending_out[s], slots[s].out, slots[s].n_out * sizeof(float));
+		}
+		in_flight_sizes.pop_front();
+		first_busy = (first_busy + size) % EXTERNAL_BATCH_NUM_SLOTS;
+		num_in_flight -= size;
+		num_completed += size;
+	}
+
+};
+
+#endif /* _EXTERNAL_MODEL_BATCH_H_ */
@@ -19,6 +19,9 @@
  *   C++ → Python : uint32_t n_feat, then n_feat * 4 bytes (float[])
  *   Python → C++ : n_out  * 4 bytes (float[])
  *
+ * This per-query protocol is the default (--ml-transport socket). See
+ * external_model_batch.h for the batched shared-memory one.
+ *
  * C++98 compatible — no lambdas, no auto, no in-class member initializers.
  */
 
@@ -67,6 +70,13 @@ struct ExternalModelClient {
 	/* Send features to the server; receive n_out floats back.
 	 * Uses retry loops to handle short send/recv on a local socket. */
 	void Query(float* features, int n_feat, float* out, int n_out) {
+		Send(features, n_feat);
+		Receive(out, n_out);
+	}
+
+	/* Send features to the server without waiting for the result, which
+	 * is read by the next Receive() (--decision-latency). */
+	void Send(float* features, int n_feat) {
 		/* --- send header (4 bytes: number of features) --- */
 		uint32_t header = (uint32_t) n_feat;
 		if (SendAll(&header, (int)sizeof(uint32_t)) < 0) {
@@ -78,6 +88,10 @@ struct ExternalModelClient {
 			fprintf(stderr, "[ExternalModelClient] send features failed\n");
 			exit(EXIT_FAILURE);
 		}
+	}
+
+	/* Receive the n_out floats of the features sent last. */
+	void Receive(float* out, int n_out) {
 		/* --- receive result --- */
 		if (RecvAll(out, n_out * (int)sizeof(float)) < 0) {
 			fprintf(stderr, "[ExternalModelClient] recv result failed\n");
@@ -99,6 +113,8 @@ struct ExternalModelClient {
 	}
 private:
 
+	friend struct ExternalModelBatch;	/* Sends its doorbells over this socket */
+
 	/* Retry send until all bytes are written; returns 0 on success, -1 on error. */
 	int SendAll(void* buf, int len) {
 		int sent = 0;
@@ -35,6 +35,13 @@
  *   features[0] = arm_ix    (last arm played)
  *   features[1] = reward    (last reward)
  *   features[2] = num_arms  (total arms, so server never needs it as an arg)
+ *
+ * Decisions can also be split into RequestDecision() and CollectDecision(),
+ * so that the simulation goes on while the model computes (--decision-latency):
+ * the features are sent without waiting for the result. With a shared batch
+ * (--ml-transport shm), the requests of all the agents deciding at the same
+ * instant are handed to the server at once by PostDecisionRequests() (see
+ * external_model_batch.h).
  */
 
 #include "../list_of_macros.h"
@@ -44,6 +51,7 @@
 #include "network_optimization_methods/multi_armed_bandits.h"
 #include "network_optimization_methods/rtot_algorithm.h"
 #include "external_model_client.h"
+#include "external_model_batch.h"
 
 #ifndef _AUX_LEARNING_ALGORITHM_
 #define _AUX_LEARNING_ALGORITHM_
@@ -54,6 +62,7 @@ class LearningAlgorithm {
 
 		/* Identity */
 		int agent_id;
+		CostRandomStream *random_stream;	/* stream of the agent */
 
 		/* Algorithm selection */
 		int learning_mechanism;
@@ -66,6 +75,7 @@ class LearningAlgorithm {
 
 		/* External model parameters (LEARNING_MECHANISM_EXTERNAL only) */
 		char external_socket_path[256];
+		ExternalModelBatch *external_batch;	/* shared with the other agents (NULL: own socket) */
 
 		/* Logging */
 		int save_logs;
@@ -80,6 +90,9 @@ class LearningAlgorithm {
 		/* Stats tracked for LEARNING_MECHANISM_EXTERNAL */
 		int    ext_num_queries;
 		double ext_last_arm;
+		float  ext_out[EXTERNAL_BATCH_MAX_OUTPUTS];	/* filled when the batch is done */
+		long long ext_ticket;	/* request of the agent in the shared batch */
+		double pending_result;	/* decision of the built-in algorithms, until collected */
 
 	public:
 
@@ -97,6 +110,7 @@ class LearningAlgorithm {
 
 				case MULTI_ARMED_BANDITS: {
 					mab_agent.agent_id               = agent_id;
+					mab_agent.random_stream          = random_stream;
 					mab_agent.save_logs              = save_logs;
 					mab_agent.print_logs             = print_logs;
 					mab_agent.action_selection_strategy = action_selection_strategy;
@@ -115,7 +129,7 @@ class LearningAlgorithm {
 				case LEARNING_MECHANISM_EXTERNAL: {
 					ext_num_queries = 0;
 					ext_last_arm    = 0.0;
-					external_client.Connect(external_socket_path);
+					if (external_batch == NULL) external_client.Connect(external_socket_path);
 					break;
 				}
 
@@ -128,6 +142,12 @@ class LearningAlgorithm {
 			}
 		}
 
+		/* Change the action-selection strategy, keeping what has been learnt so far */
+		void SetActionSelectionStrategy(int strategy) {
+			action_selection_strategy = strategy;
+			mab_agent.action_selection_strategy = strategy;
+		}
+
 		/****************************/
 		/*  MAIN UPDATE             */
 		/****************************/
@@ -167,12 +187,10 @@ class LearningAlgorithm {
 				}
 
 				case LEARNING_MECHANISM_EXTERNAL: {
-					float features[64];
+					float features[EXTERNAL_BATCH_MAX_FEATURES];
 					float out[1];
-					features[0] = (float) arm_ix;
-					features[1] = (float) reward;
-					features[2] = (float) num_arms;
-					external_client.Query(features, 3, out, 1);
+					int n_feat = ExternalFeatures(arm_ix, reward, features);
+					external_client.Query(features, n_feat, out, 1);
 					result = (double) out[0];
 					++ ext_num_queries;
 					ext_last_arm = result;
@@ -190,6 +208,48 @@ class LearningAlgorithm {
 			return result;
 		}
 
+		/* True if the decision requests are handed to a shared batch (see PostDecisionRequests) */
+		bool Batched() {
+			return learning_mechanism == LEARNING_MECHANISM_EXTERNAL && external_batch != NULL;
+		}
+
+		/**
+		 * Issue the decision of Update() without waiting for it: the features are sent to the external
+		 * model (or submitted to the shared batch), while the built-in algorithms decide right away.
+		 */
+		void RequestDecision(int arm_ix, double reward, int *available_arms) {
+			if (learning_mechanism != LEARNING_MECHANISM_EXTERNAL) {
+				pending_result = Update(arm_ix, reward, available_arms);
+				return;
+			}
+			float features[EXTERNAL_BATCH_MAX_FEATURES];
+			int n_feat = ExternalFeatures(arm_ix, reward, features);
+			if (external_batch != NULL) {
+				ext_ticket = external_batch->Submit(agent_id, features, n_feat, ext_out, 1);
+			} else {
+				external_client.Send(features, n_feat);
+			}
+		}
+
+		/* Hand the requests submitted to the shared batch to the server (no-op if already done) */
+		void PostDecisionRequests() {
+			if (Batched()) external_batch->Post();
+		}
+
+		/* Decision issued last by RequestDecision() (waits for the external model if not received yet) */
+		double CollectDecision() {
+			if (learning_mechanism != LEARNING_MECHANISM_EXTERNAL) return pending_result;
+			if (external_batch != NULL) {
+				external_batch->Wait(ext_ticket);
+			} else {
+				external_client.Receive(ext_out, 1);
+			}
+			double result = (double) ext_out[0];
+			++ ext_num_queries;
+			ext_last_arm = result;
+			return result;
+		}
+
 		/****************************/
 		/*  PRINT / WRITE           */
 		/****************************/
@@ -208,8 +268,8 @@ class LearningAlgorithm {
 					break;
 				}
 				case LEARNING_MECHANISM_EXTERNAL: {
-					printf("%s External model: socket=%s  queries=%d  last_arm=%.0f\n",
-					       LOG_LVL3, external_socket_path,
+					printf("%s External model: socket=%s (%s)  queries=%d  last_arm=%.0f\n",
+					       LOG_LVL3, external_socket_path, external_batch != NULL ? "shm" : "socket",
 					       ext_num_queries, ext_last_arm);
 					break;
 				}
@@ -221,13 +281,37 @@ class LearningAlgorithm {
 			}
 		}
 
-		/* Close the external socket (no-op for built-in algorithms). */
+		/* Save the learning state to a checkpoint, or restore it (once the variables are initialized).
+		 * The state of an external model lives in its server, so it cannot be checkpointed. */
+		void Checkpoint(CheckpointFile &file) {
+			if (learning_mechanism == LEARNING_MECHANISM_EXTERNAL) {
+				printf("ERROR: Agent %d: external ML models cannot be checkpointed\n", agent_id);
+				exit(-1);
+			}
+			file.Field(pending_result);
+			if (learning_mechanism == MULTI_ARMED_BANDITS) mab_agent.Checkpoint(file);
+		}
+
+		/* Close the external socket (no-op for built-in algorithms and shared batches,
+		 * which are closed by the simulation). */
 		void Close() {
 			if (learning_mechanism == LEARNING_MECHANISM_EXTERNAL) {
 				external_client.Close();
 			}
 		}
 
+	private:
+
+		/* Features sent to the external model (see the wire protocol above) */
+		int ExternalFeatures(int arm_ix, double reward, float *features) {
+			features[0] = (float) arm_ix;
+			features[1] = (float) reward;
+			features[2] = (float) num_arms;
+			return 3;
+		}
+
+	public:
+
 		void PrintAvailableLearningMechanisms() {
 			printf("%s Available learning mechanisms:\n", LOG_LVL2);
 			printf("%s MONITORING_ONLY          (%d)\n", LOG_LVL3, MONITORING_ONLY);
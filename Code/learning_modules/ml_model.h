@@ -70,6 +70,7 @@ class MlModel {
 
 		// Generic
 		int agent_id;					///> ID of the agent calling the ML method
+		CostRandomStream *random_stream;	///> Random number stream of the agent (or controller) calling the ML method
 		int learning_mechanism;			///> Index of the learning mechanism employed
 		int action_selection_strategy;	///> Index of the chosen action-selection strategy
 
@@ -203,6 +204,7 @@ class MlModel {
 				/* Multi-Armed Bandits */
 				case MULTI_ARMED_BANDITS: {
 					mab_agent.agent_id = agent_id;
+					mab_agent.random_stream = random_stream;
 					mab_agent.save_logs = save_logs;
 					mab_agent.print_logs = print_logs;
 					mab_agent.action_selection_strategy = action_selection_strategy;
@@ -231,6 +233,37 @@ class MlModel {
 			}
 		}
 
+		/**
+		* Change the action-selection strategy, keeping what has been learnt so far (e.g., in a continuation)
+		* @param "strategy" [type int]: index of the new action-selection strategy
+		*/
+		void SetActionSelectionStrategy(int strategy) {
+			action_selection_strategy = strategy;
+			mab_agent.action_selection_strategy = strategy;
+		}
+
+		/**
+		* Save the state of the ML method to a checkpoint, or restore it (once the variables are initialized)
+		* @param "file" [type CheckpointFile&]: checkpoint being written or read
+		* @param "controller_report" [type ControllerReport]: report of the CC (centralized methods)
+		*/
+		void Checkpoint(CheckpointFile &file, ControllerReport &controller_report) {
+			switch(learning_mechanism) {
+				case CENTRALIZED_ACTION_BANNING: {
+					action_banner.Checkpoint(file, controller_report);
+					break;
+				}
+				case MULTI_ARMED_BANDITS: {
+					mab_agent.Checkpoint(file);
+					break;
+				}
+				// The other methods keep no state between iterations
+				default: {
+					break;
+				}
+			}
+		}
+
 		/*************************/
 		/*************************/
 		/*  PRINT/WRITE METHODS  */
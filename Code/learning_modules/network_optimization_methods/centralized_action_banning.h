@@ -50,6 +50,7 @@
  */
 
 #include "../../list_of_macros.h"
+#include "../../structures/checkpoint_file.h"
 
 #ifndef _AUX_BANNING_
 #define _AUX_BANNING_
@@ -450,6 +451,34 @@ class CentralizedActionBanning {
 
 		}
 
+		/**
+		* Save the banning state to a checkpoint, or restore it (once the variables are initialized). After the first
+		* update, the information provided by the CC is the one of its report, which is restored by the CC
+		* @param "file" [type CheckpointFile&]: checkpoint being written or read
+		* @param "controller_report" [type ControllerReport]: report of the CC (already restored when reading)
+		*/
+		void Checkpoint(CheckpointFile &file, ControllerReport &controller_report) {
+			file.Array(initial_banning_threshold, agents_number);
+			file.Array(current_banning_threshold, agents_number);
+			file.Field(banning_iteration);
+			file.Field(banned_in_last_iteration);
+			file.Array(max_reward_seen_per_agent, agents_number);
+			file.Array(previous_performance_per_agent, agents_number);
+			file.Array(previously_banned_action_per_agent, agents_number);
+			int updated (list_of_available_actions_per_agent == controller_report.list_of_available_actions_per_agent);
+			file.Field(updated);
+			if (file.Reading() && updated) {
+				num_arms_per_agent = controller_report.num_arms_per_agent;
+				list_of_available_actions_per_agent = controller_report.list_of_available_actions_per_agent;
+				most_played_action_per_agent = controller_report.most_played_action_per_agent;
+				times_action_played_per_agent = controller_report.times_action_played_per_agent;
+				configuration_array = controller_report.last_configuration_array;
+				average_performance_per_agent = controller_report.average_performance_per_agent;
+				clusters_per_wlan = controller_report.clusters_per_wlan;
+				cluster_performance = controller_report.cluster_performance;
+			}
+		}
+
 };
 
 #endif
@@ -50,6 +50,7 @@
  */
 
 #include "../../list_of_macros.h"
+#include "../../structures/checkpoint_file.h"
 
 #ifndef _AUX_MABS_
 #define _AUX_MABS_
@@ -65,6 +66,7 @@ class MultiArmedBandit {
 
         // General information
 		int agent_id;						///> Identified of the agent using MABs
+		CostRandomStream *random_stream;	///> Random number stream of the agent using MABs
 		int num_arms;					///> Number of actions
 		int action_selection_strategy;		///> Index of the chosen action-selection strategy
 
@@ -195,14 +197,14 @@ class MultiArmedBandit {
 		 */
 		int PickArmEgreedy(int num_arms, double *reward_per_arm, double epsilon, int *available_arms) {
 
-			double rand_number = ((double) rand() / (double)RAND_MAX);
+			double rand_number = ((double) random_stream->Rand() / (double)RAND_MAX);
 			int action_ix;
 
 			if (rand_number < epsilon) { //EXPLORE
-				action_ix = rand() % num_arms;
+				action_ix = random_stream->Rand() % num_arms;
 				int counter(0);
 				while (!available_arms[action_ix]) {
-					action_ix = rand() % num_arms;
+					action_ix = random_stream->Rand() % num_arms;
 					if(counter > 1000) break; // To avoid getting stuck (none of the actions is available)
 				}
 				//printf("EXPLORE: Selected action %d (available = %d), reward = %f\n", action_ix, available_arms[action_ix], reward_per_arm[action_ix]);
@@ -228,8 +230,8 @@ class MultiArmedBandit {
 		/*******************************/
 
 		double rand_normal() {
-		  double u1 = (double)rand() / RAND_MAX;
-		  double u2 = (double)rand() / RAND_MAX;
+		  double u1 = (double)random_stream->Rand() / RAND_MAX;
+		  double u2 = (double)random_stream->Rand() / RAND_MAX;
 		  return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
 		}
 
@@ -443,6 +445,22 @@ class MultiArmedBandit {
 			}
 		}
 
+		/**
+		 * Save the learning state to a checkpoint, or restore it (once the variables are initialized)
+		 * @param "file" [type CheckpointFile&]: checkpoint being written or read
+		 */
+		void Checkpoint(CheckpointFile &file){
+			file.Field(initial_reward);
+			file.Field(num_iterations);
+			file.Field(initial_epsilon);
+			file.Field(epsilon);
+			file.Array(reward_per_arm, num_arms);
+			file.Array(cumulative_reward_per_arm, num_arms);
+			file.Array(average_reward_per_arm, num_arms);
+			file.Array(estimated_reward_per_arm, num_arms);
+			file.Array(times_arm_has_been_selected, num_arms);
+		}
+
 };
 
 #endif
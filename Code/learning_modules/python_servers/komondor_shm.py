@@ -0,0 +1,84 @@
+"""
+/* Kom8ndor IEEE 802.11bn Simulator
+ *
+ * Copyright (c) 2026, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+ */
+"""
+
+"""
+komondor_shm.py - server side of the shared-memory transport (--ml-transport shm).
+
+A client that starts with the uint32 MAGIC (instead of n_feat) shares a ring
+buffer with the server, and then only sends doorbells over the socket:
+    recv: uint32_t path length, path of the ring buffer      (handshake)
+    send: uint32_t MAGIC once the ring buffer is mapped
+    recv: uint32_t count, uint32_t first_slot                 (one per batch)
+    send: uint32_t count once the outputs are written
+    recv: uint32_t 0                                          (shutdown sentinel)
+
+Ring buffer layout (matches external_model_batch.h, native-endian):
+    header: uint32_t magic, num_slots, max_features, max_outputs
+    slot:   int32_t agent_id, uint32_t n_feat, n_out, reserved,
+            float features[max_features], float out[max_outputs]
+"""
+
+import mmap
+import os
+import struct
+
+MAGIC = 0x4B4D4C42
+HEADER = struct.Struct("4I")
+SLOT_HEADER = struct.Struct("iIII")
+
+
+def recv_exact(s, nbytes):
+    buf = b""
+    while len(buf) < nbytes:
+        chunk = s.recv(nbytes - len(buf))
+        if not chunk:
+            raise ConnectionError("connection closed mid-receive")
+        buf += chunk
+    return buf
+
+
+class SharedRing:
+    """Ring buffer shared with one client (created once its MAGIC is received)."""
+
+    def __init__(self, conn):
+        length = struct.unpack("I", recv_exact(conn, 4))[0]
+        path = recv_exact(conn, length).decode()
+        fd = os.open(path, os.O_RDWR)
+        try:
+            self.mm = mmap.mmap(fd, os.fstat(fd).st_size)
+        finally:
+            os.close(fd)
+        magic, self.num_slots, self.max_features, self.max_outputs = HEADER.unpack_from(self.mm, 0)
+        if magic != MAGIC:
+            raise ConnectionError(f"{path} is not a Komondor ring buffer")
+        self.slot_size = SLOT_HEADER.size + 4 * (self.max_features + self.max_outputs)
+        conn.sendall(struct.pack("I", MAGIC))
+
+    def read_batch(self, conn, count):
+        """Read the doorbell of a batch of count requests.
+        Returns the slots and the features of each request."""
+        first = struct.unpack("I", recv_exact(conn, 4))[0]
+        slots, features = [], []
+        for i in range(count):
+            slot = (first + i) % self.num_slots
+            offset = HEADER.size + slot * self.slot_size
+            _, n_feat, _, _ = SLOT_HEADER.unpack_from(self.mm, offset)
+            slots.append(slot)
+            features.append(list(struct.unpack_from(f"{n_feat}f", self.mm, offset + SLOT_HEADER.size)))
+        return slots, features
+
+    def write_batch(self, conn, slots, outputs):
+        """Write one output per request and ring the doorbell back."""
+        for slot, out in zip(slots, outputs):
+            offset = HEADER.size + slot * self.slot_size + SLOT_HEADER.size + 4 * self.max_features
+            struct.pack_into("f", self.mm, offset, out)
+        conn.sendall(struct.pack("I", len(slots)))
+
+    def close(self):
+        self.mm.close()
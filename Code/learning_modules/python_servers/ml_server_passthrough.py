@@ -16,6 +16,9 @@ Usage:
 Wire protocol (matches ExternalModelClient):
     recv: uint32_t n_feat=3, then [arm_ix, reward, num_arms] as float32
     send: 1 * float32  (= features[0], the arm index)
+
+Shared-memory transport (--ml-transport shm): the requests of the agents
+deciding at the same instant arrive as one batch, see komondor_shm.py.
 """
 
 import socket
@@ -24,6 +27,8 @@ import struct
 import sys
 import os
 
+from komondor_shm import MAGIC, SharedRing
+
 SOCKET_PATH = sys.argv[1] if len(sys.argv) > 1 else "/tmp/komondor_ml.sock"
 
 if os.path.exists(SOCKET_PATH):
@@ -35,6 +40,7 @@ srv.listen(16)
 print(f"[ml_server_passthrough] Listening on {SOCKET_PATH} ...")
 
 connections = []
+rings = {}  # shared-memory clients (see komondor_shm.py)
 any_connected = False
 
 try:
@@ -50,14 +56,27 @@ try:
                 continue
             header = s.recv(4)
             if not header:
+                if s in rings:
+                    rings.pop(s).close()
                 connections.remove(s)
                 s.close()
                 continue
             n = struct.unpack("I", header)[0]
             if n == 0:
+                if s in rings:
+                    rings.pop(s).close()
                 connections.remove(s)
                 s.close()
                 continue
+            if n == MAGIC and s not in rings:  # handshake of the shared-memory transport
+                rings[s] = SharedRing(s)
+                print(f"[ml_server_passthrough] Client shares a ring buffer of {rings[s].num_slots} slots.")
+                continue
+            if s in rings:  # batch of the shared-memory transport
+                slots, batch = rings[s].read_batch(s, n)
+                print(f"  batch: {n} requests  -> echo arm_ix")
+                rings[s].write_batch(s, slots, [features[0] for features in batch])
+                continue
             raw = b""
             while len(raw) < n * 4:
                 chunk = s.recv(n * 4 - len(raw))
@@ -17,9 +17,14 @@ Wire protocol (matches ExternalModelClient):
     recv: uint32_t n_feat=3, then [arm_ix, reward, num_arms] as float32
     send: 1 * float32  (next arm index)
 
+Shared-memory transport (--ml-transport shm): the requests of the agents
+deciding at the same instant arrive as one batch, see komondor_shm.py.
+
 Offline inference: set MODEL_PATH to a TorchScript model saved with
     torch.jit.save(torch.jit.script(model), "model.pt")
 The model must accept a 1-D float tensor of length n_feat and return a scalar.
+With --ml-transport shm, it is called once per batch with a [batch, n_feat]
+tensor and must return one value per row.
 """
 
 import socket
@@ -28,6 +33,8 @@ import struct
 import sys
 import os
 
+from komondor_shm import MAGIC, SharedRing
+
 SOCKET_PATH = sys.argv[1] if len(sys.argv) > 1 else "/tmp/komondor_ml.sock"
 MODEL_PATH  = sys.argv[2] if len(sys.argv) > 2 else "model.pt"
 
@@ -63,6 +70,7 @@ def recv_exact(s, nbytes):
     return buf
 
 connections = []
+rings = {}  # shared-memory clients (see komondor_shm.py)
 any_connected = False
 
 try:
@@ -78,14 +86,34 @@ try:
                 continue
             header = s.recv(4)
             if not header:
+                if s in rings:
+                    rings.pop(s).close()
                 connections.remove(s)
                 s.close()
                 continue
             n = struct.unpack("I", header)[0]
             if n == 0:
+                if s in rings:
+                    rings.pop(s).close()
                 connections.remove(s)
                 s.close()
                 continue
+            if n == MAGIC and s not in rings:  # handshake of the shared-memory transport
+                rings[s] = SharedRing(s)
+                print(f"[ml_server_pytorch] Client shares a ring buffer of {rings[s].num_slots} slots.")
+                continue
+            if s in rings:  # batch of the shared-memory transport: one inference for all the agents
+                slots, batch = rings[s].read_batch(s, n)
+                if model is not None and torch is not None:
+                    x = torch.tensor(batch, dtype=torch.float32)
+                    with torch.no_grad():
+                        y = model(x).reshape(-1)
+                    next_arms = [float(v) for v in y.tolist()]
+                else:
+                    next_arms = [f[0] for f in batch]
+                print(f"  batch: {n} requests  next_arms={[round(a, 2) for a in next_arms]}")
+                rings[s].write_batch(s, slots, next_arms)
+                continue
             raw = recv_exact(s, n * 4)
             features = list(struct.unpack(f"{n}f", raw))
             if model is not None and torch is not None:
@@ -20,6 +20,9 @@ Exits when all clients send the shutdown sentinel (n_feat=0).
 Wire protocol (matches ExternalModelClient):
     recv: uint32_t n_feat=3, then [arm_ix, reward, num_arms] as float32
     send: 1 * float32  (randomly chosen arm in [0, num_arms))
+
+Shared-memory transport (--ml-transport shm): the requests of the agents
+deciding at the same instant arrive as one batch, see komondor_shm.py.
 """
 
 import socket
@@ -29,6 +32,8 @@ import sys
 import os
 import random
 
+from komondor_shm import MAGIC, SharedRing
+
 SOCKET_PATH = sys.argv[1] if len(sys.argv) > 1 else "/tmp/komondor_ml.sock"
 
 if os.path.exists(SOCKET_PATH):
@@ -40,6 +45,7 @@ srv.listen(16)
 print(f"[ml_server_random] Listening on {SOCKET_PATH} ...")
 
 connections = []
+rings = {}  # shared-memory clients (see komondor_shm.py)
 any_connected = False
 
 try:
@@ -55,14 +61,28 @@ try:
                 continue
             header = s.recv(4)
             if not header:
+                if s in rings:
+                    rings.pop(s).close()
                 connections.remove(s)
                 s.close()
                 continue
             n = struct.unpack("I", header)[0]
             if n == 0:  # shutdown sentinel
+                if s in rings:
+                    rings.pop(s).close()
                 connections.remove(s)
                 s.close()
                 continue
+            if n == MAGIC and s not in rings:  # handshake of the shared-memory transport
+                rings[s] = SharedRing(s)
+                print(f"[ml_server_random] Client shares a ring buffer of {rings[s].num_slots} slots.")
+                continue
+            if s in rings:  # batch of the shared-memory transport
+                slots, batch = rings[s].read_batch(s, n)
+                next_arms = [float(random.randint(0, (int(round(f[2])) if len(f) >= 3 else 2) - 1)) for f in batch]
+                print(f"  batch: {n} requests  next_arms={[int(a) for a in next_arms]}")
+                rings[s].write_batch(s, slots, next_arms)
+                continue
             raw = b""
             while len(raw) < n * 4:
                 chunk = s.recv(n * 4 - len(raw))
@@ -69,6 +69,13 @@
 #define LOG_LVL4	"       +"
 #define LOG_LVL5	"          *"
 
+// Node logs (--save-node)
+#define SAVE_NODE_LOGS_TEXT		1	///> Node logs written as text
+#define SAVE_NODE_LOGS_BINARY	2	///> Node logs written as a binary trace (see trace_methods.h)
+#ifndef NODE_LOGS_LEVEL
+#define NODE_LOGS_LEVEL			5	///> Deepest LOG_LVL<n> compiled into node logs, 0 for none ("make NODE_LOGS_LEVEL=<n>")
+#endif
+
 // Node states
 #define STATE_UNKNOWN	-1	///> Unknown state (e.g. at the beginning of the simulation)
 #define STATE_SENSING	0	///> Sensing the channel and decreasing backoff counter when possible according PD requirements
@@ -215,6 +222,11 @@
 #define PROGRESS_BAR_DELTA		5	///> Amount of percentage between two progress bar indicators
 #define PROGRESS_BAR_DISPLAY 	1	///> Activate progress bar
 
+// Steady-state detection (--steady-state)
+#define STEADY_STATE_BATCH_SIZE		5		///> Observations per batch (MSER-5)
+#define STEADY_STATE_MIN_BATCHES	10		///> Batches needed to detect the end of the warm-up or to stop the run
+#define DEFAULT_OBSERVATION_PERIOD	0.05	///> Time between two observations of the network [s]
+
 // Timers
 #define PAUSE_TIMER					0					///> Try to pause a timer (e.g. backoff)
 #define RESUME_TIMER				1					///> Try to resume timer
@@ -330,6 +342,13 @@
 #define PDF_EXPONENTIAL		1	///> Exponential pdf
 #define PDF_DETERMINISTIC	2	///> Deterministic (same value as mean)
 
+// Random number streams (see CostRandomStream, keyed by seed, stream type and id)
+#define RANDOM_STREAM_NODE			1	///> Stream of a node (backoff, packet losses, channel bonding, ...)
+#define RANDOM_STREAM_TRAFFIC		2	///> Stream of a traffic generator
+#define RANDOM_STREAM_AGENT			3	///> Stream of an agent
+#define RANDOM_STREAM_CONTROLLER	4	///> Stream of the central controller
+#define RANDOM_STREAM_LINK			5	///> Stream of a link (shadowing and obstacles)
+
 // IEEE protocol
 #define IEEE_NOT_SPECIFIED		0
 #define IEEE_802_11_AX			1
@@ -369,6 +388,7 @@
 #define NUM_CHANNELS_KOMONDOR	16   ///> Total number of frequency channels
 #define CHANNEL_BW_MHZ			20	///> Bandwidth of a basic channel [MHz]
 #define NOISE_LEVEL_DBM			-95	///> Noise level [dBm]
+#define CHANNEL_POWER_RECOMPUTE_PERIOD	64	///> Incremental channel power updates between exact recomputations
 #define ANTENNA_RX_GAIN_DB 		0	///> Antenna receiption gain [dB]
 #define ANTENNA_TX_GAIN_DB 		0	///> Antenna transmission gain [dB]
 
@@ -389,6 +409,7 @@
 #define MODULATION_1024QAM_5_6	12
 #define MODULATION_4096QAM_3_4	13
 #define MODULATION_4096QAM_5_6	14
+#define NUM_MODULATIONS			14	///> Number of MCS (MODULATION_BPSK_1_2 to MODULATION_4096QAM_5_6)
 
 // Application parameters
 #define PACKET_BUFFER_SIZE		100		///> Size of the packets buffer
@@ -512,6 +533,7 @@
 #define BEAMFORMING_DISABLED        0   ///> Omnidirectional operation (no beamforming)
 #define BEAMFORMING_ENABLED         1   ///> ULA beamforming active
 #define MAX_BEAM_NULLS              4   ///> Maximum simultaneous null directions per TX
+#define BF_MAX_N_ELEMENTS           32  ///> Maximum number of ULA elements (32 covers all practical 802.11ax cases)
 #define DEFAULT_BEAM_N_ELEMENTS     1   ///> Default number of ULA elements (1 = omni fallback)
 #define DEFAULT_BEAM_D_SPACING      0.5 ///> Default element spacing [wavelengths]
 
@@ -549,6 +571,10 @@
 #define CENTRALIZED_ACTION_BANNING		5
 #define LEARNING_MECHANISM_EXTERNAL		7	///> Delegate to external Python ML server via Unix socket
 
+// Transport to the external ML server (--ml-transport)
+#define ML_TRANSPORT_SOCKET				0	///> One query per decision over the socket of each agent
+#define ML_TRANSPORT_SHM				1	///> Decisions of the same instant batched in a shared-memory ring buffer
+
 // Type of reward computation method used
 #define AVERAGE_REWARD 					0
 #define OPTIMISTIC_ESTIMATE_REWARD		1
@@ -61,6 +61,7 @@
 #include "../structures/node_configuration.h"
 #include "../structures/performance.h"
 #include "../structures/action.h"
+#include "../structures/checkpoint_file.h"
 #include "../methods/utils/auxiliary_methods.h"
 #include "../methods/agent/agent_methods.h"
 
@@ -83,10 +84,13 @@ component Agent : public TypeII{
         void InitializeMlPipeline();
 		void InitializePreProcessor();
 		void InitializeMlModel();
+		void SetActionSelectionStrategy(int strategy);
+		void Checkpoint(CheckpointFile &file);
 
 		// Communication with AP
 		void RequestInformationToAp();
 		void ComputeNewConfiguration();
+		void ApplyNewConfiguration();
 		void SendNewConfigurationToAp(Configuration &configuration_to_send);
 
 		// Communication with CC
@@ -151,6 +155,8 @@ component Agent : public TypeII{
 
 		// External model (LEARNING_MECHANISM_EXTERNAL)
 		char external_socket_path[256];	///> Unix socket path for the external Python ML server
+		ExternalModelBatch *external_model_batch;	///> Batch shared with the agents of the same server (NULL: own socket)
+		double decision_latency;		///> Time between a decision request and its application [s] (0: synchronous)
 
 	// Private items (just for internal agent operation)
 	private:
@@ -174,6 +180,7 @@ component Agent : public TypeII{
         LearningAlgorithm learning_algorithm;   ///> Learning algorithm object
         int learning_allowed;                   ///> Flag to indicate whether learning is allowed or not
         int flag_compute_new_configuration; 	///> Flag to be activated in case of needing to compute a new configuration
+        int flag_decision_pending;              ///> Flag to indicate that a decision has been requested but not applied yet
 
 		// Configuration and performance after being processed by the Pre-processor
 		int processed_configuration;	///> Processed configuration
@@ -205,8 +212,18 @@ component Agent : public TypeII{
 		// Triggers
 		Timer <trigger_t> trigger_request_information_to_ap;        // Timer for requesting information to the AP
 		inport inline void RequestInformationToAp(trigger_t& t1);   // Every time the timer expires execute this
+		Timer <trigger_t> trigger_post_decision_requests;           // Timer for handing the batched requests to the model
+		inport inline void PostDecisionRequests(trigger_t& t1);
+		Timer <trigger_t> trigger_send_new_configuration_to_ap;     // Timer for applying a requested decision
+		inport inline void CollectNewConfiguration(trigger_t& t1);
 		Agent () { // Connect timers to methods
 			connect trigger_request_information_to_ap.to_component,RequestInformationToAp;
+			connect trigger_post_decision_requests.to_component,PostDecisionRequests;
+			connect trigger_send_new_configuration_to_ap.to_component,CollectNewConfiguration;
+			// Names of the handlers in the engine profile (--profile)
+			trigger_request_information_to_ap.ProfileName("Agent::RequestInformationToAp");
+			trigger_post_decision_requests.ProfileName("Agent::PostDecisionRequests");
+			trigger_send_new_configuration_to_ap.ProfileName("Agent::CollectNewConfiguration");
 		}
 
 };
@@ -263,6 +280,44 @@ void Agent :: Stop(){
 	if(save_agent_logs) fclose(agent_logger.file);
 };
 
+/**
+ * Save the state of the agent to a checkpoint, or restore it (once it has started)
+ * @param "file" [type CheckpointFile&]: checkpoint being written or read
+ */
+void Agent :: Checkpoint(CheckpointFile &file){
+	file.Field(controller_on);
+	file.Field(time_between_requests);
+	file.Field(learning_allowed);
+	file.Field(flag_compute_new_configuration);
+	file.Field(flag_decision_pending);
+	file.Field(automatic_forward_enabled);
+	file.Field(flag_request_from_controller);
+	file.Field(flag_information_available);
+	file.Field(processed_configuration);
+	file.Field(processed_reward);
+	file.Field(ml_output);
+	file.Field(num_requests);
+	file.Field(initial_reward);
+	file.Report(performance);
+	file.Array(indexes_configuration, NUM_FEATURES_ACTIONS);
+	file.Config(configuration);
+	file.Config(new_configuration);
+	file.Config(configuration_from_controller);
+	// Actions (the performance of each one is a copy of the report of the AP)
+	for (int i = 0; i < num_arms; ++i) {
+		file.Report(actions[i].performance_since_last_cc_request);
+		Performance pointers (actions[i].performance_since_last_cc_request);
+		file.Raw(actions[i]);
+		if (file.Reading()) CheckpointFile::KeepPointers(actions[i].performance_since_last_cc_request, pointers);
+	}
+	file.Array(list_of_available_actions, num_arms);
+	learning_algorithm.Checkpoint(file);
+	CHECKPOINT_TIMER(file, trigger_request_information_to_ap);
+	CHECKPOINT_TIMER(file, trigger_post_decision_requests);
+	CHECKPOINT_TIMER(file, trigger_send_new_configuration_to_ap);
+	file.RandomStream(random_stream);
+}
+
 /***************************/
 /***************************/
 /*  AP-AGENT COMMUNICATION */
@@ -288,6 +343,7 @@ void Agent :: RequestInformationToAp(trigger_t &){
  * @param "received_performance" [type Performance]: performance report received from the corresponding AP
  */
 void Agent :: InportReceivingInformationFromAp(Configuration &received_configuration, Performance &received_performance){
+	COST_PROFILE_SCOPE("Agent::InportReceivingInformationFromAp");
 
 	LOGS(save_agent_logs, agent_logger.file,
 		"%.15f;A%d;%s;%s InportReceivingInformationFromAp()\n",
@@ -389,6 +445,7 @@ void Agent :: SendNewConfigurationToAp(Configuration &configuration_to_send){
  */
 void Agent :: InportReceiveCommandFromController(int destination_agent_id, int command_id,
 		Configuration &received_configuration, double shared_performance, int type_of_reward) {
+	COST_PROFILE_SCOPE("Agent::InportReceiveCommandFromController");
 
 	if(controller_on && agent_id == destination_agent_id ) {
 
@@ -573,13 +630,26 @@ void Agent :: ComputeNewConfiguration(){
 		// Compute a new configuration if information is up to date. Otherwise, request it to the AP and use it.
 		if ( CheckValidityOfData(configuration, performance, SimTime(), MAX_TIME_INFORMATION_VALID)
 				&& flag_information_available) {
-			// Run the learning algorithm: observe last reward, select next action
-			ml_output = learning_algorithm.Update(processed_configuration, processed_reward,
-			                                      list_of_available_actions);
-			// Decode the algorithm output into a Configuration and send it to the AP
-			new_configuration = configuration;
-			pre_processor.DecodeAction(ml_output, &new_configuration);
-			SendNewConfigurationToAp(new_configuration);
+			if (decision_latency > 0 || learning_algorithm.Batched()) {
+				if (flag_decision_pending) {
+					LOGS(save_agent_logs, agent_logger.file, "%.15f;A%d;%s;%s Decision already requested\n",
+						SimTime(), agent_id, LOG_F00, LOG_LVL2);
+					return;
+				}
+				// Issue the request now and apply the decision once the decision latency has elapsed, so that the
+				// simulation goes on meanwhile. Requests to a shared batch are handed to the model once every agent
+				// deciding at this instant has submitted its own (events at the same time are FIFO)
+				learning_algorithm.RequestDecision(processed_configuration, processed_reward,
+				                                   list_of_available_actions);
+				flag_decision_pending = true;
+				if (learning_algorithm.Batched()) trigger_post_decision_requests.Set(SimTime());
+				trigger_send_new_configuration_to_ap.Set(FixTimeOffset(SimTime() + decision_latency,13,12));
+			} else {
+				// Run the learning algorithm: observe last reward, select next action
+				ml_output = learning_algorithm.Update(processed_configuration, processed_reward,
+				                                      list_of_available_actions);
+				ApplyNewConfiguration();
+			}
 
 		} else {
 			// Generate the first request to be triggered after "time_between_requests"
@@ -595,6 +665,34 @@ void Agent :: ComputeNewConfiguration(){
 
 }
 
+/**
+ * Decode the output of the learning algorithm into a Configuration and send it to the AP
+ */
+void Agent :: ApplyNewConfiguration(){
+	new_configuration = configuration;
+	pre_processor.DecodeAction(ml_output, &new_configuration);
+	SendNewConfigurationToAp(new_configuration);
+}
+
+/**
+ * Hand the decision requests submitted to the shared batch to the external model (--ml-transport shm). Only the
+ * first agent deciding at a given instant finds requests to be posted
+ */
+void Agent :: PostDecisionRequests(trigger_t &){
+	learning_algorithm.PostDecisionRequests();
+}
+
+/**
+ * Apply the decision requested by ComputeNewConfiguration() once the decision latency has elapsed
+ */
+void Agent :: CollectNewConfiguration(trigger_t &){
+	LOGS(save_agent_logs, agent_logger.file, "%.15f;A%d;%s;%s CollectNewConfiguration()\n",
+		SimTime(), agent_id, LOG_F00, LOG_LVL1);
+	ml_output = learning_algorithm.CollectDecision();
+	flag_decision_pending = false;
+	ApplyNewConfiguration();
+}
+
 /**
  * Update the Action object for the corresponding played action
  * @param "action_ix" [type int]: index of the selected action/configuration
@@ -631,6 +729,9 @@ void Agent :: InitializeAgent() {
 
 	initial_reward = 0;
 	strncpy(external_socket_path, "/tmp/komondor_ml.sock", 255);
+	external_model_batch = NULL;
+	decision_latency = 0;
+	flag_decision_pending = false;
 
 	flag_request_from_controller = false;
 	flag_information_available = false;
@@ -689,6 +790,7 @@ void Agent :: InitializePreProcessor() {
  */
 void Agent :: InitializeMlModel() {
 	learning_algorithm.agent_id                = agent_id;
+	learning_algorithm.random_stream           = &random_stream;
 	learning_algorithm.num_stas                = num_stas;
 	learning_algorithm.learning_mechanism      = learning_mechanism;
 	learning_algorithm.action_selection_strategy = action_selection_strategy;
@@ -700,9 +802,19 @@ void Agent :: InitializeMlModel() {
 	}
 	strncpy(learning_algorithm.external_socket_path, external_socket_path, 255);
 	learning_algorithm.external_socket_path[255] = '\0';
+	learning_algorithm.external_batch = external_model_batch;
 	learning_algorithm.InitializeVariables();
 }
 
+/**
+ * Change the action-selection strategy, keeping what has been learnt so far (e.g., in a continuation)
+ * @param "strategy" [type int]: index of the new action-selection strategy
+ */
+void Agent :: SetActionSelectionStrategy(int strategy) {
+	action_selection_strategy = strategy;
+	learning_algorithm.SetActionSelectionStrategy(strategy);
+}
+
 /******************************/
 /******************************/
 /*  PRINT/WRITE INFORMATION   */
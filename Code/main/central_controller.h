@@ -64,6 +64,7 @@
 #include "../structures/performance.h"
 #include "../structures/action.h"
 #include "../structures/controller_report.h"
+#include "../structures/checkpoint_file.h"
 
 #include "../methods/utils/auxiliary_methods.h"
 #include "../methods/agent/agent_methods.h"
@@ -85,6 +86,7 @@ component CentralController : public TypeII{
 		// Generic
 		void InitializeCentralController();
         void StartCcActivity();
+		void Checkpoint(CheckpointFile &file);
 
 		// Communication with Agents
 		void RequestInformationToAgents();
@@ -113,6 +115,7 @@ component CentralController : public TypeII{
 		void InitializeMlPipeline();
         void InitializePreProcessor();
 		void InitializeMlModel();
+		void SetActionSelectionStrategy(int strategy);
 
 	// Public items (entered by agents constructor in komondor_main)
 	public:
@@ -187,6 +190,9 @@ component CentralController : public TypeII{
 		CentralController () {
 			connect trigger_apply_ml_method.to_component,ApplyMlMethod;
 			connect trigger_request_information_to_agents.to_component,RequestInformationToAgents;
+			// Names of the handlers in the engine profile (--profile)
+			trigger_apply_ml_method.ProfileName("CentralController::ApplyMlMethod");
+			trigger_request_information_to_agents.ProfileName("CentralController::RequestInformationToAgents");
 		}
 
 };
@@ -251,6 +257,44 @@ void CentralController :: Stop() {
 
 };
 
+/**
+ * Save the state of the CC to a checkpoint, or restore it (once it has started)
+ * @param "file" [type CheckpointFile&]: checkpoint being written or read
+ */
+void CentralController :: Checkpoint(CheckpointFile &file){
+	file.Field(time_between_requests);
+	file.Field(cc_iteration);
+	file.Field(counter_responses_received);
+	file.Array(num_arms_per_agent, agents_number);
+	for (int i = 0; i < agents_number; ++i) {
+		file.Config(configuration_array[i]);
+		file.Report(performance_array[i]);
+	}
+	// Report (the number of actions per agent may be the one of the CC)
+	file.Field(controller_report.cc_iteration);
+	int own_num_arms (controller_report.num_arms_per_agent == num_arms_per_agent);
+	file.Field(own_num_arms);
+	if (own_num_arms) {
+		controller_report.num_arms_per_agent = num_arms_per_agent;
+	} else {
+		file.Array(controller_report.num_arms_per_agent, agents_number);
+	}
+	file.Array(controller_report.performance_per_agent, agents_number);
+	file.Array(controller_report.average_performance_per_agent, agents_number);
+	file.Array(controller_report.most_played_action_per_agent, agents_number);
+	file.Array(controller_report.cluster_performance, agents_number);
+	for (int i = 0; i < agents_number; ++i) {
+		file.Array(controller_report.list_of_available_actions_per_agent[i], max_number_of_actions);
+		file.Array(controller_report.performance_action_per_agent[i], max_number_of_actions);
+		file.Array(controller_report.times_action_played_per_agent[i], max_number_of_actions);
+		file.Array(controller_report.clusters_per_wlan[i], agents_number);
+	}
+	ml_model.Checkpoint(file, controller_report);
+	CHECKPOINT_TIMER(file, trigger_apply_ml_method);
+	CHECKPOINT_TIMER(file, trigger_request_information_to_agents);
+	file.RandomStream(random_stream);
+}
+
 /**************************/
 /**************************/
 /*  CONTROLLER'S ACTIVITY */
@@ -442,6 +486,7 @@ void CentralController :: SendCommandToSingleAgent(int destination_agent_id, int
  */
 void CentralController :: InportReceivingInformationFromAgent(int agent_id,
         Configuration &received_configuration, Performance &received_performance, Action *actions, int current_action_id) {
+	COST_PROFILE_SCOPE("CentralController::InportReceivingInformationFromAgent");
 
 	LOGS(save_controller_logs,central_controller_logger.file,
 		"%.15f;CC;%s;%s InportReceivingInformationFromAgent()\n", SimTime(), LOG_F00, LOG_LVL1);
@@ -744,6 +789,7 @@ void CentralController :: InitializePreProcessor() {
 void CentralController :: InitializeMlModel() {
 
 	ml_model.learning_mechanism = learning_mechanism;
+	ml_model.random_stream = &random_stream;
 	ml_model.save_logs = save_controller_logs;
 	ml_model.print_logs = print_controller_logs;
 	ml_model.action_selection_strategy = action_selection_strategy;
@@ -776,6 +822,15 @@ void CentralController :: InitializeMlModel() {
 
 }
 
+/**
+ * Change the action-selection strategy, keeping what has been learnt so far (e.g., in a continuation)
+ * @param "strategy" [type int]: index of the new action-selection strategy
+ */
+void CentralController :: SetActionSelectionStrategy(int strategy) {
+	action_selection_strategy = strategy;
+	ml_model.SetActionSelectionStrategy(strategy);
+}
+
 /**
  * Initialize the Central Controller
  */
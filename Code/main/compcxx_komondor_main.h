@@ -17,8 +17,8 @@ typedef void  (compcxx_component::*Agent_outportAnswerToController_f_t)(int agen
 			Performance &performance, Action *actions, int processed_configuration);
 typedef void  (compcxx_component::*CentralController_outportSendCommandToAgent_f_t)(int destination_agent_id, int command_id,
 			Configuration &new_configuration, double shared_performance, int type_of_reward);
-typedef void  (compcxx_component::*Node_outportSelfStartTX_f_t)(Notification &notification);
-typedef void  (compcxx_component::*Node_outportSelfFinishTX_f_t)(Notification &notification);
+typedef void  (compcxx_component::*Node_outportSelfStartTX_f_t)(const NotificationFrame &notification);
+typedef void  (compcxx_component::*Node_outportSelfFinishTX_f_t)(const NotificationFrame &notification);
 typedef void  (compcxx_component::*Node_outportSendLogicalNack_f_t)(LogicalNack &logical_nack_info);
 typedef void  (compcxx_component::*Node_outportAskForTxModulation_f_t)(Notification &notification);
 typedef void  (compcxx_component::*Node_outportAnswerTxModulation_f_t)(Notification &notification);
@@ -59,8 +59,10 @@
 #include <string>     // std::string, std::to_string
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/file.h>
 #include <unistd.h>
 #include <getopt.h> // Required for parsing flags from user input
+#include <pthread.h>
 
 #include ".././COST/cost.h"
 
@@ -69,12 +71,17 @@
 #include "../structures/logical_nack.h"
 #include "../structures/notification.h"
 #include "../structures/wlan.h"
+#include "../structures/topology.h"
+#include "../structures/steady_state.h"
 
 #include "node.h"
 #include "traffic_generator.h"
 #include "agent.h"
 #include "central_controller.h"
 
+/* Serializes input parsing and output writing among simulations running concurrently (see --replications) */
+pthread_mutex_t simulation_output_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 /* Sequential simulation engine from where the system to be simulated is derived. */
 component Komondor : public CostSimEng {
 
@@ -84,7 +91,9 @@ component Komondor : public CostSimEng {
 		void Setup(double simulation_time_komondor, int save_node_logs, int save_agent_logs,
 			int print_node_logs, int print_system_logs, int print_agent_logs, const char *nodes_filename,
 			const char *script_filename, const char *simulation_code, int seed_console, int agents_enabled,
-			const char *agents_filename, int mapc_enabled, const char *mapc_filename);
+			const char *agents_filename, int mapc_enabled, const char *mapc_filename,
+			double neighbour_margin, int partition_enabled, int lazy_backoff, int slot_synchronous,
+			const char *frame_trace_filename, const char *scenario_filename);
 		void Stop();
 		void Start();
 
@@ -96,10 +105,39 @@ component Komondor : public CostSimEng {
 
 		void GenerateMapcConfiByReadingInputFile(const char *mapc_filename);
 
+		void GenerateScenario(const char *nodes_filename, const char *mapc_filename);
+		void SetNodeRunParameters(int node_ix);
+		void LinkNodesToWlans();
+		void ComputeChannelMatrices();
+		void CompileScenario(const char *nodes_filename, int mapc_enabled, const char *mapc_filename,
+			int seed, int print_system_logs, const char *snapshot_filename);
+		void LoadScenarioSnapshot(const char *snapshot_filename);
+
 		int GetNumOfLines(const char *nodes_filename);
-		int GetNumOfNodes(const char *nodes_filename, int node_type, std::string wlan_code);
 		int CheckCentralController(const char *agents_filename);
 
+		void ComputeMaxTxPowerPerNode();
+		int IsNeighbour(int tx_id, int rx_id);
+		void PartitionNetwork();
+		int SetupSlotSynchronous();
+		bool RunFastPath();
+		void SetupContinuations(double checkpoint_time, int num_continuations_console,
+			const std::vector<int> &strategies, int max_running_continuations_console);
+		void ForkContinuations();
+		void StartContinuation(int c);
+		void SetupCheckpoints(double checkpoint_time, double checkpoint_period_console,
+			const char *checkpoint_filename_console, const char *restore_filename_console);
+		void CheckpointState(CheckpointFile &file);
+		void WriteCheckpoint();
+		void Checkpoint();
+		void Restore();
+		void SetupSteadyState(double warmup, double target_ci, double observation_period);
+		void ClearStats();
+		bool Observe();
+		void SetupAgentDecisions(int ml_transport_console, double decision_latency_console);
+		void ConnectAgentDecisions();
+		void CloseExternalModelBatches();
+
 		void PrintSystemInfo();
 		void PrintAllWlansInfo();
 		void PrintAllAgentsInfo();
@@ -142,6 +180,29 @@ component Komondor : public CostSimEng {
 
 		int agents_enabled;				///> Determined according to the input (for generating agents or not)
 		int mapc_enabled;				///> Determined according to the input (for using MAPC or not)
+		double neighbour_margin;		///> Margin below the noise floor for wiring neighbours [dB] (negative: full mesh)
+		double *max_tx_power_per_node;	///> Highest TX power each node may ever use [pW]
+		Topology topology;				///> Positions of the nodes and channel between each pair of them (shared by the nodes)
+		std::vector<PhyTiming> phy_timing_tables;	///> Durations of the frames per data packet length (shared by the nodes)
+		int partition_enabled;			///> Simulate non-interacting groups of nodes as separate logical processes
+		int lazy_backoff;				///> Schedule the end of the backoff together with the preceding DIFS/AIFS
+		int slot_synchronous;			///> Simulate the channel accesses of contention groups slot by slot (no events)
+		int *slot_group_per_node;		///> Contention group of each node (slot-synchronous engine)
+		int num_slot_groups;			///> Number of contention groups (slot-synchronous engine)
+		FrameTrace *frame_trace;		///> Columnar trace of the frames (NULL if not enabled)
+		int num_continuations;			///> Continuations forked at the checkpoint (see continuation_methods.h)
+		std::vector<int> continuation_strategies;	///> Action-selection strategy of each continuation (empty: reseeded)
+		int max_running_continuations;	///> Continuations simulated concurrently
+		int continuation_id;			///> Index of the continuation simulated by the process (-1: no checkpoint yet)
+		std::string checkpoint_filename;	///> File of the checkpoints (empty: none, see checkpoint_methods.h)
+		double checkpoint_period;		///> Time between two checkpoints [s] (0: a single one)
+		std::string restore_filename;	///> Checkpoint the simulation resumes from (empty: none)
+		std::string input_digest;		///> Digest of the input, checked when resuming (see SetupCheckpoints)
+		double statistics_start_time;	///> Time since which the statistics are collected (end of the warm-up) [s]
+		SteadyState steady_state;		///> Observations of the network for detecting its steady state
+		int ml_transport;				///> Transport to the external ML servers (ML_TRANSPORT_SOCKET or ML_TRANSPORT_SHM)
+		std::vector<ExternalModelBatch*> external_model_batches;	///> Batch shared per socket path (--ml-transport shm)
+		double decision_latency;		///> Time between a decision request of an agent and its application [s]
 
 		// Public items (to shared with the agents)
 		public:
@@ -175,6 +236,20 @@ component Komondor : public CostSimEng {
 		int first_line_skiped_flag;		///> Flag for skipping first informative line of input file
 		int central_controller_flag; 	///> In order to allow the generation of the central controller
 
+	public:
+
+		Komondor () {
+			memset(&topology, 0, sizeof(topology));
+			max_tx_power_per_node = NULL;
+			ml_transport = ML_TRANSPORT_SOCKET;
+			decision_latency = 0;
+			checkpoint_period = 0;
+		}
+		~Komondor () {
+			topology.Free();
+			delete[] max_tx_power_per_node;
+		}
+
 };
 
 /**
@@ -193,13 +268,29 @@ component Komondor : public CostSimEng {
  * @param "seed_console" [type int]: random seed
  * @param "agents_enabled_console" [type int]: flag indicating that agents are enabled
  * @param "agents_input_filename_console" [type char*]: filename of the agents input CSV
+ * @param "mapc_enabled_console" [type int]: flag indicating that MAPC is enabled
+ * @param "mapc_input_filename_console" [type char*]: filename of the MAPC configuration CSV
+ * @param "neighbour_margin_console" [type double]: margin below the noise floor [dB] under which two nodes
+ *   are not connected (negative value: every node is connected to every other node)
+ * @param "partition_enabled_console" [type int]: flag for simulating the groups of nodes that do not interact
+ *   as separate logical processes (requires neighbour_margin_console >= 0)
+ * @param "lazy_backoff_console" [type int]: flag for deriving the end of the DIFS/AIFS from the end of the
+ *   backoff countdown scheduled with it, instead of simulating it as an event of its own
+ * @param "slot_synchronous_console" [type int]: flag for simulating saturated contention groups with the
+ *   slot-synchronous engine (falls back to events if the scenario is not eligible)
+ * @param "frame_trace_filename_console" [type char*]: file of the columnar frame trace (empty: no trace)
+ * @param "scenario_filename_console" [type char*]: scenario snapshot to be loaded instead of the nodes and MAPC
+ *   input files (empty: read the input files)
  */
 void Komondor :: Setup(double sim_time_console, int save_node_logs_console,
 		int save_agent_logs_console, int print_system_logs_console, int print_node_logs_console,
 		int print_agent_logs_console, const char *nodes_input_filename_console,
 		const char *script_output_filename, const char *simulation_code_console, int seed_console,
 		int agents_enabled_console, const char *agents_input_filename_console,
-		int mapc_enabled_console, const char *mapc_input_filename_console) {
+		int mapc_enabled_console, const char *mapc_input_filename_console,
+		double neighbour_margin_console, int partition_enabled_console, int lazy_backoff_console,
+		int slot_synchronous_console, const char *frame_trace_filename_console,
+		const char *scenario_filename_console) {
 
 	// Setup variables corresponding to the console's input
 	simulation_time_komondor = sim_time_console;
@@ -214,7 +305,16 @@ void Komondor :: Setup(double sim_time_console, int save_node_logs_console,
 	seed = seed_console;
 	agents_enabled = agents_enabled_console;
 	mapc_enabled = mapc_enabled_console;
+	neighbour_margin = neighbour_margin_console;
+	partition_enabled = partition_enabled_console;
+	lazy_backoff = lazy_backoff_console;
+	slot_synchronous = 0;
+	slot_group_per_node = NULL;
+	num_slot_groups = 0;
 	total_wlans_number = 0;
+	num_continuations = 0;
+	max_running_continuations = 1;
+	continuation_id = -1;
 
     // Generate output files
 	if (print_system_logs) printf("\n%s Creating output files\n", LOG_LVL1);
@@ -236,73 +336,77 @@ void Komondor :: Setup(double sim_time_console, int save_node_logs_console,
 	logger_script.file = script_output_file;
 	fprintf(logger_script.file, "%s KOMONDOR SIMULATION '%s' (seed %d)", LOG_LVL1, simulation_code_console, seed);
 
-	// Read system (environment) file
-	const char *filename_test = "../config_models"; // HARDCODED
-	SetupEnvironmentByReadingConfigFile(filename_test);
+	// Build the scenario (system models, nodes, WLANs, MAPC groups and channel between each pair of nodes):
+	// from the input files, or from a snapshot compiled beforehand (see scenario_snapshot_methods.h)
+	int scenario_from_snapshot (scenario_filename_console[0] != '\0');
+	if (scenario_from_snapshot) {
+		LoadScenarioSnapshot(scenario_filename_console);
+	} else {
+		GenerateScenario(nodes_input_filename, mapc_input_filename);
+	}
+	simulation_code = simulation_code_console;
 
-	// Generate nodes
-	GenerateNodesByReadingInputFile(nodes_input_filename);
+	// The received power and the path gain of each pair of nodes are kept in the topology shared by all the
+	// nodes, so that a change in the TX power only requires scaling the path gain (see InportSomeNodeStartTX)
+	// and each node only holds pointers to its own rows
+	for(int i = 0; i < total_nodes_number; ++i) {
+		node_container[i].topology = &topology;
+		node_container[i].received_power_array = topology.ReceivedPowerRow(i);
+		node_container[i].path_gain_array = topology.PathGainRow(i);
+	}
 
-	// Compute distance of each pair of nodes
+	// Durations of the frames, tabulated once per data packet length (see phy_timing.h). The tables cover the
+	// largest A-MPDU of any node, since the STAs compute the NAV of the A-MPDUs sent by their AP
+	std::map<int, int> phy_timing_per_frame_length;
+	int max_packets_aggregated_network (1);
 	for(int i = 0; i < total_nodes_number; ++i) {
-		node_container[i].distances_array = new double[total_nodes_number];
-		node_container[i].received_power_array = new double[total_nodes_number];
-		for(int j = 0; j < total_nodes_number; ++j) {
-			// Compute and assign distances for each other node
-			node_container[i].distances_array[j] = ComputeDistance(node_container[i].node_params.x,node_container[i].node_params.y,
-				node_container[i].node_params.z,node_container[j].node_params.x,node_container[j].node_params.y,node_container[j].node_params.z);
-			// Compute and assign the received power from each other node
-			if(i == j) {
-				node_container[i].received_power_array[j] = 0;
-			} else {
-				node_container[i].received_power_array[j] = ComputePowerReceived(node_container[i].distances_array[j],
-					node_container[j].node_params.tx_power_default, node_container[i].node_params.central_frequency, path_loss_model);
-			}
+		max_packets_aggregated_network = std::max(max_packets_aggregated_network,
+			node_container[i].node_params.max_num_packets_aggregated);
+		if (phy_timing_per_frame_length.count(node_container[i].node_params.frame_length) == 0) {
+			int ix_table (phy_timing_per_frame_length.size());
+			phy_timing_per_frame_length[node_container[i].node_params.frame_length] = ix_table;
 		}
 	}
+	phy_timing_tables.resize(phy_timing_per_frame_length.size());
+	for(std::map<int, int>::const_iterator it = phy_timing_per_frame_length.begin();
+			it != phy_timing_per_frame_length.end(); ++it) {
+		phy_timing_tables[it->second].Build(it->first, max_packets_aggregated_network);
+	}
+	for(int i = 0; i < total_nodes_number; ++i) {
+		node_container[i].phy_timing = &phy_timing_tables[phy_timing_per_frame_length[node_container[i].node_params.frame_length]];
+	}
 
-	// Compute the maximum power received from each WLAN
+	// Compute the maximum power received from each WLAN (a single pass over the row of each AP)
+	std::map<std::string, int> wlan_index_per_code;
+	for(int j = total_wlans_number - 1; j >= 0; --j) wlan_index_per_code[wlan_container[j].wlan_code] = j;
+	int *wlan_index_per_node = new int[total_nodes_number];
+	for(int k = 0; k < total_nodes_number; ++k) {
+		std::map<std::string, int>::const_iterator it = wlan_index_per_code.find(node_container[k].node_params.wlan_code);
+		wlan_index_per_node[k] = (it != wlan_index_per_code.end()) ? it->second : -1;
+	}
 	for(int i = 0; i < total_nodes_number; ++i) {
-		double max_power_received_per_wlan;
 		if (node_container[i].node_params.node_type == NODE_TYPE_AP) {
-			node_container[i].max_received_power_in_ap_per_wlan = new double[total_wlans_number];
-			for(int j = 0; j < total_wlans_number; ++j) {
-				if (strcmp(node_container[i].node_params.wlan_code.c_str(),wlan_container[j].wlan_code.c_str()) == 0) {
-					// Same WLAN
-					node_container[i].max_received_power_in_ap_per_wlan[j] = 0;
-				} else {
-					// Different WLAN
-					max_power_received_per_wlan = -1000;
-					for (int k = 0; k < total_nodes_number; ++k) {
-						// Check only nodes in WLAN "j"
-						if(strcmp(node_container[k].node_params.wlan_code.c_str(),wlan_container[j].wlan_code.c_str()) == 0) {
-							if (node_container[i].received_power_array[k] > max_power_received_per_wlan) {
-								max_power_received_per_wlan = node_container[i].received_power_array[k];
-							}
-						}
-					}
-					node_container[i].max_received_power_in_ap_per_wlan[j] = max_power_received_per_wlan;
+			double *max_power_received_per_wlan = new double[total_wlans_number];
+			for(int j = 0; j < total_wlans_number; ++j) max_power_received_per_wlan[j] = -1000;
+			for (int k = 0; k < total_nodes_number; ++k) {
+				int j (wlan_index_per_node[k]);
+				if (j >= 0 && node_container[i].received_power_array[k] > max_power_received_per_wlan[j]) {
+					max_power_received_per_wlan[j] = node_container[i].received_power_array[k];
 				}
 			}
+			// Same WLAN
+			if (wlan_index_per_node[i] >= 0) max_power_received_per_wlan[wlan_index_per_node[i]] = 0;
+			node_container[i].max_received_power_in_ap_per_wlan = max_power_received_per_wlan;
 		}
 	}
-
-	// Populate per-node position lookup arrays (used for per-TXOP beamforming)
-	for (int i = 0; i < total_nodes_number; ++i) {
-		node_container[i].all_node_x = new double[total_nodes_number];
-		node_container[i].all_node_y = new double[total_nodes_number];
-		node_container[i].all_node_z = new double[total_nodes_number];
-		node_container[i].all_node_first_sta_id = new int[total_nodes_number];
-		for (int j = 0; j < total_nodes_number; ++j) {
-			node_container[i].all_node_x[j] = node_container[j].node_params.x;
-			node_container[i].all_node_y[j] = node_container[j].node_params.y;
-			node_container[i].all_node_z[j] = node_container[j].node_params.z;
-			// For AP nodes: store first associated STA id; NODE_ID_NONE for STAs
-			if (node_container[j].wlan.ap_id == j && node_container[j].wlan.num_stas > 0)
-				node_container[i].all_node_first_sta_id[j] = node_container[j].wlan.list_sta_id[0];
-			else
-				node_container[i].all_node_first_sta_id[j] = NODE_ID_NONE;
-		}
+	delete[] wlan_index_per_node;
+
+	// First STA of each AP (used for per-TXOP beamforming)
+	for (int j = 0; j < total_nodes_number; ++j) {
+		if (node_container[j].wlan.ap_id == j && node_container[j].wlan.num_stas > 0)
+			topology.first_sta_id[j] = node_container[j].wlan.list_sta_id[0];
+		else
+			topology.first_sta_id[j] = NODE_ID_NONE;
 	}
 
 	// Initialize arrays for the token-based channel access
@@ -317,21 +421,12 @@ void Komondor :: Setup(double sim_time_console, int save_node_logs_console,
 		}
 	}
 
-	// Generate MAPC groups
-	GenerateMapcConfiByReadingInputFile(mapc_input_filename);
-
-	// Re-link nodes with updated WLAN info (MAPC fields populated after GenerateNodesByReadingInputFile)
-	for (int n = 0; n < total_nodes_number; ++n) {
-		for (int w = 0; w < total_wlans_number; ++w) {
-			if (strcmp(node_container[n].node_params.wlan_code.c_str(), wlan_container[w].wlan_code.c_str()) == 0) {
-				node_container[n].wlan = wlan_container[w];
-			}
-		}
-	}
-
 	// Generate agents (if enabled)
 	central_controller_flag = 0;
-	if (agents_enabled) { GenerateAgents(agents_input_filename, simulation_code_console); }
+	if (agents_enabled) {
+		GenerateAgents(agents_input_filename, simulation_code_console);
+		ConnectAgentDecisions();
+	}
 	// Generate the central controller (if enabled)
 	if (agents_enabled && central_controller_flag) { GenerateCentralController(agents_input_filename); }
 
@@ -348,19 +443,30 @@ void Komondor :: Setup(double sim_time_console, int save_node_logs_console,
 		if (print_system_logs && agents_enabled) PrintMlOperationInfo();
 	}
 
-	// Run the input checker in order to avoid unexpected situations
-	ValidateInput(total_nodes_number, node_container, print_system_logs);
+	// Run the input checker in order to avoid unexpected situations (snapshots are validated when compiled)
+	if (!scenario_from_snapshot) ValidateInput(total_nodes_number, node_container, print_system_logs);
+
+	// Bound the power each node may transmit with (used to prune the connections below)
+	if (neighbour_margin >= 0) ComputeMaxTxPowerPerNode();
 
 	// Set connections among nodes
+	int num_links = 0;
 	for(int n = 0; n < total_nodes_number; ++n){
 
 		connect traffic_generator_container[n].outportNewPacketGenerated,node_container[n].InportNewPacketGenerated;
 
 		for(int m=0; m < total_nodes_number; ++m) {
 
-			connect node_container[n].outportSelfStartTX,node_container[m].InportSomeNodeStartTX;
-			connect node_container[n].outportSelfFinishTX,node_container[m].InportSomeNodeFinishTX;
-			connect node_container[n].outportSendLogicalNack,node_container[m].InportNackReceived;
+			// Frames from "n" only reach the nodes able to sense them
+			if (IsNeighbour(n, m)) {
+				connect node_container[n].outportSelfStartTX,node_container[m].InportSomeNodeStartTX;
+				connect node_container[n].outportSelfFinishTX,node_container[m].InportSomeNodeFinishTX;
+				++num_links;
+			}
+			// NACKs are addressed to transmitters whose frames were sensed by "n"
+			if (IsNeighbour(m, n)) {
+				connect node_container[n].outportSendLogicalNack,node_container[m].InportNackReceived;
+			}
 
 			// Nodes belonging to the same WLAN
 			if(strcmp(node_container[n].node_params.wlan_code.c_str(),node_container[m].node_params.wlan_code.c_str()) == 0 && n!=m) {
@@ -392,6 +498,23 @@ void Komondor :: Setup(double sim_time_console, int save_node_logs_console,
 		}
 	}
 
+	if (print_system_logs) printf("%s Node connections: %d (full mesh: %d)\n", LOG_LVL2,
+		num_links, total_nodes_number * total_nodes_number);
+
+	// Nodes sensing the beamformed frames of each node, toward which their gain is evaluated at once
+	std::vector<int> beam_receivers;
+	for(int n = 0; n < total_nodes_number; ++n) {
+		if (!node_container[n].node_params.beamforming_enabled || node_container[n].node_params.beam_N_elements <= 1) {
+			continue;
+		}
+		beam_receivers.clear();
+		for(int m = 0; m < total_nodes_number; ++m) {
+			if (IsNeighbour(n, m)) beam_receivers.push_back(m);
+		}
+		node_container[n].SetBeamReceivers(beam_receivers.empty() ? NULL : &beam_receivers[0], beam_receivers.size(),
+			topology.x, topology.y, topology.z, total_nodes_number);
+	}
+
 	// Connect the agents to the central controller, if enabled
 	if (agents_enabled && central_controller_flag) {
 		for(int w = 0; w < total_agents_number; ++w){
@@ -402,8 +525,243 @@ void Komondor :: Setup(double sim_time_console, int save_node_logs_console,
 			}
 		}
 	}
+
+	// Frames received by every node, written by a background thread
+	frame_trace = NULL;
+	if (frame_trace_filename_console[0] != '\0') {
+		frame_trace = OpenFrameTrace(frame_trace_filename_console);
+		if (frame_trace == NULL) {
+			printf("ERROR: Frame trace %s could not be created\n", frame_trace_filename_console);
+			exit(-1);
+		}
+	}
+	for (int n = 0; n < total_nodes_number; ++n) {
+		node_container[n].frame_trace = frame_trace;
+		node_container[n].frame_trace_block = NULL;
+	}
+
+	// Simulate saturated contention groups slot by slot, or group the nodes that do not interact into logical processes
+	if (slot_synchronous_console) slot_synchronous = SetupSlotSynchronous();
+	if (partition_enabled && !slot_synchronous) PartitionNetwork();
 };
 
+/**
+ * Build the scenario from the input files: system models, nodes, WLANs, channel and MAPC groups
+ * @param "nodes_filename" [type const char*]: filename of the nodes input CSV
+ * @param "mapc_filename" [type const char*]: filename of the MAPC configuration CSV
+ */
+void Komondor :: GenerateScenario(const char *nodes_filename, const char *mapc_filename){
+
+	// Read system (environment) file
+	const char *filename_test = "../config_models"; // HARDCODED
+	SetupEnvironmentByReadingConfigFile(filename_test);
+
+	// Generate nodes
+	GenerateNodesByReadingInputFile(nodes_filename);
+
+	// Compute the received power and the path gain of each pair of nodes
+	topology.Allocate(total_nodes_number);
+	ComputeChannelMatrices();
+
+	// Generate MAPC groups
+	GenerateMapcConfiByReadingInputFile(mapc_filename);
+
+	// Re-link nodes with updated WLAN info (MAPC fields populated after GenerateNodesByReadingInputFile)
+	LinkNodesToWlans();
+}
+
+/**
+ * Set the parameters of a node (and of its traffic generator) that depend on the run rather than on the
+ * input files: console options, system models and random streams
+ * @param "node_ix" [type int]: node index
+ */
+void Komondor :: SetNodeRunParameters(int node_ix){
+	NodeParameters &params = node_container[node_ix].node_params;
+	params.simulation_time_komondor = simulation_time_komondor;
+	params.total_wlans_number = total_wlans_number;
+	params.total_nodes_number = total_nodes_number;
+	params.collisions_model = collisions_model;
+	params.save_node_logs = save_node_logs;
+	params.print_node_logs = print_node_logs;
+	params.lazy_backoff = lazy_backoff;
+	params.adjacent_channel_model = adjacent_channel_model;
+	params.path_loss_model = path_loss_model;
+	params.pdf_tx_time = pdf_tx_time;
+	params.simulation_code = simulation_code;
+	node_container[node_ix].random_stream.Seed(seed, RANDOM_STREAM_NODE, node_ix);
+	traffic_generator_container[node_ix].node_id = node_ix;
+	traffic_generator_container[node_ix].random_stream.Seed(seed, RANDOM_STREAM_TRAFFIC, node_ix);
+}
+
+/**
+ * Give every node a copy of its WLAN (the last one with its code, if several)
+ */
+void Komondor :: LinkNodesToWlans(){
+	std::map<std::string, int> wlan_index_per_code;
+	for (int w = 0; w < total_wlans_number; ++w) wlan_index_per_code[wlan_container[w].wlan_code] = w;
+	for (int n = 0; n < total_nodes_number; ++n) {
+		std::map<std::string, int>::const_iterator it = wlan_index_per_code.find(node_container[n].node_params.wlan_code);
+		if (it != wlan_index_per_code.end()) node_container[n].wlan = wlan_container[it->second];
+	}
+}
+
+/**
+ * Compute the positions of the nodes, and the received power and the path gain of each pair of them, into
+ * the (allocated) topology
+ */
+void Komondor :: ComputeChannelMatrices(){
+	for(int i = 0; i < total_nodes_number; ++i) {
+		topology.x[i] = node_container[i].node_params.x;
+		topology.y[i] = node_container[i].node_params.y;
+		topology.z[i] = node_container[i].node_params.z;
+	}
+	for(int i = 0; i < total_nodes_number; ++i) {
+		double *received_power_row = topology.ReceivedPowerRow(i);
+		double *path_gain_row = topology.PathGainRow(i);
+		for(int j = 0; j < total_nodes_number; ++j) {
+			if(i == j) continue;	// Rows start zeroed
+			// Shadowing and obstacles (if any) of each link are drawn from its own stream
+			CostRandomStream link_random_stream;
+			link_random_stream.Seed(seed, RANDOM_STREAM_LINK, ((uint64_t) i << 32) | j);
+			double distance (ComputeDistance(topology.x[i], topology.y[i], topology.z[i],
+				topology.x[j], topology.y[j], topology.z[j]));
+			received_power_row[j] = ComputePowerReceived(distance,
+				node_container[j].node_params.tx_power_default, node_container[i].node_params.central_frequency, path_loss_model,
+				&link_random_stream);
+			path_gain_row[j] = ComputePathGain(received_power_row[j],
+				distance, node_container[j].node_params.tx_power_default,
+				node_container[i].node_params.central_frequency, path_loss_model, &link_random_stream);
+		}
+	}
+}
+
+/**
+ * Compute the highest TX power each node may use during the simulation, i.e., the largest of its default
+ * TX power, the maximum TX power allowed and the TX power levels of the agent managing its WLAN
+ */
+void Komondor :: ComputeMaxTxPowerPerNode(){
+	max_tx_power_per_node = new double[total_nodes_number];
+	for(int i = 0; i < total_nodes_number; ++i) {
+		double max_tx_power = ConvertPower(DBM_TO_PW, MAX_TX_POWER_DBM);
+		if (node_container[i].node_params.tx_power_default > max_tx_power) {
+			max_tx_power = node_container[i].node_params.tx_power_default;
+		}
+		if (agents_enabled) {
+			for(int w = 0; w < total_agents_number; ++w) {
+				if (strcmp(node_container[i].node_params.wlan_code.c_str(), agent_container[w].wlan_code.c_str()) == 0) {
+					for(int k = 0; k < agent_container[w].num_arms_tx_power; ++k) {
+						if (agent_container[w].list_of_tx_power_values[k] > max_tx_power) {
+							max_tx_power = agent_container[w].list_of_tx_power_values[k];
+						}
+					}
+				}
+			}
+		}
+		// Upper bound of the ULA array gain
+		if (node_container[i].node_params.beamforming_enabled) {
+			max_tx_power = max_tx_power * node_container[i].node_params.beam_N_elements;
+		}
+		max_tx_power_per_node[i] = max_tx_power;
+	}
+}
+
+/**
+ * Check whether a node may sense the transmissions of another one, so that they must be connected
+ * @param "tx_id" [type int]: ID of the transmitter
+ * @param "rx_id" [type int]: ID of the receiver
+ * @return "is_neighbour" [type int]: 1 if the receiver may sense the transmitter, 0 otherwise
+ */
+int Komondor :: IsNeighbour(int tx_id, int rx_id){
+
+	// Full mesh (default)
+	if (neighbour_margin < 0) return 1;
+	// Node itself, node 0 (monitors the channel idle time, except in partitioned runs) and nodes of the same WLAN
+	if (tx_id == rx_id || (rx_id == 0 && !partition_enabled)) return 1;
+	if (strcmp(node_container[tx_id].node_params.wlan_code.c_str(),
+			node_container[rx_id].node_params.wlan_code.c_str()) == 0) return 1;
+	// WLANs coordinated through MAPC
+	if (mapc_enabled) {
+		Wlan *wlan_tx = &node_container[tx_id].wlan;
+		for (int g = 0; g < wlan_tx->num_mapc_groups; ++g) {
+			if (node_container[rx_id].wlan.FindMapcGroupIdx(wlan_tx->mapc_group_ids[g]) >= 0) return 1;
+		}
+	}
+	// Power received when transmitting at the highest TX power
+	double max_power_received = max_tx_power_per_node[tx_id] * node_container[rx_id].path_gain_array[tx_id];
+	double floor = ConvertPower(DBM_TO_PW, NOISE_LEVEL_DBM - neighbour_margin);
+	return max_power_received >= floor;
+}
+
+/**
+ * Split the network into logical processes, i.e., groups of nodes (with their traffic generators and agents)
+ * that never interact with the nodes of another group. Frames are delivered with no propagation delay, so
+ * interacting nodes have no lookahead and must share a logical process, whereas groups out of the sensing
+ * range of each other never exchange messages and can be simulated concurrently up to the end of the
+ * simulation by separate engines (see CostSimEng::RunPartitions). Groups are the connected components of the
+ * neighbours, so a dense network, where each WLAN senses another one that senses the rest, is a single group
+ */
+void Komondor :: PartitionNetwork(){
+
+	int *parent = new int[total_nodes_number];
+	for(int n = 0; n < total_nodes_number; ++n) parent[n] = n;
+
+	// Nodes connected to each other (same WLAN, MAPC groups and sensing range, see IsNeighbour)
+	for(int n = 0; n < total_nodes_number; ++n) {
+		for(int m = n + 1; m < total_nodes_number; ++m) {
+			if (IsNeighbour(n, m) || IsNeighbour(m, n)) JoinSets(parent, n, m);
+		}
+	}
+
+	// AP of each agent, and APs coordinated through the central controller
+	int *agent_ap_id = NULL;
+	if (agents_enabled) {
+		agent_ap_id = new int[total_agents_number];
+		int controlled_ap_id (NODE_ID_NONE);
+		for(int w = 0; w < total_agents_number; ++w) {
+			agent_ap_id[w] = 0;
+			for(int n = 0; n < total_nodes_number; ++n) {
+				if (node_container[n].node_params.node_type == NODE_TYPE_AP && strcmp(
+						node_container[n].node_params.wlan_code.c_str(), agent_container[w].wlan_code.c_str()) == 0) {
+					agent_ap_id[w] = n;
+				}
+			}
+			if (central_controller_flag && agent_container[w].agent_centralized && central_controller[0].controller_on) {
+				if (controlled_ap_id == NODE_ID_NONE) controlled_ap_id = agent_ap_id[w];
+				JoinSets(parent, controlled_ap_id, agent_ap_id[w]);
+			}
+		}
+	}
+
+	// Number the logical processes in order of their first node
+	int *partition_per_root = new int[total_nodes_number];
+	for(int n = 0; n < total_nodes_number; ++n) partition_per_root[n] = -1;
+	int num_partitions (0);
+	for(int n = 0; n < total_nodes_number; ++n) {
+		int root (FindSetRoot(parent, n));
+		if (partition_per_root[root] < 0) partition_per_root[root] = num_partitions++;
+		node_container[n].Partition(partition_per_root[root]);
+		traffic_generator_container[n].Partition(partition_per_root[root]);
+	}
+	if (agents_enabled) {
+		for(int w = 0; w < total_agents_number; ++w) {
+			agent_container[w].Partition(node_container[agent_ap_id[w]].Partition());
+			if (central_controller_flag && agent_container[w].agent_centralized && central_controller[0].controller_on) {
+				central_controller[0].Partition(agent_container[w].Partition());
+			}
+		}
+	}
+
+	if (print_system_logs) printf("%s Logical processes: %d\n", LOG_LVL2, num_partitions);
+	if (num_partitions == 1) {
+		printf("WARNING: --partition found a single logical process (every WLAN senses another one that senses the rest),"
+			" so the simulation runs without parallelism\n");
+	}
+
+	delete[] parent;
+	delete[] partition_per_root;
+	delete[] agent_ap_id;
+}
+
 /**
  * Start()
  */
@@ -416,7 +774,25 @@ void Komondor :: Start(){
  */
 void Komondor :: Stop(){
 
+	pthread_mutex_lock(&simulation_output_mutex);
+
+	// Frame trace: write the rows still held by the nodes and close it
+	if (frame_trace != NULL) {
+		FrameTraceBlock **frame_trace_blocks = new FrameTraceBlock*[total_nodes_number];
+		for (int i = 0; i < total_nodes_number; ++i) frame_trace_blocks[i] = node_container[i].frame_trace_block;
+		long long num_frames = CloseFrameTrace(frame_trace, frame_trace_blocks, total_nodes_number);
+		for (int i = 0; i < total_nodes_number; ++i) node_container[i].frame_trace_block = NULL;
+		delete[] frame_trace_blocks;
+		frame_trace = NULL;
+		if (print_system_logs) printf("%s Frame trace: %lld frames written\n", LOG_LVL2, num_frames);
+	}
+
 	printf("\n%s STOP KOMONDOR SIMULATION '%s' (seed %d)", LOG_LVL1, simulation_code.c_str(), seed);
+	CloseExternalModelBatches();
+	if (statistics_start_time > 0 || steady_state.target_ci > 0) {
+		printf("\n%s Statistics collected from %f s to %f s%s", LOG_LVL2, statistics_start_time, SimTime(),
+			steady_state.warmup_deleted ? "" : " (steady state not detected)");
+	}
 
 	// Display (in logs and files) statistics of the simulation
 	Performance *performance_per_node = new Performance[total_nodes_number];
@@ -426,9 +802,13 @@ void Komondor :: Stop(){
 		configuration_per_node[i] = node_container[i].configuration;
 	}
 
-	// Generate the output for scripts
+	// Generate the output for scripts (a continuation writes its own header, while the rest wait for it)
+	if (continuation_id >= 0) {
+		flock(fileno(script_output_file), LOCK_EX);
+		fprintf(logger_script.file, "\n%s KOMONDOR SIMULATION '%s' (seed %d)", LOG_LVL1, simulation_code.c_str(), seed);
+	}
 	GenerateScriptOutput(simulation_index, performance_per_node, configuration_per_node, logger_script,
-		total_wlans_number, total_nodes_number, wlan_container, simulation_time_komondor);
+		total_wlans_number, total_nodes_number, wlan_container, SimTime() - statistics_start_time);
 
 	// End of logs
 	fclose(script_output_file);
@@ -436,6 +816,7 @@ void Komondor :: Stop(){
 	printf("%s SIMULATION '%s' FINISHED\n", LOG_LVL1, simulation_code.c_str());
 	printf("------------------------------------------\n");
 
+	pthread_mutex_unlock(&simulation_output_mutex);
 };
 
 /*******************/
@@ -444,7 +825,15 @@ void Komondor :: Stop(){
 #include "../methods/utils/output_generation_methods.h"
 #include "../methods/utils/print_and_write_methods.h"
 #include "../methods/utils/input_methods/input_validator.h"
+#include "../methods/utils/input_methods/csv_table.h"
 #include "../methods/utils/input_methods/input_loader.h"
+#include "../methods/utils/scenario_snapshot_methods.h"
+#include "../methods/utils/replication_methods.h"
+#include "../methods/utils/slot_synchronous_methods.h"
+#include "../methods/utils/continuation_methods.h"
+#include "../methods/utils/checkpoint_methods.h"
+#include "../methods/utils/steady_state_methods.h"
+#include "../methods/utils/ml_transport_methods.h"
 
 /**********/
 /* main() */
@@ -476,6 +865,31 @@ int main(int argc, char *argv[]){
     
     double sim_time = 10.0;
     int seed = 1;
+    std::string scheduler = "heap";		// Event list of the simulation engine
+    double neighbour_margin = -1;		// Negative: connect every pair of nodes
+    int num_replications = 0;			// 0: single simulation (no batch)
+    int num_threads = 1;				// Worker threads (replications or logical processes)
+    int partition_enabled = 0;			// Simulate non-interacting groups of nodes separately
+    int lazy_backoff = 0;				// DIFS/AIFS and backoff countdown as a single event
+    int slotted = 0;					// Slot-synchronous engine for saturated contention groups
+    std::string profile_filename = "";	// Engine profile (empty: no profiling)
+    std::string trace_input_filename = "";	// Binary node trace to be decoded (no simulation)
+    std::string frame_trace_filename = "";	// Columnar frame trace (empty: no trace)
+    std::string frames_input_filename = "";	// Frame trace to be decoded (no simulation)
+    std::string compile_filename = "";		// Scenario snapshot to be compiled (no simulation)
+    std::string scenario_filename = "";		// Scenario snapshot loaded instead of the input files
+    double fork_time = 0;				// Checkpoint where the continuations are forked (0: no checkpoint)
+    int num_forks = 0;					// Continuations forked at the checkpoint
+    std::vector<int> fork_strategies;	// Action-selection strategy of each continuation (empty: reseeded)
+    double checkpoint_time = 0;			// First checkpoint written to a file (0: after the first period)
+    double checkpoint_period = 0;		// Time between two checkpoints (0: a single one)
+    std::string checkpoint_filename = "";	// File of the checkpoints (empty: ../output/checkpoint_<code>.bin)
+    std::string restore_filename = "";	// Checkpoint the simulation resumes from (empty: none)
+    double warmup = 0;					// Statistics cleared at this time (0: not cleared)
+    double steady_state = 0;			// Target relative half-width of the 95% CIs (0: no steady-state detection)
+    double observation_period = DEFAULT_OBSERVATION_PERIOD;	// Time between two observations (steady-state detection)
+    int ml_transport = ML_TRANSPORT_SOCKET;	// Transport to the external ML servers
+    double decision_latency = 0;		// Time between a decision request and its application (0: synchronous)
 
     // "Modes" are now just flags. Default to false.
     int agents_enabled = 0;
@@ -501,6 +915,45 @@ int main(int argc, char *argv[]){
         {"logs-node", 	required_argument, 0, 'l'},
         {"save-node", 	required_argument, 0, 'S'},
 		{"save-agent", 	required_argument, 0, 'A'},
+        {"decode-trace", required_argument, 0, 'D'},
+        {"frame-trace", required_argument, 0, 'F'},
+        {"decode-frames", required_argument, 0, 'd'},
+
+        // Scenario snapshots
+        {"compile-scenario", required_argument, 0, 'C'},
+        {"scenario-bin", required_argument, 0, 'B'},
+
+        // Simulation engine
+        {"scheduler", required_argument, 0, 'q'},
+        {"neighbours", required_argument, 0, 'N'},
+        {"partition", required_argument, 0, 'P'},
+        {"profile",   required_argument, 0, 'p'},
+        {"lazy-backoff", required_argument, 0, 'b'},
+        {"slotted",   required_argument, 0, 'y'},
+
+        // Warm start of several continuations
+        {"fork-at",   required_argument, 0, 'f'},
+        {"forks",     required_argument, 0, 'k'},
+        {"fork-strategies", required_argument, 0, 'Y'},
+
+        // Checkpoint and restore
+        {"checkpoint-at", required_argument, 0, 'K'},
+        {"checkpoint-every", required_argument, 0, 'U'},
+        {"checkpoint-file", required_argument, 0, 'J'},
+        {"restore",   required_argument, 0, 'r'},
+
+        // Deletion of the warm-up
+        {"warmup",    required_argument, 0, 'W'},
+        {"steady-state", required_argument, 0, 'E'},
+        {"observation-period", required_argument, 0, 'O'},
+
+        // External ML servers
+        {"ml-transport", required_argument, 0, 'M'},
+        {"decision-latency", required_argument, 0, 'G'},
+
+        // Batch of replications
+        {"replications", required_argument, 0, 'R'},
+        {"threads",   required_argument, 0, 'T'},
         
         // Help
         {"help",      no_argument,       0, 'h'},
@@ -513,7 +966,7 @@ int main(int argc, char *argv[]){
     int opt;
     int option_index = 0;
 
-    while ((opt = getopt_long(argc, argv, "n:t:s:c:o:a:m:L:l:S:A:h", long_options, &option_index)) != -1) {
+    while ((opt = getopt_long(argc, argv, "n:t:s:c:o:a:m:L:l:S:A:D:F:d:C:B:q:N:P:p:b:y:f:k:Y:K:U:J:r:W:E:O:M:G:R:T:h", long_options, &option_index)) != -1) {
         switch (opt) {
             case 'n': nodes_input_filename = optarg; break;
             case 't': sim_time = atof(optarg); break;
@@ -536,6 +989,63 @@ int main(int argc, char *argv[]){
             case 'l': print_node_logs = atoi(optarg); break;
             case 'S': save_node_logs = atoi(optarg); break;
 			case 'A': save_agent_logs = atoi(optarg); break;
+            case 'D': trace_input_filename = optarg; break;
+            case 'F': frame_trace_filename = optarg; break;
+            case 'd': frames_input_filename = optarg; break;
+            case 'C': compile_filename = optarg; break;
+            case 'B': scenario_filename = optarg; break;
+
+            // Simulation engine
+            case 'q': scheduler = optarg; break;
+            case 'N': neighbour_margin = atof(optarg); break;
+            case 'P': partition_enabled = atoi(optarg); break;
+            case 'p': profile_filename = optarg; break;
+            case 'b': lazy_backoff = atoi(optarg); break;
+            case 'y': slotted = atoi(optarg); break;
+
+            // Warm start of several continuations
+            case 'f': fork_time = atof(optarg); break;
+            case 'k': num_forks = atoi(optarg); break;
+            case 'Y': {
+                std::string list (optarg);
+                size_t start (0);
+                while (start <= list.size()) {
+                    size_t end (list.find(',', start));
+                    if (end == std::string::npos) end = list.size();
+                    fork_strategies.push_back(atoi(list.substr(start, end - start).c_str()));
+                    start = end + 1;
+                }
+                break;
+            }
+
+            // Checkpoint and restore
+            case 'K': checkpoint_time = atof(optarg); break;
+            case 'U': checkpoint_period = atof(optarg); break;
+            case 'J': checkpoint_filename = optarg; break;
+            case 'r': restore_filename = optarg; break;
+
+            // Deletion of the warm-up
+            case 'W': warmup = atof(optarg); break;
+            case 'E': steady_state = atof(optarg); break;
+            case 'O': observation_period = atof(optarg); break;
+
+            // External ML servers
+            case 'M': {
+                if (strcmp(optarg, "socket") == 0) {
+                    ml_transport = ML_TRANSPORT_SOCKET;
+                } else if (strcmp(optarg, "shm") == 0) {
+                    ml_transport = ML_TRANSPORT_SHM;
+                } else {
+                    printf("ERROR: Unknown ML transport '%s' (use socket or shm)\n", optarg);
+                    exit(-1);
+                }
+                break;
+            }
+            case 'G': decision_latency = atof(optarg); break;
+
+            // Batch of replications
+            case 'R': num_replications = atoi(optarg); break;
+            case 'T': num_threads = atoi(optarg); break;
 
             case 'h':
             default:
@@ -549,22 +1059,138 @@ int main(int argc, char *argv[]){
 				printf("Flags:\n");
 				printf("  --logs-sys <int>      : Print system logs (Default: 0)\n");
 				printf("  --logs-node <int>     : Print node logs (Default: 0)\n");
-				printf("  --save-node <int>     : Save node logs (Default: 0)\n");
+				printf("  --save-node <int>     : Save node logs: 1 as text, 2 as binary traces (Default: 0)\n");
+				printf("  --decode-trace <file> : Decode a binary node trace into a text log and exit\n");
+				printf("  --frame-trace <file>  : Write every frame received (or lost) by each node to a columnar binary trace\n");
+				printf("  --decode-frames <file> : Convert a frame trace into a CSV file and exit\n");
+				printf("  --compile-scenario <file> : Write the scenario (--nodes, --mapc) to a binary snapshot and exit\n");
+				printf("  --scenario-bin <file> : Load a compiled scenario snapshot instead of --nodes and --mapc\n");
 				
 				printf("Optional arguments:\n");
 				printf("  --agents <file>  : Input agents file (Enables Agents)\n");
 				printf("  --save-agent <int>     : Random seed (Default: 0)\n");
                 printf("  --mapc <file>    : Input MAPC file (Enables MAPC)\n");
+                printf("  --scheduler <str> : Event list: simple, heap, calendar, ladder or wheel (Default: heap)\n");
+                printf("  --neighbours <dB> : Only connect nodes sensed above noise minus <dB> (Default: all nodes)\n");
+                printf("  --replications <int> : Run <int> replications (seeds seed, seed+1, ...) and report 95%% CIs\n");
+                printf("  --partition <int> : Simulate non-interacting groups of WLANs separately, needs --neighbours (Default: 0)\n");
+                printf("                      (a dense network, where every WLAN senses another one that senses the rest, is a single group)\n");
+                printf("  --threads <int>   : Replications or partitions simulated concurrently (Default: 1)\n");
+                printf("  --profile <file>  : Write the event handlers profile to <file> (CSV, or JSON if *.json)\n");
+                printf("  --lazy-backoff <int> : Schedule DIFS/AIFS and backoff countdown as a single event (Default: 0)\n");
+                printf("  --slotted <int>   : Simulate saturated contention groups slot by slot, without events (Default: 0)\n");
+                printf("  --warmup <sec>    : Discard the statistics collected before <sec> (Default: 0)\n");
+                printf("  --steady-state <ratio> : Detect the end of the warm-up (MSER-5) and stop once the 95%% CIs are below <ratio> of the mean\n");
+                printf("  --observation-period <sec> : Time between two observations of the network for --steady-state (Default: 0.05)\n");
+                printf("  --fork-at <sec>   : Warm up until <sec> and fork the continuations from that state\n");
+                printf("  --forks <int>     : Continuations forked at --fork-at, run --threads at a time (Default: 1 per strategy)\n");
+                printf("  --fork-strategies <list> : Action-selection strategy of each continuation, e.g. 1,2,3 (Default: reseed them)\n");
+                printf("  --checkpoint-at <sec> : Write the state of the simulation at <sec> to --checkpoint-file\n");
+                printf("  --checkpoint-every <sec> : Write the state of the simulation every <sec> (after --checkpoint-at, if given)\n");
+                printf("  --checkpoint-file <file> : File of the checkpoints (Default: ../output/checkpoint_<code>.bin)\n");
+                printf("  --restore <file>  : Resume the simulation (same input, --time may be longer) from a checkpoint\n");
+                printf("  --ml-transport <str> : External ML servers: socket (a query per decision) or shm (decisions of the same instant batched in shared memory) (Default: socket)\n");
+                printf("  --decision-latency <sec> : Apply the decisions of the agents <sec> after requesting them, simulating meanwhile (Default: 0)\n");
 				printf("\n");
                 exit(0);
         }
     }
 
+    // Decoding of a binary node trace (written with --save-node 2): no simulation
+    if (!trace_input_filename.empty()) {
+        std::string trace_output_filename = trace_input_filename;
+        size_t extension = trace_output_filename.rfind(".bin");
+        if (extension != std::string::npos && extension == trace_output_filename.size() - 4) {
+            trace_output_filename.erase(extension);
+        }
+        trace_output_filename.append(".txt");
+        if (!DecodeNodeTrace(trace_input_filename.c_str(), trace_output_filename.c_str())) exit(-1);
+        printf("%s Trace %s decoded into %s\n", LOG_LVL1, trace_input_filename.c_str(), trace_output_filename.c_str());
+        return 0;
+    }
+
+    // Conversion of a frame trace (written with --frame-trace) into CSV: no simulation
+    if (!frames_input_filename.empty()) {
+        std::string frames_output_filename = frames_input_filename;
+        size_t extension = frames_output_filename.rfind(".bin");
+        if (extension != std::string::npos && extension == frames_output_filename.size() - 4) {
+            frames_output_filename.erase(extension);
+        }
+        frames_output_filename.append(".csv");
+        if (!DecodeFrameTrace(frames_input_filename.c_str(), frames_output_filename.c_str())) exit(-1);
+        printf("%s Frame trace %s decoded into %s\n", LOG_LVL1, frames_input_filename.c_str(), frames_output_filename.c_str());
+        return 0;
+    }
+
     // -------------------------------------------------------
     // 4. VALIDATION
     // -------------------------------------------------------
-    if (nodes_input_filename.empty()) {
-        printf("ERROR: You must provide a nodes file using --nodes or -n\n");
+    if (nodes_input_filename.empty() && scenario_filename.empty()) {
+        printf("ERROR: You must provide a nodes file using --nodes or -n (or a scenario using --scenario-bin)\n");
+        exit(-1);
+    }
+    if (!scenario_filename.empty() && (!nodes_input_filename.empty() || mapc_enabled || !compile_filename.empty())) {
+        printf("ERROR: --scenario-bin replaces --nodes and --mapc, and cannot be compiled again\n");
+        exit(-1);
+    }
+    if (num_replications < 0 || num_threads < 1) {
+        printf("ERROR: --replications must be positive and --threads at least 1\n");
+        exit(-1);
+    }
+    if (fork_time < 0 || (fork_time > 0 && fork_time >= sim_time)) {
+        printf("ERROR: --fork-at must be within the simulation time\n");
+        exit(-1);
+    }
+    if (fork_time > 0) {
+        if (num_forks == 0) num_forks = fork_strategies.empty() ? 1 : fork_strategies.size();
+        if (num_forks < 1 || (!fork_strategies.empty() && (int) fork_strategies.size() != num_forks)) {
+            printf("ERROR: --forks must be positive and match the number of --fork-strategies\n");
+            exit(-1);
+        }
+        for (size_t i = 0; i < fork_strategies.size(); ++i) {
+            if (fork_strategies[i] < STRATEGY_EGREEDY || fork_strategies[i] > STRATEGY_SEQUENTIAL) {
+                printf("ERROR: '%d' is not a correct action-selection strategy\n", fork_strategies[i]);
+                exit(-1);
+            }
+        }
+        if (num_replications > 0 || partition_enabled || !frame_trace_filename.empty() || save_node_logs
+                || save_agent_logs || !profile_filename.empty() || ml_transport == ML_TRANSPORT_SHM) {
+            printf("ERROR: --fork-at cannot be combined with --replications, --partition, --frame-trace, "
+                "--save-node, --save-agent, --profile nor --ml-transport shm\n");
+            exit(-1);
+        }
+    } else if (num_forks != 0 || !fork_strategies.empty()) {
+        printf("ERROR: --forks and --fork-strategies require --fork-at\n");
+        exit(-1);
+    }
+    if (checkpoint_time < 0 || checkpoint_time > sim_time || checkpoint_period < 0) {
+        printf("ERROR: --checkpoint-at must be within the simulation time, and --checkpoint-every positive\n");
+        exit(-1);
+    }
+    if (checkpoint_time > 0 || checkpoint_period > 0) {
+        if (fork_time > 0) {
+            printf("ERROR: --fork-at cannot be combined with --checkpoint-at nor --checkpoint-every (fork the restored simulation instead)\n");
+            exit(-1);
+        }
+        if (checkpoint_filename.empty()) checkpoint_filename = "../output/checkpoint_" + simulation_code + ".bin";
+    } else if (!checkpoint_filename.empty()) {
+        printf("ERROR: --checkpoint-file requires --checkpoint-at or --checkpoint-every\n");
+        exit(-1);
+    }
+    if (warmup < 0 || (warmup > 0 && warmup >= sim_time) || steady_state < 0 || observation_period <= 0) {
+        printf("ERROR: --warmup must be within the simulation time, and --steady-state and --observation-period positive\n");
+        exit(-1);
+    }
+    if (steady_state > 0 && partition_enabled) {
+        printf("ERROR: --steady-state observes the whole network, so it cannot be combined with --partition\n");
+        exit(-1);
+    }
+    if (decision_latency < 0) {
+        printf("ERROR: --decision-latency cannot be negative\n");
+        exit(-1);
+    }
+    if (partition_enabled && neighbour_margin < 0) {
+        printf("ERROR: --partition requires --neighbours (otherwise every node interacts with every other)\n");
         exit(-1);
     }
     
@@ -586,8 +1212,64 @@ int main(int argc, char *argv[]){
     // -------------------------------------------------------
 
     Komondor komondor_simulation;
-    
+
+    // Compilation of the scenario into a snapshot (see scenario_snapshot_methods.h): no simulation
+    if (!compile_filename.empty()) {
+        komondor_simulation.CompileScenario(nodes_input_filename.c_str(), mapc_enabled, mapc_input_filename.c_str(),
+            seed, print_system_logs, compile_filename.c_str());
+        return 0;
+    }
+
+    if (!komondor_simulation.Scheduler(scheduler.c_str())) {
+        printf("ERROR: Unknown scheduler '%s' (use simple, heap, calendar, ladder or wheel)\n", scheduler.c_str());
+        exit(-1);
+    }
+
+    // Batch of replications (each one simulated by its own engine)
+    if (num_replications > 0) {
+        ReplicationBatch batch;
+        batch.sim_time = sim_time;
+        batch.save_node_logs = save_node_logs;
+        batch.save_agent_logs = save_agent_logs;
+        batch.print_system_logs = print_system_logs;
+        batch.print_node_logs = print_node_logs;
+        batch.print_agent_logs = print_agent_logs;
+        batch.nodes_input_filename = nodes_input_filename;
+        batch.script_output_filename = script_output_filename;
+        batch.simulation_code = simulation_code;
+        batch.seed = seed;
+        batch.agents_enabled = agents_enabled;
+        batch.agents_input_filename = agents_input_filename;
+        batch.mapc_enabled = mapc_enabled;
+        batch.mapc_input_filename = mapc_input_filename;
+        batch.neighbour_margin = neighbour_margin;
+        batch.partition_enabled = partition_enabled;
+        batch.lazy_backoff = lazy_backoff;
+        batch.slotted = slotted;
+        batch.frame_trace_filename = frame_trace_filename;
+        batch.scenario_filename = scenario_filename;
+        batch.scheduler = scheduler;
+        batch.profile_filename = profile_filename;
+        batch.num_replications = num_replications;
+        batch.warmup = warmup;
+        batch.steady_state = steady_state;
+        batch.observation_period = observation_period;
+        batch.ml_transport = ml_transport;
+        batch.decision_latency = decision_latency;
+        batch.checkpoint_time = checkpoint_time;
+        batch.checkpoint_period = checkpoint_period;
+        batch.checkpoint_filename = checkpoint_filename;
+        batch.restore_filename = restore_filename;
+        // CompC++ renames the class of the component, which is thus named through the type of its instance
+        RunReplications<__typeof__(komondor_simulation)>(&batch, num_threads);
+        return 0;
+    }
+
 	komondor_simulation.StopTime(sim_time);
+	komondor_simulation.Threads(num_threads);
+	if (!profile_filename.empty()) komondor_simulation.Profile(profile_filename.c_str());
+	komondor_simulation.SetupSteadyState(warmup, steady_state, observation_period);
+	komondor_simulation.SetupAgentDecisions(ml_transport, decision_latency);
 	
     komondor_simulation.Setup(
         sim_time, 
@@ -603,8 +1285,17 @@ int main(int argc, char *argv[]){
         agents_enabled, 
         agents_input_filename.c_str(), 
         mapc_enabled, 
-        mapc_input_filename.c_str()
+        mapc_input_filename.c_str(),
+        neighbour_margin,
+        partition_enabled,
+        lazy_backoff,
+        slotted,
+        frame_trace_filename.c_str(),
+        scenario_filename.c_str()
     );
+    komondor_simulation.SetupCheckpoints(checkpoint_time, checkpoint_period, checkpoint_filename.c_str(),
+        restore_filename.c_str());
+    if (fork_time > 0) komondor_simulation.SetupContinuations(fork_time, num_forks, fork_strategies, num_threads);
 
     printf("------------------------------------------\n");
     printf("%s SIMULATION '%s' STARTED\n", LOG_LVL1, simulation_code.c_str());
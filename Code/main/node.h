@@ -63,6 +63,7 @@
 #include "../structures/notification.h"
 #include "../structures/logical_nack.h"
 #include "../structures/wlan.h"
+#include "../structures/topology.h"
 #include "../structures/logger.h"
 #include "../structures/FIFO.h"
 #include "../structures/node_configuration.h"
@@ -72,6 +73,7 @@
 #include "../structures/node_statistics.h"
 #include "../structures/node_parameters.h"
 #include "../structures/packet_exchange_sequence.h"
+#include "../structures/checkpoint_file.h"
 #include "../methods/channel/channel_access_methods.h"
 
 #include "../methods/mac/nack_methods.h"
@@ -80,6 +82,9 @@
 
 #include "../methods/frames/frame_duration_methods.h"
 #include "../methods/frames/packet_aggregation_methods.h"
+#include "../structures/phy_timing.h"
+#include "../methods/utils/trace_methods.h"
+#include "../methods/utils/frame_trace_methods.h"
 
 #define __SAVELOGS__
 
@@ -89,6 +94,20 @@
     #define    LOGS(flag,file,...)
 #endif
 
+// Node logs: "%.15f;N%d;S%d;%s;%s ...", SimTime(), node_id, node_state, LOG_<code>, LOG_LVL<n>, ...
+// Lines deeper than LOG_LVL<NODE_LOGS_LEVEL> are compiled out: the level is told at compile time by the
+// length of the LOG_LVL<n> string (lines without it are level 1). Lines are written by WriteNodeLog, which
+// appends them to the binary trace of the node when --save-node is SAVE_NODE_LOGS_BINARY
+#define NODE_LOGS_LEVEL_STRING_(level)    LOG_LVL##level
+#define NODE_LOGS_LEVEL_STRING(level)    NODE_LOGS_LEVEL_STRING_(level)
+#define NODE_LOGS_LINE_LEVEL(format, time, node_id, state, code, level, ...)    sizeof(level)
+#if defined(__SAVELOGS__) && NODE_LOGS_LEVEL > 0
+    #define    NODE_LOGS(flag,logger,...)    if(NODE_LOGS_LINE_LEVEL(__VA_ARGS__, LOG_LVL1, LOG_LVL1, LOG_LVL1, LOG_LVL1, LOG_LVL1) \
+		<= sizeof(NODE_LOGS_LEVEL_STRING(NODE_LOGS_LEVEL)) && (flag)){WriteNodeLog(logger, __VA_ARGS__);}
+#else
+    #define    NODE_LOGS(flag,logger,...)
+#endif
+
 // Node component: "TypeII" represents components that are aware of the existence of the simulated time.
 component Node : public TypeII{
 
@@ -99,6 +118,8 @@ component Node : public TypeII{
 		void Setup();
 		void Start();
 		void Stop();
+		void ClearStats();
+		~Node();
 
 		// Generic
 		void InitializeVariables();
@@ -110,12 +131,15 @@ component Node : public TypeII{
 		void WriteNodeInfo(Logger node_logger, int info_detail_level, std::string header_str);
 		void WriteNodeConfiguration(Logger node_logger, std::string header_str);
 		void WriteReceivedConfiguration(Logger node_logger, std::string header_str, Configuration new_configuration);
+		void ComputeNodeStatistics();
+		double StatisticsTime();
 		void PrintOrWriteNodeStatistics(int write_or_print);
 		void HandleSlottedBackoffCollision();
 		void StartSavingLogs();
 		void RecoverFromCtsTimeout();
 		void MeasureRho();
 		void SaveSimulationPerformance();
+		void Checkpoint(CheckpointFile &file);
 
 		// Packets
 		Notification GenerateNotification(int packet_type, int destination_id,
@@ -128,21 +152,37 @@ component Node : public TypeII{
 		void NavTimeout();
 		void RequestMCS();
 		void StartTransmission();
+		void SendStartTX(const Notification &notification);
+		void SendFinishTX(const Notification &notification);
+		void SetBeamReceivers(const int *receiver_ids, int num_receivers, const double *x, const double *y,
+			const double *z, int total_nodes_number);
 		void AbortInitialTransmission();
 		void PrepareNewTransmission();
 		void InitiateBurstPackets();
 		void ScheduleTransmission(int first_packet_type = PACKET_TYPE_RTS);
 
 		// NACK
-		void SendLogicalNack(LogicalNack logical_nack);
+		void SendLogicalNack(LogicalNack &logical_nack);
 
 		// Backoff
 		void PauseBackoff();
 		void ResumeBackoff();
 		void ScheduleBackoffAfterDIFS();		
+		void ArmBackoffAfterIfs(double ifs_end_time);
+		void CancelIfs();
+		int IfsPending();
+		int BackoffCountingDown();
+
+		// Slot-synchronous engine (see Komondor::RunFastPath)
+		int SlottedIfsSlots();
+		int SlottedBackoffSlots();
+		double SlottedExchangeDuration(int destination_id, int *num_packets_aggregated, double *durations);
+		double SlottedTransmission(double tx_time, double stop_time, NodeStatistics **stats_per_node);
+		double SlottedRecoveryTime(double end_time);
 
 		// Signal helpers
-		void UpdateSINRFromNotification(const Notification &notification);
+		void UpdateSINRFromNotification(const NotificationFrame &notification);
+		int EvaluateReception(const Notification &notification_interest, const Notification &notification, double pd);
 
 		// Configuration (to be sent to the agent)
 		void GenerateConfiguration();
@@ -152,37 +192,37 @@ component Node : public TypeII{
 
 		// Spatial Reuse
 		void SpatialReuseOpportunityEnds();
-		void UpdateSRStateForIncomingFrame(const Notification &notification);
-		void TryIdentifySRTXOP(const Notification &notification, int &loss_reason);
-		void ComputeNavCollisions(const Notification &notification, int &nav_collision, int &inter_bss_nav_collision);
-		void DetectSRTXOPInNavState(const Notification &notification, int loss_reason);
-		void DetectSRTXOPWhileTransmitting(const Notification &notification);
+		void UpdateSRStateForIncomingFrame(const NotificationFrame &notification);
+		void TryIdentifySRTXOP(const NotificationFrame &notification, int &loss_reason);
+		void ComputeNavCollisions(const NotificationFrame &notification, int &nav_collision, int &inter_bss_nav_collision);
+		void DetectSRTXOPInNavState(const NotificationFrame &notification, int loss_reason);
+		void DetectSRTXOPWhileTransmitting(const NotificationFrame &notification);
 		void ApplySRParametersAtBackoffEnd();
 		void CheckSRTXOPAtCallSensing();
 
 		// InportSomeNodeStartTX per-state handlers
-		void HandleStartTX_StateSensing(const Notification &notification);
-		void HandleStartTX_StateTxData(const Notification &notification);
-		void HandleStartTX_StateRxData(const Notification &notification);
-		void HandleStartTX_StateWaitAck(const Notification &notification);
-		void HandleStartTX_StateWaitCts(const Notification &notification);
-		void HandleStartTX_StateWaitData(const Notification &notification);
-		void HandleStartTX_StateNav(const Notification &notification);
+		void HandleStartTX_StateSensing(const NotificationFrame &notification);
+		void HandleStartTX_StateTxData(const NotificationFrame &notification);
+		void HandleStartTX_StateRxData(const NotificationFrame &notification);
+		void HandleStartTX_StateWaitAck(const NotificationFrame &notification);
+		void HandleStartTX_StateWaitCts(const NotificationFrame &notification);
+		void HandleStartTX_StateWaitData(const NotificationFrame &notification);
+		void HandleStartTX_StateNav(const NotificationFrame &notification);
 		// MAPC wait-state handlers
-		void HandleStartTX_StateWaitIcr(const Notification &notification);
-		void HandleStartTX_StateWaitMuRts(const Notification &notification);
-		void HandleStartTX_StateWaitTf(const Notification &notification);
+		void HandleStartTX_StateWaitIcr(const NotificationFrame &notification);
+		void HandleStartTX_StateWaitMuRts(const NotificationFrame &notification);
+		void HandleStartTX_StateWaitTf(const NotificationFrame &notification);
 
 		// InportSomeNodeFinishTX per-state handlers
-		void HandleFinishTX_StateSensing(const Notification &notification);
-		void HandleFinishTX_StateRxData(const Notification &notification);
-		void HandleFinishTX_StateTxData(const Notification &notification);
+		void HandleFinishTX_StateSensing(const NotificationFrame &notification);
+		void HandleFinishTX_StateRxData(const NotificationFrame &notification);
+		void HandleFinishTX_StateTxData(const NotificationFrame &notification);
 		// MAPC reception handlers
-		void HandleFinishTX_StateRxIcf(const Notification &notification);
-		void HandleFinishTX_StateRxIcr(const Notification &notification);
-		void HandleFinishTX_StateRxMuRts(const Notification &notification);
-		void HandleFinishTX_StateRxTf(const Notification &notification);
-		void HandleFinishTX_StateWaitAckTf(const Notification &notification);
+		void HandleFinishTX_StateRxIcf(const NotificationFrame &notification);
+		void HandleFinishTX_StateRxIcr(const NotificationFrame &notification);
+		void HandleFinishTX_StateRxMuRts(const NotificationFrame &notification);
+		void HandleFinishTX_StateRxTf(const NotificationFrame &notification);
+		void HandleFinishTX_StateWaitAckTf(const NotificationFrame &notification);
 		void ProceedAfterIcr();
 		void ComputeCoSRTxPowers(double &coordinator_pW, double &peer_pW);
 
@@ -237,17 +277,17 @@ component Node : public TypeII{
 		int distance_to_token;			///> Distance of the node to the token in "token_status_list"
 		int *num_missed_tokens_list;	///> Number of missed tokens for each involved device in the tokenized channel access
 
-		double *distances_array;					///> Distance with respect to other nodes
-		double *received_power_array;				///> Power received from the other nodes
+		const Topology *topology;					///> Positions of all the nodes and channel between them (shared, read-only)
+		const PhyTiming *phy_timing;				///> Durations of the frames per MCS and channel width (shared, read-only)
+		double *received_power_array;				///> Power received from the other nodes (own row of the topology)
+		double *path_gain_array;					///> Path gain (linear) from the other nodes (row of the topology)
 		double *max_received_power_in_ap_per_wlan;	///> Maximum power received from each WLAN
 
 		double *rssi_per_sta;	///> RSSI per STA in the WLAN
 
-		// Positions of all nodes (initialized at startup; used for per-TXOP beam steering)
-		double *all_node_x;		///> X position of every node indexed by node_id
-		double *all_node_y;		///> Y position of every node indexed by node_id
-		double *all_node_z;		///> Z position of every node indexed by node_id
-		int    *all_node_first_sta_id;	///> For AP nodes: first associated STA id; NODE_ID_NONE for STAs
+		// Frame trace (--frame-trace)
+		FrameTrace *frame_trace;				///> Columnar trace of the simulation (NULL if not enabled)
+		FrameTraceBlock *frame_trace_block;		///> Rows of the frames addressed to the node not yet handed to the trace
 
 		// Per-TXOP beamforming state (updated in PrepareNewTransmission, embedded in notifications)
 		double current_beam_az_main_rad;				///> Main beam azimuth for current TX [rad]
@@ -255,6 +295,14 @@ component Node : public TypeII{
 		int    current_beam_num_nulls;					///> Number of active nulls for current TX
 		int    current_beam_use_zf;						///> 0 = projection (standalone BF), 1 = ZF precoding (Co-BF)
 
+		// Beamformed DATA frames (see SendStartTX): weights and gains computed once by the transmitter
+		BeamWeights beam_weights;				///> ULA weights of the last beamformed DATA frame
+		int num_beam_receivers;					///> Nodes sensing the frames of the node (co-located ones excluded)
+		int *beam_receiver_ids;					///> ID of each of them
+		double *beam_receiver_az_rad;			///> Azimuth of each of them from the node [rad]
+		double *beam_receiver_gain;				///> Gain of the last beamformed DATA frame toward each of them
+		double *beam_gain_per_node;				///> Same gains, indexed by node ID (1 for co-located nodes; NULL if unused)
+
 	// Statistics (accessible when simulation finished through Komondor simulation class)
 	public:
 
@@ -280,6 +328,12 @@ component Node : public TypeII{
 		double *channel_power;				///> Channel power detected in each sub-channel [pW] (Pico watts for resolution issues)
 		int *channels_free;					///> Channels that are found free for the beginning TX (i.e. power sensed < pd)
 		int *channels_for_tx;				///> Channels that are used in the beginning TX (depend on the channel bonding model)
+		double *ongoing_tx_power;			///> Power received from each ongoing transmission of other nodes [pW] (0 if none)
+		int *ongoing_tx_left_channel;		///> Left channel of each ongoing transmission
+		int *ongoing_tx_right_channel;		///> Right channel of each ongoing transmission
+		int *ongoing_tx_punctured_bitmap;	///> Punctured sub-channels of each ongoing transmission
+		double *ongoing_tx_start_time;		///> Start of each ongoing transmission [s]
+		int num_channel_power_updates;		///> Incremental updates of "channel_power" since it was last recomputed
 
 		// File for writting node logs
 		FILE *output_log_file;				///> File for logs in which the node is involved
@@ -313,11 +367,12 @@ component Node : public TypeII{
 		Notification ack_notification;			///> ACK to be filled before sending it
 		// MAPC notifications
 		Notification icf_notification;			///> ICF (MAPC Initial Control Frame) to be filled before sending it
-		Notification incoming_notification; 	///> Notification of interest being received
+		NotificationRef incoming_notification; 	///> Notification of interest being received
 		Notification new_packet;				///> Auxiliar notification object for new packets
 		Notification null_notification;			///> Auxiliar notification object for null packets
-		Notification nav_notification;			///> Last notification that made the node change state or remain in NAV. It is used for detecting simultaneous events.
-		Notification outrange_nav_notification; ///> NAV notification sent in a different primary channel. Store it for detecting BO collisions when using CB.
+		NotificationRef nav_notification;			///> Last notification that made the node change state or remain in NAV. It is used for detecting simultaneous events.
+		NotificationRef outrange_nav_notification; ///> NAV notification sent in a different primary channel. Store it for detecting BO collisions when using CB.
+		CorsaAllocator *notification_pool;		///> Pool of the frames transmitted by the node (shared by all their receivers)
 		TxInfo current_tx_info;					///> Object to store the current transmission information
 
 		// Traffic
@@ -343,9 +398,8 @@ component Node : public TypeII{
 		// Sensing and Reception parameters
 		LogicalNack logical_nack;					///> NACK to be filled in case node is the destination of tx loss
 		double max_pw_interference;					///> Maximum interference detected in range of interest [pW]
-		int *nodes_transmitting;					///> IDs of the nodes which are transmitting to any destination
-		std::map<int, double>
-			power_received_per_node;				///> Map containing the power received from each other node
+		NodeSet nodes_transmitting;					///> Nodes which are transmitting to any destination
+		InterferenceSet power_received_per_node;	///> Power received from each node being sensed
 		double power_rx_interest;					///> Power received from a TX destined to the node [pW]
 		int receiving_from_node_id;					///> ID of the node that is transmitting to the node (-1 if node is not receiving)
 		int receiving_packet_id;					///> ID of the notification that is being transmitted to me
@@ -404,8 +458,8 @@ component Node : public TypeII{
 	public:
 
 		// INPORT connections for receiving notifications
-		inport void inline InportSomeNodeStartTX(Notification &notification);
-		inport void inline InportSomeNodeFinishTX(Notification &notification);
+		inport void inline InportSomeNodeStartTX(const NotificationFrame &notification);
+		inport void inline InportSomeNodeFinishTX(const NotificationFrame &notification);
 		inport void inline InportNackReceived(LogicalNack &logical_nack_info);
 
 		inport void inline InportMCSRequestReceived(Notification &notification);
@@ -423,8 +477,8 @@ component Node : public TypeII{
 		inport void inline InportNewSpatialReuseConfiguration(Configuration &new_configuration);
 
 		// OUTPORT connections for sending notifications
-		outport void outportSelfStartTX(Notification &notification);
-		outport void outportSelfFinishTX(Notification &notification);
+		outport void outportSelfStartTX(const NotificationFrame &notification);
+		outport void outportSelfFinishTX(const NotificationFrame &notification);
 		outport void outportSendLogicalNack(LogicalNack &logical_nack_info);
 
 		outport void outportAskForTxModulation(Notification &notification);
@@ -511,6 +565,35 @@ component Node : public TypeII{
 			connect trigger_npca_timer.to_component,NpcaSwitchBack;
 			connect trigger_npca_icr_timeout.to_component,NpcaIcrTimeout;
 			connect trigger_npca_backoff.to_component,EndNpcaBackoff;
+			// Names of the handlers in the engine profile (--profile)
+			trigger_end_backoff.ProfileName("Node::EndBackoff");
+			trigger_toFinishTX.ProfileName("Node::MyTxFinished");
+			trigger_sim_time.ProfileName("Node::PrintProgressBar");
+			trigger_start_backoff.ProfileName("Node::ResumeBackoff");
+			trigger_SIFS.ProfileName("Node::SendResponsePacket");
+			trigger_ACK_timeout.ProfileName("Node::AckTimeout");
+			trigger_CTS_timeout.ProfileName("Node::CtsTimeout");
+			trigger_DATA_timeout.ProfileName("Node::DataTimeout");
+			trigger_NAV_timeout.ProfileName("Node::NavTimeout");
+			trigger_inter_bss_NAV_timeout.ProfileName("Node::NavTimeout (inter-BSS)");
+			trigger_preoccupancy.ProfileName("Node::StartTransmission");
+			trigger_restart_sta.ProfileName("Node::CallRestartSta");
+			trigger_wait_collisions.ProfileName("Node::CallSensing");
+			trigger_start_saving_logs.ProfileName("Node::StartSavingLogs");
+			trigger_recover_cts_timeout.ProfileName("Node::RecoverFromCtsTimeout");
+			trigger_rho_measurement.ProfileName("Node::MeasureRho");
+			txop_sr_end.ProfileName("Node::SpatialReuseOpportunityEnds");
+			trigger_dso_icr_timeout.ProfileName("Node::DsoIcrTimeout");
+			trigger_npca_switch.ProfileName("Node::NpcaSwitchComplete");
+			trigger_npca_timer.ProfileName("Node::NpcaSwitchBack");
+			trigger_npca_icr_timeout.ProfileName("Node::NpcaIcrTimeout");
+			trigger_npca_backoff.ProfileName("Node::EndNpcaBackoff");
+			// Receivers of the beamformed frames (see SetBeamReceivers)
+			num_beam_receivers = 0;
+			beam_receiver_ids = NULL;
+			beam_receiver_az_rad = NULL;
+			beam_receiver_gain = NULL;
+			beam_gain_per_node = NULL;
 		}
 };
 
@@ -531,11 +614,18 @@ void Node :: Start(){
 
 	// Create node logs file if required
 	node_logger.file = NULL;
+	node_logger.trace = NULL;
 	if(node_params.save_node_logs) {
 		// Name node log file accordingly to the node_params.node_id
-		snprintf(own_file_path, sizeof(own_file_path), "%s_%s_N%d_%s.txt","../output/logs_output", node_params.simulation_code.c_str(), node_params.node_id, node_params.node_code.c_str());
+		int binary_logs = (node_params.save_node_logs == SAVE_NODE_LOGS_BINARY);
+		snprintf(own_file_path, sizeof(own_file_path), "%s_%s_N%d_%s.%s","../output/logs_output", node_params.simulation_code.c_str(), node_params.node_id, node_params.node_code.c_str(),
+			binary_logs ? "bin" : "txt");
 		remove(own_file_path);
-		output_log_file = fopen(own_file_path, "at");
+		if (binary_logs) {
+			output_log_file = OpenNodeTrace(own_file_path, &node_logger.trace);
+		} else {
+			output_log_file = fopen(own_file_path, "at");
+		}
 		if(output_log_file == NULL) {
 			printf("WARNING: Cannot open node log file %s - disabling node logs\n", own_file_path);
 			node_params.save_node_logs = 0;
@@ -545,7 +635,7 @@ void Node :: Start(){
 			node_logger.SetVoidHeadString();
 		}
 	}
-	LOGS(node_params.save_node_logs, node_logger.file,"%.18f;N%d;S%d;%s;%s Start()\n",
+	NODE_LOGS(node_params.save_node_logs, node_logger,"%.18f;N%d;S%d;%s;%s Start()\n",
 		SimTime(), node_params.node_id, STATE_UNKNOWN, LOG_B00, LOG_LVL1);
 
 	// Write node info and conf.
@@ -577,8 +667,8 @@ void Node :: Start(){
 	//    node_params.save_node_logs = FALSE;
 	//    trigger_start_saving_logs.Set(SimTime() + 3628);
 	// ----------------------------------------
-	LOGS(node_params.save_node_logs, node_logger.file,"\nXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX\n");
-	// LOGS(node_params.save_node_logs, node_logger.file, "%f;N%d;S%d;%s;%s Start() END\n", SimTime(), node_params.node_id, node_state, LOG_B01, LOG_LVL1);
+	NODE_LOGS(node_params.save_node_logs, node_logger,"\nXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX\n");
+	// NODE_LOGS(node_params.save_node_logs, node_logger, "%f;N%d;S%d;%s;%s Start() END\n", SimTime(), node_params.node_id, node_state, LOG_B01, LOG_LVL1);
 
 };
 
@@ -587,15 +677,17 @@ void Node :: Start(){
  */
 void Node :: Stop(){
 
-	LOGS(node_params.save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s Node Stop()\n",
+	NODE_LOGS(node_params.save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Node Stop()\n",
 		SimTime(), node_params.node_id, node_state, LOG_C00, LOG_LVL1);
 
-	// Print and write node statistics if required
+	// Process, print and write node statistics if required
+	ComputeNodeStatistics();
 	if (node_params.print_node_logs) PrintOrWriteNodeStatistics(PRINT_LOG);
 	if (node_params.save_node_logs) PrintOrWriteNodeStatistics(WRITE_LOG);
 
-	// Close node logs file
+	// Close node logs file (and flush the binary trace, if any)
 	if(node_params.save_node_logs) fclose(node_logger.file);
+	node_logger.trace = NULL;
 
 	// Save performance into the simulation_performance object
 	SaveSimulationPerformance();
@@ -603,8 +695,27 @@ void Node :: Stop(){
 	// Save the configuration currently being used by the node
 	GenerateConfiguration();
 
+	// Drop the frames kept from other nodes (their pools are deleted with them)
+	incoming_notification.Release();
+	nav_notification.Release();
+	outrange_nav_notification.Release();
+
 };
 
+/**
+ * ~Node(): delete the pool of transmitted frames and the receivers of the beamformed frames. Every node has
+ * released the frames of the others in Stop()
+ */
+Node :: ~Node(){
+	delete notification_pool;
+	delete[] beam_receiver_ids;
+	delete[] beam_receiver_az_rad;
+	delete[] beam_receiver_gain;
+	delete[] beam_gain_per_node;
+	nodes_transmitting.Free();
+	power_received_per_node.Free();
+}
+
 
 // Node::HandleStartTX_StateSensing  — see methods/node/node_fsm_methods.h
 // Node::HandleStartTX_StateNav      — see methods/node/node_fsm_methods.h
@@ -628,7 +739,7 @@ void Node :: Stop(){
 
 // Node::InportNewPacketGenerated — see methods/node_mcs_methods.h
 
-// Node::StartTransmission — see methods/node_packet_methods.h
+// Node::StartTransmission, SendStartTX, SendFinishTX — see methods/node_packet_methods.h
 
 // Node::InitiateBurstPackets — see methods/node/node_packet_methods.h
 
@@ -679,7 +790,7 @@ void Node :: Stop(){
 
 // --- PRINT INFORMATION (see: node_statistics_methods.h) ---
 // Node::PrintNodeInfo, WriteNodeInfo, WriteNodeConfiguration, WriteReceivedConfiguration,
-// Node::PrintNodeConfiguration, PrintProgressBar, PrintOrWriteNodeStatistics
+// Node::PrintNodeConfiguration, PrintProgressBar, ComputeNodeStatistics, PrintOrWriteNodeStatistics
 
 // Node::SaveSimulationPerformance — see methods/node_statistics_methods.h
 
@@ -763,6 +874,7 @@ void Node :: InitializeVariables() {
 	// Output file - logger
 	node_logger.save_logs = node_params.save_node_logs;
 	node_logger.file = NULL;	// File opened in Start() after InitializeVariables() returns
+	node_logger.trace = NULL;
 
 	// Arrays and other
 	channel_power = new double[NUM_CHANNELS_KOMONDOR];
@@ -796,17 +908,30 @@ void Node :: InitializeVariables() {
 		node_stats.total_time_lost_in_num_channels[i] = 0;
 	}
 
-	nodes_transmitting = new int[node_params.total_nodes_number];
+	nodes_transmitting.Allocate(node_params.total_nodes_number);
 //	// List of hidden nodes (1 indicates hidden nodes, 0 indicates the opposite)
 //	hidden_nodes_list = new int[node_params.total_nodes_number];
 //	// Counter for the times a node was implied in a collision by hidden node
 //	potential_hidden_nodes = new int[node_params.total_nodes_number];
 	for(int n = 0; n < node_params.total_nodes_number; ++n){
-		nodes_transmitting[n] = FALSE;
 //		hidden_nodes_list[n] = FALSE;
 //		potential_hidden_nodes[n] = 0;
 	}
 
+	ongoing_tx_power = new double[node_params.total_nodes_number];
+	ongoing_tx_left_channel = new int[node_params.total_nodes_number];
+	ongoing_tx_right_channel = new int[node_params.total_nodes_number];
+	ongoing_tx_punctured_bitmap = new int[node_params.total_nodes_number];
+	ongoing_tx_start_time = new double[node_params.total_nodes_number];
+	for(int n = 0; n < node_params.total_nodes_number; ++n){
+		ongoing_tx_power[n] = 0;
+		ongoing_tx_left_channel[n] = 0;
+		ongoing_tx_right_channel[n] = 0;
+		ongoing_tx_punctured_bitmap[n] = 0;
+		ongoing_tx_start_time[n] = 0;
+	}
+	num_channel_power_updates = 0;
+
 	ack_success_ewma   = new double[node_params.total_nodes_number];
 	ack_exchange_count = new int[node_params.total_nodes_number];
 	for (int n = 0; n < node_params.total_nodes_number; ++n) {
@@ -814,7 +939,7 @@ void Node :: InitializeVariables() {
 		ack_exchange_count[n] = 0;
 	}
 
-	power_received_per_node.clear();
+	power_received_per_node.Allocate(node_params.total_nodes_number);
 
 //	potential_hidden_nodes[node_params.node_id] = -1; // To indicate that the node cannot be hidden from itself
 	node_stats.nacks_received = new int[NUM_PACKET_LOST_REASONS];
@@ -828,10 +953,12 @@ void Node :: InitializeVariables() {
 	current_left_channel =  node_params.min_channel_allowed;
 	current_right_channel = node_params.max_channel_allowed;
 	node_stats.sum_waiting_time = 0;
+	node_stats.stats_start_time = 0;
 	node_stats.timestamp_new_trial_started = 0;
 	node_stats.num_average_waiting_time_measurements = 0;
 	node_stats.expected_backoff = 0;
 	ca_state.remaining_backoff = 0;
+	ca_state.ifs_end_time = 0;
 	node_stats.num_new_backoff_computations = 0;
 	last_transmission_successful = 0;
 
@@ -907,7 +1034,8 @@ void Node :: InitializeVariables() {
 	if(node_params.node_type == NODE_TYPE_AP) {
 		node_is_transmitter = TRUE;
 		ca_state.remaining_backoff = ComputeBackoff(ca_state.current_cw_min, ca_state.current_cw_max, node_params.backoff_type,
-				current_traffic_type, ca_state.deterministic_bo_active, ca_state.num_bo_interruptions, ca_state.base_backoff_deterministic, -1);
+				current_traffic_type, ca_state.deterministic_bo_active, ca_state.num_bo_interruptions, ca_state.base_backoff_deterministic, -1,
+				&random_stream);
 		ca_state.previous_backoff = ca_state.remaining_backoff;
 		node_stats.expected_backoff += ca_state.remaining_backoff;
 		node_stats.num_new_backoff_computations++;
@@ -977,7 +1105,8 @@ void Node :: InitializeVariables() {
 
 	data_notification = null_notification;
 	ack_notification= null_notification;
-	incoming_notification = null_notification;
+	notification_pool = new CorsaAllocator(sizeof(NotificationFrame), 16);
+	incoming_notification.Create(notification_pool, null_notification);
 	rts_notification = null_notification;
 	cts_notification = null_notification;
 	new_packet = null_notification;
@@ -1046,6 +1175,7 @@ void Node :: InitializeVariables() {
 	}
 	// Initialize the TXOP identified to false
 	sr_state.txop_sr_identified = FALSE;
+	sr_state.flag_change_in_tx_power = FALSE;
 	// When leaving Co-SR mode, force MCS re-measurement at standalone TX power
 	// for the next TXOP. Without this, nodes reuse the interference-measured MCS
 	// from the Co-SR simultaneous phase for their following standalone transmissions.
@@ -0,0 +1,250 @@
+/* Kom8ndor IEEE 802.11bn Simulator
+ *
+ * Copyright (c) 2026, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ */
+
+/**
+ * receive_path_benchmark.cc: micro-benchmark of the receive path of the nodes ("make benchmark").
+ *
+ * Every event, a node of a dense deployment starts transmitting a frame, and the frame started two events before
+ * finishes. Every other node updates the power sensed per channel, classifies the frame (BSS color / SRG) and
+ * evaluates the reception (interference, SINR and packet loss), as Node::InportSomeNodeStartTX() and
+ * Node::EvaluateReception() do. This is done twice: passing the notifications by value, as the receive path used to,
+ * and reading them in place from the shared frame. The bytes copied per event and the time per event are reported.
+ *
+ * Usage: ./receive_path_benchmark [num_nodes] [num_events]	(default: 100 nodes, 20000 events)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+
+#include ".././COST/cost.h"
+
+#include "../list_of_macros.h"
+
+#include "../structures/logger.h"
+#include "../structures/notification.h"
+#include "../structures/wlan.h"
+#include "../structures/interference_set.h"
+#include "../methods/channel/power_channel_methods.h"
+#include "../methods/mac/packet_loss_methods.h"
+#include "../methods/mac/spatial_reuse_methods.h"
+
+#define BENCHMARK_NUM_NODES			100		///> Default number of nodes
+#define BENCHMARK_NUM_EVENTS		20000	///> Default number of events
+#define BENCHMARK_ONGOING_FRAMES	2		///> Frames that overlap the one starting at every event
+#define BENCHMARK_AREA_SIDE			40		///> Side of the deployment area [m]
+#define BENCHMARK_NODES_PER_BSS		10		///> Nodes sharing a BSS color
+#define BENCHMARK_CAPTURE_EFFECT	10		///> Capture effect threshold (linear, i.e., 10 dB)
+
+// Bytes of the notifications passed by value (legacy receive path)
+static long long bytes_copied;
+
+// Receive path with the notifications passed by value, as it used to be
+void UpdateChannelsPowerByValue(double **channel_power, Notification notification, int update_type,
+		int adjacent_channel_model, double pw_received){
+	bytes_copied += sizeof(notification);
+	UpdateChannelsPower(channel_power, notification, update_type, 0, 0, adjacent_channel_model, pw_received, 0);
+}
+
+int CheckPacketOriginByValue(Notification notification, int bss_color, int srg){
+	bytes_copied += sizeof(notification);
+	return CheckPacketOrigin(notification, bss_color, srg);
+}
+
+void ComputeMaxInterferenceByValue(double *max_pw_interference, int *channel_max_interference,
+		Notification notification_interest, const InterferenceSet &power_received_per_node, double **channel_power){
+	bytes_copied += sizeof(notification_interest);
+	ComputeMaxInterference(max_pw_interference, channel_max_interference, notification_interest, STATE_SENSING,
+		power_received_per_node, channel_power);
+}
+
+int IsPacketLostByValue(int primary_channel, Notification incoming_notification, Notification new_notification,
+		double sinr, double pd, double power_rx_interest, int node_id, CostRandomStream *random_stream){
+	bytes_copied += sizeof(incoming_notification) + sizeof(new_notification);
+	return IsPacketLost(primary_channel, incoming_notification, new_notification, sinr, BENCHMARK_CAPTURE_EFFECT, pd,
+		power_rx_interest, 0, node_id, CE_DEFAULT, random_stream);
+}
+
+// State of a node sensing the channel
+struct BenchmarkReceiver
+{
+	double *channel_power;
+	InterferenceSet power_received_per_node;
+	CostRandomStream random_stream;
+	int bss_color;
+};
+
+/**
+ * Run the events of the benchmark
+ * @param "by_value" [type int]: 1 to pass the notifications by value, 0 to read them in place
+ * @param "frames" [type std::vector<NotificationFrame>&]: frame transmitted by each node
+ * @param "path_gain" [type std::vector<double>&]: path gain between every pair of nodes
+ * @param "num_events" [type int]: number of events
+ * @param "receivers" [type std::vector<BenchmarkReceiver>&]: state of every node
+ * @return "num_decoded" [type long long]: frames that could be decoded (the same with both paths)
+ */
+long long RunReceivePath(int by_value, const std::vector<NotificationFrame> &frames,
+		const std::vector<double> &path_gain, int num_events, std::vector<BenchmarkReceiver> &receivers){
+
+	int num_nodes (frames.size());
+	long long num_decoded (0);
+	double pd (ConvertPower(DBM_TO_PW, -82));
+
+	for (int e = 0; e < num_events + BENCHMARK_ONGOING_FRAMES; ++e) {
+		for (int start_or_finish = 0; start_or_finish < 2; ++start_or_finish) {
+			int event (start_or_finish == 0 ? e : e - BENCHMARK_ONGOING_FRAMES);
+			if (event < 0 || (start_or_finish == 0 && event >= num_events)) continue;
+			const NotificationFrame &frame = frames[event % num_nodes];
+			for (int n = 0; n < num_nodes; ++n) {
+				if (n == frame.source_id) continue;
+				BenchmarkReceiver &rx = receivers[n];
+				double pw_received (frame.tx_info.tx_power * path_gain[frame.source_id * num_nodes + n]);
+
+				if (start_or_finish == 1) {
+					if (by_value) {
+						UpdateChannelsPowerByValue(&rx.channel_power, frame, TX_FINISHED, ADJACENT_CHANNEL_BOUNDARY,
+							pw_received);
+					} else {
+						UpdateChannelsPower(&rx.channel_power, frame, TX_FINISHED, 0, 0, ADJACENT_CHANNEL_BOUNDARY,
+							pw_received, 0);
+					}
+					rx.power_received_per_node.Erase(frame.source_id);
+					continue;
+				}
+
+				rx.power_received_per_node.Set(frame.source_id, pw_received);
+				double max_pw_interference;
+				int channel_max_interference;
+				int loss_reason;
+				if (by_value) {
+					UpdateChannelsPowerByValue(&rx.channel_power, frame, TX_INITIATED, ADJACENT_CHANNEL_BOUNDARY,
+						pw_received);
+					CheckPacketOriginByValue(frame, rx.bss_color, 0);
+					ComputeMaxInterferenceByValue(&max_pw_interference, &channel_max_interference, frame,
+						rx.power_received_per_node, &rx.channel_power);
+					double sinr (UpdateSINR(pw_received, max_pw_interference));
+					loss_reason = IsPacketLostByValue(0, frame, frame, sinr, pd, pw_received, n, &rx.random_stream);
+				} else {
+					UpdateChannelsPower(&rx.channel_power, frame, TX_INITIATED, 0, 0, ADJACENT_CHANNEL_BOUNDARY,
+						pw_received, 0);
+					CheckPacketOrigin(frame, rx.bss_color, 0);
+					ComputeMaxInterference(&max_pw_interference, &channel_max_interference, frame, STATE_SENSING,
+						rx.power_received_per_node, &rx.channel_power);
+					double sinr (UpdateSINR(pw_received, max_pw_interference));
+					loss_reason = IsPacketLost(0, frame, frame, sinr, BENCHMARK_CAPTURE_EFFECT, pd, pw_received, 0, n,
+						CE_DEFAULT, &rx.random_stream);
+				}
+				if (loss_reason == PACKET_NOT_LOST) ++num_decoded;
+			}
+		}
+	}
+	return num_decoded;
+}
+
+/**
+ * Set up the nodes (same seed, so that both paths draw the same random numbers)
+ */
+void ResetReceivers(std::vector<BenchmarkReceiver> &receivers){
+	for (size_t n = 0; n < receivers.size(); ++n) {
+		for (int c = 0; c < NUM_CHANNELS_KOMONDOR; ++c) receivers[n].channel_power[c] = 0;
+		receivers[n].power_received_per_node.Free();
+		receivers[n].power_received_per_node.Allocate(receivers.size());
+		receivers[n].random_stream.Seed(1, 0, n);
+	}
+}
+
+int main(int argc, char *argv[]){
+
+	int num_nodes (argc > 1 ? atoi(argv[1]) : BENCHMARK_NUM_NODES);
+	int num_events (argc > 2 ? atoi(argv[2]) : BENCHMARK_NUM_EVENTS);
+	if (num_nodes < 2 || num_events < 1) {
+		printf("ERROR: Usage: ./receive_path_benchmark [num_nodes >= 2] [num_events >= 1]\n");
+		exit(-1);
+	}
+
+	// Nodes placed uniformly at random, every one with a frame of its own
+	CostRandomStream random_stream;
+	random_stream.Seed(1, 0, 0);
+	std::vector<double> x(num_nodes), y(num_nodes);
+	for (int n = 0; n < num_nodes; ++n) {
+		x[n] = BENCHMARK_AREA_SIDE * (double) random_stream.Rand() / RAND_MAX;
+		y[n] = BENCHMARK_AREA_SIDE * (double) random_stream.Rand() / RAND_MAX;
+	}
+	std::vector<double> path_gain(num_nodes * num_nodes, 0);
+	for (int a = 0; a < num_nodes; ++a) {
+		for (int b = 0; b < num_nodes; ++b) {
+			if (a == b) continue;
+			double distance (sqrt(pow(x[a] - x[b], 2) + pow(y[a] - y[b], 2)));
+			path_gain[a * num_nodes + b] = ComputePowerReceived(distance, 1, 5.25 * pow(10, 9),
+				PATH_LOSS_SCENARIO_1_TGax, &random_stream);
+		}
+	}
+
+	std::vector<NotificationFrame> frames(num_nodes);
+	for (int n = 0; n < num_nodes; ++n) {
+		NotificationFrame &frame = frames[n];
+		memset(&frame, 0, sizeof(frame));
+		frame.packet_type = PACKET_TYPE_DATA;
+		frame.source_id = n;
+		frame.destination_id = (n + 1) % num_nodes;
+		frame.left_channel = 0;
+		frame.right_channel = 3;
+		frame.tx_info.tx_power = ConvertPower(DBM_TO_PW, 20);
+		frame.tx_info.bss_color = 1 + n / BENCHMARK_NODES_PER_BSS;
+		frame.tx_info.srg = -1;
+		frame.references = 1;
+	}
+
+	std::vector<BenchmarkReceiver> receivers(num_nodes);
+	for (int n = 0; n < num_nodes; ++n) {
+		receivers[n].channel_power = new double[NUM_CHANNELS_KOMONDOR];
+		receivers[n].power_received_per_node.Allocate(num_nodes);
+		receivers[n].bss_color = 1 + n / BENCHMARK_NODES_PER_BSS;
+	}
+
+	printf("Receive path: %d nodes, %d events (frame starts), %d frames overlapping each one\n",
+		num_nodes, num_events, BENCHMARK_ONGOING_FRAMES);
+	printf("  sizeof(Notification) = %d bytes, sizeof(NotificationFrame) = %d bytes\n",
+		(int) sizeof(Notification), (int) sizeof(NotificationFrame));
+	printf("  %-28s %20s %18s\n", "", "bytes copied/event", "time/event [us]");
+
+	long long num_decoded[2];
+	for (int by_value = 1; by_value >= 0; --by_value) {
+		ResetReceivers(receivers);
+		bytes_copied = 0;
+		struct timespec start, stop;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		num_decoded[by_value] = RunReceivePath(by_value, frames, path_gain, num_events, receivers);
+		clock_gettime(CLOCK_MONOTONIC, &stop);
+		double elapsed ((stop.tv_sec - start.tv_sec) + (stop.tv_nsec - start.tv_nsec) * pow(10, -9));
+		printf("  %-28s %20.1f %18.3f\n", by_value ? "by value (legacy)" : "in place (shared frame)",
+			(double) bytes_copied / num_events, elapsed / num_events * pow(10, 6));
+	}
+	printf("  Frames decoded: %lld by value, %lld in place\n", num_decoded[1], num_decoded[0]);
+
+	if (num_decoded[1] != num_decoded[0]) {
+		printf("ERROR: Both receive paths must decode the same frames\n");
+		exit(-1);
+	}
+	for (int n = 0; n < num_nodes; ++n) {
+		delete[] receivers[n].channel_power;
+		receivers[n].power_received_per_node.Free();
+	}
+	return 0;
+}
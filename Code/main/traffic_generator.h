@@ -55,6 +55,7 @@
 
 #include "../list_of_macros.h"
 #include "../methods/utils/auxiliary_methods.h"
+#include "../structures/checkpoint_file.h"
 
 // Agent component: "TypeII" represents components that are aware of the existence of the simulated time.
 component TrafficGenerator : public TypeII{
@@ -68,6 +69,7 @@ component TrafficGenerator : public TypeII{
 		// Generic
 		void InitializeTrafficGenerator();
 		void GenerateTraffic();
+		void Checkpoint(CheckpointFile &file);
 //		void NewPacketGenerated();
 
 	// Public items (entered by agents constructor in komondor_main)
@@ -96,6 +98,8 @@ component TrafficGenerator : public TypeII{
 		// Connect the timer with the inport method
 		TrafficGenerator () {
 			connect trigger_new_packet_generated.to_component,NewPacketGenerated;
+			// Names of the handlers in the engine profile (--profile)
+			trigger_new_packet_generated.ProfileName("TrafficGenerator::NewPacketGenerated");
 		}
 
 };
@@ -125,6 +129,19 @@ void TrafficGenerator :: Stop(){
 
 };
 
+/**
+ * Save the state of the traffic generator to a checkpoint, or restore it (once it has started)
+ * @param "file" [type CheckpointFile&]: checkpoint being written or read
+ */
+void TrafficGenerator :: Checkpoint(CheckpointFile &file){
+	file.Field(traffic_model);
+	file.Field(traffic_load);
+	file.Field(burst_rate);
+	file.Field(num_bursts);
+	CHECKPOINT_TIMER(file, trigger_new_packet_generated);
+	file.RandomStream(random_stream);
+}
+
 /**
  * Main method for generating traffic
  */
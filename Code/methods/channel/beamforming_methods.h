@@ -20,6 +20,10 @@
  * Usage:
  *   Called from UpdatePowerSensedPerNode() via ComputeRxBeamGain().
  *   Beam parameters are embedded per-TXOP in TxInfo by GenerateNotification().
+ *   The transmitter computes the weights of each beamformed DATA frame
+ *   once (ComputeTxBeamWeights) and evaluates the gain toward all the
+ *   nodes sensing it in a batch (EvaluateBeamGains), both attached to
+ *   the frame shared by the receivers (see Node::SendStartTX).
  * -----------------------------------------------------------------
  */
 
@@ -30,10 +34,6 @@
 #include "../../structures/notification.h"
 #include "../../list_of_macros.h"
 
-/* Maximum ULA elements supported by stack arrays in this file.
- * Increase if needed; 32 covers all practical 802.11ax cases. */
-#define BF_MAX_N_ELEMENTS  32
-
 /* ---------------------------------------------------------------
  * ComputeDirectionAzimuth
  *   Returns the azimuth angle [rad] of the direction (dx, dy, dz).
@@ -153,20 +153,6 @@ static void ComputeBeamWeights(double az_main_rad,
 	}
 }
 
-/* ---------------------------------------------------------------
- * EvaluateBeamGain
- *   Returns |AF(az_rad)|² = |w'·a(az_rad)|² (linear power gain).
- *   Unity gain (1.0) in the main beam direction after normalization.
- * --------------------------------------------------------------- */
-static double EvaluateBeamGain(const double *w_real, const double *w_imag,
-		double az_rad, int N, double d) {
-	double a_real[BF_MAX_N_ELEMENTS], a_imag[BF_MAX_N_ELEMENTS];
-	ComputeULASteeringVector(az_rad, N, d, a_real, a_imag);
-	double af_r, af_i;
-	ComplexDot(w_real, w_imag, a_real, a_imag, N, &af_r, &af_i);
-	return af_r * af_r + af_i * af_i;
-}
-
 /* ---------------------------------------------------------------
  * Maximum number of ZF constraints (desired + nulls).
  * Must be > MAX_BEAM_NULLS + 1 so the Gram matrix can always hold
@@ -356,24 +342,113 @@ static void ComputeZFBeamWeights(double az_main_rad,
 	}
 }
 
+/* ---------------------------------------------------------------
+ * ComputeTxBeamWeights
+ *   Computes the weights of the transmitter's ULA for the beam
+ *   parameters embedded in tx_info (ZF precoding if beam_use_zf,
+ *   projection null-steering otherwise).  Called once per
+ *   beamformed DATA frame by the transmitter; the frame points
+ *   to them (NotificationFrame::beam_weights).
+ *   N is capped at BF_MAX_N_ELEMENTS.
+ * --------------------------------------------------------------- */
+static void ComputeTxBeamWeights(const TxInfo &tx_info, BeamWeights *weights) {
+	int N = tx_info.beam_N_elements;
+	if (N > BF_MAX_N_ELEMENTS) N = BF_MAX_N_ELEMENTS;
+	if (N < 1) N = 1;
+	weights->num_elements = N;
+
+	if (tx_info.beam_use_zf) {
+		ComputeZFBeamWeights(tx_info.beam_az_main_rad,
+			tx_info.beam_null_az_rad, tx_info.beam_num_nulls,
+			N, tx_info.beam_d_spacing,
+			weights->real, weights->imag);
+	} else {
+		ComputeBeamWeights(tx_info.beam_az_main_rad,
+			tx_info.beam_null_az_rad, tx_info.beam_num_nulls,
+			N, tx_info.beam_d_spacing,
+			weights->real, weights->imag);
+	}
+}
+
+/* ---------------------------------------------------------------
+ * Number of azimuths evaluated together by EvaluateBeamGains()
+ * (size of its stack buffers).
+ * --------------------------------------------------------------- */
+#define BF_GAIN_BATCH  64
+
+/* ---------------------------------------------------------------
+ * EvaluateBeamGains
+ *   Fills gains[k] with |AF(az_rad[k])|² = |w'·a(az_rad[k])|²
+ *   (linear power gain) for k = 0..count-1.  Unity gain in the main
+ *   beam direction after normalization.
+ *
+ *   The azimuths are processed as a structure of arrays: sin(az)
+ *   of the whole batch first, then the array factor of every
+ *   azimuth is accumulated element by element, so that the inner
+ *   loops run over contiguous arrays without dependencies between
+ *   azimuths (vectorisable).  The terms are added in the same
+ *   order as ComplexDot(w, a(az)), hence each gain does not depend
+ *   on the batch it is evaluated in.
+ * --------------------------------------------------------------- */
+static void EvaluateBeamGains(const BeamWeights &weights, double d,
+		const double *az_rad, int count, double *gains) {
+	double sin_az[BF_GAIN_BATCH];
+	double af_r[BF_GAIN_BATCH], af_i[BF_GAIN_BATCH];
+	int N = weights.num_elements;
+
+	for (int first = 0; first < count; first += BF_GAIN_BATCH) {
+		int size = count - first;
+		if (size > BF_GAIN_BATCH) size = BF_GAIN_BATCH;
+		int k;
+
+		for (k = 0; k < size; ++k) {
+			sin_az[k] = sin(az_rad[first + k]);
+			af_r[k] = 0.0;
+			af_i[k] = 0.0;
+		}
+
+		for (int n = 0; n < N; ++n) {
+			double w_r = weights.real[n], w_i = weights.imag[n];
+			for (k = 0; k < size; ++k) {
+				double phase = 2.0 * M_PI * d * n * sin_az[k];
+				double a_r = cos(phase), a_i = sin(phase);
+				af_r[k] += w_r * a_r + w_i * a_i;
+				af_i[k] += w_r * a_i - w_i * a_r;
+			}
+		}
+
+		for (k = 0; k < size; ++k) {
+			gains[first + k] = af_r[k] * af_r[k] + af_i[k] * af_i[k];
+		}
+	}
+}
+
 /* ---------------------------------------------------------------
  * ComputeRxBeamGain
  *   Top-level function called by UpdatePowerSensedPerNode().
  *
- *   Given the transmitter's beam parameters (embedded in tx_info)
- *   and the receiver's position (rx_x, rx_y, rx_z), returns the
- *   linear power gain factor to apply to the path-loss-based
+ *   Given the beamformed frame (transmitter's beam parameters in
+ *   tx_info) and the receiver (rx_id at rx_x, rx_y, rx_z), returns
+ *   the linear power gain factor to apply to the path-loss-based
  *   received power.
  *
+ *   Uses, in this order, the gain evaluated by the transmitter for
+ *   all its receivers at once, the weights attached to the frame,
+ *   or weights computed here (frames created without them).
+ *
  *   Returns 1.0 if beamforming is disabled or N_elements <= 1.
  *   Uses ZF precoding (beam_use_zf=1) for Co-BF and projection
  *   null-steering (beam_use_zf=0) for standalone beamforming.
  * --------------------------------------------------------------- */
-static double ComputeRxBeamGain(const TxInfo &tx_info,
+static double ComputeRxBeamGain(const NotificationFrame &frame, int rx_id,
 		double rx_x, double rx_y, double rx_z) {
+	const TxInfo &tx_info = frame.tx_info;
 	if (!tx_info.beamforming_active || tx_info.beam_N_elements <= 1)
 		return 1.0;
 
+	if (frame.beam_gain_per_node != NULL)
+		return frame.beam_gain_per_node[rx_id];
+
 	double dx = rx_x - tx_info.x;
 	double dy = rx_y - tx_info.y;
 	double dz = rx_z - tx_info.z;
@@ -383,24 +458,15 @@ static double ComputeRxBeamGain(const TxInfo &tx_info,
 
 	double az_rx = ComputeDirectionAzimuth(dx, dy, dz);
 
-	int N = tx_info.beam_N_elements;
-	if (N > BF_MAX_N_ELEMENTS) N = BF_MAX_N_ELEMENTS;
-
-	double w_real[BF_MAX_N_ELEMENTS], w_imag[BF_MAX_N_ELEMENTS];
-
-	if (tx_info.beam_use_zf) {
-		ComputeZFBeamWeights(tx_info.beam_az_main_rad,
-			tx_info.beam_null_az_rad, tx_info.beam_num_nulls,
-			N, tx_info.beam_d_spacing,
-			w_real, w_imag);
+	double gain;
+	if (frame.beam_weights != NULL) {
+		EvaluateBeamGains(*frame.beam_weights, tx_info.beam_d_spacing, &az_rx, 1, &gain);
 	} else {
-		ComputeBeamWeights(tx_info.beam_az_main_rad,
-			tx_info.beam_null_az_rad, tx_info.beam_num_nulls,
-			N, tx_info.beam_d_spacing,
-			w_real, w_imag);
+		BeamWeights weights;
+		ComputeTxBeamWeights(tx_info, &weights);
+		EvaluateBeamGains(weights, tx_info.beam_d_spacing, &az_rx, 1, &gain);
 	}
-
-	return EvaluateBeamGain(w_real, w_imag, az_rx, N, tx_info.beam_d_spacing);
+	return gain;
 }
 
 #endif /* BEAMFORMING_METHODS_H */
@@ -31,7 +31,8 @@
  *            node_params.max_channel_allowed, &channel_power, effective_pd,
  *            timestamp_channel_becomes_free, SimTime(), PIFS,
  *            node_params.current_dcb_policy, NUM_CHANNELS_KOMONDOR,
- *            channel_aggregation_cca_model, channels_for_tx);
+ *            channel_aggregation_cca_model, channels_for_tx, &pp_punctured_bitmap,
+ *            &random_stream);
  *
  * Dependencies: power_channel_methods.h (GetChannelOccupancyByCCA),
  *               channel_bonding_methods.h (GetTxChannels).
@@ -75,7 +76,8 @@ struct ChannelAccessPolicy {
 		int    num_channels_komondor,
 		int    channel_aggregation_cca_model,
 		int   *channels_for_tx,
-		int   *punctured_bitmap_out);
+		int   *punctured_bitmap_out,
+		CostRandomStream *random_stream);
 };
 
 /**
@@ -101,7 +103,8 @@ static void CSMA_CA_CheckAndSelectChannels(
 		int    num_channels_komondor,
 		int    channel_aggregation_cca_model,
 		int   *channels_for_tx,
-		int   *punctured_bitmap_out)
+		int   *punctured_bitmap_out,
+		CostRandomStream *random_stream)
 {
 	if (punctured_bitmap_out) *punctured_bitmap_out = 0;
 
@@ -115,7 +118,7 @@ static void CSMA_CA_CheckAndSelectChannels(
 		channels_for_tx, dcb_policy, channels_free,
 		min_channel_allowed, max_channel_allowed, primary_channel,
 		num_channels_komondor, channel_power, channel_aggregation_cca_model,
-		NULL);
+		NULL, random_stream);
 }
 
 /**
@@ -141,7 +144,8 @@ static void PP_CheckAndSelectChannels(
 		int    num_channels_komondor,
 		int    channel_aggregation_cca_model,
 		int   *channels_for_tx,
-		int   *punctured_bitmap_out)
+		int   *punctured_bitmap_out,
+		CostRandomStream *random_stream)
 {
 	// Populate channels_free[] for logging (primary-CCA based).
 	GetChannelOccupancyByCCA(
@@ -185,7 +189,8 @@ static void DSO_CheckAndSelectChannels(
 		int    num_channels_komondor,
 		int    channel_aggregation_cca_model,
 		int   *channels_for_tx,
-		int   *punctured_bitmap_out)
+		int   *punctured_bitmap_out,
+		CostRandomStream *random_stream)
 {
 	if (punctured_bitmap_out) *punctured_bitmap_out = 0;
 
@@ -200,7 +205,7 @@ static void DSO_CheckAndSelectChannels(
 		channels_for_tx, CB_ALWAYS_MAX_LOG2, channels_free,
 		min_channel_allowed, max_channel_allowed, primary_channel,
 		num_channels_komondor, channel_power, channel_aggregation_cca_model,
-		NULL);
+		NULL, random_stream);
 }
 
 #endif /* CHANNEL_ACCESS_METHODS_H */
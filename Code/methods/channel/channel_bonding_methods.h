@@ -366,10 +366,11 @@ void GetTxChannelsByChannelBondingCCA11ax(int *channels_for_tx, int channel_bond
  * @param "max_channel_allowed"   [type int]:     rightmost allowed channel
  * @param "primary_channel"       [type int]:     primary channel
  * @param "num_channels_system"   [type int]:     total number of channels in the system
+ * @param "random_stream"         [type CostRandomStream*]: random number stream of the node (CB_PROB_UNIFORM_LOG2)
  */
 void GetTxChannelsByChannelBondingCCASame(int *channels_for_tx, int channel_bonding_model,
 		int *channels_free, int min_channel_allowed, int max_channel_allowed,
-		int primary_channel, int num_channels_system) {
+		int primary_channel, int num_channels_system, CostRandomStream *random_stream) {
 
 	// Reset channels for transmitting
 	for (int c = 0; c < NUM_CHANNELS_KOMONDOR; ++c) channels_for_tx[c] = FALSE;
@@ -513,7 +514,7 @@ void GetTxChannelsByChannelBondingCCASame(int *channels_for_tx, int channel_bond
 		// Log2 probabilistic uniform: pick with equal probability any available channel range
 		case CB_PROB_UNIFORM_LOG2: {
 			int ch_range_ix = GetNumberOfSpecificElementInArray(1, possible_channel_ranges_ixs, 4);
-			int random_value = 1 + rand() % ch_range_ix;
+			int random_value = 1 + random_stream->Rand() % ch_range_ix;
 
 			channels_for_tx[primary_channel] = TRUE;  // primary is always included
 
@@ -720,7 +721,7 @@ void GetTxChannelsByDSO(int *dso_channels_for_tx, int *dso_tx_flag,
 void GetTxChannels(int *channels_for_tx, int channel_bonding_model, int *channels_free,
 		int min_channel_allowed, int max_channel_allowed, int primary_channel,
 		int num_channels_komondor, double **channel_power, int channel_aggregation_cca_model,
-		int *punctured_bitmap_out) {
+		int *punctured_bitmap_out, CostRandomStream *random_stream) {
 
 	if (punctured_bitmap_out) *punctured_bitmap_out = 0;
 
@@ -736,7 +737,7 @@ void GetTxChannels(int *channels_for_tx, int channel_bonding_model, int *channel
 	switch (channel_aggregation_cca_model) {
 		case CHANNEL_AGGREGATION_CCA_SAME: {
 			GetTxChannelsByChannelBondingCCASame(channels_for_tx, channel_bonding_model, channels_free,
-					min_channel_allowed, max_channel_allowed, primary_channel, num_channels_komondor);
+					min_channel_allowed, max_channel_allowed, primary_channel, num_channels_komondor, random_stream);
 			break;
 		}
 		case CHANNEL_AGGREGATION_CCA_11AX: {
@@ -28,6 +28,8 @@
 
 #include "../../list_of_macros.h"
 #include "../../structures/modulations.h"
+#include "../../structures/topology.h"
+#include "../../structures/interference_set.h"
 #include "../utils/auxiliary_methods.h"
 #include "beamforming_methods.h"
 
@@ -115,11 +117,11 @@ static double PathLoss_OkumuraHata(double tx_power, double distance, double wave
 	return ConvertPower(DBM_TO_PW, tx_power_dbm + ANTENNA_TX_GAIN_DB + ANTENNA_RX_GAIN_DB - path_loss);
 }
 
-static double PathLoss_Indoor(double tx_power, double distance) {
+static double PathLoss_Indoor(double tx_power, double distance, CostRandomStream *random_stream) {
 	double tx_power_dbm = ConvertPower(PW_TO_DBM, tx_power);
 	double path_loss_factor (5), shadowing (9.5), obstacles (30), walls_frequency (5), alpha (4.4);
-	double shadowing_at_wlan  = (((double) rand())/RAND_MAX) * shadowing;
-	double obstacles_at_wlan  = (((double) rand())/RAND_MAX) * obstacles;
+	double shadowing_at_wlan  = (((double) random_stream->Rand())/RAND_MAX) * shadowing;
+	double obstacles_at_wlan  = (((double) random_stream->Rand())/RAND_MAX) * obstacles;
 	double path_loss = path_loss_factor + 10*alpha*log10(distance)
 	                 + shadowing_at_wlan + (distance/walls_frequency)*obstacles_at_wlan;
 	return ConvertPower(DBM_TO_PW, tx_power_dbm + ANTENNA_TX_GAIN_DB + ANTENNA_RX_GAIN_DB - path_loss);
@@ -152,13 +154,14 @@ static double PathLoss_TGax_Scenario1(double tx_power, double distance, double c
 }
 
 // Enterprise — TGax scenario #2
-static double PathLoss_TGax_Scenario2(double tx_power, double distance, double central_frequency) {
+static double PathLoss_TGax_Scenario2(double tx_power, double distance, double central_frequency,
+		CostRandomStream *random_stream) {
 	double tx_power_dbm = ConvertPower(PW_TO_DBM, tx_power);
 	double f_walls = 12.0/20;
 	double min_d = (distance > 10) ? 10.0 : distance;
 	double cf_ghz = central_frequency / pow(10, 9);
 	double shadowing (5);
-	double shadowing_at_wlan = (((double) rand())/RAND_MAX) * shadowing;
+	double shadowing_at_wlan = (((double) random_stream->Rand())/RAND_MAX) * shadowing;
 	double LFS = 40.05 + 20*log10(cf_ghz/2.4) + 20*log10(min_d)
 	           + 7*(distance*f_walls) + shadowing_at_wlan;
 	int d_BP (1);
@@ -241,10 +244,11 @@ static double PathLoss_TMB(double tx_power, double distance) {
 * @param "tx_power"           [type double]: transmission power in pW
 * @param "central_frequency"  [type double]: central frequency in Hz
 * @param "path_loss_model"    [type int]:    path loss model identifier
+* @param "random_stream"      [type CostRandomStream*]: random number stream of the link (shadowing, obstacles)
 * @return                     [type double]: received power in pW
 */
 double ComputePowerReceived(double distance, double tx_power, double central_frequency,
-                            int path_loss_model) {
+                            int path_loss_model, CostRandomStream *random_stream) {
 	double wavelength = (double) SPEED_LIGHT / central_frequency;
 
 	switch (path_loss_model) {
@@ -253,13 +257,13 @@ double ComputePowerReceived(double distance, double tx_power, double central_fre
 		case PATH_LOSS_OKUMURA_HATA:
 			return PathLoss_OkumuraHata(tx_power, distance, wavelength);
 		case PATH_LOSS_INDOOR:
-			return PathLoss_Indoor(tx_power, distance);
+			return PathLoss_Indoor(tx_power, distance, random_stream);
 		case PATH_LOSS_INDOOR_2:
 			return PathLoss_Indoor2(tx_power, distance);
 		case PATH_LOSS_SCENARIO_1_TGax:
 			return PathLoss_TGax_Scenario1(tx_power, distance, central_frequency);
 		case PATH_LOSS_SCENARIO_2_TGax:
-			return PathLoss_TGax_Scenario2(tx_power, distance, central_frequency);
+			return PathLoss_TGax_Scenario2(tx_power, distance, central_frequency, random_stream);
 		case PATH_LOSS_SCENARIO_3_TGax:
 			return PathLoss_TGax_Scenario3(tx_power, distance, central_frequency);
 		case PATH_LOSS_SCENARIO_4_TGax:
@@ -280,6 +284,34 @@ double ComputePowerReceived(double distance, double tx_power, double central_fre
 	}
 }
 
+/**
+* Compute the path gain (linear) of a link. All the path loss models are linear in the TX power, so the power
+* received for any TX power is the TX power times this gain.
+* @param "power_received"     [type double]: power received at the default TX power in pW
+* @param "distance"           [type double]: distance in metres
+* @param "tx_power"           [type double]: default transmission power in pW
+* @param "central_frequency"  [type double]: central frequency in Hz
+* @param "path_loss_model"    [type int]:    path loss model identifier
+* @param "random_stream"      [type CostRandomStream*]: random number stream of the link (shadowing, obstacles)
+* @return                     [type double]: path gain (linear)
+*/
+double ComputePathGain(double power_received, double distance, double tx_power, double central_frequency,
+                       int path_loss_model, CostRandomStream *random_stream) {
+	if (tx_power > 0) return power_received / tx_power;
+	// Non-valid TX power (rejected later by the input checker): use a 1 pW reference
+	return ComputePowerReceived(distance, 1, central_frequency, path_loss_model, random_stream);
+}
+
+/**
+* Indicate whether a path loss model draws random numbers (shadowing, obstacles), so that the channel depends
+* on the seed of the simulation
+* @param "path_loss_model"    [type int]:    path loss model identifier
+* @return                     [type int]:    1 if the channel depends on the seed, 0 otherwise
+*/
+int PathLossDependsOnSeed(int path_loss_model) {
+	return path_loss_model == PATH_LOSS_INDOOR || path_loss_model == PATH_LOSS_SCENARIO_2_TGax;
+}
+
 // ===========================================================================
 // Transmission power per channel
 // ===========================================================================
@@ -346,11 +378,13 @@ void GetChannelOccupancyByCCA(int primary_channel, int pifs_activated, int *chan
 
 /**
 * Update the power sensed from each node on the primary channel
+* @param "notification" [type NotificationFrame]: frame whose transmission starts or finishes
+* @param "rx_id" [type int]: node sensing the frame (whose position is rx_x, rx_y, rx_z)
 */
-void UpdatePowerSensedPerNode(int primary_channel, std::map<int,double> &power_received_per_node,
-	Notification notification, double central_frequency, int path_loss_model,
+void UpdatePowerSensedPerNode(int primary_channel, InterferenceSet &power_received_per_node,
+	const NotificationFrame &notification, double central_frequency, int path_loss_model,
 	double pw_received, int start_or_finish,
-	double rx_x, double rx_y, double rx_z) {
+	int rx_id, double rx_x, double rx_y, double rx_z) {
 
 	// Preamble puncturing: if the receiver's primary channel is punctured in this PPDU,
 	// the sender contributes zero power there — treat as if out of channel range.
@@ -365,14 +399,14 @@ void UpdatePowerSensedPerNode(int primary_channel, std::map<int,double> &power_r
 				if (notification.tx_info.beamforming_active
 						&& notification.tx_info.beam_N_elements > 1
 						&& notification.packet_type == PACKET_TYPE_DATA) {
-					effective_power *= ComputeRxBeamGain(notification.tx_info,
-						rx_x, rx_y, rx_z);
+					effective_power *= ComputeRxBeamGain(notification,
+						rx_id, rx_x, rx_y, rx_z);
 				}
-				power_received_per_node[notification.source_id] = effective_power;
+				power_received_per_node.Set(notification.source_id, effective_power);
 				break;
 			}
 			case TX_FINISHED:{
-				power_received_per_node.erase(notification.source_id);
+				power_received_per_node.Erase(notification.source_id);
 				break;
 			}
 			default:{
@@ -381,11 +415,11 @@ void UpdatePowerSensedPerNode(int primary_channel, std::map<int,double> &power_r
 			}
 		}
 	} else {
-		power_received_per_node.erase(notification.source_id);
+		power_received_per_node.Erase(notification.source_id);
 	}
 }
 
-void UpdateRssiPerSta(Wlan wlan, double *rssi_per_sta,
+void UpdateRssiPerSta(const Wlan &wlan, double *rssi_per_sta,
 		double *received_power_array, int total_nodes_number){
 	int id(0);
 	for (int i = 0; i < total_nodes_number; ++i) {
@@ -400,49 +434,50 @@ void UpdateRssiPerSta(Wlan wlan, double *rssi_per_sta,
 // Adjacent channel interference
 // ===========================================================================
 
+// Linear leakage masks: mask[c] is the fraction of the received power sensed at channel "c"
+// for a transmission in [left, right] without puncturing. Built once per adjacent channel model.
+static __thread double adjacent_channel_leakage_table[NUM_CHANNELS_KOMONDOR][NUM_CHANNELS_KOMONDOR][NUM_CHANNELS_KOMONDOR];
+static __thread int adjacent_channel_leakage_model = -1;
+
 /**
-* Apply a co-channel interference model to compute total power per channel
+* Compute the linear leakage mask of a transmission (20 dB of loss per channel of separation)
+* @param "adjacent_channel_model" [type int]:    adjacent channel interference model
+* @param "left_channel"           [type int]:    left channel used in the transmission
+* @param "right_channel"          [type int]:    right channel used in the transmission
+* @param "punctured_bitmap"       [type int]:    bitmask of punctured sub-channels (bit i=1 → silent)
+* @param "mask"                   [type double*]: leakage mask (output, NUM_CHANNELS_KOMONDOR entries)
 */
-void ApplyAdjacentChannelInterferenceModel(int adjacent_channel_model, double total_power[],
-	Notification notification, double central_frequency, double pw_received, int path_loss_model){
+void ComputeAdjacentChannelLeakageMask(int adjacent_channel_model, int left_channel, int right_channel,
+	int punctured_bitmap, double *mask){
+
+	for(int c = 0; c < NUM_CHANNELS_KOMONDOR; ++c) mask[c] = 0;
 
 	// Direct power on the TX channels.
 	// Preamble puncturing: punctured sub-channels carry no power (bit i=1 → silent).
-	for(int i = notification.left_channel; i <= notification.right_channel; ++i){
-		if(notification.tx_info.pp_punctured_bitmap & (1 << i)) continue;
-		total_power[i] = pw_received;
+	for(int i = left_channel; i <= right_channel; ++i){
+		if(punctured_bitmap & (1 << i)) continue;
+		mask[i] = 1;
 	}
 
-	double pw_loss_db, total_power_dbm;
-
 	switch(adjacent_channel_model){
 		case ADJACENT_CHANNEL_NONE:{
 			break;
 		}
 		case ADJACENT_CHANNEL_BOUNDARY:{
 			for(int c = 0; c < NUM_CHANNELS_KOMONDOR; ++c){
-				if(c < notification.left_channel || c > notification.right_channel){
-					int boundary = (c < notification.left_channel) ? notification.left_channel
-					                                               : notification.right_channel;
-					pw_loss_db      = 20 * abs(c - boundary);
-					total_power_dbm = ConvertPower(PW_TO_DBM, pw_received) - pw_loss_db;
-					total_power[c] += ConvertPower(DBM_TO_PW, total_power_dbm);
-					if(total_power[c] < MIN_VALUE_C_LANGUAGE) total_power[c] = 0;
+				if(c < left_channel || c > right_channel){
+					int boundary = (c < left_channel) ? left_channel : right_channel;
+					mask[c] += ConvertPower(DB_TO_LINEAR, -20 * abs(c - boundary));
 				}
 			}
 			break;
 		}
 		case ADJACENT_CHANNEL_EXTREME:{
 			for(int c = 0; c < NUM_CHANNELS_KOMONDOR; ++c){
-				for(int j = notification.left_channel; j <= notification.right_channel; ++j){
+				for(int j = left_channel; j <= right_channel; ++j){
 					// Preamble puncturing: no leakage from punctured source sub-channels.
-					if(notification.tx_info.pp_punctured_bitmap & (1 << j)) continue;
-					if(c != j){
-						pw_loss_db      = 20 * abs(c - j);
-						total_power_dbm = ConvertPower(PW_TO_DBM, pw_received) - pw_loss_db;
-						total_power[c] += ConvertPower(DBM_TO_PW, total_power_dbm);
-						if(total_power[c] < MIN_DOUBLE_VALUE_KOMONDOR) total_power[c] = 0;
-					}
+					if(punctured_bitmap & (1 << j)) continue;
+					if(c != j) mask[c] += ConvertPower(DB_TO_LINEAR, -20 * abs(c - j));
 				}
 			}
 			break;
@@ -454,34 +489,119 @@ void ApplyAdjacentChannelInterferenceModel(int adjacent_channel_model, double to
 	}
 }
 
+/**
+* Fill the leakage table for every channel range, unless already done for the given model
+* @param "adjacent_channel_model" [type int]: adjacent channel interference model
+*/
+void BuildAdjacentChannelLeakageTable(int adjacent_channel_model){
+	if(adjacent_channel_leakage_model == adjacent_channel_model) return;
+	for(int l = 0; l < NUM_CHANNELS_KOMONDOR; ++l){
+		for(int r = l; r < NUM_CHANNELS_KOMONDOR; ++r){
+			ComputeAdjacentChannelLeakageMask(adjacent_channel_model, l, r, 0,
+				adjacent_channel_leakage_table[l][r]);
+		}
+	}
+	adjacent_channel_leakage_model = adjacent_channel_model;
+}
+
+/**
+* Compute the power contributed by a transmission to each channel, according to the adjacent channel model
+* @param "adjacent_channel_model" [type int]:    adjacent channel interference model
+* @param "total_power"            [type double*]: power per channel in pW (output)
+* @param "pw_received"            [type double]: power received from the transmitter in pW
+* @param "left_channel"           [type int]:    left channel used in the transmission
+* @param "right_channel"          [type int]:    right channel used in the transmission
+* @param "punctured_bitmap"       [type int]:    bitmask of punctured sub-channels
+*/
+void ApplyAdjacentChannelInterferenceModel(int adjacent_channel_model, double total_power[],
+	double pw_received, int left_channel, int right_channel, int punctured_bitmap){
+
+	double punctured_mask[NUM_CHANNELS_KOMONDOR];
+	const double *mask;
+	if(punctured_bitmap == 0){
+		BuildAdjacentChannelLeakageTable(adjacent_channel_model);
+		mask = adjacent_channel_leakage_table[left_channel][right_channel];
+	} else {
+		ComputeAdjacentChannelLeakageMask(adjacent_channel_model, left_channel, right_channel,
+			punctured_bitmap, punctured_mask);
+		mask = punctured_mask;
+	}
+
+	for(int c = 0; c < NUM_CHANNELS_KOMONDOR; ++c){
+		total_power[c] = pw_received * mask[c];
+	}
+
+	// Leakage below the resolution of each model is neglected
+	if(adjacent_channel_model == ADJACENT_CHANNEL_BOUNDARY){
+		for(int c = 0; c < NUM_CHANNELS_KOMONDOR; ++c){
+			if((c < left_channel || c > right_channel) && total_power[c] < MIN_VALUE_C_LANGUAGE) total_power[c] = 0;
+		}
+	} else if(adjacent_channel_model == ADJACENT_CHANNEL_EXTREME){
+		for(int c = 0; c < NUM_CHANNELS_KOMONDOR; ++c){
+			if(total_power[c] < MIN_DOUBLE_VALUE_KOMONDOR) total_power[c] = 0;
+		}
+	}
+}
+
 /**
 * Update the aggregated power sensed per channel when a transmission starts or finishes
 */
-void UpdateChannelsPower(double **channel_power, Notification notification,
+void UpdateChannelsPower(double **channel_power, const Notification &notification,
     int update_type, double central_frequency, int path_loss_model,
 	int adjacent_channel_model, double pw_received, int node_id){
 
 	double total_power[NUM_CHANNELS_KOMONDOR];
-	memset(total_power, 0, NUM_CHANNELS_KOMONDOR * sizeof(double));
 
-	ApplyAdjacentChannelInterferenceModel(adjacent_channel_model, total_power,
-		notification, central_frequency, pw_received, path_loss_model);
+	ApplyAdjacentChannelInterferenceModel(adjacent_channel_model, total_power, pw_received,
+		notification.left_channel, notification.right_channel, notification.tx_info.pp_punctured_bitmap);
 
-	for(int c = 0; c < NUM_CHANNELS_KOMONDOR; ++c){
-		switch(update_type){
-			case TX_FINISHED:{
+	switch(update_type){
+		case TX_FINISHED:{
+			for(int c = 0; c < NUM_CHANNELS_KOMONDOR; ++c){
 				(*channel_power)[c] -= total_power[c];
 				if ((*channel_power)[c] < 0.000001) (*channel_power)[c] = 0;
-				break;
 			}
-			case TX_INITIATED:{
+			break;
+		}
+		case TX_INITIATED:{
+			for(int c = 0; c < NUM_CHANNELS_KOMONDOR; ++c){
 				(*channel_power)[c] += total_power[c];
-				break;
 			}
+			break;
 		}
 	}
 }
 
+/**
+* Recompute from scratch the aggregated power sensed per channel, so that the rounding errors
+* accumulated by the incremental updates of UpdateChannelsPower() are discarded
+* @param "channel_power"          [type double**]: power per channel in pW (output)
+* @param "adjacent_channel_model" [type int]:    adjacent channel interference model
+* @param "total_nodes_number"     [type int]:    number of nodes
+* @param "ongoing_tx_power"       [type double*]: power received from each ongoing transmission in pW (0 if none)
+* @param "ongoing_tx_left"        [type int*]:   left channel of each ongoing transmission
+* @param "ongoing_tx_right"       [type int*]:   right channel of each ongoing transmission
+* @param "ongoing_tx_punctured"   [type int*]:   punctured bitmap of each ongoing transmission
+*/
+void RecomputeChannelsPower(double **channel_power, int adjacent_channel_model, int total_nodes_number,
+	double *ongoing_tx_power, int *ongoing_tx_left, int *ongoing_tx_right, int *ongoing_tx_punctured){
+
+	double total_power[NUM_CHANNELS_KOMONDOR];
+
+	for(int c = 0; c < NUM_CHANNELS_KOMONDOR; ++c) (*channel_power)[c] = 0;
+	for(int n = 0; n < total_nodes_number; ++n){
+		if(ongoing_tx_power[n] == 0) continue;
+		ApplyAdjacentChannelInterferenceModel(adjacent_channel_model, total_power, ongoing_tx_power[n],
+			ongoing_tx_left[n], ongoing_tx_right[n], ongoing_tx_punctured[n]);
+		for(int c = 0; c < NUM_CHANNELS_KOMONDOR; ++c){
+			(*channel_power)[c] += total_power[c];
+		}
+	}
+	for(int c = 0; c < NUM_CHANNELS_KOMONDOR; ++c){
+		if ((*channel_power)[c] < 0.000001) (*channel_power)[c] = 0;
+	}
+}
+
 // ===========================================================================
 // SINR and interference
 // ===========================================================================
@@ -498,8 +618,8 @@ double UpdateSINR(double pw_received_interest, double max_pw_interference){
 * Find the maximum interference power across the channels of interest
 */
 void ComputeMaxInterference(double *max_pw_interference, int *channel_max_interference,
-	Notification notification_interest, int node_state,
-	std::map<int,double> &power_received_per_node, double **channel_power) {
+	const Notification &notification_interest, int node_state,
+	const InterferenceSet &power_received_per_node, double **channel_power) {
 
 	*max_pw_interference      = 0;
 	*channel_max_interference = notification_interest.left_channel;
@@ -512,12 +632,7 @@ void ComputeMaxInterference(double *max_pw_interference, int *channel_max_interf
 		 * (post-beamforming) power for DATA frames and raw power for control frames.
 		 * channel_power is kept raw (omnidirectional) for CCA/NAV so that DCF
 		 * carrier sense works correctly regardless of beam direction. */
-		std::map<int,double>::iterator _it;
-		for (_it = power_received_per_node.begin();
-		     _it != power_received_per_node.end(); ++_it) {
-			if (_it->first != notification_interest.source_id)
-				*max_pw_interference += _it->second;
-		}
+		*max_pw_interference = power_received_per_node.TotalPowerExcept(notification_interest.source_id);
 
 		/* Find channel with highest raw power for the log field only. */
 		for (int c = notification_interest.left_channel;
@@ -589,21 +704,22 @@ void PrintOrWriteChannelsFree(int write_or_print, int save_node_logs, int print_
 }
 
 void PrintOrWriteNodesTransmitting(int write_or_print, int save_node_logs, int print_node_logs,
-	Logger node_logger, int total_nodes_number, int *nodes_transmitting){
+	Logger node_logger, int total_nodes_number, const NodeSet &nodes_transmitting){
 	switch(write_or_print){
 		case PRINT_LOG:{
 			if(print_node_logs){
 				printf("Nodes transmitting: ");
 				for(int n = 0; n < total_nodes_number; ++n)
-					if(nodes_transmitting[n] == TRUE) printf("N%d  ", n);
+					if(nodes_transmitting.Contains(n)) printf("N%d  ", n);
 				printf("\n");
 			}
 			break;
 		}
 		case WRITE_LOG:{
+			if(!save_node_logs) break;
 			for(int n = 0; n < total_nodes_number; ++n)
-				if(save_node_logs && nodes_transmitting[n]) fprintf(node_logger.file, "N%d ", n);
-			if(save_node_logs) fprintf(node_logger.file, "\n");
+				if(nodes_transmitting.Contains(n)) fprintf(node_logger.file, "N%d ", n);
+			fprintf(node_logger.file, "\n");
 			break;
 		}
 	}
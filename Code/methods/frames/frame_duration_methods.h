@@ -54,19 +54,15 @@
 #include <stddef.h>
 #include "../../list_of_macros.h"
 
-// Exponential redefinition
-double	Random( double v=1.0)	{ return v*drand48();}
-int	Random( int v)	{ return (int)(v*drand48()); }
-double	Exponential(double mean){ return -mean*log(Random());}
-
 /**
 * Compute the transmission time (just link rate) according to the number of channels used and packet length
 * @param "total_bits" [type int]: total number bits to be transmitted
 * @param "data_rate" [type int]: data rate employed
 * @param "pdf_tx_time" [type int]: pdf type for computing the transmission type (PDF_DETERMINISTIC or PDF_EXPONENTIAL)
+* @param "random_stream" [type CostRandomStream*]: random number stream of the node (only for PDF_EXPONENTIAL)
 * @return "tx_time" [type double]: transmission time
 */
-double ComputeTxTime(int total_bits, double data_rate, int pdf_tx_time){
+double ComputeTxTime(int total_bits, double data_rate, int pdf_tx_time, CostRandomStream *random_stream){
 
 	double tx_time;
 
@@ -81,7 +77,7 @@ double ComputeTxTime(int total_bits, double data_rate, int pdf_tx_time){
 		}
 
 		case PDF_EXPONENTIAL:{
-			tx_time = Exponential(total_bits/data_rate);
+			tx_time = random_stream->Exponential(total_bits/data_rate);
 			break;
 		}
 
@@ -61,11 +61,6 @@
 #include "./channel_access/deterministic_backoff_methods.h"
 #include "./channel_access/eca_methods.h"
 
-// Exponential redefinition for convenience
-double	Random2( double v=1.0)	{ return v*drand48();}
-int		Random2( int v)		{ return (int)(v*drand48()); }
-double	Exponential2(double mean)	{ return -mean*log(Random2());}
-
 /**
 * Compute a new backoff value
 * @param "current_cw_min" [type int]: current minimum contention window
@@ -76,11 +71,12 @@ double	Exponential2(double mean)	{ return -mean*log(Random2());}
 * @param "num_bo_interruptions" [type int]: number of experienced BO interruptions (Only for BACKOFF_DETERMINISTIC_QUALCOMM)
 * @param "base_backoff_deterministic" [type int]: base backoff (Only for BACKOFF_DETERMINISTIC_QUALCOMM)
 * @param "previous_backoff" [type double]: previous employed backoff backoff (Only for BACKOFF_REPEAT_BO)
+* @param "random_stream" [type CostRandomStream*]: random number stream of the node
 * @return "backoff_time" [type double]: new generated backoff
 */
 double ComputeBackoff(int current_cw_min, int current_cw_max, int backoff_type,
 		int traffic_type, int deterministic_bo_active, int num_bo_interruptions, int base_backoff_deterministic,
-		double previous_backoff){
+		double previous_backoff, CostRandomStream *random_stream){
 
 	double backoff_time;
 
@@ -89,29 +85,30 @@ double ComputeBackoff(int current_cw_min, int current_cw_max, int backoff_type,
 		// Backoff "DCF" (CW and max. stage manually introduced) or Token-based
 		case BACKOFF_DCF:
 		case BACKOFF_TOKENIZED:
-			backoff_time = ComputeBackoffDCF(current_cw_min, current_cw_max);
+			backoff_time = ComputeBackoffDCF(current_cw_min, current_cw_max, random_stream);
 			break;
 
 		// EDCA for QoS traffic differentiation (BEB: CW state passed in via current_cw_min/max)
 		case BACKOFF_EDCA:
-			backoff_time = ComputeBackoffEDCA(current_cw_min, current_cw_max);
+			backoff_time = ComputeBackoffEDCA(current_cw_min, current_cw_max, random_stream);
 			break;
 
 		// Deterministic backoff (Qualcomm)
 		case BACKOFF_DETERMINISTIC_QUALCOMM:
 			backoff_time = ComputeBackoffDeterministic(deterministic_bo_active, num_bo_interruptions, 
-				base_backoff_deterministic, current_cw_min, current_cw_max);
+				base_backoff_deterministic, current_cw_min, current_cw_max, random_stream);
 			break;
 
 		// Repeat backoff (repeat the last backoff if the transmission was successful)
 		case BACKOFF_REPEAT_BO:
-			backoff_time = ComputeBackoffRepeat(deterministic_bo_active, previous_backoff, current_cw_min, current_cw_max);
+			backoff_time = ComputeBackoffRepeat(deterministic_bo_active, previous_backoff, current_cw_min, current_cw_max,
+				random_stream);
 			break;
 
 		// ECA (https://arxiv.org/pdf/1512.02062, https://arxiv.org/pdf/1311.0787
 		case BACKOFF_ECA: 
 			backoff_time = ComputeBackoffECA(deterministic_bo_active, previous_backoff, 
-				base_backoff_deterministic, current_cw_min, current_cw_max);
+				base_backoff_deterministic, current_cw_min, current_cw_max, random_stream);
 			break;
 
 		// SYNCHRONIZED BACKOFF
@@ -109,10 +109,11 @@ static void HandleBackoffDCF(int cw_adaptation, int increase_or_reset, int *cw_s
 * Compute a new backoff value
 * @param "current_cw_min" [type int]: current minimum contention window
 * @param "current_cw_max" [type int]: current maximum contention window
+* @param "random_stream" [type CostRandomStream*]: random number stream of the node
 */
-double ComputeBackoffDCF(int current_cw_min, int current_cw_max) {
+double ComputeBackoffDCF(int current_cw_min, int current_cw_max, CostRandomStream *random_stream) {
 
-    int num_slots (current_cw_min + (std::rand() % ( current_cw_max - current_cw_min + 1 )));
+    int num_slots (current_cw_min + (random_stream->Rand() % ( current_cw_max - current_cw_min + 1 )));
     return num_slots * SLOT_TIME;
 
 }
\ No newline at end of file
@@ -71,15 +71,16 @@ void HandleBackoffDeterministic(int increase_or_reset, int *deterministic_bo_act
 * @param "deterministic_bo_active" [type int]: flag indicating whether deterministic BO is active or not (Only for BACKOFF_DETERMINISTIC_QUALCOMM)
 * @param "num_bo_interruptions" [type int]: number of experienced BO interruptions (Only for BACKOFF_DETERMINISTIC_QUALCOMM)
 * @param "base_backoff_deterministic" [type int]: base backoff (Only for BACKOFF_DETERMINISTIC_QUALCOMM)
+* @param "random_stream" [type CostRandomStream*]: random number stream of the node
 */
 double ComputeBackoffDeterministic(int deterministic_bo_active, int num_bo_interruptions, 
-    int base_backoff_deterministic, int current_cw_min, int current_cw_max) {
+    int base_backoff_deterministic, int current_cw_min, int current_cw_max, CostRandomStream *random_stream) {
 
     if (deterministic_bo_active) {
         int num_slots = base_backoff_deterministic +  num_bo_interruptions;
         return num_slots * SLOT_TIME;
     } else {
-        int num_slots (current_cw_min + (std::rand() % ( current_cw_max - current_cw_min + 1 )));
+        int num_slots (current_cw_min + (random_stream->Rand() % ( current_cw_max - current_cw_min + 1 )));
         return num_slots * SLOT_TIME;
     }
 
@@ -82,14 +82,15 @@ void HandleBackoffECA(int increase_or_reset, int *cw_stage_current, int *current
 * @param "deterministic_bo_active" [type int]: flag indicating whether deterministic BO is active or not (Only for BACKOFF_DETERMINISTIC_QUALCOMM)
 * @param "base_backoff_deterministic" [type int]: base backoff (Only for BACKOFF_DETERMINISTIC_QUALCOMM)
 * @param "previous_backoff" [type double]: previous employed backoff backoff (Only for BACKOFF_REPEAT_BO)
+* @param "random_stream" [type CostRandomStream*]: random number stream of the node
 */
 double ComputeBackoffECA(int deterministic_bo_active, int previous_backoff, 
-    int base_backoff_deterministic, int current_cw_min, int current_cw_max) {
+    int base_backoff_deterministic, int current_cw_min, int current_cw_max, CostRandomStream *random_stream) {
 
     if (deterministic_bo_active && previous_backoff != -1) {
         return base_backoff_deterministic * SLOT_TIME;
     } else {
-        int num_slots (current_cw_min + (std::rand() % ( current_cw_max - current_cw_min + 1 )));
+        int num_slots (current_cw_min + (random_stream->Rand() % ( current_cw_max - current_cw_min + 1 )));
         return num_slots * SLOT_TIME;
     }
 
@@ -101,13 +102,15 @@ double ComputeBackoffECA(int deterministic_bo_active, int previous_backoff,
 * @param "current_cw_max" [type int]: current maximum contention window
 * @param "deterministic_bo_active" [type int]: flag indicating whether deterministic BO is active or not (Only for BACKOFF_DETERMINISTIC_QUALCOMM)
 * @param "previous_backoff" [type double]: previous employed backoff backoff (Only for BACKOFF_REPEAT_BO)
+* @param "random_stream" [type CostRandomStream*]: random number stream of the node
 */
-double ComputeBackoffRepeat(int deterministic_bo_active, int previous_backoff, int current_cw_min, int current_cw_max) {
+double ComputeBackoffRepeat(int deterministic_bo_active, int previous_backoff, int current_cw_min, int current_cw_max,
+    CostRandomStream *random_stream) {
 
     if (deterministic_bo_active && previous_backoff != -1) {
         return previous_backoff;
     } else {
-        int num_slots (current_cw_min + (std::rand() % ( current_cw_max - current_cw_min + 1 )));
+        int num_slots (current_cw_min + (random_stream->Rand() % ( current_cw_max - current_cw_min + 1 )));
         return num_slots * SLOT_TIME;
     }
 
@@ -148,8 +148,9 @@ static void HandleBackoffEDCA(int increase_or_reset, int traffic_type,
  *
  * @param "current_cw_min" [type int]: lower bound of the draw range (always 0 for EDCA)
  * @param "current_cw_max" [type int]: current CW size (== live CW value)
+ * @param "random_stream" [type CostRandomStream*]: random number stream of the node
  */
-double ComputeBackoffEDCA(int current_cw_min, int current_cw_max) {
-    int num_slots = current_cw_min + (std::rand() % (current_cw_max - current_cw_min + 1));
+double ComputeBackoffEDCA(int current_cw_min, int current_cw_max, CostRandomStream *random_stream) {
+    int num_slots = current_cw_min + (random_stream->Rand() % (current_cw_max - current_cw_min + 1));
     return num_slots * SLOT_TIME;
 }
\ No newline at end of file
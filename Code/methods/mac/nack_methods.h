@@ -51,6 +51,7 @@
 
 #include <stddef.h>
 #include "../../list_of_macros.h"
+#include "../../structures/topology.h"
 
 /**
 * Generates a logical NACK
@@ -83,7 +84,7 @@ LogicalNack GenerateLogicalNack(int packet_type, int packet_id, int node_id,
 
 /**
 * Process a NACK notification.
-* @param "logical_nack" [type LogicalNack]: logical NACK to be processed
+* @param "logical_nack" [type LogicalNack&]: logical NACK to be processed
 * @param "packet_type" [type int]: type of packet lost (RTS, CTS, DATA, ACK...)
 * @param "node_id" [type int]: node processing the logical NACK
 * @param "node_logger" [type Logger]: logger object at which to write information
@@ -92,12 +93,12 @@ LogicalNack GenerateLogicalNack(int packet_type, int packet_id, int node_id,
 * @param "sim_time" [type double]: current simulation time
 * @param "nacks_received" [type int*]: list containing the number of NACKs received for each time of loss reason
 * @param "total_nodes_number" [type int]: total number of nodes in the network
-* @param "nodes_transmitting" [type int*]: list of nodes transmitting
+* @param "nodes_transmitting" [type NodeSet]: set of nodes transmitting
 * @return "reason" [type int]: potential reason for the packet loss
 */
-int ProcessNack(LogicalNack logical_nack, int node_id, Logger node_logger, int node_state,
+int ProcessNack(const LogicalNack &logical_nack, int node_id, Logger node_logger, int node_state,
 		int save_node_logs,	double sim_time, int *nacks_received,
-		int total_nodes_number, int *nodes_transmitting) {
+		int total_nodes_number, const NodeSet &nodes_transmitting) {
 
 	int reason (PACKET_NOT_LOST);
 
@@ -100,11 +100,12 @@ void HandlePacketLoss(int type, double *total_time_lost_in_num_channels, double
 * @param "node_id" [type int]: node id
 * @param "packet_type" [type int]: type of packet being decoded
 * @param "destination_id" [type int]: destination id
+* @param "random_stream" [type CostRandomStream*]: random number stream of the node
 * @return "packet_lost" [type int]: boolean indicating whether the packet can be decoded or not
 */
 int AttemptToDecodePacket(double sinr, double capture_effect, double pd,
 		double power_rx_interest, double constant_per, int node_id, int packet_type,
-		int destination_id){
+		int destination_id, CostRandomStream *random_stream){
 
 	int packet_lost;
 	double per (0);
@@ -119,7 +120,7 @@ int AttemptToDecodePacket(double sinr, double capture_effect, double pd,
 		}
 	}
 
-	packet_lost = ((double) rand() / (RAND_MAX)) < per;
+	packet_lost = ((double) random_stream->Rand() / (RAND_MAX)) < per;
 
 	return packet_lost;
 }
@@ -127,8 +128,8 @@ int AttemptToDecodePacket(double sinr, double capture_effect, double pd,
 /**
 * Compute notification loss according to SINR received and other parameters
 * @param "primary_channel" [type int]: primary channel
-* @param "incoming_notification" [type Notification]: notification that was being decoded after detecting the newest one
-* @param "new_notification" [type Notification]: new detected notification
+* @param "incoming_notification" [type Notification&]: notification that was being decoded after detecting the newest one
+* @param "new_notification" [type Notification&]: new detected notification
 * @param "sinr" [type double]: SINR in pW
 * @param "capture_effect" [type double]: capture effect threshold in pW
 * @param "pd" [type double]: packet detect (PD) threshold in pW
@@ -136,11 +137,12 @@ int AttemptToDecodePacket(double sinr, double capture_effect, double pd,
 * @param "constant_per" [type int]: constant packet error rate (PER)
 * @param "node_id" [type int]: node id
 * @param "capture_effect_model" [type int]: capture effect model
+* @param "random_stream" [type CostRandomStream*]: random number stream of the node
 * @return "loss_reason" [type int]: loss reason
 */
-int IsPacketLost(int primary_channel, Notification incoming_notification, Notification new_notification,
+int IsPacketLost(int primary_channel, const Notification &incoming_notification, const Notification &new_notification,
 		double sinr, double capture_effect, double pd, double power_rx_interest, double constant_per,
-		int node_id, int capture_effect_model){
+		int node_id, int capture_effect_model, CostRandomStream *random_stream){
 
 	int loss_reason (PACKET_NOT_LOST);
 	int is_packet_lost;	// Determines if the current notification has been lost (1) or not (0)
@@ -159,7 +161,7 @@ int IsPacketLost(int primary_channel, Notification incoming_notification, Notifi
 
 				// Attempt to decode (or continue decoding) the notification of interest
 				is_packet_lost = AttemptToDecodePacket(sinr, capture_effect, pd, power_rx_interest, constant_per, node_id,
-					new_notification.packet_type, new_notification.destination_id);
+					new_notification.packet_type, new_notification.destination_id, random_stream);
 
 				if (is_packet_lost) {	// Incoming packet is lost
 					if (power_rx_interest < pd) {	// Signal strength is not enough (< pd) to be decoded
@@ -63,12 +63,12 @@
 
 /**
 * Check whether the received notification is an intra-BSS, an inter-BSS, an SRG or a non-SRG frame
-* @param "notification" [type Notification]: notification to be inspected
+* @param "notification" [type Notification&]: notification to be inspected
 * @param "bss_color" [type int]: BSS color of the node inspecting the notification
 * @param "srg" [type int]: SRG of the node inspecting the notification
 * @return "type_of_packet" [type int]: type of packet
 */
-int CheckPacketOrigin(Notification notification, int bss_color, int srg) {
+int CheckPacketOrigin(const Notification &notification, int bss_color, int srg) {
 
 	int type_of_packet;
 	int bss_color_enabled (false);
@@ -168,13 +168,13 @@ double ApplyTxPowerRestriction(double current_pd, double current_tx_power) {
 /**
 * Update the array "type_ongoing_transmissions", which stores the type of each sensed ongoing transmissions.
 * @param "type_ongoing_transmissions" [type int*]: array of the types of ongoing transmissions (to be updated by this method)
-* @param "notification" [type Notification]: last notification received
+* @param "notification" [type Notification&]: last notification received
 * @param "bss_color" [type int]: BSS color of the node updating the array
 * @param "srg" [type int]: SRG of the node updating the array
 * @param "enter_or_leave" [type int]: indicates whether the transmission starts (1) or ends (0)
 */
 void UpdateTypeOngoingTransmissions(int *type_ongoing_transmissions,
-	Notification notification, int bss_color, int srg, int enter_or_leave) {
+	const Notification &notification, int bss_color, int srg, int enter_or_leave) {
 
 	// Identify the type of packet according to the BSS color and the SRG
 	int packet_type_source = CheckPacketOrigin(notification, bss_color, srg);
@@ -15,6 +15,10 @@
  * Functions defined here:
  *   - Node::AbortInitialTransmission
  *   - Node::ScheduleBackoffAfterDIFS
+ *   - Node::ArmBackoffAfterIfs
+ *   - Node::CancelIfs
+ *   - Node::IfsPending
+ *   - Node::BackoffCountingDown
  *   - Node::UpdateSINRFromNotification
  *   - Node::PauseBackoff
  *   - Node::ResumeBackoff
@@ -35,7 +39,7 @@
 void Node :: AbortInitialTransmission(){
 
 	if(node_params.backoff_type == BACKOFF_DETERMINISTIC_QUALCOMM){
-	LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s ca_state.deterministic_bo_active = %d, ca_state.num_bo_interruptions = %d.\n",
+	NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s ca_state.deterministic_bo_active = %d, ca_state.num_bo_interruptions = %d.\n",
 		SimTime(), node_params.node_id, node_state, LOG_Z00, LOG_LVL4,
 		ca_state.deterministic_bo_active, ca_state.num_bo_interruptions);
 	}
@@ -44,7 +48,7 @@ void Node :: AbortInitialTransmission(){
 	// Compute a new backoff and trigger a new DIFS
 	ca_state.remaining_backoff = ComputeBackoff(ca_state.current_cw_min, ca_state.current_cw_max, node_params.backoff_type,
 			current_traffic_type, ca_state.deterministic_bo_active, ca_state.num_bo_interruptions, ca_state.base_backoff_deterministic,
-			ca_state.previous_backoff);
+			ca_state.previous_backoff, &random_stream);
 
 	ca_state.previous_backoff = ca_state.remaining_backoff;	// Update the last used backoff
 
@@ -52,7 +56,7 @@ void Node :: AbortInitialTransmission(){
 	node_stats.num_new_backoff_computations++;
 	node_state = STATE_SENSING;
 
-	LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Transmission is NOT possible\n",
+	NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s Transmission is NOT possible\n",
 		SimTime(), node_params.node_id, node_state, LOG_F03, LOG_LVL3);
 
 }
@@ -66,8 +70,53 @@ void Node :: ScheduleBackoffAfterDIFS() {
 	double ifs = (node_params.backoff_type == BACKOFF_EDCA)
 	             ? ComputeAIFS(current_traffic_type)
 	             : DIFS;
-	double time_to_trigger = SimTime() + ifs;
-	trigger_start_backoff.Set(FixTimeOffset(time_to_trigger, 13, 12));
+	ArmBackoffAfterIfs(SimTime() + ifs);
+}
+
+/**
+ * Start the inter-frame space after which the backoff countdown resumes. By default, the IFS is a
+ * timer of its own that calls ResumeBackoff() when it expires. With lazy backoff, the end of the
+ * countdown is scheduled right away instead (ResumeBackoff() would have set it to exactly the same
+ * time), so that the IFS costs no event: whether it is still running is derived from ifs_end_time
+ * @param "ifs_end_time" [type double]: time at which the DIFS/AIFS ends [s]
+ */
+void Node :: ArmBackoffAfterIfs(double ifs_end_time) {
+	ca_state.ifs_end_time = FixTimeOffset(ifs_end_time, 13, 12);
+	if (node_params.lazy_backoff) {
+		time_to_trigger = ca_state.ifs_end_time + ca_state.remaining_backoff;
+		trigger_end_backoff.Set(FixTimeOffset(time_to_trigger, 13, 12));
+	} else {
+		trigger_start_backoff.Set(ca_state.ifs_end_time);
+	}
+}
+
+/**
+ * Cancel the inter-frame space before the backoff countdown (if it is running)
+ */
+void Node :: CancelIfs() {
+	if (!node_params.lazy_backoff) {
+		trigger_start_backoff.Cancel();
+	} else if (IfsPending()) {
+		trigger_end_backoff.Cancel();
+	}
+}
+
+/**
+ * Check whether the node is waiting for the DIFS/AIFS that precedes the backoff countdown
+ * @return "pending" [type int]: TRUE if the IFS is running
+ */
+int Node :: IfsPending() {
+	if (!node_params.lazy_backoff) return trigger_start_backoff.Active();
+	return trigger_end_backoff.Active() && SimTime() < ca_state.ifs_end_time;
+}
+
+/**
+ * Check whether the backoff is being decreased (IFS completed and countdown not frozen)
+ * @return "counting" [type int]: TRUE if trigger_end_backoff marks the end of a live countdown
+ */
+int Node :: BackoffCountingDown() {
+	if (!node_params.lazy_backoff) return trigger_end_backoff.Active();
+	return trigger_end_backoff.Active() && SimTime() >= ca_state.ifs_end_time;
 }
 
 /**
@@ -76,8 +125,8 @@ void Node :: ScheduleBackoffAfterDIFS() {
  * Steps 1-3 of the standard "can the packet be decoded?" sequence.
  * Step 4 (IsPacketLost) is left to the caller so intermediate LOGS remain visible.
  */
-void Node :: UpdateSINRFromNotification(const Notification &notification) {
-	power_rx_interest = power_received_per_node[notification.source_id];
+void Node :: UpdateSINRFromNotification(const NotificationFrame &notification) {
+	power_rx_interest = power_received_per_node.Power(notification.source_id);
 	ComputeMaxInterference(&max_pw_interference, &channel_max_interference,
 		notification, node_state, power_received_per_node, &channel_power);
 	current_sinr = UpdateSINR(power_rx_interest, max_pw_interference);
@@ -88,33 +137,33 @@ void Node :: UpdateSINRFromNotification(const Notification &notification) {
  */
 void Node :: PauseBackoff(){
 
-	if(trigger_start_backoff.Active()){
-		LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Cancelling DIFS. BO still frozen at %.9f (%.2f slots)\n",
+	if(IfsPending()){
+		NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s Cancelling DIFS. BO still frozen at %.9f (%.2f slots)\n",
 			SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL3,
 			ca_state.remaining_backoff * pow(10,6), ca_state.remaining_backoff / SLOT_TIME);
 
-		trigger_start_backoff.Cancel();
+		CancelIfs();
 	} else {
 
-		if(trigger_end_backoff.Active()){	// If backoff trigger is active, freeze it
+		if(BackoffCountingDown()){	// If backoff trigger is active, freeze it
 
 			ca_state.remaining_backoff = ComputeRemainingBackoff(node_params.backoff_type, trigger_end_backoff.GetTime() - SimTime());
 
 			++ca_state.num_bo_interruptions;
 
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s BO is active. Freezing it from %.9f (%.2f slots) to %.9f (%.2f slots) -> BO interruptions = %d\n",
 				SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL3,
 				(trigger_end_backoff.GetTime() - SimTime()) * pow(10,6),
 				(trigger_end_backoff.GetTime() - SimTime())/SLOT_TIME,
 				ca_state.remaining_backoff * pow(10,6), ca_state.remaining_backoff/SLOT_TIME, ca_state.num_bo_interruptions);
 
-//			LOGS(node_params.save_node_logs,node_logger.file,
+//			NODE_LOGS(node_params.save_node_logs,node_logger,
 //								"%.15f;N%d;S%d;%s;%s Original remaining BO: %.9f us\n",
 //								SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL3,
 //								(trigger_end_backoff.GetTime() - SimTime())*pow(10,6));
 
-//			LOGS(node_params.save_node_logs,node_logger.file,
+//			NODE_LOGS(node_params.save_node_logs,node_logger,
 //					"%.15f;N%d;S%d;%s;%s Backoff is active --> freeze it at %.9f us (%.2f slots)\n",
 //					SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL3,
 //					ca_state.remaining_backoff * pow(10,6), ca_state.remaining_backoff/SLOT_TIME);
@@ -123,7 +172,7 @@ void Node :: PauseBackoff(){
 
 		} else {	// If backoff trigger is frozen
 
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s Backoff is NOT active - it is already frozen at %.9f us (%.2f slots)\n",
 				SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL3,
 				ca_state.remaining_backoff * pow(10,6), ca_state.remaining_backoff / SLOT_TIME);
@@ -146,18 +195,18 @@ void Node :: PauseBackoff(){
  */
 void Node :: ResumeBackoff(trigger_t &){
 
-//	LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s DIFS finished\n",
+//	NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s DIFS finished\n",
 //					SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL2);
 
 	time_to_trigger = SimTime() + ca_state.remaining_backoff;
 
 	trigger_end_backoff.Set(FixTimeOffset(time_to_trigger,13,12));
 
-	LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Resuming backoff in %.9f us (%.2f slots)\n",
+	NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s Resuming backoff in %.9f us (%.2f slots)\n",
 		SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL3,
 		(ca_state.remaining_backoff * pow(10,6)), (ca_state.remaining_backoff / (double) SLOT_TIME));
 
-//	LOGS(node_params.save_node_logs,node_logger.file,
+//	NODE_LOGS(node_params.save_node_logs,node_logger,
 //				"%.15f;N%d;S%d;%s;%s DIFS: active = %d, t_DIFS = %f - backoff: active = %d - t_back = %f\n",
 //				SimTime(), node_params.node_id, node_state, LOG_D02, LOG_LVL3,
 //				trigger_start_backoff.Active(), trigger_start_backoff.GetTime() - SimTime(),
@@ -187,8 +236,8 @@ void Node :: CallRestartSta(trigger_t &){
  */
 void Node :: RestartNode(int called_by_time_out){
 
-	LOGS(node_params.save_node_logs, node_logger.file, "\n **********************************************************************\n");
-	LOGS(node_params.save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s Node Restarted (%d)\n",
+	NODE_LOGS(node_params.save_node_logs, node_logger, "\n **********************************************************************\n");
+	NODE_LOGS(node_params.save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Node Restarted (%d)\n",
 		SimTime(), node_params.node_id, node_state, LOG_Z00, LOG_LVL1,
 		called_by_time_out);
 
@@ -243,7 +292,7 @@ void Node :: RestartNode(int called_by_time_out){
 	trigger_recover_cts_timeout.Cancel();
 	trigger_start_backoff.Cancel();
 
-	LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s node_is_transmitter = %d "
+	NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s node_is_transmitter = %d "
 			"/ buffer.QueueSize() = %d\n",
 		SimTime(), node_params.node_id, node_state, LOG_Z00, LOG_LVL3,
 		node_is_transmitter, buffer.QueueSize());
@@ -256,7 +305,8 @@ void Node :: RestartNode(int called_by_time_out){
 
 		// In case of being an AP
 		ca_state.remaining_backoff = ComputeBackoff(ca_state.current_cw_min, ca_state.current_cw_max,
-				node_params.backoff_type, current_traffic_type, ca_state.deterministic_bo_active, ca_state.num_bo_interruptions, ca_state.base_backoff_deterministic, ca_state.previous_backoff);
+				node_params.backoff_type, current_traffic_type, ca_state.deterministic_bo_active, ca_state.num_bo_interruptions, ca_state.base_backoff_deterministic, ca_state.previous_backoff,
+				&random_stream);
 		ca_state.previous_backoff = ca_state.remaining_backoff;
 		node_stats.expected_backoff = node_stats.expected_backoff + ca_state.remaining_backoff;
 		++node_stats.num_new_backoff_computations;
@@ -266,7 +316,7 @@ void Node :: RestartNode(int called_by_time_out){
 		node_stats.timestamp_new_trial_started = SimTime();
 
 		if(node_params.backoff_type == BACKOFF_DETERMINISTIC_QUALCOMM){
-		LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s ca_state.deterministic_bo_active = %d, ca_state.num_bo_interruptions = %d.\n",
+		NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s ca_state.deterministic_bo_active = %d, ca_state.num_bo_interruptions = %d.\n",
 			SimTime(), node_params.node_id, node_state, LOG_Z00, LOG_LVL4,
 			ca_state.deterministic_bo_active, ca_state.num_bo_interruptions);
 		}
@@ -274,18 +324,18 @@ void Node :: RestartNode(int called_by_time_out){
 		// Restart the counter for the deterministic backoff
 		ca_state.num_bo_interruptions = 0;
 
-		LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s New backoff computed: %f (%.0f slots).\n",
+		NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s New backoff computed: %f (%.0f slots).\n",
 			SimTime(), node_params.node_id, node_state, LOG_Z00, LOG_LVL3,
 			ca_state.remaining_backoff, ca_state.remaining_backoff/SLOT_TIME);
 
 		// Add extra slot since node has transmitted
 		ca_state.remaining_backoff = ca_state.remaining_backoff + SLOT_TIME;
 
-		LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Extra slot added --> remaining BO %f slots\n",
+		NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s Extra slot added --> remaining BO %f slots\n",
 			SimTime(), node_params.node_id, node_state, LOG_Z00, LOG_LVL4,
 			ca_state.remaining_backoff / SLOT_TIME);
 
-		LOGS(node_params.save_node_logs,node_logger.file,
+		NODE_LOGS(node_params.save_node_logs,node_logger,
 			"%.15f;N%d;S%d;%s;%s Checking if BO can be resumed. Pow(primary #%d) =  %.2f dBm\n",
 			SimTime(), node_params.node_id, node_state, LOG_Z00, LOG_LVL4,
 			node_params.current_primary_channel, ConvertPower(PW_TO_DBM, channel_power[node_params.current_primary_channel]));
@@ -302,13 +352,13 @@ void Node :: RestartNode(int called_by_time_out){
 
 		// Check if node has to freeze the BO (if it is not already frozen)
 		if (resume) {
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s BO can be resumed! Starting DIFS...\n",
 				SimTime(), node_params.node_id, node_state, LOG_Z00, LOG_LVL5);
 			// Use AIFS[AC] for EDCA; DIFS for all other backoff types.
 			ScheduleBackoffAfterDIFS();
 		} else {
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s BO cannot be resumed!\n",
 				SimTime(), node_params.node_id, node_state, LOG_Z00, LOG_LVL5);
 		}
@@ -360,7 +410,7 @@ void Node:: HandleSlottedBackoffCollision() {
 void Node:: RecoverFromCtsTimeout(trigger_t &) {
 	// Sergio on 25 Oct 2017
 	// - Just restart the node to start the DIFS
-	LOGS(node_params.save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s RecoverFromCtsTimeout\n",
+	NODE_LOGS(node_params.save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s RecoverFromCtsTimeout\n",
 		SimTime(), node_params.node_id, node_state, LOG_Z00, LOG_LVL3);
 	// Cancel trigger for safety
 	trigger_recover_cts_timeout.Cancel();
@@ -372,7 +422,7 @@ void Node:: RecoverFromCtsTimeout(trigger_t &) {
  */
 void Node:: CallSensing(trigger_t &){
 
-	LOGS(node_params.save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s State changed to sensing due to NAV collision\n",
+	NODE_LOGS(node_params.save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s State changed to sensing due to NAV collision\n",
 		SimTime(), node_params.node_id, node_state, LOG_Z00, LOG_LVL3);
 
 	node_state = STATE_SENSING;
@@ -382,7 +432,7 @@ void Node:: CallSensing(trigger_t &){
 
 	// Check if node has to freeze the BO (if it is not already frozen)
 	if (resume) {
-		LOGS(node_params.save_node_logs, node_logger.file,
+		NODE_LOGS(node_params.save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s BO can be resumed! Starting DIFS...\n",
 			SimTime(), node_params.node_id, node_state, LOG_Z00, LOG_LVL5);
 		// time_to_trigger = SimTime() + DIFS - TIME_OUT_EXTRA_TIME;
@@ -397,7 +447,7 @@ void Node:: CallSensing(trigger_t &){
 /**
  * Handle InportSomeNodeStartTX for STATE_WAIT_ICR (coordinator waiting for ICR)
  */
-void Node :: HandleStartTX_StateWaitIcr(const Notification &notification) {
+void Node :: HandleStartTX_StateWaitIcr(const NotificationFrame &notification) {
 	if (notification.packet_type == PACKET_TYPE_ICR
 			&& notification.destination_id == node_params.node_id
 			&& notification.mapc_group_id == wlan.mapc_group_ids[mapc_active_group_idx]) {
@@ -407,7 +457,7 @@ void Node :: HandleStartTX_StateWaitIcr(const Notification &notification) {
 		// arrives during ICR reception (HandleStartTX_StateRxData uses it).
 		UpdateSINRFromNotification(notification);
 		node_state = STATE_RX_ICR;
-		LOGS(node_params.save_node_logs, node_logger.file,
+		NODE_LOGS(node_params.save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s Received ICR from N%d -> STATE_RX_ICR\n",
 			SimTime(), node_params.node_id, STATE_RX_ICR, LOG_D07, LOG_LVL2,
 			notification.source_id);
@@ -417,7 +467,7 @@ void Node :: HandleStartTX_StateWaitIcr(const Notification &notification) {
 /**
  * Handle InportSomeNodeStartTX for STATE_WAIT_MU_RTS (coordinated AP waiting for MU-RTS/TXS)
  */
-void Node :: HandleStartTX_StateWaitMuRts(const Notification &notification) {
+void Node :: HandleStartTX_StateWaitMuRts(const NotificationFrame &notification) {
 	if (notification.packet_type == PACKET_TYPE_MU_RTS_TXS
 			&& notification.destination_id == node_params.node_id) {
 		trigger_NAV_timeout.Cancel();
@@ -426,7 +476,7 @@ void Node :: HandleStartTX_StateWaitMuRts(const Notification &notification) {
 		// arrives during MU-RTS reception (HandleStartTX_StateRxData uses it).
 		UpdateSINRFromNotification(notification);
 		node_state = STATE_RX_MU_RTS;
-		LOGS(node_params.save_node_logs, node_logger.file,
+		NODE_LOGS(node_params.save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s Received MU-RTS/TXS from N%d -> STATE_RX_MU_RTS\n",
 			SimTime(), node_params.node_id, STATE_RX_MU_RTS, LOG_D07, LOG_LVL2,
 			notification.source_id);
@@ -436,7 +486,7 @@ void Node :: HandleStartTX_StateWaitMuRts(const Notification &notification) {
 /**
  * Handle InportSomeNodeStartTX for STATE_WAIT_TF (coordinated AP waiting for TF)
  */
-void Node :: HandleStartTX_StateWaitTf(const Notification &notification) {
+void Node :: HandleStartTX_StateWaitTf(const NotificationFrame &notification) {
 	if (notification.packet_type == PACKET_TYPE_TF
 			&& notification.destination_id == NODE_ID_MAPC_BROADCAST
 			&& notification.mapc_group_id == wlan.mapc_group_ids[mapc_active_group_idx]) {
@@ -446,7 +496,7 @@ void Node :: HandleStartTX_StateWaitTf(const Notification &notification) {
 		// arrives during TF reception (HandleStartTX_StateRxData uses it).
 		UpdateSINRFromNotification(notification);
 		node_state = STATE_RX_TF;
-		LOGS(node_params.save_node_logs, node_logger.file,
+		NODE_LOGS(node_params.save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s Received TF from N%d -> STATE_RX_TF\n",
 			SimTime(), node_params.node_id, STATE_RX_TF, LOG_D07, LOG_LVL2,
 			notification.source_id);
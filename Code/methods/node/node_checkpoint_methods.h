@@ -0,0 +1,331 @@
+/* Kom8ndor IEEE 802.11bn Simulator
+ *
+ * Copyright (c) 2026, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+ */
+
+/**
+ * node_checkpoint_methods.h: state of the node at a checkpoint (see checkpoint_methods.h).
+ *
+ * NOTE: This file is an implementation fragment. It must be included from node.h
+ *   after the Node class definition, not included directly.
+ *
+ * Everything the node may change once it has started is saved: buffer, FSM state and timers, channel sensing,
+ * frames being received, MCS, backoff, spatial reuse, MAPC/DSO/NPCA state, statistics and performance report.
+ * What is set up before the start and never changed afterwards (WLAN, channel, modulation tables, beamforming
+ * receivers, access policy) is not, as the restored run sets it up again from the same input. Neither are the
+ * logs nor the frame trace, which cover the resumed part of the run.
+ *
+ * Functions defined here:
+ *   - Node::Checkpoint
+ */
+
+#ifndef NODE_CHECKPOINT_METHODS_H
+#define NODE_CHECKPOINT_METHODS_H
+
+/**
+ * Frame exchange sequences the node may be running (see packet_exchange_sequence.h)
+ */
+static const PacketExchangeSequence *CHECKPOINT_EXCHANGE_SEQUENCES[] = {&IEEE_802_11_NO_RTS_CTS,
+	&IEEE_802_11_RTS_CTS, &IEEE_802_11_COTDMA, &IEEE_802_11_COBF_COSR, &IEEE_802_11_DSO, &IEEE_802_11_NPCA};
+#define CHECKPOINT_NUM_EXCHANGE_SEQUENCES 6
+
+/**
+ * Frame held by the node (e.g., the one being received): its notification, copied into a new frame when read
+ * @param "file" [type CheckpointFile&]: checkpoint being written or read
+ * @param "pool" [type CorsaAllocator*]: pool of the frames of the node
+ * @param "frame" [type NotificationRef&]: frame
+ */
+void CheckpointFrame(CheckpointFile &file, CorsaAllocator *pool, NotificationRef &frame){
+	int held (frame.Held());
+	Notification notification (*frame);
+	file.Field(held);
+	file.Raw(notification);
+	if (!file.Reading()) return;
+	if (held) {
+		frame.Create(pool, notification);
+	} else {
+		frame.Release();
+	}
+}
+
+/**
+ * Save the state of the node to a checkpoint, or restore it (once the node has started)
+ * @param "file" [type CheckpointFile&]: checkpoint being written or read
+ */
+void Node :: Checkpoint(CheckpointFile &file){
+
+	int total_nodes_number (node_params.total_nodes_number);
+
+	// Buffer
+	int buffer_size (buffer.QueueSize());
+	file.Field(buffer_size);
+	if (file.Reading()) buffer.m_queue.resize(buffer_size);
+	for (int i = 0; i < buffer_size; ++i) file.Raw(buffer.m_queue[i]);
+	file.Field(last_packet_generated_id);
+
+	// Parameters (those of the run are kept: a restored run may be longer, or log differently)
+	double simulation_time (node_params.simulation_time_komondor);
+	int save_logs (node_params.save_node_logs);
+	int print_logs (node_params.print_node_logs);
+	std::string code (node_params.simulation_code);
+	file.Parameters(node_params);
+	if (file.Reading()) {
+		node_params.simulation_time_komondor = simulation_time;
+		node_params.save_node_logs = save_logs;
+		node_params.print_node_logs = print_logs;
+		node_params.simulation_code = code;
+	}
+
+	int sequence (0);
+	for (int i = 0; i < CHECKPOINT_NUM_EXCHANGE_SEQUENCES; ++i) {
+		if (exchange_sequence.transmission_mode == CHECKPOINT_EXCHANGE_SEQUENCES[i]->transmission_mode) sequence = i;
+	}
+	file.Field(sequence);
+	if (file.Reading()) exchange_sequence = *CHECKPOINT_EXCHANGE_SEQUENCES[sequence];
+
+	// MAPC
+	file.Field(num_coordinated_aps);
+	file.Array(coordinated_ap_ids, 8);
+	file.Field(mapc_seq_pos);
+	file.Field(mapc_icr_received_count);
+	file.Field(mapc_current_peer_idx);
+	file.Field(mapc_selected_peer_id);
+	file.Field(mapc_peer_has_data);
+	file.Field(mapc_txop_data_budget);
+	file.Field(mapc_txop_per_ap_data_duration);
+	file.Field(mapc_icr_requested_duration);
+	file.Raw(mu_rts_notification);
+	file.Raw(tf_notification);
+	file.Raw(ack_tf_notification);
+	file.Field(mapc_active_group_idx);
+	file.Field(mapc_coordinator_group_rr);
+	file.Field(coordinator_ap_id);
+	file.Field(mapc_peer_position);
+	file.Raw(icr_notification);
+
+	file.Field(current_modulation);
+	file.Field(channel_max_interference);
+	file.Field(first_time_requesting_mcs);
+
+	// Token-based channel access
+	file.Field(token_status);
+	file.Field(distance_to_token);
+	if (token_order_list != NULL) file.Array(token_order_list, total_nodes_number);
+	if (num_missed_tokens_list != NULL) file.Array(num_missed_tokens_list, total_nodes_number);
+
+	// Power received from the other nodes (own row of the topology, updated with the TX power of the others)
+	file.Array(received_power_array, total_nodes_number);
+	if (rssi_per_sta != NULL) file.Array(rssi_per_sta, wlan.num_stas);
+
+	// Beamforming
+	file.Field(current_beam_az_main_rad);
+	file.Array(current_beam_null_az_rad, MAX_BEAM_NULLS);
+	file.Field(current_beam_num_nulls);
+	file.Field(current_beam_use_zf);
+	file.Raw(beam_weights);
+	if (beam_receiver_gain != NULL) file.Array(beam_receiver_gain, num_beam_receivers);
+	if (beam_gain_per_node != NULL) file.Array(beam_gain_per_node, total_nodes_number);
+
+	// Statistics
+	NodeStatistics stats_arrays (node_stats);
+	file.Raw(node_stats);
+	if (file.Reading()) {
+		node_stats.total_time_transmitting_per_channel = stats_arrays.total_time_transmitting_per_channel;
+		node_stats.total_time_transmitting_in_num_channels = stats_arrays.total_time_transmitting_in_num_channels;
+		node_stats.total_time_lost_per_channel = stats_arrays.total_time_lost_per_channel;
+		node_stats.total_time_lost_in_num_channels = stats_arrays.total_time_lost_in_num_channels;
+		node_stats.total_time_channel_busy_per_channel = stats_arrays.total_time_channel_busy_per_channel;
+		node_stats.last_total_time_transmitting_per_channel = stats_arrays.last_total_time_transmitting_per_channel;
+		node_stats.last_total_time_lost_per_channel = stats_arrays.last_total_time_lost_per_channel;
+		node_stats.num_trials_tx_per_num_channels = stats_arrays.num_trials_tx_per_num_channels;
+		node_stats.nacks_received = stats_arrays.nacks_received;
+		node_stats.throughput_per_sta = stats_arrays.throughput_per_sta;
+		node_stats.data_packets_sent_per_sta = stats_arrays.data_packets_sent_per_sta;
+		node_stats.rts_cts_sent_per_sta = stats_arrays.rts_cts_sent_per_sta;
+		node_stats.data_packets_lost_per_sta = stats_arrays.data_packets_lost_per_sta;
+		node_stats.rts_cts_lost_per_sta = stats_arrays.rts_cts_lost_per_sta;
+		node_stats.data_packets_acked_per_sta = stats_arrays.data_packets_acked_per_sta;
+		node_stats.data_frames_acked_per_sta = stats_arrays.data_frames_acked_per_sta;
+	}
+	file.Array(node_stats.total_time_transmitting_per_channel, NUM_CHANNELS_KOMONDOR);
+	file.Array(node_stats.total_time_transmitting_in_num_channels, NUM_CHANNELS_KOMONDOR);
+	file.Array(node_stats.total_time_lost_per_channel, NUM_CHANNELS_KOMONDOR);
+	file.Array(node_stats.total_time_lost_in_num_channels, NUM_CHANNELS_KOMONDOR);
+	file.Array(node_stats.total_time_channel_busy_per_channel, NUM_CHANNELS_KOMONDOR);
+	file.Array(node_stats.last_total_time_transmitting_per_channel, NUM_CHANNELS_KOMONDOR);
+	file.Array(node_stats.last_total_time_lost_per_channel, NUM_CHANNELS_KOMONDOR);
+	file.Array(node_stats.num_trials_tx_per_num_channels, NUM_CHANNELS_KOMONDOR);
+	file.Array(node_stats.nacks_received, NUM_PACKET_LOST_REASONS);
+	file.Array(node_stats.throughput_per_sta, wlan.num_stas);
+	file.Array(node_stats.data_packets_sent_per_sta, wlan.num_stas);
+	file.Array(node_stats.rts_cts_sent_per_sta, wlan.num_stas);
+	file.Array(node_stats.data_packets_lost_per_sta, wlan.num_stas);
+	file.Array(node_stats.rts_cts_lost_per_sta, wlan.num_stas);
+	file.Array(node_stats.data_packets_acked_per_sta, wlan.num_stas);
+	file.Array(node_stats.data_frames_acked_per_sta, wlan.num_stas);
+
+	// Performance report (its RSSI per STA may be that of the node)
+	Performance report_arrays (performance_report);
+	file.Raw(performance_report);
+	if (file.Reading()) CheckpointFile::KeepPointers(performance_report, report_arrays);
+	file.Array(performance_report.total_time_transmitting_per_channel, NUM_CHANNELS_KOMONDOR);
+	file.Array(performance_report.total_time_transmitting_in_num_channels, NUM_CHANNELS_KOMONDOR);
+	file.Array(performance_report.total_time_lost_per_channel, NUM_CHANNELS_KOMONDOR);
+	file.Array(performance_report.total_time_lost_in_num_channels, NUM_CHANNELS_KOMONDOR);
+	file.Array(performance_report.total_time_channel_busy_per_channel, NUM_CHANNELS_KOMONDOR);
+	file.Array(performance_report.num_trials_tx_per_num_channels, NUM_CHANNELS_KOMONDOR);
+	file.Array(performance_report.rssi_list, node_params.total_wlans_number);
+	file.Array(performance_report.max_received_power_in_ap_per_wlan, node_params.total_wlans_number);
+	int rssi_per_sta_reported (rssi_per_sta != NULL && performance_report.rssi_list_per_sta == rssi_per_sta);
+	file.Field(rssi_per_sta_reported);
+	if (rssi_per_sta_reported) {
+		if (file.Reading()) performance_report.rssi_list_per_sta = rssi_per_sta;
+	} else {
+		file.Array(performance_report.rssi_list_per_sta, wlan.num_stas);
+	}
+
+	// Configurations
+	file.Config(configuration);
+	file.Config(new_configuration);
+	file.Config(spatial_reuse_configuration);
+
+	// Channel sensing
+	file.Array(channel_power, NUM_CHANNELS_KOMONDOR);
+	file.Array(channels_free, NUM_CHANNELS_KOMONDOR);
+	file.Array(channels_for_tx, NUM_CHANNELS_KOMONDOR);
+	file.Array(ongoing_tx_power, total_nodes_number);
+	file.Array(ongoing_tx_left_channel, total_nodes_number);
+	file.Array(ongoing_tx_right_channel, total_nodes_number);
+	file.Array(ongoing_tx_punctured_bitmap, total_nodes_number);
+	file.Array(ongoing_tx_start_time, total_nodes_number);
+	file.Field(num_channel_power_updates);
+
+	// State and current transmission
+	file.Field(node_state);
+	file.Field(progress_bar_counter);
+	file.Field(node_is_transmitter);
+	file.Field(current_left_channel);
+	file.Field(current_right_channel);
+	file.Field(current_tx_power);
+	file.Field(current_pd);
+	file.Field(current_destination_id);
+	file.Field(current_tx_duration);
+	file.Field(current_nav_time);
+	file.Field(packet_id);
+	file.Field(current_sinr);
+	file.Field(loss_reason);
+	file.Field(current_num_packets_aggregated);
+	file.Field(limited_num_packets_aggregated);
+
+	// Notifications and frames held
+	file.Raw(rts_notification);
+	file.Raw(cts_notification);
+	file.Raw(data_notification);
+	file.Raw(ack_notification);
+	file.Raw(icf_notification);
+	file.Raw(new_packet);
+	CheckpointFrame(file, notification_pool, incoming_notification);
+	CheckpointFrame(file, notification_pool, nav_notification);
+	CheckpointFrame(file, notification_pool, outrange_nav_notification);
+	file.Raw(current_tx_info);
+
+	file.Field(current_traffic_type);
+	file.Field(default_modulation);
+	file.Field(bits_ofdm_sym);
+	file.Raw(ca_state);
+	file.Field(data_duration);
+	file.Field(ack_duration);
+	file.Field(rts_duration);
+	file.Field(cts_duration);
+
+	// MCS
+	for (int i = 0; i < wlan.num_stas; ++i) file.Array(mcs_per_node[i], NUM_OPTIONS_CHANNEL_LENGTH);
+	file.Array(change_modulation_flag, wlan.num_stas);
+	file.Array(mcs_response, NUM_OPTIONS_CHANNEL_LENGTH);
+
+	// Sensing and reception
+	file.Raw(logical_nack);
+	file.Field(max_pw_interference);
+	file.Bytes(nodes_transmitting.words, nodes_transmitting.num_words * sizeof(uint64_t));
+	file.Field(nodes_transmitting.size);
+	file.Array(power_received_per_node.position, total_nodes_number);
+	file.Array(power_received_per_node.node_ids, total_nodes_number);
+	file.Array(power_received_per_node.power, total_nodes_number);
+	file.Field(power_received_per_node.size);
+	file.Field(power_received_per_node.total_power);
+	file.Field(power_rx_interest);
+	file.Field(receiving_from_node_id);
+	file.Field(receiving_packet_id);
+	file.Field(BER);
+	file.Array(timestamp_channel_becomes_free, NUM_CHANNELS_KOMONDOR);
+	file.Field(time_to_trigger);
+	file.Field(num_channels_tx);
+	file.Field(flag_apply_new_configuration);
+	file.Field(channel_aggregation_cca_model);
+	file.Field(last_transmission_successful);
+	file.Field(burst_rate);
+	file.Field(num_bursts);
+	file.Field(time_rand_value);
+	file.Raw(sr_state);
+	file.Field(pp_punctured_bitmap);
+
+	// DSO
+	file.Field(dso_enabled);
+	file.Array(dso_channels_for_tx, NUM_CHANNELS_KOMONDOR);
+	file.Field(dso_tx_flag);
+	file.Field(dso_rr_idx);
+	file.Field(dso_dual_tx);
+	file.Field(dso_primary_dest_id);
+	file.Raw(dso_prim_data_notif);
+	file.Field(dso_prim_data_left);
+	file.Field(dso_prim_data_right);
+
+	// NPCA
+	file.Field(npca_enabled);
+	file.Field(npca_primary_channel);
+	file.Field(npca_min_dur_threshold_us);
+	file.Field(npca_switching_delay_us);
+	file.Field(npca_switch_back_delay_us);
+	file.Field(npca_init_qsrc);
+	file.Field(npca_timer_duration);
+	file.Field(npca_on_npca_channel);
+	file.Field(npca_sta_on_npca_channel);
+	file.Field(npca_stored_backoff_counter);
+	file.Field(npca_stored_cw);
+	file.Field(npca_stored_primary_channel);
+	file.Field(npca_cw);
+	file.Array(npca_channels_for_tx, NUM_CHANNELS_KOMONDOR);
+
+	// Adaptive ACK suppression
+	file.Array(ack_success_ewma, total_nodes_number);
+	file.Array(ack_exchange_count, total_nodes_number);
+
+	// Timers and random number stream
+	CHECKPOINT_TIMER(file, trigger_sim_time);
+	CHECKPOINT_TIMER(file, trigger_end_backoff);
+	CHECKPOINT_TIMER(file, trigger_start_backoff);
+	CHECKPOINT_TIMER(file, trigger_toFinishTX);
+	CHECKPOINT_TIMER(file, trigger_SIFS);
+	CHECKPOINT_TIMER(file, trigger_ACK_timeout);
+	CHECKPOINT_TIMER(file, trigger_CTS_timeout);
+	CHECKPOINT_TIMER(file, trigger_DATA_timeout);
+	CHECKPOINT_TIMER(file, trigger_NAV_timeout);
+	CHECKPOINT_TIMER(file, trigger_inter_bss_NAV_timeout);
+	CHECKPOINT_TIMER(file, trigger_preoccupancy);
+	CHECKPOINT_TIMER(file, trigger_restart_sta);
+	CHECKPOINT_TIMER(file, trigger_wait_collisions);
+	CHECKPOINT_TIMER(file, trigger_start_saving_logs);
+	CHECKPOINT_TIMER(file, trigger_recover_cts_timeout);
+	CHECKPOINT_TIMER(file, trigger_rho_measurement);
+	CHECKPOINT_TIMER(file, txop_sr_end);
+	CHECKPOINT_TIMER(file, trigger_dso_icr_timeout);
+	CHECKPOINT_TIMER(file, trigger_npca_switch);
+	CHECKPOINT_TIMER(file, trigger_npca_timer);
+	CHECKPOINT_TIMER(file, trigger_npca_icr_timeout);
+	CHECKPOINT_TIMER(file, trigger_npca_backoff);
+	file.RandomStream(random_stream);
+}
+
+#endif /* NODE_CHECKPOINT_METHODS_H */
@@ -47,11 +47,12 @@ void Node :: GenerateConfiguration(){
  * Called when some agent answers for information to the AP
  */
 void Node :: InportReceivingRequestFromAgent() {
+	COST_PROFILE_SCOPE("Node::InportReceivingRequestFromAgent");
 
 //	printf("%s Node #%d: New information request received from the Agent\n", LOG_LVL1, node_params.node_id);
 
-	LOGS(node_params.save_node_logs, node_logger.file, "+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n");
-	LOGS(node_params.save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s InportReceivingRequestFromAgent()\n",
+	NODE_LOGS(node_params.save_node_logs, node_logger, "+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n");
+	NODE_LOGS(node_params.save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s InportReceivingRequestFromAgent()\n",
 		SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL2);
 
 	// Generate the configuration to be sent to the agent
@@ -61,7 +62,7 @@ void Node :: InportReceivingRequestFromAgent() {
 	UpdatePerformanceMeasurements();
 
 	// Answer to the agent
-	LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Sending information to the Agent\n",
+	NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s Sending information to the Agent\n",
 		SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL2);
 
 	outportAnswerToAgent(configuration, performance_report);
@@ -69,7 +70,7 @@ void Node :: InportReceivingRequestFromAgent() {
 	// Restart performance metrics for future requests
 	RestartPerformanceMetrics(&performance_report, SimTime(), node_params.num_channels_allowed);
 
-	LOGS(node_params.save_node_logs,node_logger.file, "+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n");
+	NODE_LOGS(node_params.save_node_logs,node_logger, "+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n");
 
 }
 
@@ -78,8 +79,9 @@ void Node :: InportReceivingRequestFromAgent() {
  * @param "received_configuration" [type Configuration]: received configuration
  */
 void Node :: InportReceiveConfigurationFromAgent(Configuration &received_configuration) {
+	COST_PROFILE_SCOPE("Node::InportReceiveConfigurationFromAgent");
 
-	LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s New configuration received from the Agent\n",
+	NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s New configuration received from the Agent\n",
 		SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL2);
 
 	if(!flag_apply_new_configuration) {
@@ -104,7 +106,7 @@ void Node :: InportReceiveConfigurationFromAgent(Configuration &received_configu
  */
 void Node :: ApplyNewConfiguration(Configuration &new_configuration) {
 	// TODO: think about recommendation levels done by agents (e.g., Critical, Recommended ...)
-	LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Applying the new received configuration\n",
+	NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s Applying the new received configuration\n",
 		SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL2);
 	// Set new configuration according to received instructions
 	node_params.current_primary_channel = new_configuration.selected_primary_channel;
@@ -140,7 +142,7 @@ void Node :: ApplyNewConfiguration(Configuration &new_configuration) {
  */
 void Node :: BroadcastNewConfigurationToStas(Configuration &new_configuration) {
 	// ONLY APs connected to agents
-	LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Broadcasting the new configuration to STAs\n",
+	NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s Broadcasting the new configuration to STAs\n",
 		SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL2);
 	// Send the new configuration to the associated STAs
 	outportSetNewWlanConfiguration(new_configuration);
@@ -151,12 +153,13 @@ void Node :: BroadcastNewConfigurationToStas(Configuration &new_configuration) {
  * @param "received_configuration" [type Configuration]: struct containing the new configuration to be applied
  */
 void Node :: InportNewWlanConfigurationReceived(Configuration &received_configuration) {
+	COST_PROFILE_SCOPE("Node::InportNewWlanConfigurationReceived");
 
 	if (node_params.node_type == NODE_TYPE_STA) {
 
-		LOGS(node_params.save_node_logs, node_logger.file, "+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n");
+		NODE_LOGS(node_params.save_node_logs, node_logger, "+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n");
 
-		LOGS(node_params.save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s New configuration received from the AP\n",
+		NODE_LOGS(node_params.save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s New configuration received from the AP\n",
 			SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL2);
 
 		// Set new configuration
@@ -164,7 +167,7 @@ void Node :: InportNewWlanConfigurationReceived(Configuration &received_configur
 		if (node_params.save_node_logs) WriteReceivedConfiguration(node_logger, header_str, new_configuration);
 		// Set flag to true in order to apply the new configuration next time the node restarts
 		flag_apply_new_configuration = TRUE;
-		LOGS(node_params.save_node_logs,node_logger.file, "+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n");
+		NODE_LOGS(node_params.save_node_logs,node_logger, "+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n");
 
 //		if(node_state == STATE_SENSING) RestartNode(FALSE);
 		// Force restart
@@ -14,6 +14,7 @@
  *
  * Functions defined here (InportSomeNodeStartTX / InportSomeNodeFinishTX
  * dispatch + per-state handlers):
+ *   - Node::EvaluateReception
  *   - Node::HandleStartTX_StateSensing
  *   - Node::HandleStartTX_StateNav
  *   - Node::HandleStartTX_StateTxData
@@ -31,23 +32,42 @@
 #ifndef NODE_FSM_METHODS_H
 #define NODE_FSM_METHODS_H
 
+/**
+ * Receive evaluation of a frame: power of interest, interference sensed in the channels of the frame of interest,
+ * SINR and loss of the frame of interest, all read in place from the shared frames (nothing is copied). Sets
+ * power_rx_interest, max_pw_interference, channel_max_interference and current_sinr
+ * @param "notification_interest" [type Notification&]: frame being decoded (the new one if no reception is ongoing)
+ * @param "notification" [type Notification&]: frame that has just started
+ * @param "pd" [type double]: packet detect (PD) threshold in pW
+ * @return "loss_reason" [type int]: loss reason of the frame of interest (PACKET_NOT_LOST if it can be decoded)
+ */
+int Node :: EvaluateReception(const Notification &notification_interest, const Notification &notification, double pd) {
+	power_rx_interest = power_received_per_node.Power(notification_interest.source_id);
+	ComputeMaxInterference(&max_pw_interference, &channel_max_interference,
+		notification_interest, node_state, power_received_per_node, &channel_power);
+	current_sinr = UpdateSINR(power_rx_interest, max_pw_interference);
+	return IsPacketLost(node_params.current_primary_channel, notification_interest, notification,
+		current_sinr, node_params.capture_effect, pd, power_rx_interest, node_params.constant_per,
+		node_params.node_id, node_params.capture_effect_model, &random_stream);
+}
+
 /**
  * Handle InportSomeNodeStartTX for STATE_SENSING
  * Called when some node (this one included) starts a transmission
  * @param "notification" [type Notification]: notification containing the information of the transmission start perceived
  */
-void Node :: HandleStartTX_StateSensing(const Notification &notification) {
+void Node :: HandleStartTX_StateSensing(const NotificationFrame &notification) {
 
 	if(notification.destination_id == node_params.node_id){	// Node IS THE DESTINATION
 
 		// Update power received of interest
-		power_rx_interest = power_received_per_node[notification.source_id];
+		power_rx_interest = power_received_per_node.Power(notification.source_id);
 
 		current_left_channel = notification.left_channel;
 		current_right_channel = notification.right_channel;
 		current_modulation = notification.modulation_id;
 
-		LOGS(node_params.save_node_logs,node_logger.file,
+		NODE_LOGS(node_params.save_node_logs,node_logger,
 			"%.15f;N%d;S%d;%s;%s I am the TX destination (N%d). Checking if notification can be received.\n",
 			SimTime(), node_params.node_id, node_state, LOG_D07, LOG_LVL3,
 			notification.destination_id);
@@ -66,7 +86,7 @@ void Node :: HandleStartTX_StateSensing(const Notification &notification) {
 		ComputeMaxInterference(&max_pw_interference, &channel_max_interference,
 			notification, node_state, power_received_per_node, &channel_power);
 
-		LOGS(node_params.save_node_logs, node_logger.file,
+		NODE_LOGS(node_params.save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s P[%d] = %f dBm - P_st = %.2f dBm - P_if = %.2f dBm - P_noise = %.2f dBm\n",
 			SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL5,
 			channel_max_interference,
@@ -79,26 +99,26 @@ void Node :: HandleStartTX_StateSensing(const Notification &notification) {
 
 			current_sinr = UpdateSINR(power_rx_interest, max_pw_interference);
 
-			LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s SINR = %.2f dBm\n",
+			NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s SINR = %.2f dBm\n",
 				SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL5,
 				ConvertPower(LINEAR_TO_DB, current_sinr));
 
 			// Check if notification has been lost due to interferences or weak signal strength
 			loss_reason = IsPacketLost(node_params.current_primary_channel, notification, notification,
 					current_sinr, node_params.capture_effect, current_pd,
-					power_rx_interest, node_params.constant_per, node_params.node_id, node_params.capture_effect_model);
+					power_rx_interest, node_params.constant_per, node_params.node_id, node_params.capture_effect_model, &random_stream);
 
 			if(loss_reason != PACKET_NOT_LOST) {	// If RTS IS LOST, send logical Nack
 
 				// Check if lost due to BO collision
 				if(loss_reason == PACKET_LOST_INTERFERENCE){
-					if(fabs(outrange_nav_notification.timestamp - notification.timestamp)
+					if(fabs(outrange_nav_notification->timestamp - notification.timestamp)
 						< MAX_DIFFERENCE_SAME_TIME){
 						loss_reason = PACKET_LOST_BO_COLLISION;
 					}
 				}
 
-				LOGS(node_params.save_node_logs,node_logger.file,
+				NODE_LOGS(node_params.save_node_logs,node_logger,
 					"%.15f;N%d;S%d;%s;%s Reception of notification %d from N%d CANNOT be started because of reason %d\n",
 					SimTime(), node_params.node_id, node_state, LOG_D15, LOG_LVL4, notification.packet_id,
 					notification.source_id, loss_reason);
@@ -121,7 +141,7 @@ void Node :: HandleStartTX_StateSensing(const Notification &notification) {
 
 			} else {	// Data packet IS NOT LOST (it can be properly received)
 
-				LOGS(node_params.save_node_logs,node_logger.file,
+				NODE_LOGS(node_params.save_node_logs,node_logger,
 					"%.15f;N%d;S%d;%s;%s Reception of RTS #%d from N%d CAN be started (SINR = %f dB)\n",
 					SimTime(), node_params.node_id, node_state, LOG_D16, LOG_LVL4, notification.packet_id,
 					notification.source_id, ConvertPower(LINEAR_TO_DB, current_sinr));
@@ -156,7 +176,7 @@ void Node :: HandleStartTX_StateSensing(const Notification &notification) {
 
 			loss_reason = IsPacketLost(node_params.current_primary_channel, notification, notification,
 					current_sinr, node_params.capture_effect, current_pd,
-					power_rx_interest, node_params.constant_per, node_params.node_id, node_params.capture_effect_model);
+					power_rx_interest, node_params.constant_per, node_params.node_id, node_params.capture_effect_model, &random_stream);
 
 			if(loss_reason != PACKET_NOT_LOST) {
 
@@ -170,7 +190,7 @@ void Node :: HandleStartTX_StateSensing(const Notification &notification) {
 
 			} else {
 
-				LOGS(node_params.save_node_logs,node_logger.file,
+				NODE_LOGS(node_params.save_node_logs,node_logger,
 					"%.15f;N%d;S%d;%s;%s Reception of DATA #%d from N%d CAN be started (SINR = %f dB)\n",
 					SimTime(), node_params.node_id, node_state, LOG_D16, LOG_LVL4, notification.packet_id,
 					notification.source_id, ConvertPower(LINEAR_TO_DB, current_sinr));
@@ -203,7 +223,7 @@ void Node :: HandleStartTX_StateSensing(const Notification &notification) {
 				npca_sta_on_npca_channel = 1;
 			}
 		} else {	//	Notification does NOT CONTAIN an RTS or DATA
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 					"%.15f;N%d;S%d;%s;%s Unexpected packet type (%d) received!\n",
 					SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL4, notification.packet_type);
 		}
@@ -218,11 +238,7 @@ void Node :: HandleStartTX_StateSensing(const Notification &notification) {
 				&& notification.source_id != node_params.node_id
 				&& node_params.node_type == NODE_TYPE_AP) {
 
-			UpdateSINRFromNotification(notification);
-			loss_reason = IsPacketLost(node_params.current_primary_channel, notification, notification,
-				current_sinr, node_params.capture_effect, current_pd,
-				power_rx_interest, node_params.constant_per,
-				node_params.node_id, node_params.capture_effect_model);
+			loss_reason = EvaluateReception(notification, notification, current_pd);
 
 			if (loss_reason == PACKET_NOT_LOST) {
 				incoming_notification = notification;
@@ -248,7 +264,7 @@ void Node :: HandleStartTX_StateSensing(const Notification &notification) {
 						++mapc_peer_position;
 				}
 				if (node_is_transmitter) PauseBackoff();
-				LOGS(node_params.save_node_logs, node_logger.file,
+				NODE_LOGS(node_params.save_node_logs, node_logger,
 					"%.15f;N%d;S%d;%s;%s Received ICF from N%d -> STATE_RX_ICF (pos=%d)\n",
 					SimTime(), node_params.node_id, STATE_RX_ICF, LOG_D07, LOG_LVL2,
 					notification.source_id, mapc_peer_position);
@@ -265,18 +281,15 @@ void Node :: HandleStartTX_StateSensing(const Notification &notification) {
 			|| notification.packet_type == PACKET_TYPE_DSO_ICF
 			|| notification.packet_type == PACKET_TYPE_NPCA_ICF) {
 
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s I am not the TX destination (N%d to N%d). Checking if Frame can be decoded.\n",
 				SimTime(), node_params.node_id, node_state, LOG_D07, LOG_LVL2,
 				notification.source_id, notification.destination_id);
 
 			/** Can the packet be decoded? **/
-			UpdateSINRFromNotification(notification);
-			// 4 - Check if the packet is lost or not
-			loss_reason = IsPacketLost(node_params.current_primary_channel, notification, notification, current_sinr,
-				node_params.capture_effect, current_pd, power_rx_interest, node_params.constant_per, node_params.node_id, node_params.capture_effect_model);
+			loss_reason = EvaluateReception(notification, notification, current_pd);
 
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s Pmax_intf[%d] = %f dBm - P_st = %f dBm - P_if = %f dBm, sinr = %f dB\n",
 				SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL5,
 				channel_max_interference, ConvertPower(PW_TO_DBM, channel_power[channel_max_interference]),
@@ -289,7 +302,7 @@ void Node :: HandleStartTX_StateSensing(const Notification &notification) {
 
 			if(loss_reason == PACKET_NOT_LOST) { // RTS/DATA/CTS/ACK can be decoded
 
-				LOGS(node_params.save_node_logs,node_logger.file,
+				NODE_LOGS(node_params.save_node_logs,node_logger,
 					"%.15f;N%d;S%d;%s;%s Packet type %d can be decoded\n",
 					SimTime(), node_params.node_id, node_state, LOG_D07, LOG_LVL3, notification.packet_type);
 
@@ -330,7 +343,7 @@ void Node :: HandleStartTX_StateSensing(const Notification &notification) {
 						&& wlan.mapc_enabled
 						&& wlan.FindMapcGroupIdx(notification.mapc_group_id) >= 0) {
 					if (node_is_transmitter) PauseBackoff();
-					LOGS(node_params.save_node_logs, node_logger.file,
+					NODE_LOGS(node_params.save_node_logs, node_logger,
 						"%.15f;N%d;S%d;%s;%s ICF/TF for own MAPC group %d: stay in SENSING to receive DATA\n",
 						SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL3, notification.mapc_group_id);
 				// MAPC Co-TDMA: if ICR is for our MAPC group, don't set NAV - DATA will follow
@@ -340,7 +353,7 @@ void Node :: HandleStartTX_StateSensing(const Notification &notification) {
 						&& wlan.mapc_enabled
 						&& wlan.FindMapcGroupIdx(notification.mapc_group_id) >= 0) {
 					if (node_is_transmitter) PauseBackoff();
-					LOGS(node_params.save_node_logs, node_logger.file,
+					NODE_LOGS(node_params.save_node_logs, node_logger,
 						"%.15f;N%d;S%d;%s;%s ICR for own MAPC group %d: stay in SENSING to receive upcoming DATA\n",
 						SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL3, notification.mapc_group_id);
 				// MAPC Co-TDMA: if MU-RTS/TXS is addressed to our own AP, don't set NAV -
@@ -349,7 +362,7 @@ void Node :: HandleStartTX_StateSensing(const Notification &notification) {
 						&& node_params.node_type == NODE_TYPE_STA
 						&& notification.destination_id == wlan.ap_id) {
 					if (node_is_transmitter) PauseBackoff();
-					LOGS(node_params.save_node_logs, node_logger.file,
+					NODE_LOGS(node_params.save_node_logs, node_logger,
 						"%.15f;N%d;S%d;%s;%s MU-RTS/TXS to own AP N%d: stay in SENSING to receive upcoming DATA\n",
 						SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL3, wlan.ap_id);
 				} else if(pause) {
@@ -375,12 +388,12 @@ void Node :: HandleStartTX_StateSensing(const Notification &notification) {
 						trigger_NAV_timeout.Set(FixTimeOffset(time_to_trigger,13,12));
 					}
 
-					LOGS(node_params.save_node_logs,node_logger.file,
+					NODE_LOGS(node_params.save_node_logs,node_logger,
 						"%.15f;N%d;S%d;%s;%s Entering in NAV during %.12f and setting NAV timeout to %.12f\n",
 						SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL3,
 						current_nav_time, trigger_NAV_timeout.GetTime());
 
-//							LOGS(node_params.save_node_logs,node_logger.file,
+//							NODE_LOGS(node_params.save_node_logs,node_logger,
 //								"%.15f;N%d;S%d;%s;%s current_nav_time = %.12f\n",
 //								SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL4,
 //								current_nav_time);
@@ -393,7 +406,7 @@ void Node :: HandleStartTX_StateSensing(const Notification &notification) {
 
 			} else { // Frame cannot be decoded.
 
-				LOGS(node_params.save_node_logs,node_logger.file,
+				NODE_LOGS(node_params.save_node_logs,node_logger,
 					"%.15f;N%d;S%d;%s;%s Frame sent by N%d could not be decoded for reason %d\n",
 					SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL3,
 					notification.source_id, loss_reason);
@@ -404,7 +417,7 @@ void Node :: HandleStartTX_StateSensing(const Notification &notification) {
 				// Check if DIFS or BO must be stopped
 				if(node_is_transmitter){
 
-					LOGS(node_params.save_node_logs,node_logger.file,
+					NODE_LOGS(node_params.save_node_logs,node_logger,
 						"%.15f;N%d;S%d;%s;%s Checking if BO must be paused...\n",
 						SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL4);
 
@@ -422,9 +435,9 @@ void Node :: HandleStartTX_StateSensing(const Notification &notification) {
 					if (pause) {
 						PauseBackoff();
 					} else {
-						if(trigger_end_backoff.Active()) ca_state.remaining_backoff =
+						if(BackoffCountingDown()) ca_state.remaining_backoff =
 								ComputeRemainingBackoff(node_params.backoff_type, trigger_end_backoff.GetTime() - SimTime());
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 							"%.15f;N%d;S%d;%s;%s BO must not be paused (%f remaining slots).\n",
 							SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL5, ca_state.remaining_backoff/SLOT_TIME);
 					}
@@ -441,7 +454,7 @@ void Node :: HandleStartTX_StateSensing(const Notification &notification) {
 /**
  * Handle InportSomeNodeStartTX for STATE_NAV
  */
-void Node :: HandleStartTX_StateNav(const Notification &notification) {
+void Node :: HandleStartTX_StateNav(const NotificationFrame &notification) {
 
 	int nav_collision(0);
 	int inter_bss_nav_collision(0);
@@ -460,13 +473,8 @@ void Node :: HandleStartTX_StateNav(const Notification &notification) {
 			// nulled directions do not inflate the interference estimate.
 			// (channel_power uses raw path loss with no BF gain applied.)
 			if (notification.tx_info.beamforming_active) {
-				power_rx_interest = power_received_per_node[notification.source_id];
-				max_pw_interference = 0;
-				for (std::map<int,double>::iterator _it = power_received_per_node.begin();
-						_it != power_received_per_node.end(); ++_it) {
-					if (_it->first != notification.source_id)
-						max_pw_interference += _it->second;
-				}
+				power_rx_interest = power_received_per_node.Power(notification.source_id);
+				max_pw_interference = power_received_per_node.TotalPowerExcept(notification.source_id);
 				current_sinr = UpdateSINR(power_rx_interest, max_pw_interference);
 			} else {
 				UpdateSINRFromNotification(notification);
@@ -483,7 +491,7 @@ void Node :: HandleStartTX_StateNav(const Notification &notification) {
 				} else {
 					loss_reason = IsPacketLost(node_params.current_primary_channel, notification, notification,
 						current_sinr, node_params.capture_effect, current_pd,
-						power_rx_interest, node_params.constant_per, node_params.node_id, node_params.capture_effect_model);
+						power_rx_interest, node_params.constant_per, node_params.node_id, node_params.capture_effect_model, &random_stream);
 				}
 			}
 
@@ -506,7 +514,7 @@ void Node :: HandleStartTX_StateNav(const Notification &notification) {
 
 			} else {
 
-				LOGS(node_params.save_node_logs,node_logger.file,
+				NODE_LOGS(node_params.save_node_logs,node_logger,
 					"%.15f;N%d;S%d;%s;%s Reception of DATA #%d from N%d CAN be started (SINR = %f dB)\n",
 					SimTime(), node_params.node_id, node_state, LOG_D16, LOG_LVL4, notification.packet_id,
 					notification.source_id, ConvertPower(LINEAR_TO_DB, current_sinr));
@@ -550,26 +558,22 @@ void Node :: HandleStartTX_StateNav(const Notification &notification) {
 
 			if(notification.packet_type == PACKET_TYPE_RTS) {	// Notification CONTAINS an RTS PACKET
 
-				LOGS(node_params.save_node_logs,node_logger.file,
+				NODE_LOGS(node_params.save_node_logs,node_logger,
 					"%.15f;N%d;S%d;%s;%s RTS from my AP N%d sent simultaneously\n",
 					SimTime(), node_params.node_id, node_state, LOG_D16, LOG_LVL4,
 					notification.source_id);
 
-				UpdateSINRFromNotification(notification);
+				// Check if notification has been lost due to interferences or weak signal strength
+				// TODO: method for checking whether the detected transmission can be decoded or not
+				loss_reason = EvaluateReception(notification, notification, current_pd);
 
-				LOGS(node_params.save_node_logs,node_logger.file,
+				NODE_LOGS(node_params.save_node_logs,node_logger,
 					"%.15f;N%d;S%d;%s;%s P[%d] = %f dBm - P_st = %f dBm - P_if = %f dBm\n",
 					SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL5, channel_max_interference,
 					ConvertPower(PW_TO_DBM, channel_power[channel_max_interference]),
 					ConvertPower(PW_TO_DBM, power_rx_interest),
 					ConvertPower(PW_TO_DBM, max_pw_interference));
 
-				// Check if notification has been lost due to interferences or weak signal strength
-				// TODO: method for checking whether the detected transmission can be decoded or not
-				loss_reason = IsPacketLost(node_params.current_primary_channel, notification, notification,
-					current_sinr, node_params.capture_effect, current_pd,
-					power_rx_interest, node_params.constant_per, node_params.node_id, node_params.capture_effect_model);
-
 				if(loss_reason != PACKET_NOT_LOST) {	// If RTS IS LOST, send logical Nack
 
 					loss_reason = PACKET_LOST_BO_COLLISION;
@@ -582,7 +586,7 @@ void Node :: HandleStartTX_StateNav(const Notification &notification) {
 						// Trigger the restart then.
 
 						// Sergio on 27/09/2017. Review this case
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 							"%.15f;N%d;S%d;%s;%s RTS from my AP CANNOT be decoded\n",
 							SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL5);
 
@@ -600,7 +604,7 @@ void Node :: HandleStartTX_StateNav(const Notification &notification) {
 					// EOF HandleSlottedBackoffCollision();
 
 					if(node_params.nack_activated) {
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 							"%.15f;N%d;S%d;%s;%s RTS cannot be decoded (SINR = %f dB) -> Sending NACK corresponding to BO collision to N%d\n",
 							SimTime(), node_params.node_id, node_state, LOG_D16, LOG_LVL5,
 							ConvertPower(LINEAR_TO_DB, current_sinr), notification.source_id);
@@ -612,7 +616,7 @@ void Node :: HandleStartTX_StateNav(const Notification &notification) {
 
 				} else {	// Data packet IS NOT LOST (it can be properly received)
 
-					LOGS(node_params.save_node_logs,node_logger.file,
+					NODE_LOGS(node_params.save_node_logs,node_logger,
 						"%.15f;N%d;S%d;%s;%s Reception of RTS #%d from N%d CAN be started (SINR = %f dB)\n",
 						SimTime(), node_params.node_id, node_state, LOG_D16, LOG_LVL4, notification.packet_id,
 						notification.source_id, ConvertPower(LINEAR_TO_DB, current_sinr));
@@ -620,12 +624,12 @@ void Node :: HandleStartTX_StateNav(const Notification &notification) {
 					// Cancel the previous NAV
 					if ( sr_state.spatial_reuse_enabled ) {
 						trigger_inter_bss_NAV_timeout.Cancel(); // Cancel inter-BSS NAV
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 							"%.15f;N%d;S%d;%s;%s INTER-BSS NAV CANCELLED!\n",
 							SimTime(), node_params.node_id, node_state, LOG_D16, LOG_LVL4);
 					} else {
 						trigger_NAV_timeout.Cancel();			// Cancel intra-BSS NAV (legacy)
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 							"%.15f;N%d;S%d;%s;%s DEFAULT NAV CANCELLED!\n",
 							SimTime(), node_params.node_id, node_state, LOG_D16, LOG_LVL4);
 					}
@@ -651,7 +655,7 @@ void Node :: HandleStartTX_StateNav(const Notification &notification) {
 				}
 
 			} else {	//	Notification does NOT CONTAIN an RTS or DATA
-				LOGS(node_params.save_node_logs,node_logger.file,
+				NODE_LOGS(node_params.save_node_logs,node_logger,
 						"%.15f;N%d;S%d;%s;%s Unexpected packet type (%d) received!\n",
 						SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL4, notification.packet_type);
 			}
@@ -679,23 +683,20 @@ void Node :: HandleStartTX_StateNav(const Notification &notification) {
 
 			// TODO: determine if can be decoded!
 
-			UpdateSINRFromNotification(notification);
-			LOGS(node_params.save_node_logs, node_logger.file,
+			// Check if notification can be decoded
+			// TODO: method for checking whether the detected transmission can be decoded or not
+			int loss_reason (EvaluateReception(notification, notification, current_pd));
+			NODE_LOGS(node_params.save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s P[%d] = %f dBm - P_st = %f dBm - P_if = %f dBm\n",
 				SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL5, channel_max_interference,
 				ConvertPower(PW_TO_DBM, channel_power[channel_max_interference]),
 				ConvertPower(PW_TO_DBM, power_rx_interest),
 				ConvertPower(PW_TO_DBM, max_pw_interference));
-			// Check if notification can be decoded
-			// TODO: method for checking whether the detected transmission can be decoded or not
-			int loss_reason (IsPacketLost(node_params.current_primary_channel, notification, notification,
-				current_sinr, node_params.capture_effect, current_pd, power_rx_interest, node_params.constant_per,
-				node_params.node_id, node_params.capture_effect_model));
 
 			// NAV collision detected
 			if((nav_collision || inter_bss_nav_collision) && loss_reason == PACKET_NOT_LOST)  {
 
-				LOGS(node_params.save_node_logs, node_logger.file,
+				NODE_LOGS(node_params.save_node_logs, node_logger,
 					"%.15f;N%d;S%d;%s;%s Updating the NAV according to the last sensed transmission\n",
 					SimTime(), node_params.node_id, node_state, LOG_D07, LOG_LVL2);
 
@@ -706,21 +707,21 @@ void Node :: HandleStartTX_StateNav(const Notification &notification) {
 					if (sr_state.spatial_reuse_enabled && inter_bss_nav_collision) {
 						trigger_inter_bss_NAV_timeout.Cancel(); // Cancel inter-BSS NAV
 						trigger_inter_bss_NAV_timeout.Set(FixTimeOffset(time_to_trigger,13,12));
-						LOGS(node_params.save_node_logs, node_logger.file,
+						NODE_LOGS(node_params.save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s (workaround) setting inter-BSS NAV trigger to %.12f\n",
 							SimTime(), node_params.node_id, node_state, LOG_D07, LOG_LVL3, time_to_trigger);
 					} else {
 						trigger_NAV_timeout.Cancel();			// Cancel intra-BSS NAV (legacy)
 						trigger_NAV_timeout.Set(FixTimeOffset(time_to_trigger,13,12));
-						LOGS(node_params.save_node_logs, node_logger.file,
+						NODE_LOGS(node_params.save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s (workaround) setting NAV trigger to %.12f\n",
 							SimTime(), node_params.node_id, node_state, LOG_D07, LOG_LVL3, time_to_trigger);
 					}
 
 				} else {
 
-					if ( (nav_collision && nav_notification.packet_type == notification.packet_type)
-						|| (inter_bss_nav_collision && nav_notification.packet_type == notification.packet_type) ) {
+					if ( (nav_collision && nav_notification->packet_type == notification.packet_type)
+						|| (inter_bss_nav_collision && nav_notification->packet_type == notification.packet_type) ) {
 
 						// if(node_params.save_node_logs) fprintf(node_logger.file,
 						//	"%.15f;N%d;S%d;%s;%s Waiting just in case of more collisions.\n",
@@ -744,7 +745,7 @@ void Node :: HandleStartTX_StateNav(const Notification &notification) {
 
 						trigger_wait_collisions.Set(FixTimeOffset(time_to_trigger,13,12));
 
-						LOGS(node_params.save_node_logs, node_logger.file,
+						NODE_LOGS(node_params.save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s Recovering from EIFS at %.12f (preoc. = %.12f)\n",
 							SimTime(), node_params.node_id, node_state, LOG_D07, LOG_LVL4,
 							trigger_wait_collisions.GetTime(),
@@ -757,15 +758,16 @@ void Node :: HandleStartTX_StateNav(const Notification &notification) {
 
 			} else { // No collision
 
-				LOGS(node_params.save_node_logs, node_logger.file,
+				NODE_LOGS(node_params.save_node_logs, node_logger,
 					"%.15f;N%d;S%d;%s;%s I am not the TX destination (N%d to N%d). Checking if new RTS/CTS can be decoded.\n",
 					SimTime(), node_params.node_id, node_state, LOG_D07, LOG_LVL2,
 					notification.source_id, notification.destination_id);
 
 				// Can the notification be decoded?
-				UpdateSINRFromNotification(notification);
+				// TODO: method for checking whether the detected transmission can be decoded or not
+				loss_reason = EvaluateReception(notification, notification, current_pd);
 
-				LOGS(node_params.save_node_logs, node_logger.file,
+				NODE_LOGS(node_params.save_node_logs, node_logger,
 					"%.15f;N%d;S%d;%s;%s Pmax_intf[%d] = %f dBm - P_st = %f dBm - P_if = %f dBm, sinr = %f dB\n",
 					SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL5,
 					channel_max_interference, ConvertPower(PW_TO_DBM, channel_power[channel_max_interference]),
@@ -773,11 +775,6 @@ void Node :: HandleStartTX_StateNav(const Notification &notification) {
 					ConvertPower(PW_TO_DBM, max_pw_interference),
 					ConvertPower(LINEAR_TO_DB,current_sinr));
 
-				// TODO: method for checking whether the detected transmission can be decoded or not
-				loss_reason = IsPacketLost(node_params.current_primary_channel, notification, notification,
-					current_sinr, node_params.capture_effect, current_pd, power_rx_interest, node_params.constant_per,
-					node_params.node_id, node_params.capture_effect_model);
-
 				int power_condition (channel_power[node_params.current_primary_channel] > node_params.sensitivity_default);
 
 				if (loss_reason == PACKET_NOT_LOST && power_condition) {	// Packet IS NOT LOST
@@ -808,7 +805,7 @@ void Node :: HandleStartTX_StateNav(const Notification &notification) {
 							trigger_NAV_timeout.Set(FixTimeOffset(time_to_trigger,13,12));
 						}
 
-						LOGS(node_params.save_node_logs, node_logger.file,
+						NODE_LOGS(node_params.save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s MAPC round update from N%d (type %d): re-arming NAV during %.12f, new timeout %.12f\n",
 							SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL3,
 							notification.source_id, notification.packet_type,
@@ -821,7 +818,7 @@ void Node :: HandleStartTX_StateNav(const Notification &notification) {
 				} else {			// Packet IS LOST
 					if(notification.packet_type == PACKET_TYPE_RTS
 							||  notification.packet_type == PACKET_TYPE_CTS){
-						LOGS(node_params.save_node_logs, node_logger.file,
+						NODE_LOGS(node_params.save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s RTS/CTS sent from N%d could not be decoded for reason %d\n",
 							SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL3,
 							notification.source_id, loss_reason);
@@ -836,16 +833,16 @@ void Node :: HandleStartTX_StateNav(const Notification &notification) {
 /**
  * Handle InportSomeNodeStartTX for STATE_TX_DATA
  */
-void Node :: HandleStartTX_StateTxData(const Notification &notification) {
+void Node :: HandleStartTX_StateTxData(const NotificationFrame &notification) {
 
 	if(notification.destination_id == node_params.node_id){ // Node IS THE DESTINATION
 
-		LOGS(node_params.save_node_logs, node_logger.file,
+		NODE_LOGS(node_params.save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s I am the TX destination (N%d)\n",
 			SimTime(), node_params.node_id, node_state, LOG_D07, LOG_LVL3,
 			notification.destination_id);
 
-		LOGS(node_params.save_node_logs, node_logger.file,
+		NODE_LOGS(node_params.save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s I am transmitting, packet cannot be received\n",
 			SimTime(), node_params.node_id, node_state, LOG_D18, LOG_LVL3);
 
@@ -859,7 +856,7 @@ void Node :: HandleStartTX_StateTxData(const Notification &notification) {
 
 	} else {	// Node IS NOT THE DESTINATION, do nothing
 
-//					LOGS(node_params.save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s I am NOT the TX destination (N%d)\n",
+//					NODE_LOGS(node_params.save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s I am NOT the TX destination (N%d)\n",
 //						SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL3, notification.destination_id);
 
 	}
@@ -881,11 +878,11 @@ void Node :: HandleStartTX_StateTxData(const Notification &notification) {
 /**
  * Handle InportSomeNodeStartTX for STATE_RX_DATA
  */
-void Node :: HandleStartTX_StateRxData(const Notification &notification) {
+void Node :: HandleStartTX_StateRxData(const NotificationFrame &notification) {
 
 	if(notification.destination_id == node_params.node_id){	// Node IS THE DESTINATION
 
-//					LOGS(node_params.save_node_logs, node_logger.file,
+//					NODE_LOGS(node_params.save_node_logs, node_logger,
 //							"%.15f;N%d;S%d;%s;%s I am the TX destination (N%d)\n",
 //							SimTime(), node_params.node_id, node_state, LOG_D07, LOG_LVL3, notification.destination_id);
 
@@ -893,9 +890,9 @@ void Node :: HandleStartTX_StateRxData(const Notification &notification) {
 		current_sinr = UpdateSINR(power_rx_interest, max_pw_interference);
 
 		// Check if ongoing notification has been lost due to interferences caused by new transmission
-		loss_reason = IsPacketLost(node_params.current_primary_channel, incoming_notification, notification,
+		loss_reason = IsPacketLost(node_params.current_primary_channel, *incoming_notification, notification,
 			current_sinr, node_params.capture_effect, current_pd,
-			power_rx_interest, node_params.constant_per, node_params.node_id, node_params.capture_effect_model);
+			power_rx_interest, node_params.constant_per, node_params.node_id, node_params.capture_effect_model, &random_stream);
 
 		// TODO: method for checking whether the detected transmission can be decoded or not
 		// ...
@@ -906,12 +903,12 @@ void Node :: HandleStartTX_StateRxData(const Notification &notification) {
 				if(loss_reason != PACKET_NOT_LOST
 					&& loss_reason != PACKET_LOST_OUTSIDE_CH_RANGE)  {	// If ongoing data packet IS LOST
 						// Pure collision (two nodes transmitting to me with enough power)
-						LOGS(node_params.save_node_logs, node_logger.file,
+						NODE_LOGS(node_params.save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s Pure collision! Already receiving from N%d\n",
 							SimTime(), node_params.node_id, node_state, LOG_D19, LOG_LVL4, receiving_from_node_id);
 						loss_reason = PACKET_LOST_PURE_COLLISION;
 						// If two or more packets sent at the same time
-						if(fabs(notification.timestamp - incoming_notification.timestamp) < MAX_DIFFERENCE_SAME_TIME){
+						if(fabs(notification.timestamp - incoming_notification->timestamp) < MAX_DIFFERENCE_SAME_TIME){
 							// SERGIO HandleSlottedBackoffCollision();
 							loss_reason = PACKET_LOST_BO_COLLISION;
 							if(!node_is_transmitter) {
@@ -923,15 +920,15 @@ void Node :: HandleStartTX_StateRxData(const Notification &notification) {
 						}
 						if(node_params.nack_activated) {
 							// Send NACK to both ongoing transmitter and incoming interferer nodes
-							logical_nack = GenerateLogicalNack(notification.packet_type, nav_notification.packet_id,
-									node_params.node_id, nav_notification.source_id, notification.source_id, loss_reason, BER, current_sinr);
+							logical_nack = GenerateLogicalNack(notification.packet_type, nav_notification->packet_id,
+									node_params.node_id, nav_notification->source_id, notification.source_id, loss_reason, BER, current_sinr);
 							SendLogicalNack(logical_nack);
 						}
 
 				} else {	// If ongoing data packet IS NOT LOST (incoming transmission does not affect ongoing reception)
 
 					if (node_params.nack_activated) {
-						LOGS(node_params.save_node_logs, node_logger.file,
+						NODE_LOGS(node_params.save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s Low strength signal received while already receiving from N%d\n",
 							SimTime(), node_params.node_id, node_state, LOG_D20, LOG_LVL4, receiving_from_node_id);
 
@@ -947,8 +944,8 @@ void Node :: HandleStartTX_StateRxData(const Notification &notification) {
 			}
 
 			case CE_IEEE_802_11:{
-				int capture_effect_condition (power_received_per_node[notification.source_id] >
-					power_received_per_node[receiving_from_node_id] + node_params.capture_effect);
+				int capture_effect_condition (power_received_per_node.Power(notification.source_id) >
+					power_received_per_node.Power(receiving_from_node_id) + node_params.capture_effect);
 
 				if (loss_reason == PACKET_NOT_LOST && capture_effect_condition) {
 					if (notification.packet_type == PACKET_TYPE_RTS) {
@@ -968,18 +965,18 @@ void Node :: HandleStartTX_StateRxData(const Notification &notification) {
 						if(node_is_transmitter) PauseBackoff();
 						if (node_params.nack_activated) {
 							// Send NACK to both ongoing transmitter and incoming interferer nodes
-							logical_nack = GenerateLogicalNack(notification.packet_type, nav_notification.packet_id,
+							logical_nack = GenerateLogicalNack(notification.packet_type, nav_notification->packet_id,
 									node_params.node_id, NODE_ID_NONE, notification.source_id, PACKET_LOST_CAPTURE_EFFECT, BER, current_sinr);
 							SendLogicalNack(logical_nack);
 						}
 					}  else {
 						// Pure collision (two nodes transmitting to me with enough power)
-						LOGS(node_params.save_node_logs, node_logger.file,
+						NODE_LOGS(node_params.save_node_logs, node_logger,
 							"%.15f;N%d;S%d;%s;%s Pure collision! Already receiving from N%d\n",
 							SimTime(), node_params.node_id, node_state, LOG_D19, LOG_LVL4, receiving_from_node_id);
 						loss_reason = PACKET_LOST_PURE_COLLISION;
 						// If two or more packets sent at the same time
-						if(fabs(notification.timestamp - incoming_notification.timestamp) < MAX_DIFFERENCE_SAME_TIME) {
+						if(fabs(notification.timestamp - incoming_notification->timestamp) < MAX_DIFFERENCE_SAME_TIME) {
 							loss_reason = PACKET_LOST_BO_COLLISION;
 							if(!node_is_transmitter) {
 								time_to_trigger = SimTime() + MAX_DIFFERENCE_SAME_TIME;
@@ -990,14 +987,14 @@ void Node :: HandleStartTX_StateRxData(const Notification &notification) {
 						}
 						if(node_params.nack_activated){
 							// Send NACK to both ongoing transmitter and incoming interferer nodes
-							logical_nack = GenerateLogicalNack(notification.packet_type, nav_notification.packet_id,
-									node_params.node_id, nav_notification.source_id, notification.source_id, loss_reason, BER, current_sinr);
+							logical_nack = GenerateLogicalNack(notification.packet_type, nav_notification->packet_id,
+									node_params.node_id, nav_notification->source_id, notification.source_id, loss_reason, BER, current_sinr);
 							SendLogicalNack(logical_nack);
 						}
 					}
 				} else { // If ongoing data packet IS NOT LOST (incoming transmission does not affect ongoing reception)
 					if(node_params.nack_activated){
-						LOGS(node_params.save_node_logs, node_logger.file,
+						NODE_LOGS(node_params.save_node_logs, node_logger,
 								"%.15f;N%d;S%d;%s;%s Low strength signal received while already receiving from N%d\n",
 							SimTime(), node_params.node_id, node_state, LOG_D20, LOG_LVL4, receiving_from_node_id);
 						// Send logical NACK to incoming transmitter indicating that node is already receiving
@@ -1012,7 +1009,7 @@ void Node :: HandleStartTX_StateRxData(const Notification &notification) {
 
 	} else {	// Node is NOT THE DESTINATION
 
-//					LOGS(node_params.save_node_logs, node_logger.file,
+//					NODE_LOGS(node_params.save_node_logs, node_logger,
 //						"%.15f;N%d;S%d;%s;%s I am NOT the TX destination (N%d)\n",
 //						SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL3, notification.destination_id);
 
@@ -1020,22 +1017,17 @@ void Node :: HandleStartTX_StateRxData(const Notification &notification) {
 		// active, derive interference from per-node BF-corrected powers so that
 		// nulled directions do not inflate the interference estimate.
 		if (notification.tx_info.beamforming_active) {
-			max_pw_interference = 0;
-			for (std::map<int,double>::iterator _it = power_received_per_node.begin();
-					_it != power_received_per_node.end(); ++_it) {
-				if (_it->first != incoming_notification.source_id)
-					max_pw_interference += _it->second;
-			}
+			max_pw_interference = power_received_per_node.TotalPowerExcept(incoming_notification->source_id);
 		} else {
 			// Compute max interference (the highest one perceived in the reception channel range)
 			ComputeMaxInterference(&max_pw_interference, &channel_max_interference,
-				incoming_notification, node_state, power_received_per_node, &channel_power);
+				*incoming_notification, node_state, power_received_per_node, &channel_power);
 		}
 
 		// Check if the ongoing reception is affected
 		current_sinr = UpdateSINR(power_rx_interest, max_pw_interference);
 
-		LOGS(node_params.save_node_logs, node_logger.file,
+		NODE_LOGS(node_params.save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s P[%d] = %f dBm - P_st = %f dBm - P_if = %f dBm - current_sinr = %.2f dBm\n",
 			SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL5, channel_max_interference,
 			ConvertPower(PW_TO_DBM, channel_power[channel_max_interference]),
@@ -1049,26 +1041,26 @@ void Node :: HandleStartTX_StateRxData(const Notification &notification) {
 			int _cobf_g = wlan.mapc_enabled
 				? wlan.FindMapcGroupIdx(notification.mapc_group_id) : -1;
 			int _ongoing_g = wlan.mapc_enabled
-				? wlan.FindMapcGroupIdx(incoming_notification.mapc_group_id) : -1;
+				? wlan.FindMapcGroupIdx(incoming_notification->mapc_group_id) : -1;
 			if (_cobf_g >= 0 && _cobf_g == _ongoing_g
 					&& wlan.mapc_method_ids[_cobf_g] == CO_BF) {
 				loss_reason = PACKET_NOT_LOST;
 			// Check if the notification that was already being received is lost due to new notification
 			} else if (sr_state.spatial_reuse_enabled && sr_state.txop_sr_identified) {
-				loss_reason = IsPacketLost(node_params.current_primary_channel, incoming_notification, notification,
+				loss_reason = IsPacketLost(node_params.current_primary_channel, *incoming_notification, notification,
 					current_sinr, node_params.capture_effect, sr_state.current_obss_pd_threshold,
-					power_rx_interest, node_params.constant_per, node_params.node_id, node_params.capture_effect_model);
+					power_rx_interest, node_params.constant_per, node_params.node_id, node_params.capture_effect_model, &random_stream);
 			} else {
-				loss_reason = IsPacketLost(node_params.current_primary_channel, incoming_notification, notification,
+				loss_reason = IsPacketLost(node_params.current_primary_channel, *incoming_notification, notification,
 					current_sinr, node_params.capture_effect, current_pd,
-					power_rx_interest, node_params.constant_per, node_params.node_id, node_params.capture_effect_model);
+					power_rx_interest, node_params.constant_per, node_params.node_id, node_params.capture_effect_model, &random_stream);
 			}
 		}
 
 		// TODO: method for checking whether the detected transmission can be decoded or not
 		// ...
 
-		LOGS(node_params.save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s loss_reason = %d\n",
+		NODE_LOGS(node_params.save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s loss_reason = %d\n",
 			SimTime(), node_params.node_id, node_state, LOG_D19, LOG_LVL4, loss_reason);
 
 		if(loss_reason != PACKET_NOT_LOST) { 	// If ongoing packet reception IS LOST
@@ -1077,20 +1069,20 @@ void Node :: HandleStartTX_StateRxData(const Notification &notification) {
 
 				case CE_DEFAULT:{
 					// Collision by hidden node
-					LOGS(node_params.save_node_logs, node_logger.file,
+					NODE_LOGS(node_params.save_node_logs, node_logger,
 						"%.15f;N%d;S%d;%s;%s Collision by interferences!\n",
 						SimTime(), node_params.node_id, node_state, LOG_D19, LOG_LVL4);
 
 						// If two or more packets sent at the same time
 					if(node_state == STATE_RX_RTS && notification.packet_type == PACKET_TYPE_RTS){
-						if(fabs(notification.timestamp - incoming_notification.timestamp) < MAX_DIFFERENCE_SAME_TIME){
+						if(fabs(notification.timestamp - incoming_notification->timestamp) < MAX_DIFFERENCE_SAME_TIME){
 							loss_reason = PACKET_LOST_BO_COLLISION;
 						}
 					}
 					// Send logical NACK to ongoing transmitter
 					if (node_params.nack_activated) {
-						logical_nack = GenerateLogicalNack(incoming_notification.packet_type,
-							incoming_notification.packet_id, node_params.node_id, incoming_notification.source_id,
+						logical_nack = GenerateLogicalNack(incoming_notification->packet_type,
+							incoming_notification->packet_id, node_params.node_id, incoming_notification->source_id,
 							NODE_ID_NONE, loss_reason, BER, current_sinr);
 						SendLogicalNack(logical_nack);
 					}
@@ -1099,19 +1091,19 @@ void Node :: HandleStartTX_StateRxData(const Notification &notification) {
 				}
 
 				case CE_IEEE_802_11:{
-					int capture_effect_condition = power_received_per_node[notification.source_id] >
-						power_received_per_node[receiving_from_node_id] + node_params.capture_effect;
+					int capture_effect_condition = power_received_per_node.Power(notification.source_id) >
+						power_received_per_node.Power(receiving_from_node_id) + node_params.capture_effect;
 					if (capture_effect_condition) {
 						loss_reason = PACKET_LOST_CAPTURE_EFFECT;
 						printf("Node %d was in state RX (from %d), and a new notification arrived from %d:\n", node_params.node_id, receiving_from_node_id, notification.source_id);
-						printf("	* New RSSI: %f\n", power_received_per_node[notification.source_id]);
-						printf("	* Old RSSI: %f:\n", power_received_per_node[receiving_from_node_id]);
+						printf("	* New RSSI: %f\n", power_received_per_node.Power(notification.source_id));
+						printf("	* Old RSSI: %f:\n", power_received_per_node.Power(receiving_from_node_id));
 						printf("	* CE: %f:\n", node_params.capture_effect);
 						printf("	* loss_reason: %d:\n", loss_reason);
 						if(node_params.nack_activated){
 						// Send NACK to both ongoing transmitter and incoming interferer nodes
-						logical_nack = GenerateLogicalNack(notification.packet_type, nav_notification.packet_id,
-							node_params.node_id, nav_notification.source_id, notification.source_id, loss_reason, BER, current_sinr);
+						logical_nack = GenerateLogicalNack(notification.packet_type, nav_notification->packet_id,
+							node_params.node_id, nav_notification->source_id, notification.source_id, loss_reason, BER, current_sinr);
 						SendLogicalNack(logical_nack);
 						}
 						RestartNode(FALSE);
@@ -1127,43 +1119,35 @@ void Node :: HandleStartTX_StateRxData(const Notification &notification) {
 /**
  * Handle InportSomeNodeStartTX for STATE_WAIT_ACK
  */
-void Node :: HandleStartTX_StateWaitAck(const Notification &notification) {
+void Node :: HandleStartTX_StateWaitAck(const NotificationFrame &notification) {
 
 	if(notification.destination_id == node_params.node_id){	// Node is the destination
 
-		power_rx_interest = power_received_per_node[notification.source_id];
+		power_rx_interest = power_received_per_node.Power(notification.source_id);
 
 		incoming_notification = notification;
 
-//					LOGS(node_params.save_node_logs, node_logger.file,
+//					NODE_LOGS(node_params.save_node_logs, node_logger,
 //							"%.15f;N%d;S%d;%s;%s I am the TX destination (N%d). Checking if notification can be received.\n",
 //							SimTime(), node_params.node_id, node_state, LOG_D07, LOG_LVL3, notification.destination_id);
 
 		if(notification.packet_type == PACKET_TYPE_ACK){	// ACK packet transmission started
 
-			// Compute max interference (the highest one perceived in the reception channel range)
-			ComputeMaxInterference(&max_pw_interference, &channel_max_interference,
-				incoming_notification, node_state, power_received_per_node, &channel_power);
-
 			// Check if notification has been lost due to interferences or weak signal strength
-			current_sinr = UpdateSINR(power_rx_interest, max_pw_interference);
-
 			// TODO: method for checking whether the detected transmission can be decoded or not
-			loss_reason = IsPacketLost(node_params.current_primary_channel, incoming_notification, notification,
-					current_sinr, node_params.capture_effect, current_pd,
-					power_rx_interest, node_params.constant_per, node_params.node_id, node_params.capture_effect_model);
+			loss_reason = EvaluateReception(*incoming_notification, notification, current_pd);
 
 			if(loss_reason != PACKET_NOT_LOST
 					&& loss_reason != PACKET_LOST_OUTSIDE_CH_RANGE) {	// If ACK packet IS LOST, send logical Nack
 
-				LOGS(node_params.save_node_logs, node_logger.file,
+				NODE_LOGS(node_params.save_node_logs, node_logger,
 						"%.15f;N%d;S%d;%s;%s Reception of notification %d from N%d CANNOT be started because of reason %d\n",
 						SimTime(), node_params.node_id, node_state, LOG_D15, LOG_LVL4, notification.packet_id,
 						notification.source_id, loss_reason);
 
 				if(node_params.nack_activated){
 					// Send logical NACK to ACK transmitter
-					logical_nack = GenerateLogicalNack(incoming_notification.packet_type, incoming_notification.packet_id,
+					logical_nack = GenerateLogicalNack(incoming_notification->packet_type, incoming_notification->packet_id,
 						node_params.node_id, receiving_from_node_id, NODE_ID_NONE, loss_reason, BER, current_sinr);
 					SendLogicalNack(logical_nack);
 				}
@@ -1172,7 +1156,7 @@ void Node :: HandleStartTX_StateWaitAck(const Notification &notification) {
 
 			} else {	// If ACK packet IS NOT LOST (it can be properly received)
 
-				LOGS(node_params.save_node_logs, node_logger.file,
+				NODE_LOGS(node_params.save_node_logs, node_logger,
 					"%.15f;N%d;S%d;%s;%s Reception of ACK %d from N%d CAN be started\n",
 					SimTime(), node_params.node_id, node_state, LOG_D16, LOG_LVL4, notification.packet_id, notification.source_id);
 
@@ -1182,11 +1166,11 @@ void Node :: HandleStartTX_StateWaitAck(const Notification &notification) {
 				receiving_from_node_id = notification.source_id;
 				receiving_packet_id = notification.packet_id;
 
-//							LOGS(node_params.save_node_logs, node_logger.file,
+//							NODE_LOGS(node_params.save_node_logs, node_logger,
 //									"%.15f;N%d;S%d;%s;%s I am the TX destination (N%d)\n",
 //									SimTime(), node_params.node_id, node_state, LOG_D16, LOG_LVL4, notification.destination_id);
 
-//							LOGS(node_params.save_node_logs, node_logger.file,
+//							NODE_LOGS(node_params.save_node_logs, node_logger,
 //									"%.15f;N%d;S%d;%s;%s current_sinr = %f dB\n",
 //									SimTime(), node_params.node_id, node_state, LOG_D16, LOG_LVL5,
 //									ConvertPower(LINEAR_TO_DB,current_sinr));
@@ -1194,14 +1178,14 @@ void Node :: HandleStartTX_StateWaitAck(const Notification &notification) {
 			}
 
 		}  else {	//	Some packet type received that is not ACK
-			LOGS(node_params.save_node_logs, node_logger.file,
+			NODE_LOGS(node_params.save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s Unexpected packet type received!\n",
 				SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL4);
 		}
 
 	} else {	// Node IS NOT THE DESTINATION, do nothing
 //
-//					LOGS(node_params.save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s I am NOT the TX destination (N%d)\n",
+//					NODE_LOGS(node_params.save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s I am NOT the TX destination (N%d)\n",
 //								SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL3, notification.destination_id);
 //
 	}
@@ -1211,28 +1195,23 @@ void Node :: HandleStartTX_StateWaitAck(const Notification &notification) {
 /**
  * Handle InportSomeNodeStartTX for STATE_WAIT_CTS
  */
-void Node :: HandleStartTX_StateWaitCts(const Notification &notification) {
+void Node :: HandleStartTX_StateWaitCts(const NotificationFrame &notification) {
 
 	if(notification.destination_id == node_params.node_id){	// Node is the destination
 
 		incoming_notification = notification;
 
-//					LOGS(node_params.save_node_logs, node_logger.file,
+//					NODE_LOGS(node_params.save_node_logs, node_logger,
 //							"%.15f;N%d;S%d;%s;%s I am the TX destination (N%d). Checking if notification can be received.\n",
 //							SimTime(), node_params.node_id, node_state, LOG_D07, LOG_LVL3, notification.destination_id);
 
 		if(notification.packet_type == PACKET_TYPE_CTS){	// CTS packet transmission started
 
-			power_rx_interest = power_received_per_node[notification.source_id];
-
-			// Compute max interference (the highest one perceived in the reception channel range)
-			ComputeMaxInterference(&max_pw_interference, &channel_max_interference,
-				incoming_notification, node_state, power_received_per_node, &channel_power);
-
 			// Check if notification has been lost due to interferences or weak signal strength
-			current_sinr = UpdateSINR(power_rx_interest, max_pw_interference);
+			// TODO: method for checking whether the detected transmission can be decoded or not
+			loss_reason = EvaluateReception(*incoming_notification, notification, current_pd);
 
-//						LOGS(node_params.save_node_logs, node_logger.file,
+//						NODE_LOGS(node_params.save_node_logs, node_logger,
 //							"%.15f;N%d;S%d;%s;%s P_sn = %f dBm (%f pW) - P_st= %f dBm (%f pW)"
 //							"- P_if = %f dBm (%f pW)\n",
 //							SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL5,
@@ -1240,15 +1219,10 @@ void Node :: HandleStartTX_StateWaitCts(const Notification &notification) {
 //							ConvertPower(PW_TO_DBM, power_rx_interest), power_rx_interest, ConvertPower(PW_TO_DBM, max_pw_interference),
 //							max_pw_interference);
 
-			// TODO: method for checking whether the detected transmission can be decoded or not
-			loss_reason = IsPacketLost(node_params.current_primary_channel, incoming_notification, notification,
-				current_sinr, node_params.capture_effect, current_pd,
-				power_rx_interest, node_params.constant_per, node_params.node_id, node_params.capture_effect_model);
-
 			if(loss_reason != PACKET_NOT_LOST
 					&& loss_reason != PACKET_LOST_OUTSIDE_CH_RANGE)  {	// If CTS packet IS LOST, send logical Nack
 
-				LOGS(node_params.save_node_logs, node_logger.file,
+				NODE_LOGS(node_params.save_node_logs, node_logger,
 					"%.15f;N%d;S%d;%s;%s Reception of notification %d from N%d CANNOT be started because of reason %d\n",
 					SimTime(), node_params.node_id, node_state, LOG_D15, LOG_LVL4, notification.packet_id,
 					notification.source_id, loss_reason);
@@ -1265,7 +1239,7 @@ void Node :: HandleStartTX_StateWaitCts(const Notification &notification) {
 
 			} else {	// If CTS packet IS NOT LOST (it can be properly received)
 
-				LOGS(node_params.save_node_logs, node_logger.file,
+				NODE_LOGS(node_params.save_node_logs, node_logger,
 						"%.15f;N%d;S%d;%s;%s Reception of CTS #%d from N%d CAN be started\n",
 						SimTime(), node_params.node_id, node_state, LOG_D16, LOG_LVL4,
 						notification.packet_id, notification.source_id);
@@ -1284,18 +1258,18 @@ void Node :: HandleStartTX_StateWaitCts(const Notification &notification) {
 				ack_duration = notification.tx_info.ack_duration;
 				cts_duration = notification.tx_info.cts_duration;
 
-//							LOGS(node_params.save_node_logs, node_logger.file,
+//							NODE_LOGS(node_params.save_node_logs, node_logger,
 //									"%.15f;N%d;S%d;%s;%s I am the TX destination (N%d)\n",
 //									SimTime(), node_params.node_id, node_state, LOG_D16, LOG_LVL4, notification.destination_id);
 
-//							LOGS(node_params.save_node_logs, node_logger.file,
+//							NODE_LOGS(node_params.save_node_logs, node_logger,
 //									"%.15f;N%d;S%d;%s;%s current_sinr = %f dB\n",
 //									SimTime(), node_params.node_id, node_state, LOG_D16, LOG_LVL5, ConvertPower(LINEAR_TO_DB,current_sinr));
 
 			}
 
 		}  else {	//	Some packet type received that is not CTS
-			LOGS(node_params.save_node_logs, node_logger.file,
+			NODE_LOGS(node_params.save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s Unexpected packet type received!\n",
 				SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL4);
 		}
@@ -1309,27 +1283,24 @@ void Node :: HandleStartTX_StateWaitCts(const Notification &notification) {
 /**
  * Handle InportSomeNodeStartTX for STATE_WAIT_DATA
  */
-void Node :: HandleStartTX_StateWaitData(const Notification &notification) {
+void Node :: HandleStartTX_StateWaitData(const NotificationFrame &notification) {
 
 	if(notification.destination_id == node_params.node_id){	// Node is the destination
 
-		power_rx_interest = power_received_per_node[notification.source_id];
+		power_rx_interest = power_received_per_node.Power(notification.source_id);
 		incoming_notification = notification;
 
-//					LOGS(node_params.save_node_logs, node_logger.file,
+//					NODE_LOGS(node_params.save_node_logs, node_logger,
 //							"%.15f;N%d;S%d;%s;%s I am the TX destination (N%d). Checking if notification can be received.\n",
 //							SimTime(), node_params.node_id, node_state, LOG_D07, LOG_LVL3, notification.destination_id);
 
 		if(notification.packet_type == PACKET_TYPE_DATA){	// DATA packet transmission started
 
-			// Compute max interference (the highest one perceived in the reception channel range)
-			ComputeMaxInterference(&max_pw_interference, &channel_max_interference,
-				incoming_notification, node_state, power_received_per_node, &channel_power);
-
 			// Check if notification has been lost due to interferences or weak signal strength
-			current_sinr = UpdateSINR(power_rx_interest, max_pw_interference);
+			// TODO: method for checking whether the detected transmission can be decoded or not
+			loss_reason = EvaluateReception(*incoming_notification, notification, current_pd);
 
-			LOGS(node_params.save_node_logs, node_logger.file,
+			NODE_LOGS(node_params.save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s P[%d] = %f dBm - P_st = %f dBm - P_if = %f dBm - current_sinr = %.2f dBm\n",
 				SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL5, channel_max_interference,
 				ConvertPower(PW_TO_DBM, channel_power[channel_max_interference]),
@@ -1337,15 +1308,10 @@ void Node :: HandleStartTX_StateWaitData(const Notification &notification) {
 				ConvertPower(PW_TO_DBM, max_pw_interference),
 				ConvertPower(LINEAR_TO_DB, current_sinr));
 
-			// TODO: method for checking whether the detected transmission can be decoded or not
-			loss_reason = IsPacketLost(node_params.current_primary_channel, incoming_notification, notification,
-				current_sinr, node_params.capture_effect, current_pd,
-				power_rx_interest, node_params.constant_per, node_params.node_id, node_params.capture_effect_model);
-
 			if(loss_reason != PACKET_NOT_LOST
 				&& loss_reason != PACKET_LOST_OUTSIDE_CH_RANGE)  {	// If DATA packet IS LOST, send logical Nack
 
-				LOGS(node_params.save_node_logs, node_logger.file,
+				NODE_LOGS(node_params.save_node_logs, node_logger,
 					"%.15f;N%d;S%d;%s;%s Reception of notification %d from N%d CANNOT be started because of reason %d\n",
 					SimTime(), node_params.node_id, node_state, LOG_D15, LOG_LVL4, notification.packet_id,
 					notification.source_id, loss_reason);
@@ -1360,7 +1326,7 @@ void Node :: HandleStartTX_StateWaitData(const Notification &notification) {
 
 			} else {	// If DATA packet IS NOT LOST (it can be properly received)
 
-				LOGS(node_params.save_node_logs, node_logger.file,
+				NODE_LOGS(node_params.save_node_logs, node_logger,
 					"%.15f;N%d;S%d;%s;%s Reception of DATA %d from N%d CAN be started\n",
 					SimTime(), node_params.node_id, node_state, LOG_D16, LOG_LVL4, notification.packet_id, notification.source_id);
 
@@ -1377,14 +1343,14 @@ void Node :: HandleStartTX_StateWaitData(const Notification &notification) {
 			}
 
 		}  else {	//	Some packet type received that is not ACK
-			LOGS(node_params.save_node_logs, node_logger.file,
+			NODE_LOGS(node_params.save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s Unexpected packet type received!\n",
 				SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL4);
 		}
 
 	} else {	// Node IS NOT THE DESTINATION, do nothing
 
-//					LOGS(node_params.save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s I am NOT the TX destination (N%d)\n",
+//					NODE_LOGS(node_params.save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s I am NOT the TX destination (N%d)\n",
 //								SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL3, notification.destination_id);
 
 	}
@@ -1392,21 +1358,22 @@ void Node :: HandleStartTX_StateWaitData(const Notification &notification) {
 }
 
 
-void Node :: InportSomeNodeStartTX(Notification &notification){
+void Node :: InportSomeNodeStartTX(const NotificationFrame &notification){
+	COST_PROFILE_SCOPE("Node::InportSomeNodeStartTX");
 
-	LOGS(node_params.save_node_logs, node_logger.file,
+	NODE_LOGS(node_params.save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s InportSomeNodeStartTX(): N%d to N%d sends packet type %d in range %d-%d using a transmit power of %.2f dBm\n",
 			SimTime(), node_params.node_id, node_state, LOG_D00, LOG_LVL1,
 			notification.source_id, notification.destination_id, notification.packet_type,
 			notification.left_channel, notification.right_channel,
 			ConvertPower(PW_TO_DBM, notification.tx_info.tx_power));
 
-	LOGS(node_params.save_node_logs,node_logger.file,
+	NODE_LOGS(node_params.save_node_logs,node_logger,
 	        "%.15f;N%d;S%d;%s;%s Nodes transmitting: ",
 			SimTime(), node_params.node_id, node_state, LOG_D00, LOG_LVL3);
 
 	// Identify node that has started the transmission as transmitting node in the array
-	nodes_transmitting[notification.source_id] = TRUE;
+	nodes_transmitting.Insert(notification.source_id);
 	PrintOrWriteNodesTransmitting(WRITE_LOG, node_params.save_node_logs,
 		node_params.print_node_logs, node_logger, node_params.total_nodes_number, nodes_transmitting);
 
@@ -1421,16 +1388,16 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 				if (received_power_array[notification.source_id] > current_pd) {
 					// Update the list of neighboring devices (if not done)
 					if (token_order_list[notification.source_id] == DEVICE_INACTIVE_FOR_TOKEN) {
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 							"%.15f;N%d;S%d;%s;%s Token-based channel access operation (update neighbor list):\n",
 							SimTime(), node_params.node_id, node_state, LOG_E18, LOG_LVL3);
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 								"%.15f;N%d;S%d;%s;%s Token's order list before the update: ",
 								SimTime(), node_params.node_id, node_state, LOG_E18, LOG_LVL5);
 							PrintOrWriteTokenList(WRITE_LOG, node_params.save_node_logs,
 								node_params.print_node_logs, node_logger, token_order_list, node_params.total_nodes_number);
 						UpdateTokenList(ADD_DEVICE_TO_LIST, &token_order_list, notification.source_id);
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 							"%.15f;N%d;S%d;%s;%s Token's order list updated: ",
 							SimTime(), node_params.node_id, node_state, LOG_E18, LOG_LVL5);
 						PrintOrWriteTokenList(WRITE_LOG, node_params.save_node_logs, node_params.print_node_logs, node_logger,
@@ -1438,13 +1405,13 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 					}
 					// Update the status of the token
 					if (node_state != STATE_TX_RTS) {
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 							"%.15f;N%d;S%d;%s;%s Token-based channel access operation (token ACQUISITION):\n",
 							SimTime(), node_params.node_id, node_state, LOG_E18, LOG_LVL4);
 						UpdateTokenStatus(node_params.node_id, TAKE_TOKEN, &token_status, notification.source_id,
 							token_order_list, node_params.total_nodes_number, &distance_to_token);
 					} else if (node_state == STATE_TX_RTS && node_params.node_id < notification.source_id) {
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 							"%.15f;N%d;S%d;%s;%s Token-based channel access operation (token ACQUISITION):\n",
 							SimTime(), node_params.node_id, node_state, LOG_E18, LOG_LVL4);
 						UpdateTokenStatus(node_params.node_id, TAKE_TOKEN, &token_status, node_params.node_id,
@@ -1452,20 +1419,20 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 					} else {
 						// In case of a collision (two simultaneous RTS transmissions occur),
 						// solve the conflict by releasing the token (the node with lowest ID gets the token)
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 							"%.15f;N%d;S%d;%s;%s Token-based channel access operation (token RELEASE):\n",
 							SimTime(), node_params.node_id, node_state, LOG_E18, LOG_LVL4);
 						UpdateTokenStatus(node_params.node_id, RELEASE_TOKEN, &token_status, node_params.node_id,
 							token_order_list, node_params.total_nodes_number, &distance_to_token);
 					}
-					LOGS(node_params.save_node_logs,node_logger.file,
+					NODE_LOGS(node_params.save_node_logs,node_logger,
 						"%.15f;N%d;S%d;%s;%s Token status updated, the new token holder is %d\n",
 						SimTime(), node_params.node_id, node_state, LOG_E18, LOG_LVL5, token_status);
 					// Update the CW parameters
 					HandleContentionWindow(
 						node_params.cw_adaptation, -1, &ca_state.deterministic_bo_active, &ca_state.current_cw_min, &ca_state.current_cw_max, &ca_state.cw_stage_current,
 						node_params.cw_min_default, node_params.cw_max_default, node_params.cw_stage_max, distance_to_token, node_params.backoff_type, current_traffic_type);
-					LOGS(node_params.save_node_logs,node_logger.file,
+					NODE_LOGS(node_params.save_node_logs,node_logger,
 						"%.15f;N%d;S%d;%s;%s Updated CW parameters (token-based BO) = [%d-%d]\n",
 						SimTime(), node_params.node_id, node_state, LOG_E18, LOG_LVL5, ca_state.current_cw_min, ca_state.current_cw_max);
 				}
@@ -1475,7 +1442,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 	if(notification.source_id == node_params.node_id){ // If OWN NODE IS THE TRANSMITTER, do nothing
 
-		LOGS(node_params.save_node_logs,node_logger.file,
+		NODE_LOGS(node_params.save_node_logs,node_logger,
 			"%.15f;N%d;S%d;%s;%s I have started a TX of packet #%d (type %d) to N%d in channels %d - %d of duration %.9f us\n",
 			SimTime(), node_params.node_id, node_state, LOG_D02, LOG_LVL2, notification.packet_id,
 			notification.packet_type, notification.destination_id,
@@ -1484,13 +1451,13 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 
 	} else {	// If OTHER NODE IS THE TRANSMITTER
 
-		LOGS(node_params.save_node_logs,node_logger.file,
+		NODE_LOGS(node_params.save_node_logs,node_logger,
 			"%.15f;N%d;S%d;%s;%s N%d has started a TX of packet #%d (type %d) to N%d in channels %d - %d\n",
 			SimTime(), node_params.node_id, node_state, LOG_D02, LOG_LVL2, notification.source_id,
 			notification.packet_id,	notification.packet_type, notification.destination_id,
 			notification.left_channel, notification.right_channel);
 
-		LOGS(node_params.save_node_logs,node_logger.file,
+		NODE_LOGS(node_params.save_node_logs,node_logger,
 			"%.15f;N%d;S%d;%s;%s Power sensed per channel BEFORE updating [dBm]: ",
 			SimTime(), node_params.node_id, node_state, LOG_E18, LOG_LVL3);
 
@@ -1500,8 +1467,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 		// Update 'power received' array in case a new tx power is used
 		if (notification.tx_info.flag_change_in_tx_power) {
 			received_power_array[notification.source_id] =
-				ComputePowerReceived(distances_array[notification.source_id],
-				notification.tx_info.tx_power, node_params.central_frequency, node_params.path_loss_model);
+				notification.tx_info.tx_power * path_gain_array[notification.source_id];
 		}
 
 		// Update the power sensed at each channel (raw path-loss power, used for CCA/NAV).
@@ -1509,8 +1475,13 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 		// omnidirectional energy on the medium so that carrier-sense works correctly.
 		UpdateChannelsPower(&channel_power, notification, TX_INITIATED,
 			node_params.central_frequency, node_params.path_loss_model, node_params.adjacent_channel_model, received_power_array[notification.source_id], node_params.node_id);
+		ongoing_tx_power[notification.source_id] = received_power_array[notification.source_id];
+		ongoing_tx_left_channel[notification.source_id] = notification.left_channel;
+		ongoing_tx_right_channel[notification.source_id] = notification.right_channel;
+		ongoing_tx_punctured_bitmap[notification.source_id] = notification.tx_info.pp_punctured_bitmap;
+		ongoing_tx_start_time[notification.source_id] = SimTime();
 
-		LOGS(node_params.save_node_logs,node_logger.file,
+		NODE_LOGS(node_params.save_node_logs,node_logger,
 			"%.15f;N%d;S%d;%s;%s Power sensed per channel [dBm]: ",
 			SimTime(), node_params.node_id, node_state, LOG_E18, LOG_LVL3);
 
@@ -1520,7 +1491,7 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 		// Call UpdatePowerSensedPerNode() ONLY for adding power (some node started)
 		UpdatePowerSensedPerNode(node_params.current_primary_channel, power_received_per_node, notification,
 			node_params.central_frequency, node_params.path_loss_model, received_power_array[notification.source_id], TX_INITIATED,
-			node_params.x, node_params.y, node_params.z);
+			node_params.node_id, node_params.x, node_params.y, node_params.z);
 
 		UpdateTimestampChannelFreeAgain(timestamp_channel_becomes_free, &channel_power,
 			current_pd, SimTime());
@@ -1652,13 +1623,13 @@ void Node :: InportSomeNodeStartTX(Notification &notification){
 		node_stats.channel_idle = false;
 	}
 
-	// LOGS(node_params.save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s InportSomeNodeStartTX() END\n", SimTime(), node_params.node_id, node_state, LOG_D01, LOG_LVL1);
+	// NODE_LOGS(node_params.save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s InportSomeNodeStartTX() END\n", SimTime(), node_params.node_id, node_state, LOG_D01, LOG_LVL1);
 };
 
 /**
  * Helper for InportSomeNodeFinishTX: handles STATE_SENSING case
  */
-void Node :: HandleFinishTX_StateSensing(const Notification &notification){
+void Node :: HandleFinishTX_StateSensing(const NotificationFrame &notification){
 
 	// NPCA STA: DATA phase ended while still in SENSING (DATA was lost); restore primary channel
 	if (npca_sta_on_npca_channel && notification.packet_type == PACKET_TYPE_DATA
@@ -1684,7 +1655,7 @@ void Node :: HandleFinishTX_StateSensing(const Notification &notification){
 			current_left_channel  = _save_l;
 			current_right_channel = _save_r;
 		}
-		LOGS(node_params.save_node_logs, node_logger.file,
+		NODE_LOGS(node_params.save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s NPCA: ICF done; sending ICR to N%d on [%d,%d] after SIFS\n",
 			SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL2,
 			current_destination_id, notification.left_channel, notification.right_channel);
@@ -1693,13 +1664,13 @@ void Node :: HandleFinishTX_StateSensing(const Notification &notification){
 	}
 
 	if(node_is_transmitter) {
-		if(!trigger_start_backoff.Active()
-			&& !trigger_end_backoff.Active()){	// BO was paused and DIFS not initiated
+		if(!IfsPending()
+			&& !BackoffCountingDown()){	// BO was paused and DIFS not initiated
 
 			int resume (HandleBackoff(RESUME_TIMER, &channel_power, node_params.current_primary_channel, current_pd,
 					buffer.QueueSize()));
 
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s P[%d] = %f dBm (%f)\n",
 				SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL5,
 				node_params.current_primary_channel, ConvertPower(PW_TO_DBM, channel_power[node_params.current_primary_channel]), channel_power[node_params.current_primary_channel]);
@@ -1710,19 +1681,19 @@ void Node :: HandleFinishTX_StateSensing(const Notification &notification){
 				// - If not, just resume the backoff
 				time_to_trigger = SimTime() + DIFS;
 				// time_to_trigger = SimTime() + SIFS + notification.tx_info.cts_duration + DIFS;
-				trigger_start_backoff.Set(FixTimeOffset(time_to_trigger,13,12));
-				LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s BO will be resumed after DIFS at %.12f.\n",
+				ArmBackoffAfterIfs(time_to_trigger);
+				NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s BO will be resumed after DIFS at %.12f.\n",
 					SimTime(), node_params.node_id, node_state, LOG_E11, LOG_LVL4,
-					trigger_start_backoff.GetTime());
-//							LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s EIFS started.\n",
+					ca_state.ifs_end_time);
+//							NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s EIFS started.\n",
 //														SimTime(), node_params.node_id, node_state, LOG_E11, LOG_LVL4);
 			} else {	// BO cannot be resumed
-				LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s EIFS/DIFS cannot be started because the channel is busy.\n",
+				NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s EIFS/DIFS cannot be started because the channel is busy.\n",
 					SimTime(), node_params.node_id, node_state, LOG_E11, LOG_LVL4);
 
 }
 		} else {	// BO was already active
-			LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s BO was already active.\n",
+			NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s BO was already active.\n",
 					SimTime(), node_params.node_id, node_state, LOG_E11, LOG_LVL4);
 		}
 	}
@@ -1731,20 +1702,20 @@ void Node :: HandleFinishTX_StateSensing(const Notification &notification){
 /**
  * Helper for InportSomeNodeFinishTX: handles STATE_RX_DATA case
  */
-void Node :: HandleFinishTX_StateRxData(const Notification &notification){
+void Node :: HandleFinishTX_StateRxData(const NotificationFrame &notification){
 
 	if(notification.destination_id == node_params.node_id){ 	// Node IS THE DESTINATION
 
 		if(notification.packet_type == PACKET_TYPE_DATA){	// Data packet transmission finished
 
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s Packet #%d reception from N%d is finished successfully.\n",
 				SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3, notification.packet_id,
 				notification.source_id);
 
 			// ACK suppression: transmitter flagged ack_required=0 — skip ACK, return to sensing
 			if (notification.tx_info.ack_required == 0) {
-				LOGS(node_params.save_node_logs, node_logger.file,
+				NODE_LOGS(node_params.save_node_logs, node_logger,
 					"%.15f;N%d;S%d;%s;%s ACK suppressed by TX for DATA #%d from N%d. Returning to sensing.\n",
 					SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3,
 					notification.packet_id, notification.source_id);
@@ -1804,7 +1775,7 @@ void Node :: HandleFinishTX_StateRxData(const Notification &notification){
 				node_state = STATE_WAIT_ACK_TF;
 				time_to_trigger = SimTime() + SIFS + notification.tx_info.rts_duration + TIME_OUT_EXTRA_TIME;
 				trigger_DATA_timeout.Set(FixTimeOffset(time_to_trigger, 13, 12));
-				LOGS(node_params.save_node_logs, node_logger.file,
+				NODE_LOGS(node_params.save_node_logs, node_logger,
 					"%.15f;N%d;S%d;%s;%s DATA from N%d done; waiting for ACK TF from coordinator.\n",
 					SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3, notification.source_id);
 			} else {
@@ -1812,21 +1783,21 @@ void Node :: HandleFinishTX_StateRxData(const Notification &notification){
 				node_state = STATE_TX_ACK;
 				time_to_trigger = SimTime() + SIFS;
 				trigger_SIFS.Set(FixTimeOffset(time_to_trigger,13,12));
-				LOGS(node_params.save_node_logs,node_logger.file,
+				NODE_LOGS(node_params.save_node_logs,node_logger,
 					"%.15f;N%d;S%d;%s;%s SIFS will be triggered in %.12f\n",
 					SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3,
 					trigger_SIFS.GetTime());
 			}
 
 		} else {	// Other packet type transmission finished
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s Unexpected packet type transmission finished!\n",
 				SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL4);
 		}
 
 	} else {	// Node IS NOT THE DESTINATION, do nothing
 
-		LOGS(node_params.save_node_logs,node_logger.file,
+		NODE_LOGS(node_params.save_node_logs,node_logger,
 			"%.15f;N%d;S%d;%s;%s Still locked into the reception of packet #%d from N%d.\n",
 			SimTime(), node_params.node_id, node_state, LOG_E15, LOG_LVL3, notification.packet_id,
 			notification.source_id);
@@ -1837,7 +1808,7 @@ void Node :: HandleFinishTX_StateRxData(const Notification &notification){
 /**
  * Helper for InportSomeNodeFinishTX: handles STATE_TX_DATA/STATE_TX_ACK/STATE_WAIT_ACK/etc. cases
  */
-void Node :: HandleFinishTX_StateTxData(const Notification &notification){
+void Node :: HandleFinishTX_StateTxData(const NotificationFrame &notification){
 	// Do nothing
 }
 
@@ -1845,9 +1816,10 @@ void Node :: HandleFinishTX_StateTxData(const Notification &notification){
  * Called when some node (this one included) finishes a packet TX (RTS, CTS, Data, or ACK)
  * @param "notification" [type Notification]: notification containing the information of the transmission that has finished
  */
-void Node :: InportSomeNodeFinishTX(Notification &notification){
+void Node :: InportSomeNodeFinishTX(const NotificationFrame &notification){
+	COST_PROFILE_SCOPE("Node::InportSomeNodeFinishTX");
 
-	LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s InportSomeNodeFinishTX(): N%d to N%d (type %d)"
+	NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s InportSomeNodeFinishTX(): N%d to N%d (type %d)"
 			" at range %d-%d "
 			"- nodes transmitting: ",
 		SimTime(), node_params.node_id, node_state, LOG_E00, LOG_LVL1,
@@ -1855,7 +1827,7 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 		notification.left_channel, notification.right_channel);
 
 	// Identify node that has finished the transmission as non-transmitting node in the array
-	nodes_transmitting[notification.source_id] = FALSE;
+	nodes_transmitting.Remove(notification.source_id);
 	PrintOrWriteNodesTransmitting(WRITE_LOG, node_params.save_node_logs,
 			node_params.print_node_logs, node_logger, node_params.total_nodes_number, nodes_transmitting);
 
@@ -1867,23 +1839,23 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 			token_order_list[notification.destination_id] == DEVICE_ACTIVE_FOR_TOKEN) {
 		// - Check that the incoming transmission is an ACK
 		if (notification.packet_type == PACKET_TYPE_ACK) {
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s Token-based channel access operation (token RELEASE):\n",
 				SimTime(), node_params.node_id, node_state, LOG_E18, LOG_LVL4);
 			// Update the status of the token
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s UPDATING the status of the token (until now, with N%d)\n",
 				SimTime(), node_params.node_id, node_state, LOG_E18, LOG_LVL3, token_status);
 			UpdateTokenStatus(node_params.node_id, RELEASE_TOKEN, &token_status, notification.destination_id,
 					token_order_list, node_params.total_nodes_number, &distance_to_token);
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s Token status updated, the new token holder is %d\n",
 				SimTime(), node_params.node_id, node_state, LOG_E18, LOG_LVL5, token_status);
 			// Update the CW parameters
 			HandleContentionWindow(
 				node_params.cw_adaptation, -1, &ca_state.deterministic_bo_active, &ca_state.current_cw_min, &ca_state.current_cw_max, &ca_state.cw_stage_current,
 				node_params.cw_min_default, node_params.cw_max_default, node_params.cw_stage_max, distance_to_token, node_params.backoff_type, current_traffic_type);
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s Updated CW parameters (token-based BO) = [%d-%d]\n",
 				SimTime(), node_params.node_id, node_state, LOG_E18, LOG_LVL5, ca_state.current_cw_min, ca_state.current_cw_max);
 		}
@@ -1891,20 +1863,20 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 
 	if(notification.source_id == node_params.node_id){	// Node is the TX source: do nothing
 
-//		LOGS(node_params.save_node_logs,node_logger.file,
+//		NODE_LOGS(node_params.save_node_logs,node_logger,
 //				"%.15f;N%d;S%d;%s;%s I have finished the TX of packet #%d (type %d) in channel range: %d - %d\n",
 //				SimTime(), node_params.node_id, node_state, LOG_E18, LOG_LVL2, notification.packet_id,
 //				notification.packet_type, notification.left_channel, notification.right_channel);
 
 	} else {	// Node is not the TX source
 
-//		LOGS(node_params.save_node_logs,node_logger.file,
+//		NODE_LOGS(node_params.save_node_logs,node_logger,
 //				"%.15f;N%d;S%d;%s;%s N%d has finished the TX of packet #%d (type %d) in channel range: %d - %d\n",
 //				SimTime(), node_params.node_id, node_state, LOG_E18, LOG_LVL2, notification.source_id,
 //				notification.packet_id, notification.packet_type, notification.left_channel,
 //				notification.right_channel);
 
-		LOGS(node_params.save_node_logs,node_logger.file,
+		NODE_LOGS(node_params.save_node_logs,node_logger,
 			"%.15f;N%d;S%d;%s;%s Power sensed per channel BEFORE updating [dBm]: ",
 			SimTime(), node_params.node_id, node_state, LOG_E18, LOG_LVL3);
 
@@ -1914,16 +1886,19 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 		// Update the power sensed at each channel (raw power, matching TX_INITIATED).
 		UpdateChannelsPower(&channel_power, notification, TX_FINISHED,
 			node_params.central_frequency, node_params.path_loss_model, node_params.adjacent_channel_model, received_power_array[notification.source_id], node_params.node_id);
+		ongoing_tx_power[notification.source_id] = 0;
+
+		// Periodically discard the rounding errors accumulated by the incremental updates
+		++num_channel_power_updates;
+		if(num_channel_power_updates >= CHANNEL_POWER_RECOMPUTE_PERIOD){
+			RecomputeChannelsPower(&channel_power, node_params.adjacent_channel_model, node_params.total_nodes_number,
+				ongoing_tx_power, ongoing_tx_left_channel, ongoing_tx_right_channel, ongoing_tx_punctured_bitmap);
+			num_channel_power_updates = 0;
+		}
 
 		// -------------------------
 		// Safety condtion. Empty the channel when no node is transmitting
-		int num_nodes_transmitting = 0;
-		for(int i = 0; i < node_params.total_nodes_number; ++i){
-			if(nodes_transmitting[i] == TRUE){
-				++num_nodes_transmitting;
-			}
-		}
-		if(num_nodes_transmitting == 0){
+		if(nodes_transmitting.size == 0){
 			for(int i = 0; i < NUM_CHANNELS_KOMONDOR; ++i){
 				channel_power[i] = 0;
 			}
@@ -1937,17 +1912,30 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 				notification, node_params.bss_color, node_params.srg, 0);
 		}
 
-		LOGS(node_params.save_node_logs,node_logger.file,
+		NODE_LOGS(node_params.save_node_logs,node_logger,
 			"%.15f;N%d;S%d;%s;%s Power sensed per channel [dBm]: ",
 			SimTime(), node_params.node_id, node_state, LOG_E18, LOG_LVL3);
 
 		PrintOrWriteChannelPower(WRITE_LOG, node_params.save_node_logs, node_params.print_node_logs, node_logger,
 				&channel_power);
 
+		// Frame trace: frames addressed to the node, decoded if it was locked into their reception
+		if(frame_trace != NULL && notification.destination_id == node_params.node_id){
+			int decoded = (node_state == STATE_RX_DATA || node_state == STATE_RX_ACK || node_state == STATE_RX_RTS
+				|| node_state == STATE_RX_CTS || node_state == STATE_RX_ICF || node_state == STATE_RX_ICR
+				|| node_state == STATE_RX_MU_RTS || node_state == STATE_RX_TF)
+				&& incoming_notification->source_id == notification.source_id
+				&& incoming_notification->packet_type == notification.packet_type
+				&& incoming_notification->packet_id == notification.packet_id;
+			RecordFrame(frame_trace, &frame_trace_block, notification, ongoing_tx_start_time[notification.source_id], SimTime(),
+				UpdateSINR(power_received_per_node.Power(notification.source_id),
+					power_received_per_node.TotalPowerExcept(notification.source_id)), decoded);
+		}
+
 		// Call UpdatePowerSensedPerNode() ONLY for adding power (some node started)
 		UpdatePowerSensedPerNode(node_params.current_primary_channel, power_received_per_node, notification,
 			node_params.central_frequency, node_params.path_loss_model, received_power_array[notification.source_id], TX_FINISHED,
-			node_params.x, node_params.y, node_params.z);
+			node_params.node_id, node_params.x, node_params.y, node_params.z);
 
 		UpdateTimestampChannelFreeAgain(timestamp_channel_becomes_free, &channel_power,
 			current_pd, SimTime());
@@ -1986,19 +1974,19 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 
 					if(notification.packet_type == PACKET_TYPE_ACK){	// ACK packet transmission finished
 
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 							"%.15f;N%d;S%d;%s;%s ACK #%d reception from N%d is finished successfully.\n",
 							SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3, notification.packet_id,
 							notification.source_id);
 
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 							"%.15f;N%d;S%d;%s;%s -------------------------------------\n",
 							SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL2);
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 							"%.15f;N%d;S%d;%s;%s TRANSMISSION #%d SUCCESSFULLY FINISHED!\n",
 							SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL2,
 							node_stats.data_packets_acked);
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 							"%.15f;N%d;S%d;%s;%s -------------------------------------\n",
 							SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL2);
 
@@ -2057,7 +2045,7 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 							if ((SimTime() - pkt_ts) < performance_report.min_delay) {
 								performance_report.min_delay = (SimTime() - pkt_ts);
 							}
-							LOGS(node_params.save_node_logs,node_logger.file,
+							NODE_LOGS(node_params.save_node_logs,node_logger,
 								"%.15f;N%d;S%d;%s;%s Packet delay: %f us (generated at %f).\n",
 								SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL4,
 								(SimTime() - pkt_ts) * pow(10,6),
@@ -2068,10 +2056,10 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 
 						}
 
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 							"%.15f;N%d;S%d;%s;%s Handling contention window\n",
 							SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL4);
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 									"%.15f;N%d;S%d;%s;%s From CW = [%d-%d], b = %d, m = %d\n",
 							SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL5,
 							ca_state.current_cw_min, ca_state.current_cw_max, ca_state.cw_stage_current, node_params.cw_stage_max);
@@ -2080,7 +2068,7 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 							node_params.cw_adaptation, RESET_CW, &ca_state.deterministic_bo_active, &ca_state.current_cw_min, &ca_state.current_cw_max,
 							&ca_state.cw_stage_current, node_params.cw_min_default, node_params.cw_max_default, node_params.cw_stage_max, distance_to_token, node_params.backoff_type, current_traffic_type);
 
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 							"%.15f;N%d;S%d;%s;%s To CW = [%d-%d], b = %d, m = %d\n",
 							SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL5,
 							ca_state.current_cw_min, ca_state.current_cw_max, ca_state.cw_stage_current, node_params.cw_stage_max);
@@ -2108,13 +2096,13 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 								time_rand_value = 0;
 								time_to_trigger = SimTime() + SIFS;
 								trigger_SIFS.Set(FixTimeOffset(time_to_trigger, 13, 12));
-								LOGS(node_params.save_node_logs,node_logger.file,
+								NODE_LOGS(node_params.save_node_logs,node_logger,
 									"%.15f;N%d;S%d;%s;%s Sending MU-RTS/TXS to N%d (selected peer) after SIFS\n",
 									SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3,
 									current_destination_id);
 							} else {
 								// Peer has no data (reported in ICR): skip MU-RTS slot
-								LOGS(node_params.save_node_logs,node_logger.file,
+								NODE_LOGS(node_params.save_node_logs,node_logger,
 									"%.15f;N%d;S%d;%s;%s N%d has no data (ICR flag); skipping MU-RTS slot\n",
 									SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3,
 									mapc_selected_peer_id);
@@ -2127,16 +2115,16 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 						}
 
 					} else {	// Other packet type transmission finished
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 							"%.15f;N%d;S%d;%s;%s Unexpected packet type transmission finished!\n",
 							SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL4);
 					}
 
 				} else {	// Node IS NOT THE DESTINATION
 
-					LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Still receiving packet #%d reception from N%d.\n",
-						SimTime(), node_params.node_id, node_state, LOG_E15, LOG_LVL3, incoming_notification.packet_id,
-						incoming_notification.source_id);
+					NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s Still receiving packet #%d reception from N%d.\n",
+						SimTime(), node_params.node_id, node_state, LOG_E15, LOG_LVL3, incoming_notification->packet_id,
+						incoming_notification->source_id);
 				}
 
 				break;
@@ -2174,7 +2162,7 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 						current_left_channel  = _save_l;
 						current_right_channel = _save_r;
 					}
-					LOGS(node_params.save_node_logs, node_logger.file,
+					NODE_LOGS(node_params.save_node_logs, node_logger,
 						"%.15f;N%d;S%d;%s;%s NPCA: ICF done; sending ICR to N%d on [%d,%d] after SIFS\n",
 						SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL2,
 						current_destination_id, notification.left_channel, notification.right_channel);
@@ -2194,13 +2182,13 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 
 					if(notification.packet_type == PACKET_TYPE_RTS){	// RTS packet transmission finished
 
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 							"%.15f;N%d;S%d;%s;%s RTS #%d reception from N%d is finished successfully.\n",
 							SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3, notification.packet_id,
 							notification.source_id);
 
 						// Check channel availability in order to send the CTS
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 							"%.15f;N%d;S%d;%s;%s Checking if CTS can be sent: P_sen = %f dBm, pd = %f dBm.\n",
 							SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3,
 							ConvertPower(PW_TO_DBM, channel_power[node_params.current_primary_channel]),
@@ -2218,7 +2206,7 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 						GetChannelOccupancyByCCA(node_params.current_primary_channel, node_params.pifs_activated, channels_free, current_left_channel,
 								current_right_channel, &channel_power, current_pd, timestamp_channel_becomes_free, SimTime(), PIFS);
 
-						LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Channels founds free after RTS: ",
+						NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s Channels founds free after RTS: ",
 								SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL3);
 
 						PrintOrWriteChannelsFree(WRITE_LOG, node_params.save_node_logs, node_params.print_node_logs, node_logger,
@@ -2226,9 +2214,9 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 
 						GetTxChannels(channels_for_tx, node_params.current_dcb_policy, channels_free,
 								current_left_channel, current_right_channel, node_params.current_primary_channel,
-								NUM_CHANNELS_KOMONDOR, &channel_power, channel_aggregation_cca_model, NULL);
+								NUM_CHANNELS_KOMONDOR, &channel_power, channel_aggregation_cca_model, NULL, &random_stream);
 						
-						LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Channels for transmitting after RTS: ",
+						NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s Channels for transmitting after RTS: ",
 								SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL2);
 
 						PrintOrWriteChannelForTx(WRITE_LOG, node_params.save_node_logs, node_params.print_node_logs, node_logger,
@@ -2253,7 +2241,7 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 
 						if(CTS_transmission_possible){
 
-							LOGS(node_params.save_node_logs,node_logger.file,
+							NODE_LOGS(node_params.save_node_logs,node_logger,
 								"%.15f;N%d;S%d;%s;%s Channel(s) is (are) clear! Sending CTS to N%d (STATE = %d) ...\n",
 								SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3, current_destination_id, node_state);
 
@@ -2263,14 +2251,12 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 							current_tx_duration = cts_duration;
 
 							// Compute the NAV time
-							bits_ofdm_sym =  GetNumberSubcarriers(current_right_channel - current_left_channel +1) *
-								Mcs_array::modulation_bits[notification.modulation_id-1] *
-								Mcs_array::coding_rates[notification.modulation_id-1] *
-								IEEE_AX_SU_SPATIAL_STREAMS;
+							PhyRate phy_rate (phy_timing->Rate(notification.modulation_id,
+								current_right_channel - current_left_channel + 1));
+							bits_ofdm_sym = phy_rate.bits_ofdm_sym;
 
-							ComputeFramesDuration(&rts_duration, &cts_duration, &data_duration, &ack_duration,
-								num_channels_tx, notification.modulation_id, notification.tx_info.num_packets_aggregated,
-								node_params.frame_length, bits_ofdm_sym);
+							phy_timing->FramesDuration(phy_rate, notification.tx_info.num_packets_aggregated,
+								&rts_duration, &cts_duration, &data_duration, &ack_duration);
 
 							current_nav_time = ComputeNavTime(node_state, rts_duration, cts_duration, data_duration, ack_duration, SIFS);
 							current_nav_time = FixTimeOffset(current_nav_time,13,12); // Update the NAV time according to the time offsets
@@ -2285,7 +2271,7 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 							time_to_trigger = SimTime() + SIFS;
 							trigger_SIFS.Set(FixTimeOffset(time_to_trigger,13,12)); // triggers the SendResponsePacket() function after SIFS
 
-							LOGS(node_params.save_node_logs,node_logger.file,
+							NODE_LOGS(node_params.save_node_logs,node_logger,
 								"%.15f;N%d;S%d;%s;%s SIFS will be triggered in %.12f\n",
 								SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3,
 								trigger_SIFS.GetTime());
@@ -2307,7 +2293,7 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 						} else {
 							// CANNOT START PACKET TX
 
-							LOGS(node_params.save_node_logs,node_logger.file,
+							NODE_LOGS(node_params.save_node_logs,node_logger,
 								"%.15f;N%d;S%d;%s;%s CTS TX NOT POSSIBLE\n",
 								SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL4);
 
@@ -2328,16 +2314,16 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 						}
 
 					} else {	// Other packet type transmission finished
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 								"%.15f;N%d;S%d;%s;%s Unexpected packet type transmission finished!\n",
 								SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL4);
 					}
 
 				} else {	// Node IS NOT THE DESTINATION
 
-					LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Still receiving packet #%d reception from N%d.\n",
-							SimTime(), node_params.node_id, node_state, LOG_E15, LOG_LVL3, incoming_notification.packet_id,
-							incoming_notification.source_id);
+					NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s Still receiving packet #%d reception from N%d.\n",
+							SimTime(), node_params.node_id, node_state, LOG_E15, LOG_LVL3, incoming_notification->packet_id,
+							incoming_notification->source_id);
 				}
 
 				break;
@@ -2353,7 +2339,7 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 
 					if(notification.packet_type == PACKET_TYPE_CTS){	// CTS packet transmission finished
 
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 								"%.15f;N%d;S%d;%s;%s CTS #%d reception from N%d is finished successfully.\n",
 								SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3,
 								notification.packet_id, notification.source_id);
@@ -2361,18 +2347,16 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 						node_state = STATE_TX_DATA;
 
 						// Compute the NAV time
-						bits_ofdm_sym =  GetNumberSubcarriers(current_right_channel - current_left_channel +1) *
-							Mcs_array::modulation_bits[notification.modulation_id-1] *
-							Mcs_array::coding_rates[notification.modulation_id-1] *
-							IEEE_AX_SU_SPATIAL_STREAMS;
+						PhyRate phy_rate (phy_timing->Rate(notification.modulation_id,
+							current_right_channel - current_left_channel + 1));
+						bits_ofdm_sym = phy_rate.bits_ofdm_sym;
 
-						ComputeFramesDuration(&rts_duration, &cts_duration, &data_duration, &ack_duration,
-							num_channels_tx, notification.modulation_id, notification.tx_info.num_packets_aggregated,
-							node_params.frame_length, bits_ofdm_sym);
+						phy_timing->FramesDuration(phy_rate, notification.tx_info.num_packets_aggregated,
+							&rts_duration, &cts_duration, &data_duration, &ack_duration);
 
 						limited_num_packets_aggregated = notification.tx_info.num_packets_aggregated;
 
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 							"%.15f;N%d;S%d;%s;%s Transmitting DATA (N_agg = %d) in %d channels using modulation %d (%.0f bits per OFDM symbol ---> %.2f Mbps) \n",
 							SimTime(), node_params.node_id, node_state, LOG_F04, LOG_LVL4, limited_num_packets_aggregated,
 							(current_right_channel - current_left_channel + 1), current_modulation, bits_ofdm_sym,
@@ -2397,7 +2381,7 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 
 						trigger_SIFS.Set(FixTimeOffset(time_to_trigger,13,12));
 
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 							"%.15f;N%d;S%d;%s;%s SIFS will be triggered in %.12f\n",
 							SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3,
 							trigger_SIFS.GetTime());
@@ -2414,16 +2398,16 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 
 
 					} else {	// Other packet type transmission finished
-						LOGS(node_params.save_node_logs,node_logger.file,
+						NODE_LOGS(node_params.save_node_logs,node_logger,
 								"%.15f;N%d;S%d;%s;%s Unexpected packet type transmission finished!\n",
 								SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL4);
 					}
 
 				} else {	// Node IS NOT THE DESTINATION
 
-					LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Still receiving packet #%d reception from N%d.\n",
-						SimTime(), node_params.node_id, node_state, LOG_E15, LOG_LVL3, incoming_notification.packet_id,
-						incoming_notification.source_id);
+					NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s Still receiving packet #%d reception from N%d.\n",
+						SimTime(), node_params.node_id, node_state, LOG_E15, LOG_LVL3, incoming_notification->packet_id,
+						incoming_notification->source_id);
 				}
 
 				break;
@@ -2454,7 +2438,7 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 				if (notification.packet_type == PACKET_TYPE_NPCA_ICR
 						&& notification.destination_id == node_params.node_id
 						&& npca_on_npca_channel) {
-					LOGS(node_params.save_node_logs, node_logger.file,
+					NODE_LOGS(node_params.save_node_logs, node_logger,
 						"%.15f;N%d;S%d;%s;%s NPCA: ICR received from N%d; proceeding to DATA\n",
 						SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL2,
 						notification.source_id);
@@ -2502,21 +2486,15 @@ void Node :: InportSomeNodeFinishTX(Notification &notification){
 
 	// STATISTICS: compute the time the channel is idle (Node 0 is responsible to monitors this)
 	if (node_params.node_id == 0) {
-		int num_nodes_transmitting = 0;
-		for(int i = 0; i < node_params.total_nodes_number; ++i){
-			if(nodes_transmitting[i] == TRUE){
-				++ num_nodes_transmitting;
-			}
-		}
 		// Check if nobody is transmitting
-		if (num_nodes_transmitting == 0) {
+		if (nodes_transmitting.size == 0) {
 			// If no one is transmitting, set the current SimTime() as the last time the channel has been seen idle
 			node_stats.last_time_channel_is_idle = SimTime();
 			node_stats.channel_idle = true;
 		}
 	}
 
-	// LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s InportSomeNodeFinishTX() END",	SimTime(), node_params.node_id, node_state, LOG_E01, LOG_LVL1);
+	// NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s InportSomeNodeFinishTX() END",	SimTime(), node_params.node_id, node_state, LOG_E01, LOG_LVL1);
 };
 
 #endif /* NODE_FSM_METHODS_H */
@@ -23,6 +23,8 @@
  *   - node_packet_methods.h      : packet generation, MCS request, frame exchange sequence
  *                                  (GenerateNotification, EndBackoff, MyTxFinished, PrepareNewTransmission,
  *                                   ScheduleTransmission, InitiateBurstPackets, SendResponsePacket)
+ *   - node_slotted_methods.h     : channel accesses of the slot-synchronous engine (see Komondor::RunFastPath)
+ *   - node_checkpoint_methods.h  : state of the node at a checkpoint (see Komondor::Checkpoint)
  */
 
 #ifndef NODE_IMPL_H
@@ -36,5 +38,7 @@
 #include "node_backoff_methods.h"
 #include "node_fsm_methods.h"
 #include "node_packet_methods.h"
+#include "node_slotted_methods.h"
+#include "node_checkpoint_methods.h"
 
 #endif /* NODE_IMPL_H */
@@ -92,10 +92,11 @@ double ComputeEbToNoise(double sinr, double bit_rate, int bandwidth, int modulat
 // ===========================================================================
 
 void Node :: InportNackReceived(LogicalNack &logical_nack){
+	COST_PROFILE_SCOPE("Node::InportNackReceived");
 
 	int nack_reason;
 
-//	LOGS(node_params.save_node_logs,node_logger.file,
+//	NODE_LOGS(node_params.save_node_logs,node_logger,
 //			"%.15f;N%d;S%d;%s;%s InportNackReceived(): N%d to N%d (A) and N%d (B)\n",
 //			SimTime(), node_params.node_id, node_state, LOG_H00, LOG_LVL1, logical_nack.source_id,
 //			logical_nack.node_id_a, logical_nack.node_id_b);
@@ -104,7 +105,7 @@ void Node :: InportNackReceived(LogicalNack &logical_nack){
 	if(logical_nack.source_id != node_params.node_id &&
 			(node_params.node_id == logical_nack.node_id_a || node_params.node_id == logical_nack.node_id_b)){
 
-		LOGS(node_params.save_node_logs,node_logger.file,
+		NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s NACK of packet #%d received from N%d sent to a:N%d (and b:N%d) with reason %d\n",
 				SimTime(), node_params.node_id, node_state, LOG_H00, LOG_LVL2, logical_nack.packet_id, logical_nack.source_id,
 				logical_nack.node_id_a, logical_nack.node_id_b, logical_nack.loss_reason);
@@ -116,29 +117,29 @@ void Node :: InportNackReceived(LogicalNack &logical_nack){
 		if(nack_reason == PACKET_LOST_BO_COLLISION){
 			++ node_stats.rts_lost_slotted_bo;
 
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s ++++++++++++++++++++++++++++++++\n",
 				SimTime(), node_params.node_id, node_state, LOG_H00, LOG_LVL2);
 
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s node_stats.rts_lost_slotted_bo ++\n",
 				SimTime(), node_params.node_id, node_state, LOG_H00, LOG_LVL2);
 
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s ++++++++++++++++++++++++++++++++\n",
 				SimTime(), node_params.node_id, node_state, LOG_H00, LOG_LVL2);
 		}
 
 	} else {	// Node is the NACK transmitter, do nothing
 
-//		LOGS(node_params.save_node_logs,node_logger.file,
+//		NODE_LOGS(node_params.save_node_logs,node_logger,
 //				"%.15f;N%d;S%d;%s;%s NACK of packet #%d sent to a) N%d and b) N%d with reason %d\n",
 //				SimTime(), node_params.node_id, node_state, LOG_H00, LOG_LVL2, logical_nack.packet_id,
 //				logical_nack.node_id_a, logical_nack.node_id_b, logical_nack.loss_reason);
 
 	}
 
-	// LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;G01;%s InportNackReceived() END\n", SimTime(), node_params.node_id, LOG_LVL1);
+	// NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;G01;%s InportNackReceived() END\n", SimTime(), node_params.node_id, LOG_LVL1);
 }
 
 /**
@@ -146,10 +147,11 @@ void Node :: InportNackReceived(LogicalNack &logical_nack){
  * @param "notification" [type Notification]: notification containing the MCS request
  */
 void Node :: InportMCSRequestReceived(Notification &notification){
+	COST_PROFILE_SCOPE("Node::InportMCSRequestReceived");
 
 	if(notification.destination_id == node_params.node_id) {	// If node IS THE DESTINATION
 
-		LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s MCS request received from N%d\n",
+		NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s MCS request received from N%d\n",
 			SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL1, notification.source_id);
 
 //		// Compute distance and power received from transmitter
@@ -163,19 +165,19 @@ void Node :: InportMCSRequestReceived(Notification &notification){
 		// Update 'power received' array in case a new tx power is used
 		if (notification.tx_info.flag_change_in_tx_power) {
 			received_power_array[notification.source_id] =
-				ComputePowerReceived(distances_array[notification.source_id],
-				notification.tx_info.tx_power, node_params.central_frequency, node_params.path_loss_model);
+				notification.tx_info.tx_power * path_gain_array[notification.source_id];
 		}
 
-		LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s I am at distance: %.2f m (sensing P_rx = %.2f dBm)\n",
+		NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s I am at distance: %.2f m (sensing P_rx = %.2f dBm)\n",
 			SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL2,
-			distances_array[notification.source_id], ConvertPower(PW_TO_DBM,
+			ComputeDistance(node_params.x, node_params.y, node_params.z, topology->x[notification.source_id],
+				topology->y[notification.source_id], topology->z[notification.source_id]), ConvertPower(PW_TO_DBM,
 			received_power_array[notification.source_id]));
 
 		// Select the modulation according to the SINR perceived corresponding to incoming transmitter
 		SelectMCSResponse(mcs_response, received_power_array[notification.source_id]);
 
-		LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s mcs_response for 1, 2, 4 and 8 channels: ",
+		NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s mcs_response for 1, 2, 4 and 8 channels: ",
 			SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL3);
 
 		PrintOrWriteArrayInt(WRITE_LOG, node_params.save_node_logs,
@@ -197,15 +199,16 @@ void Node :: InportMCSRequestReceived(Notification &notification){
  * @param "notification" [type Notification]: notification containing the MCS response
  */
 void Node :: InportMCSResponseReceived(Notification &notification){
+	COST_PROFILE_SCOPE("Node::InportMCSResponseReceived");
 
 	if(notification.destination_id == node_params.node_id) {	// If node IS THE DESTINATION
 
-		LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s InportMCSResponseReceived()\n",
+		NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s InportMCSResponseReceived()\n",
 				SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL1);
 
 		int ix_aux (current_destination_id - wlan.list_sta_id[0]);	// Auxiliary index for correcting the node id offset
 
-		LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s MCS per number of channels: ",
+		NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s MCS per number of channels: ",
 			SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL2);
 
 		// Set receiver modulation to the received one
@@ -217,7 +220,7 @@ void Node :: InportMCSResponseReceived(Notification &notification){
 			} else {
 				mcs_per_node[ix_aux][i] = notification.tx_info.modulation_schemes[i];
 			}
-			LOGS(node_params.save_node_logs,node_logger.file, "%d ", mcs_per_node[ix_aux][i]);
+			NODE_LOGS(node_params.save_node_logs,node_logger, "%d ", mcs_per_node[ix_aux][i]);
 		}
 
 		// Update performance measurements
@@ -233,8 +236,8 @@ void Node :: InportMCSResponseReceived(Notification &notification){
 			double max_achievable_throughput (max_achievable_bits_ofdm_sym / IEEE_AX_OFDM_SYMBOL_GI32_DURATION);
 			performance_report.max_bound_throughput = max_achievable_throughput;
 			first_time_requesting_mcs = FALSE;
-			LOGS(node_params.save_node_logs,node_logger.file, "\n");
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger, "\n");
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s max_achievable_throughput (%d - %d) = %.1f Mbps "
 				"(%d channel/s: Y_sc = %d, MCS %d: Y_m = %d, Y_c = %.2f)\n",
 				SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL3,
@@ -256,7 +259,7 @@ void Node :: InportMCSResponseReceived(Notification &notification){
 //				change_modulation_flag[ix_aux] = TRUE;
 			} else {
 				// NODE UNREACHABLE
-				LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Unreachable node: transmissions to N%d are cancelled\n",
+				NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s Unreachable node: transmissions to N%d are cancelled\n",
 					SimTime(), node_params.node_id, node_state, LOG_G00, LOG_LVL3, current_destination_id);
 				// TODO: unreachable_nodes[current_destination_id] = TRUE;
 			}
@@ -271,6 +274,7 @@ void Node :: InportMCSResponseReceived(Notification &notification){
  * Called when a new packet is generated by the traffic generator (refer to "traffic_generator.h")
  */
 void Node :: InportNewPacketGenerated(){
+	COST_PROFILE_SCOPE("Node::InportNewPacketGenerated");
 
 //	printf("N%d New packet received from the traffic generator!\n", node_params.node_id);
 
@@ -295,7 +299,7 @@ void Node :: InportNewPacketGenerated(){
 				new_packet.packet_id = last_packet_generated_id;
 				buffer.PutPacket(new_packet);
 
-				LOGS(node_params.save_node_logs,node_logger.file,
+				NODE_LOGS(node_params.save_node_logs,node_logger,
 						"%.15f;N%d;S%d;%s;%s A new packet (id: %d) has been generated (queue: %d/%d)\n",
 						SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL4,
 						new_packet.packet_id, buffer.QueueSize(), PACKET_BUFFER_SIZE);
@@ -303,7 +307,7 @@ void Node :: InportNewPacketGenerated(){
 				// Attempt to restart BO only if node didn't have any packet before a new packet was generated
 				if(node_state == STATE_SENSING && buffer.QueueSize() == 1) {
 
-					if(trigger_end_backoff.Active()) {
+					if(BackoffCountingDown()) {
 						// Backoff already counting down: just refresh the cached remaining value.
 						// Do NOT call ScheduleBackoffAfterDIFS() -- that would arm trigger_start_backoff
 						// while trigger_end_backoff is still live. When PauseBackoff() later cancels
@@ -311,7 +315,7 @@ void Node :: InportNewPacketGenerated(){
 						// state, causing a simultaneous-transmission deadlock.
 						ca_state.remaining_backoff =
 							ComputeRemainingBackoff(node_params.backoff_type, trigger_end_backoff.GetTime() - SimTime());
-					} else if (!trigger_start_backoff.Active()) {
+					} else if (!IfsPending()) {
 						// No countdown in progress: start one now.
 						int resume (HandleBackoff(RESUME_TIMER, &channel_power,
 							node_params.current_primary_channel, current_pd, buffer.QueueSize()));
@@ -325,7 +329,7 @@ void Node :: InportNewPacketGenerated(){
 
 			} else {
 				// Buffer overflow - new packet is lost
-				LOGS(node_params.save_node_logs,node_logger.file,
+				NODE_LOGS(node_params.save_node_logs,node_logger,
 					"%.15f;N%d;S%d;%s;%s A new packet (id: %d) has been dropped! (queue: %d/%d)\n",
 					SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL4,
 					last_packet_generated_id, buffer.QueueSize(), PACKET_BUFFER_SIZE);
@@ -344,7 +348,7 @@ void Node :: InportNewPacketGenerated(){
 
 			int num_packets_generated_in_burst (burst_rate);
 
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s New traffic burst (#%d) generated %d packets\n",
 				SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL4,
 				num_bursts,
@@ -362,7 +366,7 @@ void Node :: InportNewPacketGenerated(){
 					new_packet.packet_id = last_packet_generated_id;
 					buffer.PutPacket(new_packet);
 
-					LOGS(node_params.save_node_logs,node_logger.file,
+					NODE_LOGS(node_params.save_node_logs,node_logger,
 							"%.15f;N%d;S%d;%s;%s A new packet (id: %d) has been generated from burst %d (buffer queue: %d/%d)\n",
 							SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL4,
 							new_packet.packet_id,
@@ -373,7 +377,7 @@ void Node :: InportNewPacketGenerated(){
 					// Attempt to restart BO only if node didn't have any packet before a new packet was generated
 					if(node_state == STATE_SENSING && buffer.QueueSize() == 1) {
 
-						if(trigger_end_backoff.Active()) ca_state.remaining_backoff =
+						if(BackoffCountingDown()) ca_state.remaining_backoff =
 								ComputeRemainingBackoff(node_params.backoff_type, trigger_end_backoff.GetTime() - SimTime());
 
 						int resume (HandleBackoff(RESUME_TIMER, &channel_power, node_params.current_primary_channel,
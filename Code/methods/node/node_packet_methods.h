@@ -14,6 +14,8 @@
  *
  * Functions defined here:
  *   - Node::StartTransmission
+ *   - Node::SendStartTX
+ *   - Node::SendFinishTX
  *   - Node::RequestMCS
  *   - Node::SelectDestination
  *   - Node::GenerateNotification
@@ -36,19 +38,81 @@ void Node :: StartTransmission(trigger_t &){
 	// Check STATE_TX_TF first: TF is sent mid-sequence (exchange_sequence[0] is still ICF)
 	if (node_state == STATE_TX_TF) {
 		tf_notification.timestamp = SimTime();
-		outportSelfStartTX(tf_notification);
+		SendStartTX(tf_notification);
 	} else if (exchange_sequence.frame_types[0] == PACKET_TYPE_RTS) {
 		rts_notification.timestamp = SimTime();
-		outportSelfStartTX(rts_notification);
+		SendStartTX(rts_notification);
 	} else if (exchange_sequence.frame_types[0] == PACKET_TYPE_ICF) {
 		icf_notification.timestamp = SimTime();
-		outportSelfStartTX(icf_notification);
+		SendStartTX(icf_notification);
 	} else if (node_state == STATE_TX_DSO_ICF || node_state == STATE_TX_NPCA_ICF) {
 		icf_notification.timestamp = SimTime();
-		outportSelfStartTX(icf_notification);
+		SendStartTX(icf_notification);
 	} else {
 		data_notification.timestamp = SimTime();
-		outportSelfStartTX(data_notification);
+		SendStartTX(data_notification);
+	}
+}
+
+/**
+ * Notify the start of a transmission to the nodes in range. The notification is copied once into a frame of the
+ * node's pool, which is shared by all the receivers
+ * @param "notification" [type Notification]: notification of the transmission
+ */
+void Node :: SendStartTX(const Notification &notification){
+	NotificationRef frame;
+	if (notification.packet_type == PACKET_TYPE_DATA && notification.tx_info.beamforming_active
+			&& notification.tx_info.beam_N_elements > 1) {
+		// Beamformed DATA: the weights are computed once for all the receivers, which are delivered the frame
+		// right away, so that the gain toward each of them is evaluated here at once
+		ComputeTxBeamWeights(notification.tx_info, &beam_weights);
+		if (beam_gain_per_node != NULL) {
+			EvaluateBeamGains(beam_weights, notification.tx_info.beam_d_spacing, beam_receiver_az_rad,
+				num_beam_receivers, beam_receiver_gain);
+			for (int k = 0; k < num_beam_receivers; ++k) beam_gain_per_node[beam_receiver_ids[k]] = beam_receiver_gain[k];
+		}
+		frame.Create(notification_pool, notification, &beam_weights, beam_gain_per_node);
+	} else {
+		frame.Create(notification_pool, notification);
+	}
+	outportSelfStartTX(*frame);
+}
+
+/**
+ * Notify the end of a transmission to the nodes in range (see SendStartTX)
+ * @param "notification" [type Notification]: notification of the transmission
+ */
+void Node :: SendFinishTX(const Notification &notification){
+	NotificationRef frame;
+	frame.Create(notification_pool, notification);
+	outportSelfFinishTX(*frame);
+}
+
+/**
+ * Set the nodes sensing the frames of the node, toward which the gain of its beamformed DATA frames is
+ * evaluated (see SendStartTX). Nodes at the position of the node get a gain of 1
+ * @param "receiver_ids" [type int*]: IDs of the nodes connected to the node
+ * @param "num_receivers" [type int]: number of nodes connected to the node
+ * @param "x" [type double*]: X position of every node [m]
+ * @param "y" [type double*]: Y position of every node [m]
+ * @param "z" [type double*]: Z position of every node [m]
+ * @param "total_nodes_number" [type int]: number of nodes
+ */
+void Node :: SetBeamReceivers(const int *receiver_ids, int num_receivers, const double *x, const double *y,
+		const double *z, int total_nodes_number){
+	beam_receiver_ids = new int[num_receivers];
+	beam_receiver_az_rad = new double[num_receivers];
+	beam_receiver_gain = new double[num_receivers];
+	beam_gain_per_node = new double[total_nodes_number];
+	num_beam_receivers = 0;
+	for (int k = 0; k < num_receivers; ++k) {
+		int m (receiver_ids[k]);
+		double dx (x[m] - node_params.x), dy (y[m] - node_params.y), dz (z[m] - node_params.z);
+		beam_gain_per_node[m] = 1;
+		if (dx == 0.0 && dy == 0.0 && dz == 0.0) continue;	// As ComputeRxBeamGain() does
+		beam_receiver_ids[num_beam_receivers] = m;
+		beam_receiver_az_rad[num_beam_receivers] = ComputeDirectionAzimuth(dx, dy, dz);
+		++num_beam_receivers;
 	}
 }
 
@@ -57,7 +121,7 @@ void Node :: StartTransmission(trigger_t &){
  */
 void Node :: RequestMCS(){
 
-//	LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s RequestMCS() to N%d\n",
+//	NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s RequestMCS() to N%d\n",
 //				SimTime(), node_params.node_id, node_state, LOG_G00, LOG_LVL1, current_destination_id);
 	// Only one channel required (logically!)
 	// Receiver is able to determine the power received when transmitter uses more than one channel by its own
@@ -70,14 +134,14 @@ void Node :: RequestMCS(){
 	outportAskForTxModulation(request_modulation);
 	int ix_aux (current_destination_id - wlan.list_sta_id[0]);	// Auxiliary variable for correcting the node id offset	
 	change_modulation_flag[ix_aux] = FALSE; 	// MCS of receiver is not pending anymore
-	// LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s RequestMCS() END\n", SimTime(), node_params.node_id, node_state, LOG_G00, LOG_LVL1);
+	// NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s RequestMCS() END\n", SimTime(), node_params.node_id, node_state, LOG_G00, LOG_LVL1);
 }
 
 /**
  * Select the destination node before transmitting
  */
 void Node :: SelectDestination(){
-	current_destination_id = PickRandomElementFromArray(wlan.list_sta_id, wlan.num_stas);
+	current_destination_id = PickRandomElementFromArray(wlan.list_sta_id, wlan.num_stas, &random_stream);
 }
 
 /**
@@ -170,19 +234,19 @@ Notification Node :: GenerateNotification(int packet_type, int destination_id, i
 				/* Coordinator: null toward each peer AP's associated STA */
 				int _g = mapc_active_group_idx;
 				for (int _p = 0; _p < wlan.mapc_num_peers[_g] && _nulls < MAX_BEAM_NULLS; ++_p) {
-					int _ps = all_node_first_sta_id[wlan.mapc_peer_ap_ids[_g][_p]];
+					int _ps = topology->first_sta_id[wlan.mapc_peer_ap_ids[_g][_p]];
 					if (_ps == NODE_ID_NONE) continue;
-					double _dx = all_node_x[_ps] - node_params.x;
-					double _dy = all_node_y[_ps] - node_params.y;
+					double _dx = topology->x[_ps] - node_params.x;
+					double _dy = topology->y[_ps] - node_params.y;
 					_null_az[_nulls++] = atan2(_dy, _dx);
 				}
 				if (wlan.mapc_method_ids[_g] == CO_BF) _zf = 1;
 			} else {
 				/* Coordinated AP: null toward coordinator's associated STA */
-				int _cs = all_node_first_sta_id[coordinator_ap_id];
+				int _cs = topology->first_sta_id[coordinator_ap_id];
 				if (_cs != NODE_ID_NONE) {
-					double _dx = all_node_x[_cs] - node_params.x;
-					double _dy = all_node_y[_cs] - node_params.y;
+					double _dx = topology->x[_cs] - node_params.x;
+					double _dy = topology->y[_cs] - node_params.y;
 					_null_az[0] = atan2(_dy, _dx);
 					_nulls = 1;
 				}
@@ -335,13 +399,13 @@ Notification Node :: GenerateNotification(int packet_type, int destination_id, i
 
 /**
  * Send a NACK notification
- * @param "logical_nack" [type LogicalNack]: logical NACK object to be sent
+ * @param "logical_nack" [type LogicalNack&]: logical NACK object to be sent
  */
-void Node :: SendLogicalNack(LogicalNack logical_nack){
+void Node :: SendLogicalNack(LogicalNack &logical_nack){
 
 	outportSendLogicalNack(logical_nack);
 
-	LOGS(node_params.save_node_logs,node_logger.file,
+	NODE_LOGS(node_params.save_node_logs,node_logger,
 		"%.15f;N%d;S%d;%s;%s NACK of packet type %d sent to a:N%d (and b:N%d) with reason %d\n",
 		SimTime(), node_params.node_id, node_state, LOG_I00, LOG_LVL4, logical_nack.packet_type,
 		logical_nack.node_id_a, logical_nack.node_id_b, logical_nack.loss_reason);
@@ -357,18 +421,18 @@ void Node :: SendResponsePacket(trigger_t &){
 
 		case STATE_TX_ACK:{
 
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s SIFS completed after receiving DATA, sending ACK...\n",
 				SimTime(), node_params.node_id, node_state, LOG_I00, LOG_LVL3);
 
-			outportSelfStartTX(ack_notification);
+			SendStartTX(ack_notification);
 
 			// trigger_toFinishTX.Set(SimTime() + current_tx_duration);
 			// time_to_trigger = TruncateDouble(SimTime() + FEMTO_VALUE,12) + current_tx_duration;
 			time_to_trigger = SimTime() + current_tx_duration;
 			trigger_toFinishTX.Set(FixTimeOffset(time_to_trigger,13,12));
 
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s TruncateDouble = %.12f - current_tx_duration = %.12f - trigger_toFinishTX = %.12f\n",
 				SimTime(), node_params.node_id, node_state, LOG_I00, LOG_LVL3,
 				TruncateDouble(SimTime() + FEMTO_VALUE,12), current_tx_duration, trigger_toFinishTX.GetTime());
@@ -377,10 +441,10 @@ void Node :: SendResponsePacket(trigger_t &){
 		}
 
 		case STATE_TX_CTS:{
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s SIFS completed after receiving RTS, sending CTS (duration = %f)\n",
 				SimTime(), node_params.node_id, node_state, LOG_I00, LOG_LVL3, current_tx_duration);
-			outportSelfStartTX(cts_notification);
+			SendStartTX(cts_notification);
 
 			time_to_trigger = SimTime() + current_tx_duration;
 			trigger_toFinishTX.Set(FixTimeOffset(time_to_trigger,13,12));
@@ -388,10 +452,10 @@ void Node :: SendResponsePacket(trigger_t &){
 		}
 
 		case STATE_TX_DATA:{
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s SIFS completed after receiving CTS, sending DATA...\n",
 				SimTime(), node_params.node_id, node_state, LOG_I00, LOG_LVL3);
-			outportSelfStartTX(data_notification);
+			SendStartTX(data_notification);
 			time_to_trigger = SimTime() + current_tx_duration;
 			trigger_toFinishTX.Set(FixTimeOffset(time_to_trigger,13,12));
 			++node_stats.data_packets_sent;
@@ -399,7 +463,7 @@ void Node :: SendResponsePacket(trigger_t &){
 
 			// Update performance measurements
 			++performance_report.data_packets_sent;
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s Data TX will be finished at %.15f\n",
 				SimTime(), node_params.node_id, node_state, LOG_I00, LOG_LVL3,
 				trigger_toFinishTX.GetTime());
@@ -407,20 +471,20 @@ void Node :: SendResponsePacket(trigger_t &){
 		}
 
 		case STATE_TX_ICR:{
-			LOGS(node_params.save_node_logs, node_logger.file,
+			NODE_LOGS(node_params.save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s SIFS (+stagger) completed after receiving ICF, sending ICR...\n",
 				SimTime(), node_params.node_id, node_state, LOG_I00, LOG_LVL3);
-			outportSelfStartTX(icr_notification);
+			SendStartTX(icr_notification);
 			time_to_trigger = SimTime() + current_tx_duration;
 			trigger_toFinishTX.Set(FixTimeOffset(time_to_trigger, 13, 12));
 			break;
 		}
 
 		case STATE_TX_ACK_TF:{
-			LOGS(node_params.save_node_logs, node_logger.file,
+			NODE_LOGS(node_params.save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s SIFS completed after DATA, sending ACK TF (broadcast)...\n",
 				SimTime(), node_params.node_id, node_state, LOG_I00, LOG_LVL3);
-			outportSelfStartTX(ack_tf_notification);
+			SendStartTX(ack_tf_notification);
 			time_to_trigger = SimTime() + current_tx_duration;
 			trigger_toFinishTX.Set(FixTimeOffset(time_to_trigger, 13, 12));
 			break;
@@ -428,11 +492,11 @@ void Node :: SendResponsePacket(trigger_t &){
 
 		case STATE_TX_RTS:{
 			// MAPC Co-TDMA: sending MU-RTS/TXS after coordinator's own DATA/ACK
-			LOGS(node_params.save_node_logs, node_logger.file,
+			NODE_LOGS(node_params.save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s Sending MU-RTS/TXS to N%d after SIFS\n",
 				SimTime(), node_params.node_id, node_state, LOG_I00, LOG_LVL3,
 				current_destination_id);
-			outportSelfStartTX(mu_rts_notification);
+			SendStartTX(mu_rts_notification);
 			time_to_trigger = SimTime() + current_tx_duration;
 			trigger_toFinishTX.Set(FixTimeOffset(time_to_trigger, 13, 12));
 			break;
@@ -471,19 +535,19 @@ void Node :: InitiateBurstPackets(){
  */
 void Node :: ScheduleTransmission(int first_packet_type){
 
-	LOGS(node_params.save_node_logs,node_logger.file,
+	NODE_LOGS(node_params.save_node_logs,node_logger,
 		"%.15f;N%d;S%d;%s;%s -------------------------------------\n",
 		SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL2);
-	LOGS(node_params.save_node_logs,node_logger.file,
+	NODE_LOGS(node_params.save_node_logs,node_logger,
 		"%.15f;N%d;S%d;%s;%s TRANSMISSION #%d STARTED\n",
 		SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL2,
 		node_stats.rts_cts_sent);
-	LOGS(node_params.save_node_logs,node_logger.file,
+	NODE_LOGS(node_params.save_node_logs,node_logger,
 		"%.15f;N%d;S%d;%s;%s -------------------------------------\n",
 		SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL2);
 
 	if (first_packet_type == PACKET_TYPE_RTS) {
-		LOGS(node_params.save_node_logs,node_logger.file,
+		NODE_LOGS(node_params.save_node_logs,node_logger,
 			"%.15f;N%d;S%d;%s;%s Transmission of RTS #%d started\n",
 			SimTime(), node_params.node_id, node_state, LOG_F04, LOG_LVL3, rts_notification.packet_id);
 		++node_stats.rts_cts_sent;
@@ -491,22 +555,22 @@ void Node :: ScheduleTransmission(int first_packet_type){
 		++performance_report.rts_cts_sent;
 	} else if (first_packet_type == PACKET_TYPE_ICF || first_packet_type == PACKET_TYPE_DSO_ICF
 			|| first_packet_type == PACKET_TYPE_NPCA_ICF) {
-		LOGS(node_params.save_node_logs,node_logger.file,
+		NODE_LOGS(node_params.save_node_logs,node_logger,
 			"%.15f;N%d;S%d;%s;%s Transmission of ICF #%d started\n",
 			SimTime(), node_params.node_id, node_state, LOG_F04, LOG_LVL3, icf_notification.packet_id);
 		++node_stats.rts_cts_sent;
 		++performance_report.rts_cts_sent;
 		// ICF is broadcast — no per-STA breakdown (rts_cts_sent_per_sta not updated)
 	} else if (first_packet_type == PACKET_TYPE_TF) {
-		LOGS(node_params.save_node_logs,node_logger.file,
+		NODE_LOGS(node_params.save_node_logs,node_logger,
 			"%.15f;N%d;S%d;%s;%s Transmission of TF #%d started\n",
 			SimTime(), node_params.node_id, node_state, LOG_F04, LOG_LVL3, tf_notification.packet_id);
 	} else if (first_packet_type == PACKET_TYPE_MU_RTS_TXS) {
-		LOGS(node_params.save_node_logs,node_logger.file,
+		NODE_LOGS(node_params.save_node_logs,node_logger,
 			"%.15f;N%d;S%d;%s;%s Transmission of MU-RTS/TXS #%d started\n",
 			SimTime(), node_params.node_id, node_state, LOG_F04, LOG_LVL3, mu_rts_notification.packet_id);
 	} else {
-		LOGS(node_params.save_node_logs,node_logger.file,
+		NODE_LOGS(node_params.save_node_logs,node_logger,
 			"%.15f;N%d;S%d;%s;%s Transmission of DATA #%d started\n",
 			SimTime(), node_params.node_id, node_state, LOG_F04, LOG_LVL3, data_notification.packet_id);
 		// 2-way path (no RTS/CTS): count DATA TX here since SendResponsePacket is never called
@@ -541,7 +605,7 @@ void Node :: ScheduleTransmission(int first_packet_type){
 	time_to_trigger = SimTime() + current_tx_duration;
 
 	trigger_toFinishTX.Set(FixTimeOffset(time_to_trigger,13,12));
-	trigger_start_backoff.Cancel();	// Safety instruction
+	CancelIfs();	// Safety instruction
 }
 
 /**
@@ -558,7 +622,7 @@ void Node :: PrepareNewTransmission() {
 	current_right_channel = GetFirstOrLastTrueElemOfArray(LAST_TRUE_IN_ARRAY,
 		channels_for_tx, NUM_CHANNELS_KOMONDOR);
 
-	LOGS(node_params.save_node_logs,node_logger.file,
+	NODE_LOGS(node_params.save_node_logs,node_logger,
 		"%.15f;N%d;S%d;%s;%s Transmission is possible in range: %d - %d\n",
 		SimTime(), node_params.node_id, node_state, LOG_F04, LOG_LVL3, current_left_channel, current_right_channel);
 
@@ -620,7 +684,7 @@ void Node :: PrepareNewTransmission() {
 			buffer.DelFirstPacket();
 		}
 	}
-	LOGS(node_params.save_node_logs,node_logger.file,
+	NODE_LOGS(node_params.save_node_logs,node_logger,
 		"%.15f;N%d;S%d;%s;%s Data packet/s removed from buffer (queue: %d/%d).\n",
 		SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3,
 		buffer.QueueSize(), PACKET_BUFFER_SIZE);
@@ -632,20 +696,16 @@ void Node :: PrepareNewTransmission() {
 		current_num_packets_aggregated = buffer.QueueSize();
 	}
 
-	// data rate depending on CB and streams: Nsc * ym * yc * SUSS
+	// data rate depending on CB and streams: Nsc * ym * yc * SUSS (looked up in the timing table)
 	// Preamble puncturing: GetNumberSubcarriers uses the full range (for correct MCS bandwidth class),
 	// then scaled down by the active-to-range ratio to reflect punctured sub-channels.
-	bits_ofdm_sym =  GetNumberSubcarriers(num_channels_tx) *
-		Mcs_array::modulation_bits[current_modulation-1] *
-		Mcs_array::coding_rates[current_modulation-1] *
-		IEEE_AX_SU_SPATIAL_STREAMS *
-		((double)num_active_channels_tx / (double)num_channels_tx);
+	PhyRate phy_rate (phy_timing->Rate(current_modulation, num_channels_tx, num_active_channels_tx));
+	bits_ofdm_sym = phy_rate.bits_ofdm_sym;
 
 	// Update the number of packets to aggregate (just in case that the max PPDU is exceeded with the current MCS)
-	limited_num_packets_aggregated = FindMaximumPacketsAggregated
-		(current_num_packets_aggregated, node_params.frame_length, bits_ofdm_sym);
+	limited_num_packets_aggregated = phy_timing->MaximumPacketsAggregated(phy_rate, current_num_packets_aggregated);
 
-	LOGS(node_params.save_node_logs,node_logger.file,
+	NODE_LOGS(node_params.save_node_logs,node_logger,
 		"%.15f;N%d;S%d;%s;%s Num. of packets to aggregate: %d/%d (last_transmission_successful=%d)\n",
 		SimTime(), node_params.node_id, node_state, LOG_F04, LOG_LVL4,
 		limited_num_packets_aggregated, node_params.max_num_packets_aggregated, last_transmission_successful);
@@ -654,7 +714,7 @@ void Node :: PrepareNewTransmission() {
 	// Transmitting 0 packets wastes the TXOP and produces invalid frame durations.
 	if (limited_num_packets_aggregated == 0
 			&& node_params.traffic_model != TRAFFIC_FULL_BUFFER_NO_DIFFERENTIATION) {
-		LOGS(node_params.save_node_logs, node_logger.file,
+		NODE_LOGS(node_params.save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s Buffer empty; aborting TX and restarting (no CW increase).\n",
 			SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3);
 		RestartNode(FALSE);
@@ -682,8 +742,8 @@ void Node :: PrepareNewTransmission() {
 	// ********************************************************
 
 	// Compute all packets durations (RTS, CTS, DATA and ACK) and NAV time
-	ComputeFramesDuration(&rts_duration, &cts_duration, &data_duration, &ack_duration,
-		num_channels_tx, current_modulation, limited_num_packets_aggregated, node_params.frame_length, bits_ofdm_sym);
+	phy_timing->FramesDuration(phy_rate, limited_num_packets_aggregated,
+		&rts_duration, &cts_duration, &data_duration, &ack_duration);
 
 	// TXOP split: save budget at ICF time; cap DATA duration to per-AP allocation
 	if (wlan.mapc_enabled && coordinator_ap_id == NODE_ID_NONE
@@ -694,11 +754,10 @@ void Node :: PrepareNewTransmission() {
 			&& mapc_txop_per_ap_data_duration > 0.0
 			&& exchange_sequence.frame_types[0] != PACKET_TYPE_ICF) {
 		// DATA path (coordinator or coordinated AP): reduce lnpa to fit within budget
-		while (limited_num_packets_aggregated > 1 && data_duration > mapc_txop_per_ap_data_duration) {
-			--limited_num_packets_aggregated;
-			ComputeFramesDuration(&rts_duration, &cts_duration, &data_duration, &ack_duration,
-				num_channels_tx, current_modulation, limited_num_packets_aggregated, node_params.frame_length, bits_ofdm_sym);
-		}
+		limited_num_packets_aggregated = phy_timing->PacketsAggregatedWithin(phy_rate,
+			limited_num_packets_aggregated, mapc_txop_per_ap_data_duration);
+		phy_timing->FramesDuration(phy_rate, limited_num_packets_aggregated,
+			&rts_duration, &cts_duration, &data_duration, &ack_duration);
 		// Co-BF/Co-SR: if AP has fewer packets than the TXOP slot, pad data_duration
 		// to the allocated value so both APs' DATA frames end at the same time.
 		// Co-TDMA is excluded (sequential slots; each AP uses its natural duration).
@@ -716,28 +775,26 @@ void Node :: PrepareNewTransmission() {
 	if (node_params.backoff_type == BACKOFF_EDCA) {
 		double edca_txop_limit = ComputeTxopLimit(current_traffic_type);
 		if (edca_txop_limit > 0.0) {
-			while (limited_num_packets_aggregated > 1 && data_duration > edca_txop_limit) {
-				--limited_num_packets_aggregated;
-				ComputeFramesDuration(&rts_duration, &cts_duration, &data_duration, &ack_duration,
-					num_channels_tx, current_modulation, limited_num_packets_aggregated,
-					node_params.frame_length, bits_ofdm_sym);
-			}
+			limited_num_packets_aggregated = phy_timing->PacketsAggregatedWithin(phy_rate,
+				limited_num_packets_aggregated, edca_txop_limit);
+			phy_timing->FramesDuration(phy_rate, limited_num_packets_aggregated,
+				&rts_duration, &cts_duration, &data_duration, &ack_duration);
 		}
 	}
 
-	LOGS(node_params.save_node_logs,node_logger.file,
+	NODE_LOGS(node_params.save_node_logs,node_logger,
 		"%.15f;N%d;S%d;%s;%s Transmitting (N_agg = %d) in %d channels using modulation %d (%.0f bits per OFDM symbol ---> %.2f Mbps) \n",
 		SimTime(), node_params.node_id, node_state, LOG_F04, LOG_LVL4, limited_num_packets_aggregated,
 		(int) pow(2, ix_num_channels_used), current_modulation, bits_ofdm_sym,
 		bits_ofdm_sym/IEEE_AX_OFDM_SYMBOL_GI32_DURATION * pow(10,-6));
 
 	if(sr_state.mapc_cosr_active || (sr_state.spatial_reuse_enabled && sr_state.txop_sr_identified)) {
-		LOGS(node_params.save_node_logs,node_logger.file,
+		NODE_LOGS(node_params.save_node_logs,node_logger,
 			"%.15f;N%d;S%d;%s;%s Using tx power = %f dBm \n",
 			SimTime(), node_params.node_id, node_state, LOG_F04, LOG_LVL4,
 			ConvertPower(PW_TO_DBM, sr_state.current_tx_power_sr));
 	} else {
-		LOGS(node_params.save_node_logs,node_logger.file,
+		NODE_LOGS(node_params.save_node_logs,node_logger,
 			"%.15f;N%d;S%d;%s;%s Using tx power = %f dBm \n",
 			SimTime(), node_params.node_id, node_state, LOG_F04, LOG_LVL4,
 			ConvertPower(PW_TO_DBM, current_tx_power));
@@ -748,8 +805,8 @@ void Node :: PrepareNewTransmission() {
 	if (node_params.beamforming_enabled) {
 		double _bf_dx, _bf_dy;
 		// Main beam: steer toward current destination
-		_bf_dx = all_node_x[current_destination_id] - node_params.x;
-		_bf_dy = all_node_y[current_destination_id] - node_params.y;
+		_bf_dx = topology->x[current_destination_id] - node_params.x;
+		_bf_dy = topology->y[current_destination_id] - node_params.y;
 		current_beam_az_main_rad = atan2(_bf_dy, _bf_dx);
 		current_beam_num_nulls = 0;
 		current_beam_use_zf = 0;	/* default: projection (standalone BF) */
@@ -759,10 +816,10 @@ void Node :: PrepareNewTransmission() {
 			int _g = mapc_active_group_idx;
 			for (int _p = 0; _p < wlan.mapc_num_peers[_g]
 					&& current_beam_num_nulls < MAX_BEAM_NULLS; ++_p) {
-				int _peer_sta = all_node_first_sta_id[wlan.mapc_peer_ap_ids[_g][_p]];
+				int _peer_sta = topology->first_sta_id[wlan.mapc_peer_ap_ids[_g][_p]];
 				if (_peer_sta == NODE_ID_NONE) continue;
-				_bf_dx = all_node_x[_peer_sta] - node_params.x;
-				_bf_dy = all_node_y[_peer_sta] - node_params.y;
+				_bf_dx = topology->x[_peer_sta] - node_params.x;
+				_bf_dy = topology->y[_peer_sta] - node_params.y;
 				current_beam_null_az_rad[current_beam_num_nulls++] = atan2(_bf_dy, _bf_dx);
 			}
 			// Co-BF: use ZF precoding for simultaneous transmissions
@@ -770,10 +827,10 @@ void Node :: PrepareNewTransmission() {
 				current_beam_use_zf = 1;
 		} else if (wlan.mapc_enabled && coordinator_ap_id != NODE_ID_NONE) {
 			// MAPC coordinated AP: null toward coordinator's associated STA
-			int _coord_sta = all_node_first_sta_id[coordinator_ap_id];
+			int _coord_sta = topology->first_sta_id[coordinator_ap_id];
 			if (_coord_sta != NODE_ID_NONE) {
-				_bf_dx = all_node_x[_coord_sta] - node_params.x;
-				_bf_dy = all_node_y[_coord_sta] - node_params.y;
+				_bf_dx = topology->x[_coord_sta] - node_params.x;
+				_bf_dy = topology->y[_coord_sta] - node_params.y;
 				current_beam_null_az_rad[0] = atan2(_bf_dy, _bf_dx);
 				current_beam_num_nulls = 1;
 			}
@@ -792,18 +849,16 @@ void Node :: PrepareNewTransmission() {
 			+ NPCA_ICR_DURATION_US) * MICRO_VALUE + 2.0 * SIFS;
 		double _npca_cap = IEEE_AX_MAX_PPDU_DURATION - _npca_pre - SIFS - ack_duration;
 		if (_npca_cap < 0.0) _npca_cap = 0.0;
-		while (limited_num_packets_aggregated > 1 && data_duration > _npca_cap) {
-			--limited_num_packets_aggregated;
-			ComputeFramesDuration(&rts_duration, &cts_duration, &data_duration, &ack_duration,
-				num_channels_tx, current_modulation, limited_num_packets_aggregated,
-				node_params.frame_length, bits_ofdm_sym);
-		}
+		limited_num_packets_aggregated = phy_timing->PacketsAggregatedWithin(phy_rate,
+			limited_num_packets_aggregated, _npca_cap);
+		phy_timing->FramesDuration(phy_rate, limited_num_packets_aggregated,
+			&rts_duration, &cts_duration, &data_duration, &ack_duration);
 		current_tx_duration = data_duration;
 		current_nav_time = ComputeNavTime(STATE_TX_DATA, rts_duration, cts_duration,
 			data_duration, ack_duration, SIFS);
 		current_nav_time = FixTimeOffset(current_nav_time, 13, 12);
 		time_rand_value = 0;
-		int _rand_npca (2 + rand() % (MAX_NUM_RAND_TIME-2));
+		int _rand_npca (2 + random_stream.Rand() % (MAX_NUM_RAND_TIME-2));
 		time_rand_value = (double)_rand_npca * MAX_DIFFERENCE_SAME_TIME/MAX_NUM_RAND_TIME;
 		time_rand_value = FixTimeOffset(time_rand_value, 13, 12);
 		current_nav_time = current_nav_time - time_rand_value;
@@ -823,12 +878,10 @@ void Node :: PrepareNewTransmission() {
 			+ DSO_ICR_DURATION_US) * MICRO_VALUE + 2.0 * SIFS;
 		double _dso_cap = IEEE_AX_MAX_PPDU_DURATION - _dso_pre - SIFS - ack_duration;
 		if (_dso_cap < 0.0) _dso_cap = 0.0;
-		while (limited_num_packets_aggregated > 1 && data_duration > _dso_cap) {
-			--limited_num_packets_aggregated;
-			ComputeFramesDuration(&rts_duration, &cts_duration, &data_duration, &ack_duration,
-				num_channels_tx, current_modulation, limited_num_packets_aggregated,
-				node_params.frame_length, bits_ofdm_sym);
-		}
+		limited_num_packets_aggregated = phy_timing->PacketsAggregatedWithin(phy_rate,
+			limited_num_packets_aggregated, _dso_cap);
+		phy_timing->FramesDuration(phy_rate, limited_num_packets_aggregated,
+			&rts_duration, &cts_duration, &data_duration, &ack_duration);
 
 		current_tx_duration = data_duration;
 		current_nav_time = ComputeNavTime(STATE_TX_DATA, rts_duration, cts_duration,
@@ -836,7 +889,7 @@ void Node :: PrepareNewTransmission() {
 		current_nav_time = FixTimeOffset(current_nav_time, 13, 12);
 
 		time_rand_value = 0;
-		int _rand_dso (2 + rand() % (MAX_NUM_RAND_TIME-2));
+		int _rand_dso (2 + random_stream.Rand() % (MAX_NUM_RAND_TIME-2));
 		time_rand_value = (double)_rand_dso * MAX_DIFFERENCE_SAME_TIME/MAX_NUM_RAND_TIME;
 		time_rand_value = FixTimeOffset(time_rand_value, 13, 12);
 		current_nav_time = current_nav_time - time_rand_value;
@@ -860,19 +913,14 @@ void Node :: PrepareNewTransmission() {
 			int _npca_nch = _nr - _nl + 1;
 			int _npca_mcs = mcs_per_node[ix_mcs_per_node][(int)log2((double)_npca_nch)];
 			if (_npca_mcs <= 0) _npca_mcs = MODULATION_BPSK_1_2;
-			double _npca_bpsy = GetNumberSubcarriers(_npca_nch)
-				* Mcs_array::modulation_bits[_npca_mcs - 1]
-				* Mcs_array::coding_rates[_npca_mcs - 1]
-				* IEEE_AX_SU_SPATIAL_STREAMS;
-			ComputeFramesDuration(&rts_duration, &cts_duration, &data_duration, &ack_duration,
-				_npca_nch, _npca_mcs, limited_num_packets_aggregated,
-				node_params.frame_length, _npca_bpsy);
+			phy_timing->FramesDuration(phy_timing->Rate(_npca_mcs, _npca_nch), limited_num_packets_aggregated,
+				&rts_duration, &cts_duration, &data_duration, &ack_duration);
 		}
 		double _npca_pre2 = (double)(NPCA_SWITCH_TIME_US + NPCA_ICR_DURATION_US) * MICRO_VALUE;
 		current_nav_time = SIFS + _npca_pre2 + SIFS + data_duration + SIFS + ack_duration;
 		current_nav_time = FixTimeOffset(current_nav_time, 13, 12);
 		time_rand_value = 0;
-		int _rand_npca_icf (2 + rand() % (MAX_NUM_RAND_TIME-2));
+		int _rand_npca_icf (2 + random_stream.Rand() % (MAX_NUM_RAND_TIME-2));
 		time_rand_value = (double)_rand_npca_icf * MAX_DIFFERENCE_SAME_TIME/MAX_NUM_RAND_TIME;
 		time_rand_value = FixTimeOffset(time_rand_value, 13, 12);
 		current_nav_time = current_nav_time - time_rand_value;
@@ -899,13 +947,8 @@ void Node :: PrepareNewTransmission() {
 		{
 			int _dso_nch = dso_channels_for_tx[1] - dso_channels_for_tx[0] + 1;
 			int _dso_mcs = mcs_per_node[ix_mcs_per_node][(int)log2((double)_dso_nch)];
-			double _dso_bpsy = GetNumberSubcarriers(_dso_nch)
-				* Mcs_array::modulation_bits[_dso_mcs - 1]
-				* Mcs_array::coding_rates[_dso_mcs - 1]
-				* IEEE_AX_SU_SPATIAL_STREAMS;
-			ComputeFramesDuration(&rts_duration, &cts_duration, &data_duration, &ack_duration,
-				_dso_nch, _dso_mcs, limited_num_packets_aggregated,
-				node_params.frame_length, _dso_bpsy);
+			phy_timing->FramesDuration(phy_timing->Rate(_dso_mcs, _dso_nch), limited_num_packets_aggregated,
+				&rts_duration, &cts_duration, &data_duration, &ack_duration);
 		}
 
 		// NAV: ICR wait + SIFS + data + SIFS + ack (data_duration now reflects DSO subband BW)
@@ -914,7 +957,7 @@ void Node :: PrepareNewTransmission() {
 		current_nav_time = FixTimeOffset(current_nav_time, 13, 12);
 
 		time_rand_value = 0;
-		int _rand_icf (2 + rand() % (MAX_NUM_RAND_TIME-2));
+		int _rand_icf (2 + random_stream.Rand() % (MAX_NUM_RAND_TIME-2));
 		time_rand_value = (double)_rand_icf * MAX_DIFFERENCE_SAME_TIME/MAX_NUM_RAND_TIME;
 		time_rand_value = FixTimeOffset(time_rand_value, 13, 12);
 		current_nav_time = current_nav_time - time_rand_value;
@@ -950,7 +993,7 @@ void Node :: PrepareNewTransmission() {
 		 * way we are able to capture slotted BO collisions.
 		 */
 		time_rand_value = 0;
-		int rand_number_rts (2 + rand() % (MAX_NUM_RAND_TIME-2));	// in [2, MAX_NUM_RAND_TIME]
+		int rand_number_rts (2 + random_stream.Rand() % (MAX_NUM_RAND_TIME-2));	// in [2, MAX_NUM_RAND_TIME]
 		time_rand_value = (double) rand_number_rts * MAX_DIFFERENCE_SAME_TIME/MAX_NUM_RAND_TIME; // in [FEMTO_SECOND, MAX_DIFFERENCE_SAME_TIME]
 		// Sergio on 28/09/2017
 		// time_rand_value = RoundToDigits(time_rand_value, 15);
@@ -982,7 +1025,7 @@ void Node :: PrepareNewTransmission() {
 		current_nav_time = FixTimeOffset(current_nav_time,13,12);
 
 		time_rand_value = 0;
-		int rand_number_icf (2 + rand() % (MAX_NUM_RAND_TIME-2));
+		int rand_number_icf (2 + random_stream.Rand() % (MAX_NUM_RAND_TIME-2));
 		time_rand_value = (double) rand_number_icf * MAX_DIFFERENCE_SAME_TIME/MAX_NUM_RAND_TIME;
 		time_rand_value = FixTimeOffset(time_rand_value,13,12);
 		current_nav_time = current_nav_time - time_rand_value;
@@ -1019,7 +1062,7 @@ void Node :: PrepareNewTransmission() {
 		// same simulation time. The random offset exists only to break backoff ties, which
 		// is not relevant here since neither AP is contending — both start immediately.
 		if (!(wlan.mapc_enabled && sr_state.mapc_cosr_active)) {
-			int rand_number_data (2 + rand() % (MAX_NUM_RAND_TIME-2));
+			int rand_number_data (2 + random_stream.Rand() % (MAX_NUM_RAND_TIME-2));
 			time_rand_value = (double) rand_number_data * MAX_DIFFERENCE_SAME_TIME/MAX_NUM_RAND_TIME;
 			time_rand_value = FixTimeOffset(time_rand_value,13,12);
 		}
@@ -1044,8 +1087,8 @@ void Node :: PrepareNewTransmission() {
  */
 void Node :: EndBackoff(trigger_t &){
 
-	LOGS(node_params.save_node_logs,node_logger.file, "\n----------------------------------------------------------\n");
-	LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s EndBackoff()\n",
+	NODE_LOGS(node_params.save_node_logs,node_logger, "\n----------------------------------------------------------\n");
+	NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s EndBackoff()\n",
 			SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL1);
 
 	// Spatial Reuse: apply SR TX power/PD parameters if an SR TXOP was identified
@@ -1071,7 +1114,7 @@ void Node :: EndBackoff(trigger_t &){
 			coordinated_ap_ids[i] = wlan.mapc_peer_ap_ids[mapc_active_group_idx][i];
 		// Round-robin: select which coordinated AP to invite this TXOP
 		mapc_selected_peer_id = coordinated_ap_ids[mapc_current_peer_idx % num_coordinated_aps];
-		LOGS(node_params.save_node_logs, node_logger.file,
+		NODE_LOGS(node_params.save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s MAPC: selected peer N%d (round-robin idx %d)\n",
 			SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL2,
 			mapc_selected_peer_id, mapc_current_peer_idx % num_coordinated_aps);
@@ -1113,19 +1156,19 @@ void Node :: EndBackoff(trigger_t &){
 		current_destination_id = wlan.list_sta_id[n];
 		// Receive the possible MCS to be used for each number of channels
 		if (change_modulation_flag[n]) {
-			LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Requesting MCS to N%d\n",
+			NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s Requesting MCS to N%d\n",
 				SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL2, current_destination_id);
 			RequestMCS();
 		}
 	}
 
-	LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Allowed LEFT/RIGHT: %d - %d\n",
+	NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s Allowed LEFT/RIGHT: %d - %d\n",
 		SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL2, node_params.min_channel_allowed, node_params.max_channel_allowed);
 
 	// Pick one receiver from the pool of potential receivers
 	SelectDestination();
 
-	LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Trying to start TX to STA N%d\n",
+	NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s Trying to start TX to STA N%d\n",
 		SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL2, current_destination_id);
 
 	// Identify free channels
@@ -1151,7 +1194,7 @@ void Node :: EndBackoff(trigger_t &){
 			if (sta_max_ch >= 0 && sta_max_ch < eff_max_channel) eff_max_channel = sta_max_ch;
 		}
 	}
-	LOGS(node_params.save_node_logs,node_logger.file,
+	NODE_LOGS(node_params.save_node_logs,node_logger,
 		"%.15f;N%d;S%d;%s;%s Effective TX range for N%d: [%d, %d]\n",
 		SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL3,
 		current_destination_id, eff_min_channel, eff_max_channel);
@@ -1166,22 +1209,22 @@ void Node :: EndBackoff(trigger_t &){
 		channels_free, eff_min_channel, eff_max_channel,
 		&channel_power, effective_pd, timestamp_channel_becomes_free, SimTime(), PIFS,
 		node_params.current_dcb_policy, NUM_CHANNELS_KOMONDOR, channel_aggregation_cca_model,
-		channels_for_tx, &pp_punctured_bitmap);
+		channels_for_tx, &pp_punctured_bitmap, &random_stream);
 
-	LOGS(node_params.save_node_logs,node_logger.file,
+	NODE_LOGS(node_params.save_node_logs,node_logger,
 		"%.15f;N%d;S%d;%s;%s Power sensed per channel [dBm]: ",
 		SimTime(), node_params.node_id, node_state, LOG_E18, LOG_LVL3);
 
 	PrintOrWriteChannelPower(WRITE_LOG, node_params.save_node_logs, node_params.print_node_logs, node_logger,
 		&channel_power);
 
-	LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Channels founds free (mind PIFS if activated): ",
+	NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s Channels founds free (mind PIFS if activated): ",
 		SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL3);
 
 	PrintOrWriteChannelsFree(WRITE_LOG, node_params.save_node_logs, node_params.print_node_logs, node_logger,
 		channels_free);
 
-	LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s Channels for transmitting: ",
+	NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s Channels for transmitting: ",
 		SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL2);
 
 	PrintOrWriteChannelForTx(WRITE_LOG, node_params.save_node_logs, node_params.print_node_logs, node_logger,
@@ -1213,7 +1256,7 @@ void Node :: EndBackoff(trigger_t &){
 				current_destination_id = _cand;
 				dso_rr_idx = (_idx + 1) % _n_stas;
 				exchange_sequence = IEEE_802_11_DSO;
-				LOGS(node_params.save_node_logs, node_logger.file,
+				NODE_LOGS(node_params.save_node_logs, node_logger,
 					"%.15f;N%d;S%d;%s;%s DSO: selected N%d on secondary [%d,%d]\n",
 					SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL2,
 					_cand, dso_channels_for_tx[0], dso_channels_for_tx[1]);
@@ -1229,7 +1272,7 @@ void Node :: EndBackoff(trigger_t &){
 	} else {	// Transmission IS NOT POSSIBLE, compute a new backoff.
 		AbortInitialTransmission();
 	}
-	// LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s EndBackoff() END\n", SimTime(), node_params.node_id, node_state, LOG_F01, LOG_LVL1);
+	// NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s EndBackoff() END\n", SimTime(), node_params.node_id, node_state, LOG_F01, LOG_LVL1);
 };
 
 /**
@@ -1237,7 +1280,7 @@ void Node :: EndBackoff(trigger_t &){
  */
 void Node :: MyTxFinished(trigger_t &){
 
-//	LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s MyTxFinished()\n",
+//	NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s MyTxFinished()\n",
 //			SimTime(), node_params.node_id, node_state, LOG_G00, LOG_LVL1);
 
 	switch(node_state){
@@ -1252,8 +1295,8 @@ void Node :: MyTxFinished(trigger_t &){
 				// Propagate per-AP allocation so HandleFinishTX_StateRxMuRts can cap AP_B's DATA
 				notification.tx_info.mapc_allocated_data_duration =
 					mu_rts_notification.tx_info.mapc_allocated_data_duration;
-				outportSelfFinishTX(notification);
-				LOGS(node_params.save_node_logs, node_logger.file,
+				SendFinishTX(notification);
+				NODE_LOGS(node_params.save_node_logs, node_logger,
 					"%.15f;N%d;S%d;%s;%s MU-RTS/TXS #%d tx finished. Advancing round-robin and restarting.\n",
 					SimTime(), node_params.node_id, node_state, LOG_G00, LOG_LVL2,
 					notification.packet_id);
@@ -1267,14 +1310,14 @@ void Node :: MyTxFinished(trigger_t &){
 					rts_notification.packet_id, limited_num_packets_aggregated,
 					rts_notification.timestamp_generated, TX_DURATION_NONE);
 
-				outportSelfFinishTX(notification);
+				SendFinishTX(notification);
 
 				// Time out = T_c = T_RTS + SIFS + T_CTS minus T_RTS (already txed)
 				time_to_trigger = SimTime() + SIFS + notification.tx_info.cts_duration;
 				trigger_CTS_timeout.Set(FixTimeOffset(time_to_trigger,13,12));
 				node_state = STATE_WAIT_CTS;
 
-				LOGS(node_params.save_node_logs,node_logger.file,
+				NODE_LOGS(node_params.save_node_logs,node_logger,
 					"%.15f;N%d;S%d;%s;%s RTS #%d tx finished. Waiting for CTS until %.12f\n",
 					SimTime(), node_params.node_id, node_state, LOG_G00, LOG_LVL2,
 					notification.packet_id, trigger_CTS_timeout.GetTime());
@@ -1289,14 +1332,14 @@ void Node :: MyTxFinished(trigger_t &){
 				cts_notification.packet_id, cts_notification.tx_info.num_packets_aggregated,
 				cts_notification.timestamp_generated, TX_DURATION_NONE);
 
-			outportSelfFinishTX(notification);
+			SendFinishTX(notification);
 
 			// Set CTS timeout and change state to STATE_WAIT_DATA
 			time_to_trigger = SimTime() + SIFS + TIME_OUT_EXTRA_TIME;
 			trigger_DATA_timeout.Set(FixTimeOffset(time_to_trigger,13,12));
 			node_state = STATE_WAIT_DATA;
 
-			LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s CTS %d tx finished. Waiting for DATA...\n",
+			NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s CTS %d tx finished. Waiting for DATA...\n",
 				SimTime(), node_params.node_id, node_state, LOG_G00, LOG_LVL2, notification.packet_id);
 
 			break;
@@ -1320,7 +1363,7 @@ void Node :: MyTxFinished(trigger_t &){
 			if (cobf_cosr)
 				notification.mapc_group_id = wlan.mapc_group_ids[mapc_active_group_idx];
 
-			outportSelfFinishTX(notification);
+			SendFinishTX(notification);
 
 			if (cobf_cosr && coordinator_ap_id == NODE_ID_NONE) {
 				// COORDINATOR: send ACK TF after SIFS to trigger simultaneous ACKs from both STAs
@@ -1331,7 +1374,7 @@ void Node :: MyTxFinished(trigger_t &){
 				node_state = STATE_TX_ACK_TF;
 				time_to_trigger = SimTime() + SIFS;
 				trigger_SIFS.Set(FixTimeOffset(time_to_trigger, 13, 12));
-				LOGS(node_params.save_node_logs, node_logger.file,
+				NODE_LOGS(node_params.save_node_logs, node_logger,
 					"%.15f;N%d;S%d;%s;%s DATA %d tx done (Co-BF/SR coordinator). Sending ACK TF after SIFS.\n",
 					SimTime(), node_params.node_id, node_state, LOG_G00, LOG_LVL2, notification.packet_id);
 			} else if (cobf_cosr && coordinator_ap_id != NODE_ID_NONE) {
@@ -1339,7 +1382,7 @@ void Node :: MyTxFinished(trigger_t &){
 				node_state = STATE_WAIT_ACK_TF;
 				time_to_trigger = SimTime() + SIFS + rts_duration + SIFS + TIME_OUT_EXTRA_TIME;
 				trigger_DATA_timeout.Set(FixTimeOffset(time_to_trigger, 13, 12));
-				LOGS(node_params.save_node_logs, node_logger.file,
+				NODE_LOGS(node_params.save_node_logs, node_logger,
 					"%.15f;N%d;S%d;%s;%s DATA %d tx done (Co-BF/SR coordinated). Waiting for ACK TF.\n",
 					SimTime(), node_params.node_id, node_state, LOG_G00, LOG_LVL2, notification.packet_id);
 			} else if (data_notification.tx_info.ack_required == 0) {
@@ -1372,7 +1415,7 @@ void Node :: MyTxFinished(trigger_t &){
 					&ca_state.current_cw_min, &ca_state.current_cw_max, &ca_state.cw_stage_current,
 					node_params.cw_min_default, node_params.cw_max_default, node_params.cw_stage_max,
 					distance_to_token, node_params.backoff_type, current_traffic_type);
-				LOGS(node_params.save_node_logs, node_logger.file,
+				NODE_LOGS(node_params.save_node_logs, node_logger,
 					"%.15f;N%d;S%d;%s;%s DATA %d tx done. ACK suppressed, assuming delivery success.\n",
 					SimTime(), node_params.node_id, node_state, LOG_G00, LOG_LVL2, notification.packet_id);
 				RestartNode(FALSE);
@@ -1381,7 +1424,7 @@ void Node :: MyTxFinished(trigger_t &){
 				time_to_trigger = SimTime() + SIFS + TIME_OUT_EXTRA_TIME;
 				trigger_ACK_timeout.Set(FixTimeOffset(time_to_trigger,13,12));
 				node_state = STATE_WAIT_ACK;
-				LOGS(node_params.save_node_logs,node_logger.file,
+				NODE_LOGS(node_params.save_node_logs,node_logger,
 					"%.15f;N%d;S%d;%s;%s DATA %d tx finished. Waiting for ACK...\n",
 					SimTime(), node_params.node_id, node_state, LOG_G00, LOG_LVL2, notification.packet_id);
 			}
@@ -1395,14 +1438,14 @@ void Node :: MyTxFinished(trigger_t &){
 				ack_tf_notification.packet_id, 0,
 				ack_tf_notification.timestamp_generated, TX_DURATION_NONE);
 			notification.mapc_group_id = wlan.mapc_group_ids[mapc_active_group_idx];
-			outportSelfFinishTX(notification);
+			SendFinishTX(notification);
 
 			// Now wait for ACK from own STA
 			time_to_trigger = SimTime() + SIFS + TIME_OUT_EXTRA_TIME;
 			trigger_ACK_timeout.Set(FixTimeOffset(time_to_trigger, 13, 12));
 			node_state = STATE_WAIT_ACK;
 
-			LOGS(node_params.save_node_logs, node_logger.file,
+			NODE_LOGS(node_params.save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s ACK TF #%d tx finished. Waiting for ACK from N%d.\n",
 				SimTime(), node_params.node_id, node_state, LOG_G00, LOG_LVL2,
 				notification.packet_id, current_destination_id);
@@ -1416,9 +1459,9 @@ void Node :: MyTxFinished(trigger_t &){
 				ack_notification.packet_id, ack_notification.tx_info.num_packets_aggregated,
 				ack_notification.timestamp_generated, TX_DURATION_NONE);
 
-			outportSelfFinishTX(notification);
+			SendFinishTX(notification);
 
-			LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s ACK %d tx finished. Restarting node...\n",
+			NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s ACK %d tx finished. Restarting node...\n",
 				SimTime(), node_params.node_id, node_state, LOG_G00, LOG_LVL2, notification.packet_id);
 
 			RestartNode(FALSE);
@@ -1435,7 +1478,7 @@ void Node :: MyTxFinished(trigger_t &){
 			notification.mapc_group_id = wlan.mapc_group_ids[mapc_active_group_idx];
 			notification.mapc_target_ap_id = icf_notification.mapc_target_ap_id;
 
-			outportSelfFinishTX(notification);
+			SendFinishTX(notification);
 
 			// ICR timeout reuses trigger_CTS_timeout (same semantic role: waiting for control response)
 			time_to_trigger = SimTime() + SIFS + notification.tx_info.cts_duration;
@@ -1443,7 +1486,7 @@ void Node :: MyTxFinished(trigger_t &){
 
 			node_state = STATE_WAIT_ICR;
 
-			LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s ICF #%d tx finished. Waiting for ICR until %.12f\n",
+			NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s ICF #%d tx finished. Waiting for ICR until %.12f\n",
 				SimTime(), node_params.node_id, node_state, LOG_G00, LOG_LVL2,
 				notification.packet_id, trigger_CTS_timeout.GetTime());
 
@@ -1451,7 +1494,7 @@ void Node :: MyTxFinished(trigger_t &){
 		}
 
 		case STATE_TX_ICR:{		// ICR sent — wait for next MAPC frame (MU-RTS/TXS or TF)
-			outportSelfFinishTX(icr_notification);
+			SendFinishTX(icr_notification);
 			int icr_rejected = FALSE;
 			if (wlan.mapc_method_ids[mapc_active_group_idx] == CO_TDMA) {
 				if (icr_notification.mapc_has_data) {
@@ -1464,7 +1507,7 @@ void Node :: MyTxFinished(trigger_t &){
 					// ICR rejection (no data): coordinator will continue TXOP solo.
 					// Channel will be busy during coordinator's DATA slot, so our backoff freezes naturally.
 					icr_rejected = TRUE;
-					LOGS(node_params.save_node_logs, node_logger.file,
+					NODE_LOGS(node_params.save_node_logs, node_logger,
 						"%.15f;N%d;S%d;%s;%s ICR sent as rejection (no data). Coordinator continues solo; returning to SENSING.\n",
 						SimTime(), node_params.node_id, node_state, LOG_G00, LOG_LVL2);
 					coordinator_ap_id = NODE_ID_NONE;
@@ -1480,7 +1523,7 @@ void Node :: MyTxFinished(trigger_t &){
 				} else {
 					// ICR rejection (no data): coordinator will transmit solo; return to SENSING.
 					icr_rejected = TRUE;
-					LOGS(node_params.save_node_logs, node_logger.file,
+					NODE_LOGS(node_params.save_node_logs, node_logger,
 						"%.15f;N%d;S%d;%s;%s ICR sent as rejection (no data). Coordinator continues solo; returning to SENSING.\n",
 						SimTime(), node_params.node_id, node_state, LOG_G00, LOG_LVL2);
 					coordinator_ap_id = NODE_ID_NONE;
@@ -1488,7 +1531,7 @@ void Node :: MyTxFinished(trigger_t &){
 				}
 			}
 			if (!icr_rejected) {
-				LOGS(node_params.save_node_logs, node_logger.file,
+				NODE_LOGS(node_params.save_node_logs, node_logger,
 					"%.15f;N%d;S%d;%s;%s ICR tx finished; waiting for %s\n",
 					SimTime(), node_params.node_id, node_state, LOG_G00, LOG_LVL2,
 					(wlan.mapc_method_ids[mapc_active_group_idx] == CO_TDMA) ? "MU-RTS/TXS" : "TF");
@@ -1506,9 +1549,9 @@ void Node :: MyTxFinished(trigger_t &){
 			notification.tx_info.mapc_sr_peer_tx_power          = tf_notification.tx_info.mapc_sr_peer_tx_power;
 			notification.tx_info.mapc_allocated_data_duration   = tf_notification.tx_info.mapc_allocated_data_duration;
 
-			outportSelfFinishTX(notification);
+			SendFinishTX(notification);
 
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s TF #%d tx finished. Coordinator starts DATA simultaneously.\n",
 				SimTime(), node_params.node_id, node_state, LOG_G00, LOG_LVL2, notification.packet_id);
 
@@ -1530,7 +1573,7 @@ void Node :: MyTxFinished(trigger_t &){
 					&channel_power, current_pd, timestamp_channel_becomes_free, SimTime(), PIFS);
 				GetTxChannels(channels_for_tx, node_params.current_dcb_policy, channels_free,
 					eff_min, eff_max, node_params.current_primary_channel,
-					NUM_CHANNELS_KOMONDOR, &channel_power, channel_aggregation_cca_model, NULL);
+					NUM_CHANNELS_KOMONDOR, &channel_power, channel_aggregation_cca_model, NULL, &random_stream);
 			}
 			// No packets were ACKed during the ICF/ICR/TF exchange; reset so
 			// PrepareNewTransmission does not attempt to delete from the empty buffer
@@ -1543,7 +1586,7 @@ void Node :: MyTxFinished(trigger_t &){
 		case STATE_TX_NPCA_ICF:{
 			Notification _npca_icf_fin = GenerateNotification(PACKET_TYPE_NPCA_ICF, current_destination_id,
 				icf_notification.packet_id, limited_num_packets_aggregated, SimTime(), TX_DURATION_NONE);
-			outportSelfFinishTX(_npca_icf_fin);
+			SendFinishTX(_npca_icf_fin);
 			time_to_trigger = SimTime() + SIFS
 				+ (double)NPCA_SWITCH_TIME_US * MICRO_VALUE
 				+ (double)NPCA_ICR_DURATION_US * MICRO_VALUE;
@@ -1557,7 +1600,7 @@ void Node :: MyTxFinished(trigger_t &){
 				data_notification.packet_id, data_notification.tx_info.num_packets_aggregated,
 				data_notification.timestamp_generated, TX_DURATION_NONE);
 			_npca_data_fin.tx_info.ack_required = data_notification.tx_info.ack_required;
-			outportSelfFinishTX(_npca_data_fin);
+			SendFinishTX(_npca_data_fin);
 			time_to_trigger = SimTime() + SIFS + TIME_OUT_EXTRA_TIME;
 			trigger_ACK_timeout.Set(FixTimeOffset(time_to_trigger, 13, 12));
 			node_state = STATE_WAIT_ACK_NPCA;
@@ -1570,7 +1613,7 @@ void Node :: MyTxFinished(trigger_t &){
 			_dso_icf_fin.tx_info.dso_tx           = 1;
 			_dso_icf_fin.tx_info.dso_subband_left  = dso_channels_for_tx[0];
 			_dso_icf_fin.tx_info.dso_subband_right = dso_channels_for_tx[1];
-			outportSelfFinishTX(_dso_icf_fin);
+			SendFinishTX(_dso_icf_fin);
 			time_to_trigger = SimTime() + SIFS
 				+ (double)DSO_SWITCH_TIME_US * MICRO_VALUE
 				+ (double)DSO_ICR_DURATION_US * MICRO_VALUE;
@@ -1585,7 +1628,7 @@ void Node :: MyTxFinished(trigger_t &){
 				data_notification.timestamp_generated, TX_DURATION_NONE);
 			_dso_data_fin.tx_info.dso_tx = 1;
 			_dso_data_fin.tx_info.ack_required = data_notification.tx_info.ack_required;
-			outportSelfFinishTX(_dso_data_fin);
+			SendFinishTX(_dso_data_fin);
 			time_to_trigger = SimTime() + SIFS + TIME_OUT_EXTRA_TIME;
 			trigger_ACK_timeout.Set(FixTimeOffset(time_to_trigger, 13, 12));
 			node_state = STATE_WAIT_ACK_DSO;
@@ -1599,7 +1642,7 @@ void Node :: MyTxFinished(trigger_t &){
     // Reset the flag that indicates whether the tx power changed or not
     sr_state.flag_change_in_tx_power = FALSE;
 
-	// LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s  MyTxFinished()\n", SimTime(), node_params.node_id, node_state, LOG_G01, LOG_LVL1);
+	// NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s  MyTxFinished()\n", SimTime(), node_params.node_id, node_state, LOG_G01, LOG_LVL1);
 };
 
 /**
@@ -1608,7 +1651,7 @@ void Node :: MyTxFinished(trigger_t &){
  */
 void Node :: DsoIcrTimeout(trigger_t &){
 
-	LOGS(node_params.save_node_logs, node_logger.file,
+	NODE_LOGS(node_params.save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s DsoIcrTimeout: switching to DSO subband [%d,%d]\n",
 		SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL1,
 		dso_channels_for_tx[0], dso_channels_for_tx[1]);
@@ -1631,8 +1674,9 @@ void Node :: DsoIcrTimeout(trigger_t &){
  * CheckAndArmNpcaSwitch: freeze primary backoff and arm switch to NPCA channel.
  */
 void Node :: CheckAndArmNpcaSwitch() {
+	COST_PROFILE_SCOPE("Node::CheckAndArmNpcaSwitch");
 	if (trigger_npca_switch.Active()) return;
-	if (trigger_end_backoff.Active())
+	if (BackoffCountingDown())
 		npca_stored_backoff_counter = (int)(ComputeRemainingBackoff(
 			node_params.backoff_type, trigger_end_backoff.GetTime() - SimTime()) / SLOT_TIME + 0.5);
 	else
@@ -1642,7 +1686,7 @@ void Node :: CheckAndArmNpcaSwitch() {
 	npca_stored_primary_channel = node_params.current_primary_channel;
 	trigger_end_backoff.Cancel();
 	trigger_start_backoff.Cancel();
-	LOGS(node_params.save_node_logs, node_logger.file,
+	NODE_LOGS(node_params.save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s NPCA: arming switch to ch%d (stored BO=%d)\n",
 		SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL1,
 		npca_primary_channel, npca_stored_backoff_counter);
@@ -1654,7 +1698,7 @@ void Node :: CheckAndArmNpcaSwitch() {
  * NpcaSwitchComplete: radio tuned to NPCA channel. Start NPCA_TIMER and draw backoff.
  */
 void Node :: NpcaSwitchComplete(trigger_t &) {
-	LOGS(node_params.save_node_logs, node_logger.file,
+	NODE_LOGS(node_params.save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s NPCA: on ch%d; starting NPCA_TIMER\n",
 		SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL1, npca_primary_channel);
 	npca_on_npca_channel = 1;
@@ -1666,8 +1710,7 @@ void Node :: NpcaSwitchComplete(trigger_t &) {
 		npca_on_npca_channel = 0;
 		ca_state.remaining_backoff = (double)npca_stored_backoff_counter * SLOT_TIME;
 		ca_state.current_cw_max    = npca_stored_cw;
-		time_to_trigger = SimTime() + DIFS;
-		trigger_start_backoff.Set(FixTimeOffset(time_to_trigger, 13, 12));
+		ArmBackoffAfterIfs(SimTime() + DIFS);
 		return;
 	}
 	for (int _c = 0; _c < NUM_CHANNELS_KOMONDOR; ++_c)
@@ -1679,7 +1722,7 @@ void Node :: NpcaSwitchComplete(trigger_t &) {
 	{
 		int _cw_base = (1 << npca_init_qsrc) * (GetAcCwMin(current_traffic_type) + 1) - 1;
 		npca_cw = _cw_base;
-		int _bo = (int)(((double)rand() / (double)RAND_MAX) * (double)_cw_base);
+		int _bo = (int)(((double)random_stream.Rand() / (double)RAND_MAX) * (double)_cw_base);
 		time_to_trigger = SimTime() + (double)_bo * SLOT_TIME;
 		if (time_to_trigger <= SimTime()) time_to_trigger = SimTime() + SLOT_TIME;
 		trigger_npca_backoff.Set(FixTimeOffset(time_to_trigger, 13, 12));
@@ -1697,7 +1740,7 @@ void Node :: EndNpcaBackoff(trigger_t &) {
 			npca_stored_primary_channel,
 			node_params.min_channel_allowed, node_params.max_channel_allowed,
 			&channel_power, current_pd)) {
-		int _bo = (int)(((double)rand() / (double)RAND_MAX) * (double)npca_cw);
+		int _bo = (int)(((double)random_stream.Rand() / (double)RAND_MAX) * (double)npca_cw);
 		if (_bo < 1) _bo = 1;
 		time_to_trigger = SimTime() + (double)_bo * SLOT_TIME;
 		trigger_npca_backoff.Set(FixTimeOffset(time_to_trigger, 13, 12));
@@ -1709,7 +1752,7 @@ void Node :: EndNpcaBackoff(trigger_t &) {
 	current_right_channel = _nr;
 	for (int _c = 0; _c < NUM_CHANNELS_KOMONDOR; ++_c)
 		channels_for_tx[_c] = npca_channels_for_tx[_c];
-	LOGS(node_params.save_node_logs, node_logger.file,
+	NODE_LOGS(node_params.save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s NPCA: backoff done; ICF on [%d,%d]\n",
 		SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL1, _nl, _nr);
 	node_state = STATE_TX_NPCA_ICF;
@@ -1727,7 +1770,7 @@ void Node :: EndNpcaBackoff(trigger_t &) {
  */
 void Node :: NpcaIcrTimeout(trigger_t &) {
 	if (!npca_on_npca_channel) return;
-	LOGS(node_params.save_node_logs, node_logger.file,
+	NODE_LOGS(node_params.save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s NPCA: ICR timeout; DATA on [%d,%d]\n",
 		SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL1,
 		current_left_channel, current_right_channel);
@@ -1739,7 +1782,7 @@ void Node :: NpcaIcrTimeout(trigger_t &) {
  * NpcaSwitchBack: NPCA_TIMER expired. Restore BSS primary backoff.
  */
 void Node :: NpcaSwitchBack(trigger_t &) {
-	LOGS(node_params.save_node_logs, node_logger.file,
+	NODE_LOGS(node_params.save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s NPCA: TIMER expired; returning to BSS primary\n",
 		SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL1);
 	trigger_npca_switch.Cancel();
@@ -1755,14 +1798,14 @@ void Node :: NpcaSwitchBack(trigger_t &) {
 	ca_state.remaining_backoff = (double)npca_stored_backoff_counter * SLOT_TIME;
 	ca_state.current_cw_max    = npca_stored_cw;
 	node_state = STATE_SENSING;
-	time_to_trigger = SimTime() + (double)npca_switch_back_delay_us * MICRO_VALUE + DIFS;
-	trigger_start_backoff.Set(FixTimeOffset(time_to_trigger, 13, 12));
+	ArmBackoffAfterIfs(SimTime() + (double)npca_switch_back_delay_us * MICRO_VALUE + DIFS);
 }
 
 /**
  * HandleFinishTX_StateRxIcf: coordinated AP responds with ICR after receiving ICF
  */
-void Node :: HandleFinishTX_StateRxIcf(const Notification &notification) {
+void Node :: HandleFinishTX_StateRxIcf(const NotificationFrame &notification) {
+	COST_PROFILE_SCOPE("Node::HandleFinishTX_StateRxIcf");
 	if (notification.packet_type != PACKET_TYPE_ICF
 			|| notification.destination_id != NODE_ID_MAPC_BROADCAST
 			|| notification.mapc_group_id != wlan.mapc_group_ids[mapc_active_group_idx]) return;
@@ -1777,7 +1820,7 @@ void Node :: HandleFinishTX_StateRxIcf(const Notification &notification) {
 
 	GetTxChannels(channels_for_tx, node_params.current_dcb_policy, channels_free,
 		current_left_channel, current_right_channel, node_params.current_primary_channel,
-		NUM_CHANNELS_KOMONDOR, &channel_power, channel_aggregation_cca_model, NULL);
+		NUM_CHANNELS_KOMONDOR, &channel_power, channel_aggregation_cca_model, NULL, &random_stream);
 
 	if (channels_for_tx[0] == TX_NOT_POSSIBLE) {
 		RestartNode(TRUE);
@@ -1809,21 +1852,14 @@ void Node :: HandleFinishTX_StateRxIcf(const Notification &notification) {
 		int _ix_ch = (int)log2((double)(current_right_channel - current_left_channel + 1));
 		int _mod   = mcs_per_node[0][_ix_ch];
 		if (_mod > 0) {
-			double _bs = (double)GetNumberSubcarriers(current_right_channel - current_left_channel + 1)
-				* Mcs_array::modulation_bits[_mod - 1]
-				* Mcs_array::coding_rates[_mod - 1]
-				* (double)IEEE_AX_SU_SPATIAL_STREAMS;
+			PhyRate _rate = phy_timing->Rate(_mod, current_right_channel - current_left_channel + 1);
 			int _lnpa = (node_params.traffic_model == TRAFFIC_FULL_BUFFER_NO_DIFFERENTIATION)
 				? node_params.max_num_packets_aggregated
 				: ((buffer.QueueSize() < node_params.max_num_packets_aggregated)
 				   ? buffer.QueueSize() : node_params.max_num_packets_aggregated);
-			_lnpa = FindMaximumPacketsAggregated(_lnpa, node_params.frame_length, _bs);
+			_lnpa = phy_timing->MaximumPacketsAggregated(_rate, _lnpa);
 			if (_lnpa > 0) {
-				double _req_data = 0.0, _dmy1 = 0.0, _dmy2 = 0.0, _dmy3 = 0.0;
-				ComputeFramesDuration(&_dmy1, &_dmy2, &_req_data, &_dmy3,
-					current_right_channel - current_left_channel + 1,
-					_mod, _lnpa, node_params.frame_length, (int)_bs);
-				icr_notification.tx_info.mapc_allocated_data_duration = _req_data;
+				icr_notification.tx_info.mapc_allocated_data_duration = phy_timing->DataDuration(_rate, _lnpa);
 			} else {
 				icr_notification.tx_info.mapc_allocated_data_duration = 0.0;
 			}
@@ -1839,7 +1875,7 @@ void Node :: HandleFinishTX_StateRxIcf(const Notification &notification) {
 	time_to_trigger = SimTime() + sifs_delay;
 	trigger_SIFS.Set(FixTimeOffset(time_to_trigger, 13, 12));
 
-	LOGS(node_params.save_node_logs, node_logger.file,
+	NODE_LOGS(node_params.save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s ICF done, sending ICR after %.9f s (stagger pos %d)\n",
 		SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3,
 		sifs_delay, mapc_peer_position);
@@ -1848,13 +1884,14 @@ void Node :: HandleFinishTX_StateRxIcf(const Notification &notification) {
 /**
  * HandleFinishTX_StateRxIcr: coordinator collects ICRs and proceeds when all received
  */
-void Node :: HandleFinishTX_StateRxIcr(const Notification &notification) {
+void Node :: HandleFinishTX_StateRxIcr(const NotificationFrame &notification) {
+	COST_PROFILE_SCOPE("Node::HandleFinishTX_StateRxIcr");
 	if (notification.packet_type != PACKET_TYPE_ICR
 			|| notification.destination_id != node_params.node_id) return;
 
 	++mapc_icr_received_count;
 	++node_stats.num_icr_rx;
-	LOGS(node_params.save_node_logs, node_logger.file,
+	NODE_LOGS(node_params.save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s ICR received from N%d (%d/%d) has_data=%d\n",
 		SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3,
 		notification.source_id, mapc_icr_received_count, num_coordinated_aps,
@@ -1889,7 +1926,8 @@ void Node :: ComputeCoSRTxPowers(double &coordinator_pW, double &peer_pW) {
  * ProceedAfterIcr: coordinator decides next action after all ICRs collected
  */
 void Node :: ProceedAfterIcr() {
-	LOGS(node_params.save_node_logs, node_logger.file,
+	COST_PROFILE_SCOPE("Node::ProceedAfterIcr");
+	NODE_LOGS(node_params.save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s All ICRs collected. Proceeding with %s\n",
 		SimTime(), node_params.node_id, node_state, LOG_F04, LOG_LVL2,
 		(wlan.mapc_method_ids[mapc_active_group_idx] == CO_TDMA) ? "Co-TDMA DATA" : "Co-BF/SR TF");
@@ -1913,7 +1951,7 @@ void Node :: ProceedAfterIcr() {
 				&channel_power, current_pd, timestamp_channel_becomes_free, SimTime(), PIFS);
 			GetTxChannels(channels_for_tx, node_params.current_dcb_policy, channels_free,
 				eff_min, eff_max, node_params.current_primary_channel,
-				NUM_CHANNELS_KOMONDOR, &channel_power, channel_aggregation_cca_model, NULL);
+				NUM_CHANNELS_KOMONDOR, &channel_power, channel_aggregation_cca_model, NULL, &random_stream);
 		}
 		// No packets were ACKed during the ICF/ICR exchange; reset so
 		// PrepareNewTransmission does not attempt to delete from the empty buffer
@@ -1948,7 +1986,7 @@ void Node :: ProceedAfterIcr() {
 		// Co-BF / Co-SR
 		if (!mapc_peer_has_data) {
 			// Peer has no data: skip TF, coordinator transmits DATA alone
-			LOGS(node_params.save_node_logs, node_logger.file,
+			NODE_LOGS(node_params.save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s ICR: peer N%d has no data; skipping TF, transmitting solo\n",
 				SimTime(), node_params.node_id, node_state, LOG_F04, LOG_LVL3,
 				mapc_selected_peer_id);
@@ -1969,7 +2007,7 @@ void Node :: ProceedAfterIcr() {
 					&channel_power, current_pd, timestamp_channel_becomes_free, SimTime(), PIFS);
 				GetTxChannels(channels_for_tx, node_params.current_dcb_policy, channels_free,
 					eff_min, eff_max, node_params.current_primary_channel,
-					NUM_CHANNELS_KOMONDOR, &channel_power, channel_aggregation_cca_model, NULL);
+					NUM_CHANNELS_KOMONDOR, &channel_power, channel_aggregation_cca_model, NULL, &random_stream);
 			}
 			limited_num_packets_aggregated = 0;
 			mapc_txop_per_ap_data_duration = 0.0;
@@ -2020,11 +2058,12 @@ void Node :: ProceedAfterIcr() {
 /**
  * HandleFinishTX_StateRxMuRts: coordinated AP (Co-TDMA) received MU-RTS/TXS, starts DATA
  */
-void Node :: HandleFinishTX_StateRxMuRts(const Notification &notification) {
+void Node :: HandleFinishTX_StateRxMuRts(const NotificationFrame &notification) {
+	COST_PROFILE_SCOPE("Node::HandleFinishTX_StateRxMuRts");
 	if (notification.packet_type != PACKET_TYPE_MU_RTS_TXS
 			|| notification.destination_id != node_params.node_id) return;
 
-	LOGS(node_params.save_node_logs, node_logger.file,
+	NODE_LOGS(node_params.save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s MU-RTS/TXS done, starting DATA exchange\n",
 		SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3);
 
@@ -2047,7 +2086,7 @@ void Node :: HandleFinishTX_StateRxMuRts(const Notification &notification) {
 			&channel_power, current_pd, timestamp_channel_becomes_free, SimTime(), PIFS);
 		GetTxChannels(channels_for_tx, node_params.current_dcb_policy, channels_free,
 			eff_min, eff_max, node_params.current_primary_channel,
-			NUM_CHANNELS_KOMONDOR, &channel_power, channel_aggregation_cca_model, NULL);
+			NUM_CHANNELS_KOMONDOR, &channel_power, channel_aggregation_cca_model, NULL, &random_stream);
 	}
 	if (channels_for_tx[0] == TX_NOT_POSSIBLE) {
 		RestartNode(TRUE);
@@ -2056,7 +2095,7 @@ void Node :: HandleFinishTX_StateRxMuRts(const Notification &notification) {
 	{
 		int ix_dest (current_destination_id - wlan.list_sta_id[0]);
 		if (change_modulation_flag[ix_dest]) {
-			LOGS(node_params.save_node_logs, node_logger.file,
+			NODE_LOGS(node_params.save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s MU-RTS: first TDMA slot, requesting MCS for N%d\n",
 				SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3,
 				current_destination_id);
@@ -2075,11 +2114,12 @@ void Node :: HandleFinishTX_StateRxMuRts(const Notification &notification) {
 /**
  * HandleFinishTX_StateRxTf: coordinated AP (Co-BF/Co-SR) received TF, starts simultaneous DATA
  */
-void Node :: HandleFinishTX_StateRxTf(const Notification &notification) {
+void Node :: HandleFinishTX_StateRxTf(const NotificationFrame &notification) {
+	COST_PROFILE_SCOPE("Node::HandleFinishTX_StateRxTf");
 	if (notification.packet_type != PACKET_TYPE_TF
 			|| notification.mapc_group_id != wlan.mapc_group_ids[mapc_active_group_idx]) return;
 
-	LOGS(node_params.save_node_logs, node_logger.file,
+	NODE_LOGS(node_params.save_node_logs, node_logger,
 		"%.15f;N%d;S%d;%s;%s TF done, starting simultaneous DATA transmission\n",
 		SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3);
 
@@ -2102,7 +2142,7 @@ void Node :: HandleFinishTX_StateRxTf(const Notification &notification) {
 			&channel_power, current_pd, timestamp_channel_becomes_free, SimTime(), PIFS);
 		GetTxChannels(channels_for_tx, node_params.current_dcb_policy, channels_free,
 			eff_min, eff_max, node_params.current_primary_channel,
-			NUM_CHANNELS_KOMONDOR, &channel_power, channel_aggregation_cca_model, NULL);
+			NUM_CHANNELS_KOMONDOR, &channel_power, channel_aggregation_cca_model, NULL, &random_stream);
 	}
 	if (channels_for_tx[0] == TX_NOT_POSSIBLE) {
 		RestartNode(TRUE);
@@ -2118,7 +2158,7 @@ void Node :: HandleFinishTX_StateRxTf(const Notification &notification) {
 	{
 		int ix_dest (current_destination_id - wlan.list_sta_id[0]);
 		if (change_modulation_flag[ix_dest]) {
-			LOGS(node_params.save_node_logs, node_logger.file,
+			NODE_LOGS(node_params.save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s TF: first slot, requesting MCS for N%d\n",
 				SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3,
 				current_destination_id);
@@ -2142,7 +2182,7 @@ void Node :: HandleFinishTX_StateRxTf(const Notification &notification) {
  * - Coordinated AP: transitions to STATE_WAIT_ACK to receive its own STA's ACK.
  * - STA: transitions to STATE_TX_ACK and sends ACK to its AP after SIFS.
  */
-void Node :: HandleFinishTX_StateWaitAckTf(const Notification &notification) {
+void Node :: HandleFinishTX_StateWaitAckTf(const NotificationFrame &notification) {
 	if (notification.packet_type != PACKET_TYPE_ACK_TF
 			|| wlan.FindMapcGroupIdx(notification.mapc_group_id) < 0) return;
 
@@ -2153,7 +2193,7 @@ void Node :: HandleFinishTX_StateWaitAckTf(const Notification &notification) {
 		time_to_trigger = SimTime() + SIFS + TIME_OUT_EXTRA_TIME;
 		trigger_ACK_timeout.Set(FixTimeOffset(time_to_trigger, 13, 12));
 		node_state = STATE_WAIT_ACK;
-		LOGS(node_params.save_node_logs, node_logger.file,
+		NODE_LOGS(node_params.save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s ACK TF received. Waiting for ACK from own STA (N%d).\n",
 			SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3, current_destination_id);
 	} else {
@@ -2161,7 +2201,7 @@ void Node :: HandleFinishTX_StateWaitAckTf(const Notification &notification) {
 		node_state = STATE_TX_ACK;
 		time_to_trigger = SimTime() + SIFS;
 		trigger_SIFS.Set(FixTimeOffset(time_to_trigger, 13, 12));
-		LOGS(node_params.save_node_logs, node_logger.file,
+		NODE_LOGS(node_params.save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s ACK TF received. Sending ACK to N%d after SIFS.\n",
 			SimTime(), node_params.node_id, node_state, LOG_E14, LOG_LVL3, current_destination_id);
 	}
@@ -0,0 +1,189 @@
+/* Kom8ndor IEEE 802.11bn Simulator
+ *
+ * Copyright (c) 2026, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+ */
+
+/**
+ * node_slotted_methods.h: node side of the slot-synchronous engine (see Komondor::RunFastPath).
+ *
+ * NOTE: This file is an implementation fragment. It must be included from node.h
+ *   after the Node class definition, not included directly.
+ *
+ * In a saturated contention group whose nodes all sense each other, every channel access starts at a
+ * slot boundary after the DIFS/AIFS, and every RTS/CTS/DATA/ACK exchange succeeds under the IEEE
+ * 802.11 capture model. The engine then only needs the number of slots each AP counts before its next
+ * access; these methods perform an access exactly as EndBackoff() through RestartNode() would (same
+ * random draws, same counters), without any event.
+ *
+ * Functions defined here:
+ *   - Node::SlottedIfsSlots
+ *   - Node::SlottedBackoffSlots
+ *   - Node::SlottedExchangeDuration
+ *   - Node::SlottedTransmission
+ *   - Node::SlottedRecoveryTime
+ */
+
+#ifndef NODE_SLOTTED_METHODS_H
+#define NODE_SLOTTED_METHODS_H
+
+/**
+ * Slots of the DIFS/AIFS after its SIFS, i.e., DIFS = SIFS + 2 slots and AIFS[AC] = SIFS + AIFSN[AC] slots
+ * @return "ifs_slots" [type int]: number of slots of the inter-frame space after the SIFS
+ */
+int Node :: SlottedIfsSlots(){
+	double ifs = (node_params.backoff_type == BACKOFF_EDCA) ? ComputeAIFS(current_traffic_type) : DIFS;
+	return (int) floor((ifs - SIFS) / SLOT_TIME + 0.5);
+}
+
+/**
+ * Backoff slots left before the node accesses the channel (including the extra slot after a transmission)
+ * @return "backoff_slots" [type int]: remaining backoff [slots]
+ */
+int Node :: SlottedBackoffSlots(){
+	return (int) floor(ca_state.remaining_backoff / SLOT_TIME + 0.5);
+}
+
+/**
+ * Compute the frames of a single-channel RTS/CTS/DATA/ACK exchange to the given STA, as done by
+ * PrepareNewTransmission() with the MCS answered by the STA. The state of the node is not modified
+ * @param "destination_id" [type int]: STA of the exchange
+ * @param "num_packets_aggregated" [type int*]: packets aggregated in the DATA frame (output)
+ * @param "durations" [type double*]: RTS, CTS, DATA and ACK durations [s] (output, 4 elements)
+ * @return "exchange_duration" [type double]: duration of the whole exchange, SIFS included [s]
+ */
+double Node :: SlottedExchangeDuration(int destination_id, int *num_packets_aggregated, double *durations){
+
+	int mcs[NUM_OPTIONS_CHANNEL_LENGTH];
+	SelectMCSResponse(mcs, topology->ReceivedPowerRow(destination_id)[node_params.node_id]);
+	int modulation (mcs[0] > 0 ? mcs[0] : MODULATION_BPSK_1_2);
+
+	PhyRate rate (phy_timing->Rate(modulation, 1));
+	*num_packets_aggregated = phy_timing->MaximumPacketsAggregated(rate, node_params.max_num_packets_aggregated);
+
+	// EDCA TXOP limit (see PrepareNewTransmission)
+	if (node_params.backoff_type == BACKOFF_EDCA) {
+		double edca_txop_limit = ComputeTxopLimit(node_params.traffic_type);
+		if (edca_txop_limit > 0.0) {
+			*num_packets_aggregated = phy_timing->PacketsAggregatedWithin(rate, *num_packets_aggregated, edca_txop_limit);
+		}
+	}
+	phy_timing->FramesDuration(rate, *num_packets_aggregated, &durations[0], &durations[1], &durations[2], &durations[3]);
+
+	return durations[0] + SIFS + durations[1] + SIFS + durations[2] + SIFS + durations[3];
+}
+
+/**
+ * Access the channel at a slot boundary and complete the exchange with a STA picked as in EndBackoff().
+ * Statistics of the AP and of the STA are updated as the frame exchange would (only the steps taking place
+ * before the end of the simulation are accounted) and, if the ACK is received in time, the CW is reset and
+ * a new backoff is computed as in RestartNode()
+ * @param "tx_time" [type double]: time at which the backoff expires [s]
+ * @param "stop_time" [type double]: end of the simulation [s]
+ * @param "stats_per_node" [type NodeStatistics**]: statistics of every node (to account the CTS and ACK of the STA)
+ * @return "end_time" [type double]: time at which the exchange finishes [s]
+ */
+double Node :: SlottedTransmission(double tx_time, double stop_time, NodeStatistics **stats_per_node){
+
+	int ch (node_params.current_primary_channel);
+	double last_window_start (node_params.simulation_time_komondor - node_stats.last_measurements_window);
+
+	// EndBackoff()
+	node_stats.sum_waiting_time = node_stats.sum_waiting_time + tx_time - node_stats.timestamp_new_trial_started;
+	++node_stats.num_average_waiting_time_measurements;
+	if (tx_time > last_window_start) {
+		node_stats.last_sum_waiting_time = node_stats.last_sum_waiting_time + tx_time - node_stats.timestamp_new_trial_started;
+		++node_stats.last_num_average_waiting_time_measurements;
+	}
+	SelectDestination();
+	++node_stats.num_tx_init_tried;
+	++node_stats.num_trials_tx_per_num_channels[0];
+	current_left_channel = ch;
+	current_right_channel = ch;
+	num_channels_tx = 1;
+
+	double durations[4];
+	double exchange_duration (SlottedExchangeDuration(current_destination_id, &limited_num_packets_aggregated, durations));
+	rts_duration = durations[0];
+	cts_duration = durations[1];
+	data_duration = durations[2];
+	ack_duration = durations[3];
+	int ix_sta (current_destination_id - node_params.node_id - 1);
+	NodeStatistics &sta_stats = *stats_per_node[current_destination_id];
+
+	// RTS
+	++node_stats.rts_cts_sent;
+	++node_stats.rts_cts_sent_per_sta[ix_sta];
+	node_stats.total_time_channel_busy_per_channel[ch] += rts_duration;
+
+	// CTS (accounted by the STA once the RTS is received)
+	double rts_end_time (tx_time + rts_duration);
+	if (rts_end_time >= stop_time) return tx_time + exchange_duration;
+	sta_stats.total_time_channel_busy_per_channel[ch] += cts_duration;
+
+	// DATA (accounted once the CTS is received)
+	double cts_end_time (rts_end_time + SIFS + cts_duration);
+	if (cts_end_time >= stop_time) return tx_time + exchange_duration;
+	node_stats.total_time_channel_busy_per_channel[ch] += data_duration;
+	if (cts_end_time + SIFS >= stop_time) return tx_time + exchange_duration;
+	++node_stats.data_packets_sent;
+	++node_stats.data_packets_sent_per_sta[ix_sta];
+
+	// ACK (accounted by the STA once the DATA is received)
+	double data_end_time (cts_end_time + SIFS + data_duration);
+	if (data_end_time >= stop_time) return tx_time + exchange_duration;
+	sta_stats.total_time_channel_busy_per_channel[ch] += ack_duration;
+
+	// ACK received: the packets were generated when the backoff expired (InitiateBurstPackets)
+	double end_time (tx_time + exchange_duration);
+	if (end_time >= stop_time) return end_time;
+	++node_stats.data_packets_acked;
+	++node_stats.data_packets_acked_per_sta[ix_sta];
+	node_stats.data_frames_acked += limited_num_packets_aggregated;
+	node_stats.data_frames_acked_per_sta[ix_sta] += limited_num_packets_aggregated;
+	node_stats.num_delay_measurements += limited_num_packets_aggregated;
+	node_stats.sum_delays = node_stats.sum_delays + limited_num_packets_aggregated * (end_time - tx_time);
+	if (tx_time > last_window_start) {
+		node_stats.last_data_frames_acked += limited_num_packets_aggregated;
+		node_stats.last_num_delay_measurements += limited_num_packets_aggregated;
+		node_stats.last_sum_delays = node_stats.last_sum_delays + limited_num_packets_aggregated * (end_time - tx_time);
+	}
+	HandleContentionWindow(node_params.cw_adaptation, RESET_CW, &ca_state.deterministic_bo_active,
+		&ca_state.current_cw_min, &ca_state.current_cw_max, &ca_state.cw_stage_current, node_params.cw_min_default,
+		node_params.cw_max_default, node_params.cw_stage_max, distance_to_token, node_params.backoff_type,
+		current_traffic_type);
+
+	// RestartNode(): the DATA plus, once the ACK is received, the SIFS and the duration carried by the end of the
+	// ACK (TX_DURATION_NONE)
+	double tx_duration (data_duration + SIFS + TX_DURATION_NONE);
+	node_stats.total_time_transmitting_in_num_channels[0] += tx_duration;
+	node_stats.total_time_transmitting_per_channel[ch] += tx_duration;
+	if (end_time > last_window_start) node_stats.last_total_time_transmitting_per_channel[ch] += tx_duration;
+	++packet_id;
+	ca_state.remaining_backoff = ComputeBackoff(ca_state.current_cw_min, ca_state.current_cw_max,
+		node_params.backoff_type, current_traffic_type, ca_state.deterministic_bo_active, ca_state.num_bo_interruptions,
+		ca_state.base_backoff_deterministic, ca_state.previous_backoff, &random_stream);
+	ca_state.previous_backoff = ca_state.remaining_backoff;
+	node_stats.expected_backoff = node_stats.expected_backoff + ca_state.remaining_backoff;
+	++node_stats.num_new_backoff_computations;
+	node_stats.timestamp_new_trial_started = end_time;
+	ca_state.num_bo_interruptions = 0;
+	ca_state.remaining_backoff = ca_state.remaining_backoff + SLOT_TIME;	// Extra slot since node has transmitted
+
+	return end_time;
+}
+
+/**
+ * Time at which the nodes sensing (but not taking part in) simultaneous exchanges like the last one of the
+ * node sense the channel again. Their ACKs collide, so that these nodes wait for the collision to be over
+ * from the start of the ACKs, as for any NAV collision (see InportSomeNodeStartTX), and not from their end
+ * @param "end_time" [type double]: time at which the exchanges finish [s]
+ * @return "recovery_time" [type double]: time at which the IFS of the rest of nodes starts [s]
+ */
+double Node :: SlottedRecoveryTime(double end_time){
+	double recovery_time (end_time - ack_duration + rts_duration + SIFS + cts_duration);
+	return recovery_time > end_time ? recovery_time : end_time;
+}
+
+#endif /* NODE_SLOTTED_METHODS_H */
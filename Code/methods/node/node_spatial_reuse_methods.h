@@ -32,7 +32,7 @@
  * Called when an SR-based TXOP finished (trigger-based operation)
  */
 void Node :: SpatialReuseOpportunityEnds(trigger_t &){
-	LOGS(node_params.save_node_logs,node_logger.file,
+	NODE_LOGS(node_params.save_node_logs,node_logger,
 		"%.15f;N%d;S%d;%s;%s SpatialReuseOpportunityEnds()\n",
 		SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL2);
 	// Set the SR parameters to the default values (disable mechanism to activate SR opportunities)
@@ -45,11 +45,11 @@ void Node :: SpatialReuseOpportunityEnds(trigger_t &){
 		change_modulation_flag[n] = true;
 	}
 
-	LOGS(node_params.save_node_logs,node_logger.file,
+	NODE_LOGS(node_params.save_node_logs,node_logger,
 		"%.15f;N%d;S%d;%s;%s sr_state.current_obss_pd_threshold = %f\n",
 		SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL3,
 		ConvertPower(PW_TO_DBM,sr_state.current_obss_pd_threshold));
-	LOGS(node_params.save_node_logs,node_logger.file,
+	NODE_LOGS(node_params.save_node_logs,node_logger,
 		"%.15f;N%d;S%d;%s;%s sr_state.current_tx_power_sr = %f\n",
 		SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL3,
 		ConvertPower(PW_TO_DBM,sr_state.current_tx_power_sr));
@@ -60,6 +60,7 @@ void Node :: SpatialReuseOpportunityEnds(trigger_t &){
  * Called when a request is received for returning the current SR configuration
  */
 void Node :: InportRequestSpatialReuseConfiguration() {
+	COST_PROFILE_SCOPE("Node::InportRequestSpatialReuseConfiguration");
 	// Update the SR configuration
 	spatial_reuse_configuration.capabilities = node_params;
 	spatial_reuse_configuration.spatial_reuse_enabled = sr_state.spatial_reuse_enabled;
@@ -74,6 +75,7 @@ void Node :: InportRequestSpatialReuseConfiguration() {
  * @param "received_configuration" [type Configuration]: received SR configuration
  */
 void Node :: InportNewSpatialReuseConfiguration(Configuration &received_configuration) {
+	COST_PROFILE_SCOPE("Node::InportNewSpatialReuseConfiguration");
 	sr_state.spatial_reuse_enabled = received_configuration.spatial_reuse_enabled;
 	node_params.bss_color = received_configuration.capabilities.bss_color;
 	node_params.srg = received_configuration.capabilities.srg;
@@ -87,24 +89,25 @@ void Node :: InportNewSpatialReuseConfiguration(Configuration &received_configur
  * Called once per StartTX event before the per-state dispatch switch.
  * @param "notification" [type const Notification&]: incoming TX notification
  */
-void Node :: UpdateSRStateForIncomingFrame(const Notification &notification) {
+void Node :: UpdateSRStateForIncomingFrame(const NotificationFrame &notification) {
+	COST_PROFILE_SCOPE("Node::UpdateSRStateForIncomingFrame");
 	if (sr_state.spatial_reuse_enabled) {
 		// Identify the source of detected packet
 		sr_state.type_last_sensed_packet = CheckPacketOrigin(notification, node_params.bss_color, node_params.srg);
 		// Obtain the CST to be used
 		sr_state.potential_obss_pd_threshold = GetSensitivitySpatialReuse(sr_state.type_last_sensed_packet,
-			node_params.srg_obss_pd, node_params.non_srg_obss_pd, current_pd, power_received_per_node[notification.source_id]);
+			node_params.srg_obss_pd, node_params.non_srg_obss_pd, current_pd, power_received_per_node.Power(notification.source_id));
 		// In case of detecting an inter-BSS frame, print the information
 		if (sr_state.type_last_sensed_packet != INTRA_BSS_FRAME) {
-			LOGS(node_params.save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s SPATIAL REUSE OPERATION: \n",
+			NODE_LOGS(node_params.save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s SPATIAL REUSE OPERATION: \n",
 				SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL3);
-			LOGS(node_params.save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s sr_state.type_last_sensed_packet = %d\n",
+			NODE_LOGS(node_params.save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s sr_state.type_last_sensed_packet = %d\n",
 				SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL4, sr_state.type_last_sensed_packet);
-			LOGS(node_params.save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s Previous sr_state.current_obss_pd_threshold = %f\n",
+			NODE_LOGS(node_params.save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s Previous sr_state.current_obss_pd_threshold = %f\n",
 				SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL4, ConvertPower(PW_TO_DBM, sr_state.current_obss_pd_threshold));
-			LOGS(node_params.save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s previous sr_state.txop_sr_identified = %d\n",
+			NODE_LOGS(node_params.save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s previous sr_state.txop_sr_identified = %d\n",
 				SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL4, sr_state.txop_sr_identified);
-			LOGS(node_params.save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s New sr_state.potential_obss_pd_threshold = %f\n",
+			NODE_LOGS(node_params.save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s New sr_state.potential_obss_pd_threshold = %f\n",
 				SimTime(), node_params.node_id, node_state, LOG_F02, LOG_LVL4, ConvertPower(PW_TO_DBM, sr_state.potential_obss_pd_threshold));
 		}
 	}
@@ -117,11 +120,11 @@ void Node :: UpdateSRStateForIncomingFrame(const Notification &notification) {
  * @param "notification" [type const Notification&]: incoming TX notification
  * @param "loss_reason"  [type int&]: in/out — current packet loss reason; may be overwritten
  */
-void Node :: TryIdentifySRTXOP(const Notification &notification, int &loss_reason) {
+void Node :: TryIdentifySRTXOP(const NotificationFrame &notification, int &loss_reason) {
 	// If the packet is not lost, check if we can ignore it by applying another pd
 	if (sr_state.spatial_reuse_enabled && loss_reason == PACKET_NOT_LOST) {
 		// The incoming packet can be decoded by the default pd
-		LOGS(node_params.save_node_logs, node_logger.file,
+		NODE_LOGS(node_params.save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s The packet could be decoded with the default pd (%f dBm)...\n",
 			SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL3, ConvertPower(PW_TO_DBM, current_pd));
 		// Check if a new SR-based opportunity can be identified to ignore the incoming tranmission
@@ -129,7 +132,7 @@ void Node :: TryIdentifySRTXOP(const Notification &notification, int &loss_reaso
 		// Two cases:
 		// (1) An SR-based opportunity was already identified and needs to be overwritten
 		// (2) None SR opportunites were previously detected
-		LOGS(node_params.save_node_logs, node_logger.file,
+		NODE_LOGS(node_params.save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s sr_state.txop_sr_identified = %d / new_txop_sr_identified = %d\n",
 			SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL4, sr_state.txop_sr_identified, new_txop_sr_identified);
 		if ( (sr_state.txop_sr_identified && new_txop_sr_identified &&
@@ -146,7 +149,7 @@ void Node :: TryIdentifySRTXOP(const Notification &notification, int &loss_reaso
 			// Start (update) the trigger that indicates the end of the SR-based opportunity
 			time_to_trigger = SimTime() + notification.tx_info.nav_time;
 			txop_sr_end.Set(FixTimeOffset(time_to_trigger,13,12));
-			LOGS(node_params.save_node_logs, node_logger.file,
+			NODE_LOGS(node_params.save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s An SR TXOP was detected for OBSS_PD = %f dBm "
 				"(received RTS/CTS while being in SENSING state.)\n",
 				SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL3,
@@ -162,13 +165,13 @@ void Node :: TryIdentifySRTXOP(const Notification &notification, int &loss_reaso
  * @param "nav_collision"           [type int&]: out — set to 1 if intra-BSS NAV collision
  * @param "inter_bss_nav_collision" [type int&]: out — set to 1 if inter-BSS NAV collision
  */
-void Node :: ComputeNavCollisions(const Notification &notification,
+void Node :: ComputeNavCollisions(const NotificationFrame &notification,
 		int &nav_collision, int &inter_bss_nav_collision) {
 	if (sr_state.spatial_reuse_enabled && sr_state.type_last_sensed_packet != INTRA_BSS_FRAME) {
-		inter_bss_nav_collision = fabs(nav_notification.timestamp -
+		inter_bss_nav_collision = fabs(nav_notification->timestamp -
 			notification.timestamp) < MAX_DIFFERENCE_SAME_TIME;
 	} else {
-		nav_collision = fabs(nav_notification.timestamp -
+		nav_collision = fabs(nav_notification->timestamp -
 			notification.timestamp) < MAX_DIFFERENCE_SAME_TIME;
 	}
 }
@@ -179,13 +182,14 @@ void Node :: ComputeNavCollisions(const Notification &notification,
  * @param "notification" [type const Notification&]: incoming TX notification
  * @param "loss_reason"  [type int]: current packet loss result (read-only here)
  */
-void Node :: DetectSRTXOPInNavState(const Notification &notification, int loss_reason) {
+void Node :: DetectSRTXOPInNavState(const NotificationFrame &notification, int loss_reason) {
+	COST_PROFILE_SCOPE("Node::DetectSRTXOPInNavState");
 	// Check if the packet could have been decoded with SR pd
 	// This allows transmitting once the NAV is over
 	int loss_reason_sr (1);
 	int power_condition_sr (1);
 	if (sr_state.spatial_reuse_enabled && sr_state.type_last_sensed_packet != INTRA_BSS_FRAME && node_is_transmitter) { 	// Check for TXOP
-		double power_interference (power_received_per_node[notification.source_id]);
+		double power_interference (power_received_per_node.Power(notification.source_id));
 		// SR TXOP: use direct power comparison (consistent units, pW) matching TryIdentifySRTXOP.
 		// loss_reason_sr signals "SR opportunity" when the frame is below the SR threshold.
 		loss_reason_sr = IdentifySpatialReuseOpportunity(power_interference, sr_state.potential_obss_pd_threshold)
@@ -201,7 +205,7 @@ void Node :: DetectSRTXOPInNavState(const Notification &notification, int loss_r
 			time_to_trigger = SimTime() + notification.tx_info.nav_time;
 			txop_sr_end.Set(FixTimeOffset(time_to_trigger,13,12));
 		}
-		LOGS(node_params.save_node_logs, node_logger.file,
+		NODE_LOGS(node_params.save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s TXOP detected while being in NAV state\n",
 			SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL3);
 	} else {
@@ -211,7 +215,7 @@ void Node :: DetectSRTXOPInNavState(const Notification &notification, int loss_r
 			if(trigger_inter_bss_NAV_timeout.GetTime() < notification.tx_info.nav_time) {
 				time_to_trigger = SimTime() +  notification.tx_info.nav_time + TIME_OUT_EXTRA_TIME;
 				trigger_inter_bss_NAV_timeout.Set(FixTimeOffset(time_to_trigger,13,12));
-				LOGS(node_params.save_node_logs, node_logger.file,
+				NODE_LOGS(node_params.save_node_logs, node_logger,
 					"%.15f;N%d;S%d;%s;%s Updating inter-BSS NAV timeout to the more restrictive one: From %.12f to %.12f\n",
 					SimTime(), node_params.node_id, node_state, LOG_D07, LOG_LVL4,
 					trigger_inter_bss_NAV_timeout.GetTime(), time_to_trigger);
@@ -221,13 +225,13 @@ void Node :: DetectSRTXOPInNavState(const Notification &notification, int loss_r
 			if(trigger_NAV_timeout.GetTime() < notification.tx_info.nav_time) {
 				time_to_trigger = SimTime() +  notification.tx_info.nav_time + TIME_OUT_EXTRA_TIME;
 				trigger_NAV_timeout.Set(FixTimeOffset(time_to_trigger,13,12));
-				LOGS(node_params.save_node_logs, node_logger.file,
+				NODE_LOGS(node_params.save_node_logs, node_logger,
 					"%.15f;N%d;S%d;%s;%s Updating NAV timeout to the more restrictive one: From %.12f to %.12f\n",
 					SimTime(), node_params.node_id, node_state, LOG_D07, LOG_LVL4,
 					trigger_NAV_timeout.GetTime(), time_to_trigger);
 			}
 		}
-		LOGS(node_params.save_node_logs, node_logger.file,
+		NODE_LOGS(node_params.save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s New RTS/CTS arrived from (N%d). Setting NAV to new value %.18f\n",
 			SimTime(), node_params.node_id, node_state, LOG_D07, LOG_LVL3,
 			notification.source_id, trigger_NAV_timeout.GetTime());
@@ -239,24 +243,25 @@ void Node :: DetectSRTXOPInNavState(const Notification &notification, int loss_r
  * an SR TXOP that can be used in the next transmission attempt.
  * @param "notification" [type const Notification&]: incoming TX notification
  */
-void Node :: DetectSRTXOPWhileTransmitting(const Notification &notification) {
+void Node :: DetectSRTXOPWhileTransmitting(const NotificationFrame &notification) {
+	COST_PROFILE_SCOPE("Node::DetectSRTXOPWhileTransmitting");
 	if (sr_state.spatial_reuse_enabled && sr_state.type_last_sensed_packet != INTRA_BSS_FRAME && node_is_transmitter) {
 
-		double power_interference (power_received_per_node[notification.source_id]);
+		double power_interference (power_received_per_node.Power(notification.source_id));
 		double sinr_interference (UpdateSINR(power_interference, max_pw_interference));
 
 		// Is packet lost with the default pd?
 		// TODO: method for checking whether the detected transmission can be decoded or not
 		int loss_reason_legacy (IsPacketLost(node_params.current_primary_channel, notification, notification,
 			sinr_interference, node_params.capture_effect, node_params.sensitivity_default, power_interference, node_params.constant_per,
-			node_params.node_id, node_params.capture_effect_model));
+			node_params.node_id, node_params.capture_effect_model, &random_stream));
 		// Is packet lost with the SR pd?
 		// TODO: method for checking whether the detected transmission can be decoded or not
 		int loss_reason_sr (IsPacketLost(node_params.current_primary_channel, notification, notification,
 			sinr_interference, node_params.capture_effect, sr_state.potential_obss_pd_threshold, power_interference, node_params.constant_per,
-			node_params.node_id, node_params.capture_effect_model));
+			node_params.node_id, node_params.capture_effect_model, &random_stream));
 
-		if(node_params.save_node_logs && node_params.node_id == 0) LOGS(node_params.save_node_logs, node_logger.file,
+		if(node_params.save_node_logs && node_params.node_id == 0) NODE_LOGS(node_params.save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s sinr_interference = %f - node_params.capture_effect = %f - sr_state.pd_spatial_reuse = %f"
 			" - power_interference = %f)\n",
 			SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL3,
@@ -277,13 +282,13 @@ void Node :: DetectSRTXOPWhileTransmitting(const Notification &notification) {
 			// Start (update) the trigger that indicates the end of the SR-based opportunity
 			time_to_trigger = SimTime() + notification.tx_info.nav_time;
 			txop_sr_end.Set(FixTimeOffset(time_to_trigger,13,12));
-			LOGS(node_params.save_node_logs, node_logger.file,
+			NODE_LOGS(node_params.save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s TXOP detected while being in TX state\n",
 				SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL3);
 		} else if (loss_reason_legacy == PACKET_NOT_LOST && sr_state.txop_sr_identified) {
 			// Cancel SR TXOP
 			sr_state.txop_sr_identified = FALSE;
-			LOGS(node_params.save_node_logs, node_logger.file,
+			NODE_LOGS(node_params.save_node_logs, node_logger,
 				"%.15f;N%d;S%d;%s;%s Cancelling SR TXOP while being in TX state\n",
 				SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL3);
 		}
@@ -296,7 +301,7 @@ void Node :: DetectSRTXOPWhileTransmitting(const Notification &notification) {
  */
 void Node :: ApplySRParametersAtBackoffEnd() {
 	if (sr_state.spatial_reuse_enabled) {
-		LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s sr_state.txop_sr_identified = %d\n",
+		NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s sr_state.txop_sr_identified = %d\n",
 			SimTime(), node_params.node_id, node_state, LOG_F00, LOG_LVL1, sr_state.txop_sr_identified);
 		sr_state.flag_change_in_tx_power = TRUE;
 		if(sr_state.txop_sr_identified) {
@@ -325,8 +330,8 @@ void Node :: CheckSRTXOPAtCallSensing() {
 	// Check if the packet can be decoded with the CST indicated by the SR operation
 	if (loss_reason == PACKET_NOT_LOST && sr_state.spatial_reuse_enabled) {
 		// TODO: method for checking whether the detected transmission can be decoded or not
-		loss_reason_sr = IsPacketLost(node_params.current_primary_channel, nav_notification, nav_notification,
-			current_sinr, node_params.capture_effect, sr_state.potential_obss_pd_threshold, power_rx_interest, node_params.constant_per, node_params.node_id, node_params.capture_effect_model);
+		loss_reason_sr = IsPacketLost(node_params.current_primary_channel, *nav_notification, *nav_notification,
+			current_sinr, node_params.capture_effect, sr_state.potential_obss_pd_threshold, power_rx_interest, node_params.constant_per, node_params.node_id, node_params.capture_effect_model, &random_stream);
 		if (loss_reason_sr != PACKET_NOT_LOST && node_is_transmitter) {
 			sr_state.txop_sr_identified = TRUE;	// TXOP identified!
 			sr_state.current_obss_pd_threshold = sr_state.potential_obss_pd_threshold;	// Update the pd
@@ -336,7 +341,7 @@ void Node :: CheckSRTXOPAtCallSensing() {
 				SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL3, ConvertPower(PW_TO_DBM, sr_state.current_obss_pd_threshold));
 		}
 	} else {
-		LOGS(node_params.save_node_logs, node_logger.file,
+		NODE_LOGS(node_params.save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s BO canot be resumed!\n",
 			SimTime(), node_params.node_id, node_state, LOG_Z00, LOG_LVL5);
 	}
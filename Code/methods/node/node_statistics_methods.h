@@ -21,6 +21,7 @@
  *   - Node::WriteReceivedConfiguration
  *   - Node::PrintNodeConfiguration
  *   - Node::PrintProgressBar
+ *   - Node::ComputeNodeStatistics
  *   - Node::PrintOrWriteNodeStatistics
  *   - Node::SaveSimulationPerformance
  */
@@ -81,21 +82,21 @@ void Node :: UpdatePerformanceMeasurements(){
 void Node:: MeasureRho(trigger_t &){
 	// if ( (buffer.QueueSize() > 0) && (channel_power[node_params.current_primary_channel] < current_pd)){
 	if (node_state == STATE_SENSING && channel_power[node_params.current_primary_channel] < current_pd){
-		LOGS(node_params.save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s RHO: Sensing + free\n",
+		NODE_LOGS(node_params.save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s RHO: Sensing + free\n",
 			SimTime(), node_params.node_id, node_state, LOG_Z00, LOG_LVL3);
 		++node_stats.num_measures_rho;
 		// DIFS condition: !trigger_start_backoff.Active()
 		if (buffer.QueueSize() > 0){
-			LOGS(node_params.save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s RHO: Packet in buffer\n",
+			NODE_LOGS(node_params.save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s RHO: Packet in buffer\n",
 				SimTime(), node_params.node_id, node_state, LOG_Z00, LOG_LVL4);
 			node_stats.num_measures_rho_accomplished ++;
 		} else {
-			LOGS(node_params.save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s RHO: Not packet in buffer\n",
+			NODE_LOGS(node_params.save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s RHO: Not packet in buffer\n",
 				SimTime(), node_params.node_id, node_state, LOG_Z00, LOG_LVL4);
 		}
 	} else {
 
-//		LOGS(node_params.save_node_logs, node_logger.file, "%.15f;N%d;S%d;%s;%s No RHO!\n",
+//		NODE_LOGS(node_params.save_node_logs, node_logger, "%.15f;N%d;S%d;%s;%s No RHO!\n",
 //						SimTime(), node_params.node_id, node_state, LOG_Z00, LOG_LVL3);
 	}
 	// Utilization
@@ -249,38 +250,128 @@ void Node :: PrintProgressBar(trigger_t &){
 }
 
 /**
- * Print or write final statistics of the given node
- * @param "write_or_print" [type int]: variable indicating whether to print or write logs
+ * Time over which the statistics have been collected so far (i.e., since the start or the end of the warm-up)
+ * @return "statistics_time" [type double]: observation time [s]
  */
-void Node :: PrintOrWriteNodeStatistics(int write_or_print){
-	// Process statistics
-	double data_packets_lost_percentage (0);
-	double rts_cts_lost_percentage (0);
-	double tx_init_failure_percentage (0);
-	double rts_lost_bo_percentage (0);
+double Node :: StatisticsTime(){
+	return SimTime() - node_stats.stats_start_time;
+}
 
+/**
+ * Discard the statistics collected so far (e.g., during the warm-up), so that the final ones, and the next
+ * report to the agent, only cover what happens from now on. The state of the node and the rolling-window
+ * statistics of the end of the simulation are kept
+ */
+void Node :: ClearStats(){
+
+	double now (SimTime());
+	node_stats.stats_start_time = now;
+
+	// Counters
+	node_stats.data_packets_sent = 0;
+	node_stats.rts_cts_sent = 0;
+	node_stats.num_packets_generated = 0;
+	node_stats.num_packets_dropped = 0;
+	node_stats.data_packets_acked = 0;
+	node_stats.data_frames_acked = 0;
+	node_stats.data_packets_lost = 0;
+	node_stats.rts_cts_lost = 0;
+	node_stats.rts_lost_slotted_bo = 0;
+	node_stats.num_tx_init_tried = 0;
+	node_stats.num_tx_init_not_possible = 0;
+	node_stats.throughput_loss = 0;
+	node_stats.num_delay_measurements = 0;
+	node_stats.sum_delays = 0;
+	node_stats.expected_backoff = 0;
+	node_stats.num_new_backoff_computations = 0;
+	node_stats.num_icf_tx = 0;
+	node_stats.num_icr_rx = 0;
+	node_stats.num_tf_tx = 0;
+	node_stats.num_mu_rts_tx = 0;
+	node_stats.num_icf_rx = 0;
+	node_stats.num_icr_tx = 0;
+	node_stats.num_tf_rx = 0;
+	node_stats.num_mu_rts_rx = 0;
+	node_stats.total_mapc_data_duration_own = 0;
+	node_stats.total_mapc_data_duration_shared = 0;
+	node_stats.total_mapc_data_duration_allocated = 0;
+	node_stats.num_measures_rho = 0;
+	node_stats.num_measures_rho_accomplished = 0;
+	node_stats.num_measures_utilization = 0;
+	node_stats.num_measures_buffer_with_packets = 0;
+
+	// Times (the ongoing idle, NAV and contention periods are only accounted from now on)
+	node_stats.sum_time_channel_idle = 0;
+	if (node_stats.last_time_channel_is_idle < now) node_stats.last_time_channel_is_idle = now;
+	node_stats.time_in_nav = 0;
+	node_stats.times_went_to_nav = 0;
+	if (node_stats.last_time_not_in_nav < now) node_stats.last_time_not_in_nav = now;
+	node_stats.sum_waiting_time = 0;
+	node_stats.num_average_waiting_time_measurements = 0;
+	if (node_stats.timestamp_new_trial_started < now) node_stats.timestamp_new_trial_started = now;
+	for (int c = 0; c < NUM_CHANNELS_KOMONDOR; ++c) {
+		node_stats.total_time_transmitting_per_channel[c] = 0;
+		node_stats.total_time_transmitting_in_num_channels[c] = 0;
+		node_stats.total_time_lost_per_channel[c] = 0;
+		node_stats.total_time_lost_in_num_channels[c] = 0;
+		node_stats.total_time_channel_busy_per_channel[c] = 0;
+		node_stats.num_trials_tx_per_num_channels[c] = 0;
+	}
+	for (int i = 0; i < NUM_PACKET_LOST_REASONS; ++i) node_stats.nacks_received[i] = 0;
+	for (int i = 0; i < wlan.num_stas; ++i) {
+		node_stats.throughput_per_sta[i] = 0;
+		node_stats.data_packets_sent_per_sta[i] = 0;
+		node_stats.rts_cts_sent_per_sta[i] = 0;
+		node_stats.data_packets_lost_per_sta[i] = 0;
+		node_stats.rts_cts_lost_per_sta[i] = 0;
+		node_stats.data_packets_acked_per_sta[i] = 0;
+		node_stats.data_frames_acked_per_sta[i] = 0;
+	}
+
+	// Measurements to be sent to the agent
+	RestartPerformanceMetrics(&performance_report, now, node_params.num_channels_allowed);
+}
+
+/**
+ * Process the final statistics of the given node (called once, at the end of the simulation)
+ */
+void Node :: ComputeNodeStatistics(){
 	if (node_stats.num_delay_measurements > 0) node_stats.average_delay = node_stats.sum_delays / (double) node_stats.num_delay_measurements;
 	if (node_stats.flag_measure_rho && node_stats.num_measures_rho > 0) node_stats.average_rho = (double) node_stats.num_measures_rho_accomplished/(double) node_stats.num_measures_rho;
 	if (node_stats.num_measures_utilization > 0) node_stats.average_utilization = (double) node_stats.num_measures_buffer_with_packets / (double) node_stats.num_measures_utilization;
-	if (node_stats.num_tx_init_tried > 0) tx_init_failure_percentage = double(node_stats.num_tx_init_not_possible * 100)/double(node_stats.num_tx_init_tried);
-	if (node_stats.data_packets_sent > 0) data_packets_lost_percentage = double(node_stats.data_packets_lost * 100)/double(node_stats.data_packets_sent);
 	if (node_stats.rts_cts_sent > 0){
-		rts_cts_lost_percentage = double(node_stats.rts_cts_lost * 100)/double(node_stats.rts_cts_sent);
-		rts_lost_bo_percentage = double(node_stats.rts_lost_slotted_bo *100)/double(node_stats.rts_cts_sent);
-		node_stats.prob_slotted_bo_collision = double(rts_lost_bo_percentage / double(100));
+		node_stats.prob_slotted_bo_collision = double(double(node_stats.rts_lost_slotted_bo *100)/double(node_stats.rts_cts_sent) / double(100));
 	}
 	if (node_stats.num_packets_generated > 1){
 		node_stats.generation_drop_ratio = node_stats.num_packets_dropped * 100/ node_stats.num_packets_generated;
 	}
-	node_stats.throughput = ((double) node_stats.data_frames_acked * node_params.frame_length) / SimTime();
+	node_stats.throughput = ((double) node_stats.data_frames_acked * node_params.frame_length) / StatisticsTime();
 	for(int c = 0; c < NUM_CHANNELS_KOMONDOR; ++c){
-		node_stats.bandwidth_used_txing += (node_stats.total_time_channel_busy_per_channel[c]/SimTime()) * 20;
+		node_stats.bandwidth_used_txing += (node_stats.total_time_channel_busy_per_channel[c]/StatisticsTime()) * 20;
 	}
 	node_stats.last_throughput = ((double) node_stats.last_data_frames_acked * node_params.frame_length) / node_stats.last_measurements_window;
 	if (node_stats.last_num_delay_measurements > 0) node_stats.last_average_delay = node_stats.last_sum_delays / (double) node_stats.last_num_delay_measurements;
 
 	node_stats.average_waiting_time = node_stats.sum_waiting_time / (double) node_stats.num_average_waiting_time_measurements;
 	node_stats.expected_backoff = node_stats.expected_backoff / (double) node_stats.num_new_backoff_computations;
+}
+
+/**
+ * Print or write final statistics of the given node (processed by ComputeNodeStatistics())
+ * @param "write_or_print" [type int]: variable indicating whether to print or write logs
+ */
+void Node :: PrintOrWriteNodeStatistics(int write_or_print){
+	double data_packets_lost_percentage (0);
+	double rts_cts_lost_percentage (0);
+	double tx_init_failure_percentage (0);
+	double rts_lost_bo_percentage (0);
+
+	if (node_stats.num_tx_init_tried > 0) tx_init_failure_percentage = double(node_stats.num_tx_init_not_possible * 100)/double(node_stats.num_tx_init_tried);
+	if (node_stats.data_packets_sent > 0) data_packets_lost_percentage = double(node_stats.data_packets_lost * 100)/double(node_stats.data_packets_sent);
+	if (node_stats.rts_cts_sent > 0){
+		rts_cts_lost_percentage = double(node_stats.rts_cts_lost * 100)/double(node_stats.rts_cts_sent);
+		rts_lost_bo_percentage = double(node_stats.rts_lost_slotted_bo *100)/double(node_stats.rts_cts_sent);
+	}
 
 	switch(write_or_print){
 
@@ -291,7 +382,7 @@ void Node :: PrintOrWriteNodeStatistics(int write_or_print){
 				// Throughput
 				printf("%s Throughput = %f Mbps (%.2f pkt/s)\n", LOG_LVL2,
 					node_stats.throughput * pow(10,-6),
-					(double)node_stats.data_packets_acked / SimTime());
+					(double)node_stats.data_packets_acked / StatisticsTime());
 				// Delay
 				printf("%s Average delay from %d measurements = %f s (%.2f ms)\n", LOG_LVL2,
 					node_stats.num_delay_measurements, node_stats.average_delay, node_stats.average_delay * 1000);
@@ -324,7 +415,7 @@ void Node :: PrintOrWriteNodeStatistics(int write_or_print){
 					node_stats.data_packets_acked > 0 ? (double)node_stats.data_frames_acked/node_stats.data_packets_acked : 0.0);
 				// Data packets sent and lost
 				printf("%s Buffer: packets generated = %.0f (%.2f pkt/s) - Packets dropped = %.0f  (%f %% drop ratio)\n",
-					LOG_LVL2, node_stats.num_packets_generated, node_stats.num_packets_generated / SimTime(), node_stats.num_packets_dropped, node_stats.generation_drop_ratio);
+					LOG_LVL2, node_stats.num_packets_generated, node_stats.num_packets_generated / StatisticsTime(), node_stats.num_packets_dropped, node_stats.generation_drop_ratio);
 				if(TRAFFIC_POISSON_BURST){
 					printf("%s Buffer: num bursts = %d\n",
 						LOG_LVL2,
@@ -347,9 +438,9 @@ void Node :: PrintOrWriteNodeStatistics(int write_or_print){
 					if((int)pow(2,n) == NUM_CHANNELS_KOMONDOR) break;
 				}
 				printf("%s Airtime = %.2f s (%.2f %%) - Successful airtime = %.2f s (%.2f %%) - Effective (DATA) airtime = %.2f s (%.2f %%)\n",
-					LOG_LVL2, total_airtime, (total_airtime * 100 /SimTime()),
-					successful_airtime, (successful_airtime * 100 /SimTime()),
-					effective_airtime, (effective_airtime * 100 /SimTime()));
+					LOG_LVL2, total_airtime, (total_airtime * 100 /StatisticsTime()),
+					successful_airtime, (successful_airtime * 100 /StatisticsTime()),
+					effective_airtime, (effective_airtime * 100 /StatisticsTime()));
 				// Time EFFECTIVELY transmitting in a given number of channels (no losses)
 				printf("%s DATA-phase airtime by channel width (excludes MAPC control frames):", LOG_LVL3);
 				for(int n = 0; n < node_params.num_channels_allowed; ++n){
@@ -357,7 +448,7 @@ void Node :: PrintOrWriteNodeStatistics(int write_or_print){
 							LOG_LVL3, (int) pow(2,n),
 							node_stats.total_time_transmitting_in_num_channels[n] - node_stats.total_time_lost_in_num_channels[n],
 							((node_stats.total_time_transmitting_in_num_channels[n] -
-									node_stats.total_time_lost_in_num_channels[n])) * 100 /SimTime());
+									node_stats.total_time_lost_in_num_channels[n])) * 100 /StatisticsTime());
 					if((int) pow(2,n) == NUM_CHANNELS_KOMONDOR) break;
 				}
 				printf("\n");
@@ -370,8 +461,8 @@ void Node :: PrintOrWriteNodeStatistics(int write_or_print){
 						node_stats.total_time_lost_per_channel[c];
 					printf("\n%s - %d: %.2f s (%.2f %%) / %.2f s (%.2f %%)",
 						LOG_LVL3, c, node_stats.total_time_channel_busy_per_channel[c],
-						(node_stats.total_time_channel_busy_per_channel[c] * 100 /SimTime()),
-						time_effectively_txing, time_effectively_txing * 100 /SimTime());
+						(node_stats.total_time_channel_busy_per_channel[c] * 100 /StatisticsTime()),
+						time_effectively_txing, time_effectively_txing * 100 /StatisticsTime());
 				}
 				printf("\n%s Average bandwidth used for transmitting = %.2f MHz / %d MHz (%.2f %%)\n",
 					LOG_LVL3,
@@ -406,7 +497,7 @@ void Node :: PrintOrWriteNodeStatistics(int write_or_print){
 
 				printf("%s node_stats.times_went_to_nav = %d\n", LOG_LVL2, node_stats.times_went_to_nav);
 				printf("%s node_stats.time_in_nav = %f (%.2f %% of the total time)\n", LOG_LVL2,
-					node_stats.time_in_nav, (node_stats.time_in_nav/node_params.simulation_time_komondor*100));
+					node_stats.time_in_nav, (node_stats.time_in_nav/StatisticsTime()*100));
 
 				printf("%s node_stats.average_waiting_time = %f (%f slots)\n", LOG_LVL2, node_stats.average_waiting_time, node_stats.average_waiting_time / SLOT_TIME);
 				printf("%s Expected BO = %f (%f slots)\n", LOG_LVL2, node_stats.expected_backoff, node_stats.expected_backoff / SLOT_TIME);
@@ -416,7 +507,7 @@ void Node :: PrintOrWriteNodeStatistics(int write_or_print){
 				// Throughput
 				printf("%s Throughput: {", LOG_LVL3);
 				for(int n = 0; n < wlan.num_stas; ++n){
-					node_stats.throughput_per_sta[n] = ((double)node_stats.data_frames_acked_per_sta[n] * (double)node_params.frame_length) / SimTime();
+					node_stats.throughput_per_sta[n] = ((double)node_stats.data_frames_acked_per_sta[n] * (double)node_params.frame_length) / StatisticsTime();
 					printf("%.2f Mbps",  node_stats.throughput_per_sta[n] * pow(10,-6));
 					if(n<wlan.num_stas-1) printf(", ");
 				}
@@ -551,7 +642,7 @@ void Node :: PrintOrWriteNodeStatistics(int write_or_print){
 					for(int c = 0; c < NUM_CHANNELS_KOMONDOR; ++c){
 						fprintf(node_logger.file,"\n%s - %d = %.2f s (%.2f %%)",
 							LOG_LVL3, c, node_stats.total_time_channel_busy_per_channel[c],
-							(node_stats.total_time_channel_busy_per_channel[c] * 100 /SimTime()));
+							(node_stats.total_time_channel_busy_per_channel[c] * 100 /StatisticsTime()));
 					}
 
 					fprintf(node_logger.file,"\n%s - Average bandwidth used for transmitting = %.2f MHz / %d MHz (%.2f %%)\n",
@@ -585,6 +676,7 @@ void Node :: PrintOrWriteNodeStatistics(int write_or_print){
  */
 void Node :: SaveSimulationPerformance() {
 
+	// Node 0 senses every node, except in partitioned runs, where it only covers its logical process
 	if(node_params.node_id == 0) simulation_performance.sum_time_channel_idle = node_stats.sum_time_channel_idle;
 
 	simulation_performance.num_stas = wlan.num_stas;
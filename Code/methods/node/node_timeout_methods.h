@@ -56,14 +56,14 @@ void Node :: AckTimeout(trigger_t &){
 	}
 	performance_report.data_packets_lost++;
 
-	LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s  ACK TIMEOUT! Data packet %d lost\n",
+	NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s  ACK TIMEOUT! Data packet %d lost\n",
 		SimTime(), node_params.node_id, node_state, LOG_D17, LOG_LVL4,
 		packet_id);
 
-	LOGS(node_params.save_node_logs,node_logger.file,
+	NODE_LOGS(node_params.save_node_logs,node_logger,
 		"%.15f;N%d;S%d;%s;%s Handling contention window\n",
 		SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL4);
-	LOGS(node_params.save_node_logs,node_logger.file,
+	NODE_LOGS(node_params.save_node_logs,node_logger,
 		"%.15f;N%d;S%d;%s;%s From CW = [%d-%d], b = %d, m = %d\n",
 		SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL5,
 		ca_state.current_cw_min, ca_state.current_cw_max, ca_state.cw_stage_current, node_params.cw_stage_max);
@@ -72,7 +72,7 @@ void Node :: AckTimeout(trigger_t &){
 		node_params.cw_adaptation, INCREASE_CW, &ca_state.deterministic_bo_active, &ca_state.current_cw_min, &ca_state.current_cw_max, &ca_state.cw_stage_current,
 		node_params.cw_min_default, node_params.cw_max_default, node_params.cw_stage_max, distance_to_token, node_params.backoff_type, current_traffic_type);
 
-	LOGS(node_params.save_node_logs,node_logger.file,
+	NODE_LOGS(node_params.save_node_logs,node_logger,
 		"%.15f;N%d;S%d;%s;%s To CW = [%d-%d], b = %d, m = %d\n",
 		SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL5,
 		ca_state.current_cw_min, ca_state.current_cw_max, ca_state.cw_stage_current, node_params.cw_stage_max);
@@ -90,7 +90,7 @@ void Node :: CtsTimeout(trigger_t &){
 	if (node_state == STATE_WAIT_ICR
 			&& wlan.mapc_enabled
 			&& wlan.mapc_method_ids[mapc_active_group_idx] == CO_TDMA) {
-		LOGS(node_params.save_node_logs, node_logger.file,
+		NODE_LOGS(node_params.save_node_logs, node_logger,
 			"%.15f;N%d;S%d;%s;%s ICR timeout (N%d did not reply to ICF). Continuing TXOP solo.\n",
 			SimTime(), node_params.node_id, node_state, LOG_D17, LOG_LVL2, mapc_selected_peer_id);
 		mapc_peer_has_data = FALSE;
@@ -103,15 +103,15 @@ void Node :: CtsTimeout(trigger_t &){
 		current_left_channel,current_tx_duration, node_params.node_id, current_destination_id);
 	performance_report.rts_cts_lost++;
 
-	LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s ---------------------------------------------\n",
+	NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s ---------------------------------------------\n",
 		SimTime(), node_params.node_id, node_state, LOG_D17, LOG_LVL1);
-	LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s CTS TIMEOUT! RTS-CTS packet lost\n",
+	NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s CTS TIMEOUT! RTS-CTS packet lost\n",
 		SimTime(), node_params.node_id, node_state, LOG_D17, LOG_LVL2);
 
-	LOGS(node_params.save_node_logs,node_logger.file,
+	NODE_LOGS(node_params.save_node_logs,node_logger,
 		"%.15f;N%d;S%d;%s;%s Handling contention window\n",
 		SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL4);
-	LOGS(node_params.save_node_logs,node_logger.file,
+	NODE_LOGS(node_params.save_node_logs,node_logger,
 		"%.15f;N%d;S%d;%s;%s From CW = [%d-%d], b = %d, m = %d\n",
 		SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL5,
 		ca_state.current_cw_min, ca_state.current_cw_max, ca_state.cw_stage_current, node_params.cw_stage_max);
@@ -120,7 +120,7 @@ void Node :: CtsTimeout(trigger_t &){
 		node_params.cw_adaptation, INCREASE_CW, &ca_state.deterministic_bo_active, &ca_state.current_cw_min, &ca_state.current_cw_max, &ca_state.cw_stage_current,
 		node_params.cw_min_default, node_params.cw_max_default, node_params.cw_stage_max, distance_to_token, node_params.backoff_type, current_traffic_type);
 
-	LOGS(node_params.save_node_logs,node_logger.file,
+	NODE_LOGS(node_params.save_node_logs,node_logger,
 		"%.15f;N%d;S%d;%s;%s To CW = [%d-%d], b = %d, m = %d\n",
 		SimTime(), node_params.node_id, node_state, LOG_D08, LOG_LVL5,
 		ca_state.current_cw_min, ca_state.current_cw_max, ca_state.cw_stage_current, node_params.cw_stage_max);
@@ -158,7 +158,7 @@ void Node :: DataTimeout(trigger_t &){
 	performance_report.total_time_lost_in_num_channels[(int)log2(current_right_channel - current_left_channel + 1)] += current_tx_duration;
 
 
-	LOGS(node_params.save_node_logs,node_logger.file, "%.15f;N%d;S%d;%s;%s DATA TIMEOUT! (state=%d)\n",
+	NODE_LOGS(node_params.save_node_logs,node_logger, "%.15f;N%d;S%d;%s;%s DATA TIMEOUT! (state=%d)\n",
 		SimTime(), node_params.node_id, node_state, LOG_D17, LOG_LVL4, node_state);
 
 	// Sergio on 20/09/2017. CW only must be changed when ACK received or loss detected.
@@ -171,9 +171,9 @@ void Node :: DataTimeout(trigger_t &){
  */
 void Node :: NavTimeout(trigger_t &){
 
-	LOGS(node_params.save_node_logs,node_logger.file, "\n **********************************************************************\n");
+	NODE_LOGS(node_params.save_node_logs,node_logger, "\n **********************************************************************\n");
 
-	LOGS(node_params.save_node_logs,node_logger.file,
+	NODE_LOGS(node_params.save_node_logs,node_logger,
 		"%.15f;N%d;S%d;%s;%s NAV TIMEOUT!\n",
 		SimTime(), node_params.node_id, node_state, LOG_D17, LOG_LVL1);
 
@@ -201,15 +201,15 @@ void Node :: NavTimeout(trigger_t &){
 
 			time_to_trigger = SimTime() + DIFS - TIME_OUT_EXTRA_TIME;
 
-			trigger_start_backoff.Set(FixTimeOffset(time_to_trigger,13,12));
+			ArmBackoffAfterIfs(time_to_trigger);
 
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s Starting new DIFS to finsih in %.12f\n",
 				SimTime(), node_params.node_id, node_state, LOG_D17, LOG_LVL3,
-				trigger_start_backoff.GetTime());
+				ca_state.ifs_end_time);
 
 		} else {
-			LOGS(node_params.save_node_logs,node_logger.file,
+			NODE_LOGS(node_params.save_node_logs,node_logger,
 				"%.15f;N%d;S%d;%s;%s New DIFS cannot be started\n",
 				SimTime(), node_params.node_id, node_state, LOG_D17, LOG_LVL3);
 		}
@@ -73,13 +73,14 @@ std::string ToString(T val)
 * Pick uniformly random an element of an array
 * @param "array" [type int*]: array of integers
 * @param "array_size" [type int]: size of the introduced array
+* @param "random_stream" [type CostRandomStream*]: random number stream
 * @return "element" [type int]: random element from the input array of integers
 */
-int PickRandomElementFromArray(int *array, int array_size){
+int PickRandomElementFromArray(int *array, int array_size, CostRandomStream *random_stream){
 	int element (0);
 	// Pick one of the STAs in the WLAN uniformly
 	if(array_size > 0){
-		int rand_ix (rand()%(array_size));
+		int rand_ix (random_stream->Rand()%(array_size));
 		element = array[rand_ix];
 	} else {
 		element = NODE_ID_NONE;
@@ -95,7 +96,7 @@ int PickRandomElementFromArray(int *array, int array_size){
 * @return "element" [type int]: random element from the input array of integers
 */
 int PickElementFromArrayRR(int *array, int array_size){
-	static int i,j;
+	static __thread int i,j;
 	int element (0);
 	if(array_size > 0){
 		element = array[j];
@@ -164,15 +165,44 @@ int GetNumberOfSpecificElementInArray(int value, int* array, int list_size){
 	return num;
 }
 
+/**
+* Find the representative of the set of an element (disjoint-set forest with path halving)
+* @param "parent" [type int*]: parent of each element (the representative is its own parent)
+* @param "element" [type int]: element of interest
+* @return "root" [type int]: representative of the set of the element
+*/
+int FindSetRoot(int *parent, int element){
+	while(parent[element] != element){
+		parent[element] = parent[parent[element]];
+		element = parent[element];
+	}
+	return element;
+}
+
+/**
+* Merge the sets of two elements (disjoint-set forest)
+* @param "parent" [type int*]: parent of each element (the representative is its own parent)
+* @param "a" [type int]: element of the first set
+* @param "b" [type int]: element of the second set
+*/
+void JoinSets(int *parent, int a, int b){
+	int root_a (FindSetRoot(parent, a));
+	int root_b (FindSetRoot(parent, b));
+	// Keep the lowest element as representative
+	if(root_a < root_b) parent[root_b] = root_a;
+	else parent[root_a] = root_b;
+}
+
 /**
 * Return a random value between min and max
 * @param "min" [type double]: minimum value to be provided
 * @param "max" [type double]: maximum value to be provided
+* @param "random_stream" [type CostRandomStream*]: random number stream
 * @return "num" [type double]: random double number
 */
-double RandomDouble(double min, double max)
+double RandomDouble(double min, double max, CostRandomStream *random_stream)
 {
-    double f ((double)rand() / RAND_MAX);
+    double f ((double)random_stream->Rand() / RAND_MAX);
     return min + f * (max - min);
 }
 
@@ -0,0 +1,306 @@
+/* Kom8ndor IEEE 802.11bn Simulator
+ *
+ * Copyright (c) 2026, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ */
+
+/**
+ * checkpoint_methods.h: checkpoint of a simulation to a binary file (--checkpoint-at, --checkpoint-every), and
+ * resumption of a simulation from it (--restore).
+ *
+ * At every checkpoint time, the engine pauses the event list (see CostSimEng::Checkpoint()) and the whole state
+ * of the simulation is written: clock and event list (as the timers of the components), nodes, traffic generators,
+ * random number streams, agents with their learning algorithms, and central controller with its ML model. The
+ * file is written aside and then renamed, so that a crash leaves the previous checkpoint intact.
+ *
+ * A resumed simulation is set up from the same input as the one that was checkpointed and its components are
+ * started as usual, but their state is then replaced by the one of the checkpoint (see
+ * CostSimEng::Restore()), so that the events run from the checkpoint time exactly as they would have in the
+ * uninterrupted simulation. The simulation time may be longer than the one of the checkpointed simulation. The
+ * logs, the frame trace and the engine profile cover the resumed part only. The input is checked through a
+ * digest of the scenario the simulation is built from (system models, parameters of the nodes and traffic loads,
+ * as stored in scenario snapshots, WLANs with their MAPC groups, sensing range and agents file), taken before it
+ * starts, so that a checkpoint cannot be resumed against another scenario with the same nodes.
+ *
+ * The slot-synchronous engine (--slotted) does not pause, and the state of the external ML models (agents using
+ * LEARNING_MECHANISM_EXTERNAL) lives in their servers, so neither can be checkpointed.
+ *
+ * File format (native byte order, see CheckpointFile):
+ *   "KOMCHKPT", int version, int byte order mark, int sizes of the structures stored as they are in memory,
+ *   int total_nodes_number, total_wlans_number, total_agents_number, central controller, mapc_enabled,
+ *   logical processes, node codes, input digest (as a string of 16 hexadecimal digits), int seed,
+ *   double clock and long last "seq" of the engine and of every logical process, engine random stream,
+ *   statistics start time and steady-state observations,
+ *   nodes and traffic generators, agents, central controller (see their Checkpoint() methods)
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+
+#include "../../list_of_macros.h"
+#include "../../structures/checkpoint_file.h"
+
+#ifndef _CHECKPOINT_METHODS_
+#define _CHECKPOINT_METHODS_
+
+#define CHECKPOINT_MAGIC			"KOMCHKPT"
+#define CHECKPOINT_VERSION			2
+#define CHECKPOINT_BYTE_ORDER		0x01020304	///> Read back differently on machines of another byte order
+
+/**
+ * Digest (64-bit FNV-1a) of the fields of a scenario, written through the archive interface of the scenario
+ * snapshots (see SnapshotNode and SnapshotWlan)
+ */
+struct InputDigest
+{
+	uint64_t hash;
+
+	InputDigest() : hash(14695981039346656037ULL) {}
+
+	int Reading() const { return 0; }
+
+	void Bytes(const void *value, size_t size){
+		const unsigned char *bytes = (const unsigned char *) value;
+		for (size_t i = 0; i < size; ++i) {
+			hash ^= bytes[i];
+			hash *= 1099511628211ULL;
+		}
+	}
+	void Field(int &value){ Bytes(&value, sizeof(value)); }
+	void Field(double &value){ Bytes(&value, sizeof(value)); }
+	void Field(std::string &value){
+		int length (value.size());
+		Field(length);
+		Bytes(value.data(), length);
+	}
+	void Array(int *values, int size){ Bytes(values, size * sizeof(int)); }
+
+	/**
+	 * Contents of a file
+	 * @param "filename" [type const char*]: file
+	 */
+	void File(const char *filename){
+		FILE *file = fopen(filename, "rb");
+		if (file == NULL) {
+			printf("ERROR: %s could not be opened\n", filename);
+			exit(-1);
+		}
+		char buffer[4096];
+		size_t size;
+		while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0) Bytes(buffer, size);
+		fclose(file);
+	}
+
+	std::string Hex() const {
+		char hex[17];
+		snprintf(hex, sizeof(hex), "%016llx", (unsigned long long) hash);
+		return hex;
+	}
+};
+
+/**
+ * Set up the checkpoints of the simulation and the one it resumes from (called after Setup())
+ * @param "checkpoint_time" [type double]: first checkpoint [s] (0: after the first period)
+ * @param "checkpoint_period_console" [type double]: time between two checkpoints [s] (0: a single one)
+ * @param "checkpoint_filename_console" [type char*]: file of the checkpoints (empty: no checkpoint)
+ * @param "restore_filename_console" [type char*]: checkpoint to resume from (empty: start from scratch)
+ */
+void Komondor :: SetupCheckpoints(double checkpoint_time, double checkpoint_period_console,
+		const char *checkpoint_filename_console, const char *restore_filename_console){
+
+	checkpoint_filename = checkpoint_filename_console;
+	checkpoint_period = checkpoint_period_console;
+	restore_filename = restore_filename_console;
+	if (checkpoint_filename.empty() && restore_filename.empty()) return;
+
+	if (slot_synchronous) {
+		printf("ERROR: Checkpoints require events (the slot-synchronous engine does not pause)\n");
+		exit(-1);
+	}
+	int num_agents (agents_enabled ? total_agents_number : 0);
+	for (int a = 0; a < num_agents; ++a) {
+		if (agent_container[a].learning_mechanism == LEARNING_MECHANISM_EXTERNAL) {
+			printf("ERROR: Agent %d: the state of external ML models cannot be checkpointed\n", a);
+			exit(-1);
+		}
+	}
+
+	// Digest of the input, taken before the nodes start changing their configuration
+	InputDigest digest;
+	digest.Field(path_loss_model);
+	digest.Field(adjacent_channel_model);
+	digest.Field(collisions_model);
+	digest.Field(pdf_tx_time);
+	digest.Field(neighbour_margin);
+	for (int n = 0; n < total_nodes_number; ++n) {
+		SnapshotNode(digest, node_container[n].node_params, traffic_generator_container[n].traffic_load);
+	}
+	for (int w = 0; w < total_wlans_number; ++w) SnapshotWlan(digest, wlan_container[w]);
+	if (agents_enabled) digest.File(agents_input_filename);
+	input_digest = digest.Hex();
+
+	if (!checkpoint_filename.empty()) CheckpointTime(checkpoint_time > 0 ? checkpoint_time : checkpoint_period);
+}
+
+/**
+ * Write the state of the simulation to a checkpoint, or read it back
+ * @param "file" [type CheckpointFile&]: checkpoint being written or read
+ */
+void Komondor :: CheckpointState(CheckpointFile &file){
+
+	int num_agents (agents_enabled ? total_agents_number : 0);
+
+	// Format, and simulation the checkpoint belongs to
+	char magic[8];
+	memcpy(magic, CHECKPOINT_MAGIC, 8);
+	file.Bytes(magic, 8);
+	if (memcmp(magic, CHECKPOINT_MAGIC, 8) != 0) {
+		printf("ERROR: %s is not a checkpoint\n", file.filename.c_str());
+		exit(-1);
+	}
+	file.Check(CHECKPOINT_VERSION, "version");
+	file.Check(CHECKPOINT_BYTE_ORDER, "byte order");
+	file.Check(sizeof(Notification), "size of a frame");
+	file.Check(sizeof(NodeStatistics), "size of the statistics");
+	file.Check(sizeof(Performance), "size of a performance report");
+	file.Check(sizeof(Action), "size of an action");
+	file.Check(total_nodes_number, "nodes");
+	file.Check(total_wlans_number, "WLANs");
+	file.Check(num_agents, "agents");
+	file.Check(central_controller_flag, "central controller");
+	file.Check(mapc_enabled, "MAPC");
+	file.Check(Processes(), "logical processes");
+	for (int n = 0; n < total_nodes_number; ++n) file.Check(node_container[n].node_params.node_code, "node");
+	file.Check(input_digest, "digest of the input");
+	file.Check(seed, "seed");
+
+	// Engine (and logical processes): clock, and last "seq" stamped, which the events restored keep
+	for (int p = -1; p < Processes(); ++p) {
+		double clock (Process(p)->SimTime());
+		long seq (Process(p)->EventSeq());
+		file.Field(clock);
+		file.Field(seq);
+		if (file.Reading()) Process(p)->RestoreClock(clock, seq);
+	}
+	file.RandomStream(random_stream);
+
+	// Statistics
+	file.Field(statistics_start_time);
+	file.Field(steady_state.warmup_deleted);
+	file.Field(steady_state.throughput);
+	file.Field(steady_state.delay);
+	file.Field(steady_state.last_observation_time);
+	file.Field(steady_state.last_bits_acked);
+	file.Field(steady_state.last_sum_delays);
+	file.Field(steady_state.last_num_delay_measurements);
+
+	// Components (their timers are restored into the event list of their logical process)
+	file.reports.clear();
+	for (int n = 0; n < total_nodes_number; ++n) file.reports.push_back(&node_container[n].performance_report);
+	file.available_actions.clear();
+	for (int a = 0; a < num_agents; ++a) {
+		file.available_actions.push_back(agent_container[a].list_of_available_actions);
+	}
+	for (int n = 0; n < total_nodes_number; ++n) {
+		SelectProcess(node_container[n].Partition());
+		node_container[n].Checkpoint(file);
+		traffic_generator_container[n].Checkpoint(file);
+	}
+	for (int a = 0; a < num_agents; ++a) {
+		SelectProcess(agent_container[a].Partition());
+		agent_container[a].Checkpoint(file);
+	}
+	if (central_controller_flag && central_controller[0].controller_on) {
+		SelectProcess(central_controller[0].Partition());
+		central_controller[0].Checkpoint(file);
+	}
+	SelectProcess(-1);
+}
+
+/**
+ * Write the checkpoint (aside, and then in place of the previous one)
+ */
+void Komondor :: WriteCheckpoint(){
+
+	CheckpointFile file;
+	file.filename = checkpoint_filename + ".tmp";
+	file.reading = 0;
+	file.file = fopen(file.filename.c_str(), "wb");
+	if (file.file == NULL) {
+		printf("ERROR: Checkpoint %s could not be created\n", file.filename.c_str());
+		exit(-1);
+	}
+	CheckpointState(file);
+	if (fflush(file.file) != 0 || fsync(fileno(file.file)) != 0 || fclose(file.file) != 0
+			|| rename(file.filename.c_str(), checkpoint_filename.c_str()) != 0) {
+		printf("ERROR: Checkpoint %s could not be written\n", checkpoint_filename.c_str());
+		exit(-1);
+	}
+	printf("%s Checkpoint @ %f s written to %s\n", LOG_LVL1, SimTime(), checkpoint_filename.c_str());
+}
+
+/**
+ * Called by the engine at the checkpoint time: write the checkpoint (and set the next one), or fork the
+ * continuations (see continuation_methods.h)
+ */
+void Komondor :: Checkpoint(){
+	if (!checkpoint_filename.empty()) {
+		WriteCheckpoint();
+		if (checkpoint_period > 0) CheckpointTime(SimTime() + checkpoint_period);
+	}
+	if (num_continuations > 0) ForkContinuations();
+}
+
+/**
+ * Called by the engine once the components have started: replace their state by the one of the checkpoint
+ * to resume from (if any)
+ */
+void Komondor :: Restore(){
+
+	if (restore_filename.empty()) return;
+
+	CheckpointFile file;
+	file.filename = restore_filename;
+	file.reading = 1;
+	file.file = fopen(restore_filename.c_str(), "rb");
+	if (file.file == NULL) {
+		printf("ERROR: Checkpoint %s could not be opened\n", restore_filename.c_str());
+		exit(-1);
+	}
+	CheckpointState(file);
+	char trailing;
+	if (fread(&trailing, 1, 1, file.file) != 0) {
+		printf("ERROR: Checkpoint %s is corrupted\n", restore_filename.c_str());
+		exit(-1);
+	}
+	fclose(file.file);
+
+	if (SimTime() >= StopTime()) {
+		printf("ERROR: Checkpoint %s was taken at %f s, which is not before the simulation time\n",
+			restore_filename.c_str(), SimTime());
+		exit(-1);
+	}
+	// Next checkpoint due, as in the checkpointed simulation
+	if (!checkpoint_filename.empty() && checkpoint_period > 0) {
+		double next_checkpoint (CheckpointTime());
+		while (next_checkpoint <= SimTime()) next_checkpoint += checkpoint_period;
+		CheckpointTime(next_checkpoint);
+	}
+	printf("%s Simulation '%s' resumed from %s @ %f s\n", LOG_LVL1, simulation_code.c_str(),
+		restore_filename.c_str(), SimTime());
+}
+
+#endif
@@ -0,0 +1,151 @@
+/* Kom8ndor IEEE 802.11bn Simulator
+ *
+ * Copyright (c) 2026, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ */
+
+/**
+ * continuation_methods.h: warm start of several continuations of a simulation from the same state (--fork-at).
+ *
+ * The simulation is run up to the checkpoint time (the warm-up), where the engine pauses the event list (see
+ * CostSimEng::Checkpoint()) and the process is forked once per continuation. Every child process inherits the
+ * whole simulation state as it is at that time (event list, FSM, timers and buffers of the nodes, traffic
+ * generators, random number streams, and learning state of the agents and of the central controller), applies
+ * the changes of its continuation and resumes the event list up to the simulation time, whereas the warm-up
+ * process waits for all of them and exits.
+ *
+ * Continuation "c" is named "<code>_F<c>". If action-selection strategies are given, continuation "c" switches
+ * every agent (and the central controller) to the c-th one and keeps the random number streams, so that the
+ * continuations only differ in the policy (common random numbers). Otherwise, continuation "c" draws from the
+ * streams of seed "seed + c" (continuation 0 thus reproduces the uninterrupted simulation).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/file.h>
+#include <vector>
+
+#include "../../list_of_macros.h"
+
+#ifndef _CONTINUATION_METHODS_
+#define _CONTINUATION_METHODS_
+
+/**
+ * Set up the continuations to be forked at the checkpoint time
+ * @param "checkpoint_time" [type double]: end of the warm-up [s]
+ * @param "num_continuations_console" [type int]: number of continuations
+ * @param "strategies" [type std::vector<int>&]: action-selection strategy of each continuation (empty: same
+ *   strategies, different seeds)
+ * @param "max_running_continuations_console" [type int]: continuations simulated concurrently
+ */
+void Komondor :: SetupContinuations(double checkpoint_time, int num_continuations_console,
+		const std::vector<int> &strategies, int max_running_continuations_console){
+
+	if (slot_synchronous) {
+		printf("ERROR: --fork-at requires events (the slot-synchronous engine does not pause)\n");
+		exit(-1);
+	}
+	if (!strategies.empty() && !agents_enabled) {
+		printf("ERROR: --fork-strategies requires agents (--agents)\n");
+		exit(-1);
+	}
+
+	num_continuations = num_continuations_console;
+	continuation_strategies = strategies;
+	max_running_continuations = max_running_continuations_console;
+	CheckpointTime(checkpoint_time);
+}
+
+/**
+ * Wait for a continuation to finish
+ * @return "failed" [type int]: 1 if the continuation did not finish successfully, 0 otherwise
+ */
+int WaitContinuation(){
+	int status;
+	pid_t pid (wait(&status));
+	return (pid < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) ? 1 : 0;
+}
+
+/**
+ * Fork the continuations (called at the checkpoint time, see checkpoint_methods.h). The warm-up process does not
+ * return
+ */
+void Komondor :: ForkContinuations(){
+
+	printf("%s Checkpoint @ %f s: forking %d continuations\n", LOG_LVL1, SimTime(), num_continuations);
+	fflush(NULL);	// Otherwise, the buffered output would be written by every process
+
+	int num_running (0);
+	int num_failed (0);
+	for (int c = 0; c < num_continuations; ++c) {
+		if (num_running == max_running_continuations) {
+			num_failed += WaitContinuation();
+			--num_running;
+		}
+		pid_t pid (fork());
+		if (pid < 0) {
+			printf("ERROR: Continuation %d could not be forked\n", c);
+			exit(-1);
+		}
+		if (pid == 0) {
+			StartContinuation(c);
+			return;
+		}
+		++num_running;
+	}
+	while (num_running > 0) {
+		num_failed += WaitContinuation();
+		--num_running;
+	}
+
+	printf("%s %d continuations of '%s' finished (%d failed)\n", LOG_LVL1, num_continuations,
+		simulation_code.c_str(), num_failed);
+	exit(num_failed > 0 ? -1 : 0);
+}
+
+/**
+ * Apply the changes of a continuation to the state inherited from the warm-up
+ * @param "c" [type int]: continuation index
+ */
+void Komondor :: StartContinuation(int c){
+
+	continuation_id = c;
+	char suffix[32];
+	snprintf(suffix, sizeof(suffix), "_F%d", c);
+	simulation_code.append(suffix);
+
+	if (!continuation_strategies.empty()) {
+		int strategy (continuation_strategies[c]);
+		for (int a = 0; a < total_agents_number; ++a) agent_container[a].SetActionSelectionStrategy(strategy);
+		if (central_controller_flag) central_controller[0].SetActionSelectionStrategy(strategy);
+		printf("%s Continuation '%s': action-selection strategy %d\n", LOG_LVL2, simulation_code.c_str(), strategy);
+	} else if (c > 0) {
+		seed += c;
+		for (int n = 0; n < total_nodes_number; ++n) {
+			node_container[n].random_stream.Seed(seed, RANDOM_STREAM_NODE, n);
+			traffic_generator_container[n].random_stream.Seed(seed, RANDOM_STREAM_TRAFFIC, n);
+		}
+		if (agents_enabled) {
+			for (int a = 0; a < total_agents_number; ++a) {
+				agent_container[a].random_stream.Seed(seed, RANDOM_STREAM_AGENT, a);
+			}
+			if (central_controller_flag) central_controller[0].random_stream.Seed(seed, RANDOM_STREAM_CONTROLLER, 0);
+		}
+		printf("%s Continuation '%s': seed %d\n", LOG_LVL2, simulation_code.c_str(), seed);
+	}
+}
+
+#endif
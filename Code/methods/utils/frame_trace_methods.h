@@ -0,0 +1,445 @@
+/* Kom8ndor IEEE 802.11bn Simulator
+ *
+ * Copyright (c) 2026, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ */
+
+/**
+ * frame_trace_methods.h: columnar binary trace of the frames of a simulation (--frame-trace).
+ *
+ * Every frame addressed to a node is recorded by its destination when the transmission ends (one row per
+ * frame and destination). Each node fills the columns of a block of FRAME_TRACE_BLOCK_ROWS rows and hands
+ * it over when full; a background thread encodes the blocks and writes them, so that the simulation only
+ * copies a few numbers per frame. DecodeFrameTrace (--decode-frames) converts the trace into a CSV file.
+ *
+ * File format (native byte order, int = int32):
+ *   "KOMFRAME", int version, int num_columns, and per column: int type, int name length, name
+ *   'B' int num_rows, int node_id, and per column: int length, encoded values   (a block of rows)
+ *   'E' int64 total number of rows                                             (end of the trace)
+ *
+ * Values are encoded per column and block as unsigned LEB128 varints of:
+ *   - FRAME_COLUMN_INT: zig-zag difference with the previous value of the block
+ *   - FRAME_COLUMN_TIME: zig-zag difference with the previous value of the block, in picoseconds
+ *   - FRAME_COLUMN_DOUBLE: bits of the value XOR the bits of the previous value of the block
+ * so that sorted times, node ids, channels and repeated values take one or two bytes each.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "../../list_of_macros.h"
+
+#ifndef _FRAME_TRACE_METHODS_
+#define _FRAME_TRACE_METHODS_
+
+#define FRAME_TRACE_MAGIC		"KOMFRAME"
+#define FRAME_TRACE_VERSION		1
+#define FRAME_TRACE_BLOCK_ROWS	4096	///> Rows buffered by a node before its block is written
+
+// Types of the columns
+#define FRAME_COLUMN_INT		0
+#define FRAME_COLUMN_TIME		1
+#define FRAME_COLUMN_DOUBLE		2
+
+// Columns of the trace
+#define FRAME_COL_START			0	///> Start of the transmission [s]
+#define FRAME_COL_END			1	///> End of the transmission [s]
+#define FRAME_COL_SOURCE		2	///> Transmitter
+#define FRAME_COL_DESTINATION	3	///> Receiver (node recording the row)
+#define FRAME_COL_TYPE			4	///> Packet type (PACKET_TYPE_*)
+#define FRAME_COL_PACKET_ID		5	///> Packet identifier
+#define FRAME_COL_LEFT_CHANNEL	6	///> Left channel of the transmission
+#define FRAME_COL_RIGHT_CHANNEL	7	///> Right channel of the transmission
+#define FRAME_COL_AGGREGATED	8	///> Packets aggregated (DATA and ACK)
+#define FRAME_COL_SINR			9	///> SINR at the receiver at the end of the frame [dB]
+#define FRAME_COL_DECODED		10	///> 1 if the receiver decoded the frame, 0 if it was lost
+#define FRAME_COL_DELAY			11	///> Time since the (first) packet was generated [s]
+#define FRAME_TRACE_COLUMNS		12
+
+const int frame_column_types[FRAME_TRACE_COLUMNS] = {FRAME_COLUMN_TIME, FRAME_COLUMN_TIME, FRAME_COLUMN_INT,
+	FRAME_COLUMN_INT, FRAME_COLUMN_INT, FRAME_COLUMN_INT, FRAME_COLUMN_INT, FRAME_COLUMN_INT, FRAME_COLUMN_INT,
+	FRAME_COLUMN_DOUBLE, FRAME_COLUMN_INT, FRAME_COLUMN_TIME};
+const char *frame_column_names[FRAME_TRACE_COLUMNS] = {"start_time", "end_time", "source_id", "destination_id",
+	"packet_type", "packet_id", "left_channel", "right_channel", "num_packets_aggregated", "sinr_db", "decoded",
+	"delay"};
+
+// Rows recorded by a node, stored by columns (integers and times as int64, doubles by their bits)
+struct FrameTraceBlock
+{
+	int node_id;			///> Node recording the rows
+	int num_rows;			///> Rows filled
+	int64_t columns[FRAME_TRACE_COLUMNS][FRAME_TRACE_BLOCK_ROWS];
+};
+
+// Trace file of a simulation, shared by its nodes
+struct FrameTrace
+{
+	FILE *file;									///> Binary trace file
+	pthread_t writer;							///> Thread encoding and writing the blocks
+	pthread_mutex_t mutex;						///> Protects the queues and "closing"
+	pthread_cond_t block_ready;					///> Signaled when a block is queued or the trace is closed
+	std::deque<FrameTraceBlock*> pending;		///> Full blocks waiting to be written
+	std::vector<FrameTraceBlock*> free_blocks;	///> Written blocks to be reused by the nodes
+	int closing;								///> Whether the trace is being closed
+	int64_t num_rows;							///> Rows written
+};
+
+/**
+ * Append a value to an encoded column as an unsigned LEB128 varint
+ * @param "value" [type uint64_t]: value
+ * @param "buffer" [type std::string*]: encoded column
+ */
+void AppendVarint(uint64_t value, std::string *buffer){
+	while (value >= 0x80) {
+		buffer->push_back((char) ((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	buffer->push_back((char) value);
+}
+
+/**
+ * Read a varint from an encoded column
+ * @param "buffer" [type std::string]: encoded column
+ * @param "position" [type size_t*]: position of the varint, moved past it (output)
+ * @param "value" [type uint64_t*]: value (output)
+ * @return "success" [type int]: FALSE if the column ends before the varint
+ */
+int ReadVarint(const std::string &buffer, size_t *position, uint64_t *value){
+	*value = 0;
+	for (int shift = 0; shift < 64 && *position < buffer.size(); shift += 7) {
+		uint8_t byte = (uint8_t) buffer[(*position)++];
+		*value |= (uint64_t) (byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0) return TRUE;
+	}
+	return FALSE;
+}
+
+/**
+ * Encode a column of a block
+ * @param "type" [type int]: FRAME_COLUMN_* type of the column
+ * @param "values" [type int64_t*]: values of the column
+ * @param "num_rows" [type int]: number of values
+ * @param "buffer" [type std::string*]: encoded column (output)
+ */
+void EncodeFrameColumn(int type, const int64_t *values, int num_rows, std::string *buffer){
+	buffer->clear();
+	int64_t previous = 0;
+	for (int r = 0; r < num_rows; ++r) {
+		if (type == FRAME_COLUMN_DOUBLE) {
+			AppendVarint((uint64_t) (values[r] ^ previous), buffer);
+		} else {
+			int64_t difference = values[r] - previous;
+			AppendVarint(((uint64_t) difference << 1) ^ (uint64_t) (difference >> 63), buffer);
+		}
+		previous = values[r];
+	}
+}
+
+/**
+ * Decode a column of a block
+ * @param "type" [type int]: FRAME_COLUMN_* type of the column
+ * @param "buffer" [type std::string]: encoded column
+ * @param "num_rows" [type int]: number of values
+ * @param "values" [type int64_t*]: values of the column (output)
+ * @return "success" [type int]: FALSE if the column does not hold "num_rows" values
+ */
+int DecodeFrameColumn(int type, const std::string &buffer, int num_rows, int64_t *values){
+	size_t position = 0;
+	int64_t previous = 0;
+	for (int r = 0; r < num_rows; ++r) {
+		uint64_t encoded;
+		if (!ReadVarint(buffer, &position, &encoded)) return FALSE;
+		if (type == FRAME_COLUMN_DOUBLE) {
+			values[r] = (int64_t) encoded ^ previous;
+		} else {
+			values[r] = previous + (int64_t) ((encoded >> 1) ^ (~(encoded & 1) + 1));
+		}
+		previous = values[r];
+	}
+	return position == buffer.size();
+}
+
+/**
+ * Encode a block and write it into the trace file (writer side)
+ * @param "trace" [type FrameTrace*]: trace
+ * @param "block" [type FrameTraceBlock*]: block
+ */
+void WriteFrameTraceBlock(FrameTrace *trace, const FrameTraceBlock *block){
+	std::string buffer;
+	fputc('B', trace->file);
+	fwrite(&block->num_rows, sizeof(int), 1, trace->file);
+	fwrite(&block->node_id, sizeof(int), 1, trace->file);
+	for (int c = 0; c < FRAME_TRACE_COLUMNS; ++c) {
+		EncodeFrameColumn(frame_column_types[c], block->columns[c], block->num_rows, &buffer);
+		int length = buffer.size();
+		fwrite(&length, sizeof(int), 1, trace->file);
+		fwrite(buffer.data(), 1, length, trace->file);
+	}
+	trace->num_rows += block->num_rows;
+}
+
+/**
+ * Writer thread: write the queued blocks until the trace is closed
+ * @param "arg" [type FrameTrace*]: trace
+ */
+void *FrameTraceWriterWorker(void *arg){
+	FrameTrace *trace = (FrameTrace *) arg;
+	pthread_mutex_lock(&trace->mutex);
+	while (true) {
+		while (trace->pending.empty() && !trace->closing) pthread_cond_wait(&trace->block_ready, &trace->mutex);
+		if (trace->pending.empty()) break;
+		FrameTraceBlock *block = trace->pending.front();
+		trace->pending.pop_front();
+		pthread_mutex_unlock(&trace->mutex);
+		WriteFrameTraceBlock(trace, block);
+		pthread_mutex_lock(&trace->mutex);
+		trace->free_blocks.push_back(block);
+	}
+	pthread_mutex_unlock(&trace->mutex);
+	return NULL;
+}
+
+/**
+ * Open a frame trace and start its writer thread
+ * @param "filename" [type char*]: binary trace file
+ * @return "trace" [type FrameTrace*]: trace, NULL if the file could not be created
+ */
+FrameTrace *OpenFrameTrace(const char *filename){
+
+	FILE *file = fopen(filename, "wb");
+	if (file == NULL) return NULL;
+
+	// Schema
+	int version = FRAME_TRACE_VERSION;
+	int num_columns = FRAME_TRACE_COLUMNS;
+	fwrite(FRAME_TRACE_MAGIC, 1, strlen(FRAME_TRACE_MAGIC), file);
+	fwrite(&version, sizeof(int), 1, file);
+	fwrite(&num_columns, sizeof(int), 1, file);
+	for (int c = 0; c < FRAME_TRACE_COLUMNS; ++c) {
+		int length = strlen(frame_column_names[c]);
+		fwrite(&frame_column_types[c], sizeof(int), 1, file);
+		fwrite(&length, sizeof(int), 1, file);
+		fwrite(frame_column_names[c], 1, length, file);
+	}
+
+	FrameTrace *trace = new FrameTrace;
+	trace->file = file;
+	trace->closing = FALSE;
+	trace->num_rows = 0;
+	pthread_mutex_init(&trace->mutex, NULL);
+	pthread_cond_init(&trace->block_ready, NULL);
+	if (pthread_create(&trace->writer, NULL, FrameTraceWriterWorker, trace) != 0) {
+		printf("ERROR: Frame trace writer thread could not be created\n");
+		exit(-1);
+	}
+	return trace;
+}
+
+/**
+ * Queue a block to be written (node side) and get an empty one
+ * @param "trace" [type FrameTrace*]: trace
+ * @param "block" [type FrameTraceBlock*]: block of the node (NULL if it has none yet)
+ * @param "node_id" [type int]: node
+ * @return "new_block" [type FrameTraceBlock*]: empty block of the node
+ */
+FrameTraceBlock *SubmitFrameTraceBlock(FrameTrace *trace, FrameTraceBlock *block, int node_id){
+	FrameTraceBlock *new_block = NULL;
+	pthread_mutex_lock(&trace->mutex);
+	if (block != NULL && block->num_rows > 0) {
+		trace->pending.push_back(block);
+		pthread_cond_signal(&trace->block_ready);
+		block = NULL;
+	}
+	if (block != NULL) {
+		new_block = block;
+	} else if (!trace->free_blocks.empty()) {
+		new_block = trace->free_blocks.back();
+		trace->free_blocks.pop_back();
+	}
+	pthread_mutex_unlock(&trace->mutex);
+	if (new_block == NULL) new_block = new FrameTraceBlock;
+	new_block->node_id = node_id;
+	new_block->num_rows = 0;
+	return new_block;
+}
+
+/**
+ * Record a frame received (or lost) by a node
+ * @param "trace" [type FrameTrace*]: trace
+ * @param "block" [type FrameTraceBlock**]: block of the node (NULL if it has none yet)
+ * @param "notification" [type Notification]: frame (as notified at the end of the transmission)
+ * @param "start_time" [type double]: start of the transmission [s]
+ * @param "end_time" [type double]: end of the transmission [s]
+ * @param "sinr" [type double]: SINR at the receiver (linear)
+ * @param "decoded" [type int]: whether the receiver decoded the frame
+ */
+void RecordFrame(FrameTrace *trace, FrameTraceBlock **block, const Notification &notification,
+		double start_time, double end_time, double sinr, int decoded){
+	if (*block == NULL || (*block)->num_rows == FRAME_TRACE_BLOCK_ROWS) {
+		*block = SubmitFrameTraceBlock(trace, *block, notification.destination_id);
+	}
+	FrameTraceBlock &b = **block;
+	int r = b.num_rows++;
+	double sinr_db = ConvertPower(LINEAR_TO_DB, sinr);
+	b.columns[FRAME_COL_START][r] = (int64_t) floor(start_time / PICO_VALUE + 0.5);
+	b.columns[FRAME_COL_END][r] = (int64_t) floor(end_time / PICO_VALUE + 0.5);
+	b.columns[FRAME_COL_SOURCE][r] = notification.source_id;
+	b.columns[FRAME_COL_DESTINATION][r] = notification.destination_id;
+	b.columns[FRAME_COL_TYPE][r] = notification.packet_type;
+	b.columns[FRAME_COL_PACKET_ID][r] = notification.packet_id;
+	b.columns[FRAME_COL_LEFT_CHANNEL][r] = notification.left_channel;
+	b.columns[FRAME_COL_RIGHT_CHANNEL][r] = notification.right_channel;
+	b.columns[FRAME_COL_AGGREGATED][r] = notification.tx_info.num_packets_aggregated;
+	memcpy(&b.columns[FRAME_COL_SINR][r], &sinr_db, sizeof(double));
+	b.columns[FRAME_COL_DECODED][r] = decoded;
+	b.columns[FRAME_COL_DELAY][r] = (int64_t) floor((end_time - notification.timestamp_generated) / PICO_VALUE + 0.5);
+}
+
+/**
+ * Write the pending blocks, close the trace file and stop its writer thread
+ * @param "trace" [type FrameTrace*]: trace
+ * @param "blocks" [type FrameTraceBlock**]: blocks still held by the nodes (NULL entries are skipped)
+ * @param "num_blocks" [type int]: number of blocks
+ * @return "num_rows" [type int64_t]: rows written
+ */
+int64_t CloseFrameTrace(FrameTrace *trace, FrameTraceBlock **blocks, int num_blocks){
+	pthread_mutex_lock(&trace->mutex);
+	for (int b = 0; b < num_blocks; ++b) {
+		if (blocks[b] == NULL) continue;
+		if (blocks[b]->num_rows > 0) {
+			trace->pending.push_back(blocks[b]);
+		} else {
+			trace->free_blocks.push_back(blocks[b]);
+		}
+		blocks[b] = NULL;
+	}
+	trace->closing = TRUE;
+	pthread_cond_signal(&trace->block_ready);
+	pthread_mutex_unlock(&trace->mutex);
+	pthread_join(trace->writer, NULL);
+
+	fputc('E', trace->file);
+	fwrite(&trace->num_rows, sizeof(int64_t), 1, trace->file);
+	fclose(trace->file);
+	int64_t num_rows = trace->num_rows;
+	for (size_t b = 0; b < trace->free_blocks.size(); ++b) delete trace->free_blocks[b];
+	pthread_mutex_destroy(&trace->mutex);
+	pthread_cond_destroy(&trace->block_ready);
+	delete trace;
+	return num_rows;
+}
+
+/**
+ * Convert a frame trace into a CSV file (one line per row, columns named as in the schema)
+ * @param "input_filename" [type char*]: binary trace file
+ * @param "output_filename" [type char*]: CSV file
+ * @return "success" [type int]: TRUE if the whole trace was decoded
+ */
+int DecodeFrameTrace(const char *input_filename, const char *output_filename){
+
+	FILE *input = fopen(input_filename, "rb");
+	if (input == NULL) {
+		printf("ERROR: Frame trace %s could not be opened\n", input_filename);
+		return FALSE;
+	}
+
+	// Schema
+	char magic[8];
+	int version, num_columns;
+	int ok = fread(magic, 1, 8, input) == 8 && memcmp(magic, FRAME_TRACE_MAGIC, 8) == 0
+		&& fread(&version, sizeof(int), 1, input) == 1 && version == FRAME_TRACE_VERSION
+		&& fread(&num_columns, sizeof(int), 1, input) == 1 && num_columns > 0 && num_columns <= 256;
+	std::vector<int> types;
+	std::vector<std::string> names;
+	for (int c = 0; ok && c < num_columns; ++c) {
+		int type, length;
+		ok = fread(&type, sizeof(int), 1, input) == 1 && type >= FRAME_COLUMN_INT && type <= FRAME_COLUMN_DOUBLE
+			&& fread(&length, sizeof(int), 1, input) == 1 && length > 0 && length < 256;
+		if (ok) {
+			std::string name(length, '\0');
+			ok = fread(&name[0], 1, length, input) == (size_t) length;
+			types.push_back(type);
+			names.push_back(name);
+		}
+	}
+	if (!ok) {
+		printf("ERROR: %s is not a Komondor frame trace (version %d)\n", input_filename, FRAME_TRACE_VERSION);
+		fclose(input);
+		return FALSE;
+	}
+
+	FILE *output = fopen(output_filename, "w");
+	if (output == NULL) {
+		printf("ERROR: Output file %s could not be opened\n", output_filename);
+		fclose(input);
+		return FALSE;
+	}
+	for (int c = 0; c < num_columns; ++c) fprintf(output, "%s%s", c > 0 ? ";" : "", names[c].c_str());
+	fprintf(output, "\n");
+
+	// Blocks
+	std::vector<std::vector<int64_t> > columns(num_columns);
+	std::string buffer;
+	int64_t num_rows = 0;
+	int tag;
+	ok = FALSE;
+	while ((tag = fgetc(input)) == 'B') {
+		int block_rows, node_id;
+		if (fread(&block_rows, sizeof(int), 1, input) != 1 || fread(&node_id, sizeof(int), 1, input) != 1
+				|| block_rows < 0 || block_rows > (1 << 24)) break;
+		int block_ok = TRUE;
+		for (int c = 0; block_ok && c < num_columns; ++c) {
+			int length;
+			block_ok = fread(&length, sizeof(int), 1, input) == 1 && length >= 0;
+			if (block_ok) {
+				buffer.resize(length);
+				columns[c].resize(block_rows);
+				block_ok = (length == 0 || fread(&buffer[0], 1, length, input) == (size_t) length)
+					&& (block_rows == 0 || DecodeFrameColumn(types[c], buffer, block_rows, &columns[c][0]));
+			}
+		}
+		if (!block_ok) break;
+		for (int r = 0; r < block_rows; ++r) {
+			for (int c = 0; c < num_columns; ++c) {
+				if (c > 0) fputc(';', output);
+				int64_t value = columns[c][r];
+				if (types[c] == FRAME_COLUMN_TIME) {
+					fprintf(output, "%.12f", value * PICO_VALUE);
+				} else if (types[c] == FRAME_COLUMN_DOUBLE) {
+					double double_value;
+					memcpy(&double_value, &value, sizeof(double));
+					fprintf(output, "%.2f", double_value);
+				} else {
+					fprintf(output, "%lld", (long long) value);
+				}
+			}
+			fputc('\n', output);
+		}
+		num_rows += block_rows;
+	}
+	int64_t total_rows;
+	if (tag == 'E' && fread(&total_rows, sizeof(int64_t), 1, input) == 1 && total_rows == num_rows) ok = TRUE;
+	if (!ok) printf("ERROR: Frame trace %s is corrupted or truncated\n", input_filename);
+
+	fclose(input);
+	fclose(output);
+	return ok;
+}
+
+#endif
@@ -0,0 +1,304 @@
+/* Kom8ndor IEEE 802.11bn Simulator
+ *
+ * Copyright (c) 2026, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ */
+
+/**
+ * csv_table.h: read-only view of a semicolon-separated input file (e.g., the nodes file).
+ *
+ * The file is mapped into memory (or read at once if it cannot be mapped) and tokenized in a single pass:
+ * the lines are located first, and then the offsets of the fields of every row are computed by several
+ * threads, each one in charge of a contiguous range of rows. The fields are then accessed in place, with
+ * the same semantics as GetField(): columns are 1-based, and an empty or missing field is absent (NULL).
+ * The first line (header) is not a row, and neither are blank lines.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#ifndef _CSV_TABLE_
+#define _CSV_TABLE_
+
+#define CSV_MAX_THREADS			8		///> Maximum number of threads tokenizing the rows
+#define CSV_MIN_ROWS_PER_THREAD	1024	///> Rows below which an additional thread is not worth it
+
+struct CsvTable
+{
+	std::string filename;
+	const char *data;						///> Contents of the file
+	size_t size;							///> Size of the contents [bytes]
+	int mapped;								///> 1 if data is mapped, 0 if it was allocated (and must be freed)
+	int num_rows;							///> Number of rows (header and blank lines excluded)
+	std::vector<size_t> row_start;			///> Offset of the first character of each row
+	std::vector<size_t> row_end;			///> Offset of the end of each row (newline excluded)
+	std::vector<int> row_line;				///> Line of the file of each row (for error messages)
+	std::vector<size_t> row_first_bound;	///> Index in field_bounds of the first field of each row (+1 sentinel)
+	std::vector<size_t> field_bounds;		///> Per row: offset of every field, plus the row end + 1
+};
+
+/**
+ * Range of rows tokenized by a thread
+ */
+struct CsvChunk
+{
+	const CsvTable *table;
+	int first_row;
+	int last_row;						///> Exclusive
+	std::vector<size_t> row_num_bounds;	///> Number of bounds of each row of the range
+	std::vector<size_t> bounds;			///> Bounds of the fields of the rows of the range
+};
+
+/**
+ * Tokenize the rows of a chunk (thread routine)
+ * @param "arg" [type void*]: chunk (CsvChunk*)
+ */
+void *TokenizeCsvChunk(void *arg){
+	CsvChunk *chunk = (CsvChunk *) arg;
+	const char *data (chunk->table->data);
+	for (int r = chunk->first_row; r < chunk->last_row; ++r) {
+		size_t end (chunk->table->row_end[r]);
+		size_t num_bounds (chunk->bounds.size());
+		size_t p (chunk->table->row_start[r]);
+		chunk->bounds.push_back(p);
+		while (true) {
+			const char *delimiter = (const char *) memchr(data + p, ';', end - p);
+			if (delimiter == NULL) break;
+			p = delimiter - data + 1;
+			chunk->bounds.push_back(p);
+		}
+		chunk->bounds.push_back(end + 1);
+		chunk->row_num_bounds.push_back(chunk->bounds.size() - num_bounds);
+	}
+	return NULL;
+}
+
+/**
+ * Load a CSV file and tokenize its rows. Exits if the file cannot be read
+ * @param "filename" [type const char*]: CSV filename
+ * @param "table" [type CsvTable*]: table to fill
+ */
+void OpenCsvTable(const char *filename, CsvTable *table){
+
+	table->filename = filename;
+	table->data = NULL;
+	table->size = 0;
+	table->mapped = 0;
+
+	int fd (open(filename, O_RDONLY));
+	struct stat file_status;
+	if (fd < 0 || fstat(fd, &file_status) != 0) {
+		printf("ERROR: Could not open input file: %s\n", filename);
+		exit(-1);
+	}
+	table->size = file_status.st_size;
+
+#ifndef _WIN32
+	// Mapped only if the last line is terminated, so that atoi() and atof() always find a delimiter
+	if (table->size > 0) {
+		void *map = mmap(NULL, table->size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (map != MAP_FAILED) {
+			if (((const char *) map)[table->size - 1] == '\n') {
+				table->data = (const char *) map;
+				table->mapped = 1;
+			} else {
+				munmap(map, table->size);
+			}
+		}
+	}
+#endif
+	if (!table->mapped) {
+		char *buffer = (char *) malloc(table->size + 2);
+		size_t read_bytes (0);
+		while (read_bytes < table->size) {
+			ssize_t n (read(fd, buffer + read_bytes, table->size - read_bytes));
+			if (n <= 0) {
+				printf("ERROR: Could not read input file: %s\n", filename);
+				exit(-1);
+			}
+			read_bytes += n;
+		}
+		buffer[table->size] = '\n';
+		buffer[table->size + 1] = '\0';
+		table->data = buffer;
+	}
+	close(fd);
+
+	// Rows: every line but the header and the blank ones
+	const char *data (table->data);
+	size_t p (0);
+	int line (0);
+	table->row_start.clear();
+	table->row_end.clear();
+	table->row_line.clear();
+	while (p < table->size) {
+		const char *newline = (const char *) memchr(data + p, '\n', table->size - p);
+		size_t end (newline != NULL ? (size_t) (newline - data) : table->size);
+		size_t next (end + 1);
+		while (end > p && data[end - 1] == '\r') --end;
+		++line;
+		if (line > 1 && end > p) {
+			table->row_start.push_back(p);
+			table->row_end.push_back(end);
+			table->row_line.push_back(line);
+		}
+		p = next;
+	}
+	table->num_rows = table->row_start.size();
+
+	// Fields: the rows are split into one chunk per thread
+	long num_cpus (sysconf(_SC_NPROCESSORS_ONLN));
+	int num_threads (table->num_rows / CSV_MIN_ROWS_PER_THREAD);
+	if (num_threads > num_cpus) num_threads = num_cpus;
+	if (num_threads > CSV_MAX_THREADS) num_threads = CSV_MAX_THREADS;
+	if (num_threads < 1) num_threads = 1;
+
+	std::vector<CsvChunk> chunks(num_threads);
+	for (int t = 0; t < num_threads; ++t) {
+		chunks[t].table = table;
+		chunks[t].first_row = (long) table->num_rows * t / num_threads;
+		chunks[t].last_row = (long) table->num_rows * (t + 1) / num_threads;
+	}
+	if (num_threads == 1) {
+		TokenizeCsvChunk(&chunks[0]);
+	} else {
+		std::vector<pthread_t> threads(num_threads);
+		for (int t = 0; t < num_threads; ++t) pthread_create(&threads[t], NULL, TokenizeCsvChunk, &chunks[t]);
+		for (int t = 0; t < num_threads; ++t) pthread_join(threads[t], NULL);
+	}
+
+	size_t num_bounds (0);
+	for (int t = 0; t < num_threads; ++t) num_bounds += chunks[t].bounds.size();
+	table->field_bounds.clear();
+	table->field_bounds.reserve(num_bounds);
+	table->row_first_bound.clear();
+	table->row_first_bound.reserve(table->num_rows + 1);
+	for (int t = 0; t < num_threads; ++t) {
+		for (size_t r = 0; r < chunks[t].row_num_bounds.size(); ++r) {
+			table->row_first_bound.push_back(table->field_bounds.size());
+			table->field_bounds.resize(table->field_bounds.size() + chunks[t].row_num_bounds[r]);
+		}
+		std::copy(chunks[t].bounds.begin(), chunks[t].bounds.end(), table->field_bounds.end() - chunks[t].bounds.size());
+	}
+	table->row_first_bound.push_back(table->field_bounds.size());
+}
+
+/**
+ * Release the contents of a CSV table
+ * @param "table" [type CsvTable*]: table
+ */
+void CloseCsvTable(CsvTable *table){
+#ifndef _WIN32
+	if (table->mapped) munmap((void *) table->data, table->size);
+#endif
+	if (!table->mapped) free((void *) table->data);
+	table->data = NULL;
+	table->row_start.clear();
+	table->row_end.clear();
+	table->row_line.clear();
+	table->row_first_bound.clear();
+	table->field_bounds.clear();
+	table->num_rows = 0;
+}
+
+/**
+ * Return a field of a row, as GetField() does with a line
+ * @param "table" [type CsvTable&]: table
+ * @param "row" [type int]: row index (0 is the first line after the header)
+ * @param "column" [type int]: column number (1-based, as the IX_* indexes)
+ * @param "length" [type int*]: length of the field, if not NULL
+ * @return "field" [type const char*]: first character of the field (not null-terminated), or NULL if it is
+ * empty or missing
+ */
+const char *CsvField(const CsvTable &table, int row, int column, int *length){
+	size_t first (table.row_first_bound[row]);
+	size_t num_fields (table.row_first_bound[row + 1] - first - 1);
+	if (column < 1 || (size_t) column > num_fields) return NULL;
+	size_t start (table.field_bounds[first + column - 1]);
+	size_t end (table.field_bounds[first + column] - 1);
+	if (end == start) return NULL;
+	if (length != NULL) *length = end - start;
+	return table.data + start;
+}
+
+/**
+ * Return whether a field of a row is present (i.e., not empty nor missing)
+ */
+bool CsvHasField(const CsvTable &table, int row, int column){
+	return CsvField(table, row, column, NULL) != NULL;
+}
+
+/**
+ * Exit reporting a missing mandatory field
+ */
+void CsvMissingField(const CsvTable &table, int row, int column){
+	printf("ERROR: %s, line %d: field %d is missing\n", table.filename.c_str(), table.row_line[row], column);
+	exit(-1);
+}
+
+/**
+ * Return a field as a string ("" if absent)
+ */
+std::string CsvFieldString(const CsvTable &table, int row, int column){
+	int length (0);
+	const char *field (CsvField(table, row, column, &length));
+	return field != NULL ? std::string(field, length) : std::string();
+}
+
+/**
+ * Return a mandatory field as an integer (parsed as atoi() does). Exits if the field is absent
+ */
+int CsvFieldInt(const CsvTable &table, int row, int column){
+	const char *field (CsvField(table, row, column, NULL));
+	if (field == NULL) CsvMissingField(table, row, column);
+	return atoi(field);
+}
+
+/**
+ * Return an optional field as an integer, or default_value if absent
+ */
+int CsvFieldInt(const CsvTable &table, int row, int column, int default_value){
+	const char *field (CsvField(table, row, column, NULL));
+	return field != NULL ? atoi(field) : default_value;
+}
+
+/**
+ * Return a mandatory field as a double (parsed as atof() does). Exits if the field is absent
+ */
+double CsvFieldDouble(const CsvTable &table, int row, int column){
+	const char *field (CsvField(table, row, column, NULL));
+	if (field == NULL) CsvMissingField(table, row, column);
+	return atof(field);
+}
+
+/**
+ * Return an optional field as a double, or default_value if absent
+ */
+double CsvFieldDouble(const CsvTable &table, int row, int column, double default_value){
+	const char *field (CsvField(table, row, column, NULL));
+	return field != NULL ? atof(field) : default_value;
+}
+
+#endif
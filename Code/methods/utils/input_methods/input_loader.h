@@ -55,382 +55,210 @@ void Komondor::GenerateNodesByReadingInputFile(const char *nodes_filename) {
     if (print_system_logs) printf("\n%s Generating nodes DETERMINISTICALLY through NODES input file...\n", LOG_LVL1);
     if (print_system_logs) printf("%s Reading nodes input file '%s'...\n", LOG_LVL2, nodes_filename);
 
+    // The file is tokenized once (see csv_table.h); the fields are then read in place
+    CsvTable nodes_table;
+    OpenCsvTable(nodes_filename, &nodes_table);
+
     // ---------------------------------------------------------
     // 1. WLAN IDENTIFICATION AND ALLOCATION
     // ---------------------------------------------------------
-    total_wlans_number = GetNumOfNodes(nodes_filename, NODE_TYPE_AP, ToString(""));
+    total_wlans_number = 0;
+    for (int r = 0; r < nodes_table.num_rows; ++r) {
+        if (CsvFieldInt(nodes_table, r, IX_NODE_TYPE) == NODE_TYPE_AP) ++total_wlans_number;
+    }
     if (print_system_logs) printf("%s Num. of WLANs detected: %d\n", LOG_LVL3, total_wlans_number);
 
     wlan_container = new Wlan[total_wlans_number];
 
-    FILE* stream_nodes = fopen(nodes_filename, "r");
-    if (!stream_nodes) {
-        printf("ERROR: Could not open input file: %s\n", nodes_filename);
-        exit(-1);
-    }
-
-    char line_nodes[CHAR_BUFFER_SIZE];
-    int first_line_skiped_flag = 0;
+    // WLANs of each code (one per AP, in order of appearance)
+    std::map<std::string, std::vector<int> > wlans_per_code;
     int wlan_ix = 0;
-    char* tmp_nodes = NULL;
-
-    // First Pass: Identify WLANs
-    while (fgets(line_nodes, CHAR_BUFFER_SIZE, stream_nodes)){
-        if(!first_line_skiped_flag){
-            first_line_skiped_flag = 1;
-        } else {
-            tmp_nodes = strdup(line_nodes);
-            int node_type = atoi(GetField(tmp_nodes, IX_NODE_TYPE));
-            
-            if(node_type == NODE_TYPE_AP){
-                wlan_container[wlan_ix].wlan_id = wlan_ix;
-                
-                free(tmp_nodes); // Free before reusing
-                tmp_nodes = strdup(line_nodes);
-                std::string wlan_code_aux = ToString(GetField(tmp_nodes, IX_WLAN_CODE));
-                
-                wlan_container[wlan_ix].wlan_code = wlan_code_aux;
-                wlan_container[wlan_ix].mapc_enabled = 0;
-                wlan_container[wlan_ix].num_mapc_groups = 0;
-                for (int mapc_g = 0; mapc_g < MAX_MAPC_GROUPS_PER_WLAN; ++mapc_g) {
-                    wlan_container[wlan_ix].mapc_group_ids[mapc_g] = 0;
-                    wlan_container[wlan_ix].mapc_method_ids[mapc_g] = 0;
-                    wlan_container[wlan_ix].mapc_num_peers[mapc_g] = 0;
-                    wlan_container[wlan_ix].mapc_peer_ap_ids[mapc_g] = NULL;
-                    wlan_container[wlan_ix].mapc_txop_splits[mapc_g] = TXOP_SPLIT_EQUAL;
-                    wlan_container[wlan_ix].mapc_sr_tx_power_dbm[mapc_g] = DEFAULT_COSR_TX_POWER_DBM;
-                }
-                ++wlan_ix;
+    for (int r = 0; r < nodes_table.num_rows; ++r) {
+        if (CsvFieldInt(nodes_table, r, IX_NODE_TYPE) == NODE_TYPE_AP) {
+            wlan_container[wlan_ix].wlan_id = wlan_ix;
+            wlan_container[wlan_ix].wlan_code = CsvFieldString(nodes_table, r, IX_WLAN_CODE);
+            wlan_container[wlan_ix].mapc_enabled = 0;
+            wlan_container[wlan_ix].num_mapc_groups = 0;
+            for (int mapc_g = 0; mapc_g < MAX_MAPC_GROUPS_PER_WLAN; ++mapc_g) {
+                wlan_container[wlan_ix].mapc_group_ids[mapc_g] = 0;
+                wlan_container[wlan_ix].mapc_method_ids[mapc_g] = 0;
+                wlan_container[wlan_ix].mapc_num_peers[mapc_g] = 0;
+                wlan_container[wlan_ix].mapc_peer_ap_ids[mapc_g] = NULL;
+                wlan_container[wlan_ix].mapc_txop_splits[mapc_g] = TXOP_SPLIT_EQUAL;
+                wlan_container[wlan_ix].mapc_sr_tx_power_dbm[mapc_g] = DEFAULT_COSR_TX_POWER_DBM;
             }
-            free(tmp_nodes);
+            wlans_per_code[wlan_container[wlan_ix].wlan_code].push_back(wlan_ix);
+            ++wlan_ix;
         }
     }
-    fclose(stream_nodes);
 
     // ---------------------------------------------------------
-    // 2. COUNT STAs PER WLAN
+    // 2. STAs PER WLAN (collected in file order, in the same pass)
     // ---------------------------------------------------------
+    std::vector< std::vector<int> > stas_per_wlan(total_wlans_number);
+    for (int r = 0; r < nodes_table.num_rows; ++r) {
+        if (CsvFieldInt(nodes_table, r, IX_NODE_TYPE) != NODE_TYPE_STA) continue;
+        std::map<std::string, std::vector<int> >::const_iterator it =
+            wlans_per_code.find(CsvFieldString(nodes_table, r, IX_WLAN_CODE));
+        if (it == wlans_per_code.end()) continue;
+        for (size_t i = 0; i < it->second.size(); ++i) stas_per_wlan[it->second[i]].push_back(r);
+    }
     for(int w = 0; w < total_wlans_number; ++w){
-        int num_stas_in_wlan = GetNumOfNodes(nodes_filename, NODE_TYPE_STA, wlan_container[w].wlan_code);
+        int num_stas_in_wlan = stas_per_wlan[w].size();
         wlan_container[w].num_stas = num_stas_in_wlan;
         wlan_container[w].SetSizeOfSTAsArray(num_stas_in_wlan);
+        for (int s = 0; s < num_stas_in_wlan; ++s) {
+            // Node IDs are assigned in row order
+            int sta_row (stas_per_wlan[w][s]);
+            wlan_container[w].list_sta_id[s]     = sta_row;
+            wlan_container[w].sta_min_channel[s] = CsvFieldInt(nodes_table, sta_row, IX_MIN_CH_ALLOWED);
+            wlan_container[w].sta_max_channel[s] = CsvFieldInt(nodes_table, sta_row, IX_MAX_CH_ALLOWED);
+        }
     }
 
     // ---------------------------------------------------------
-    // 3. NODE GENERATION (The part that was missing)
+    // 3. NODE GENERATION
     // ---------------------------------------------------------
     if (print_system_logs) printf("%s Generating nodes...\n", LOG_LVL3);
-    
-    total_nodes_number = GetNumOfNodes(nodes_filename, NODE_TYPE_UNKWNOW, ToString(""));
+
+    total_nodes_number = nodes_table.num_rows;
     node_container.SetSize(total_nodes_number);
     traffic_generator_container.SetSize(total_nodes_number);
 
-    stream_nodes = fopen(nodes_filename, "r");
-    int node_ix = 0;
-    first_line_skiped_flag = 0;
+    for (int node_ix = 0; node_ix < total_nodes_number; ++node_ix) {
 
-    while (fgets(line_nodes, CHAR_BUFFER_SIZE, stream_nodes)){
+        const int r (node_ix);
+        NodeParameters &params = node_container[node_ix].node_params;
 
-        if(!first_line_skiped_flag){
-            first_line_skiped_flag = 1;
-        } else {
-            // Node ID (auto-assigned)
-            node_container[node_ix].node_params.node_id = node_ix;
-
-            // Node code
-            tmp_nodes = strdup(line_nodes);
-            std::string node_code = ToString(GetField(tmp_nodes, IX_NODE_CODE));
-            node_container[node_ix].node_params.node_code = node_code;
-            free(tmp_nodes);
-
-            // Node type
-            tmp_nodes = strdup(line_nodes);
-            int node_type = atoi(GetField(tmp_nodes, IX_NODE_TYPE));
-            node_container[node_ix].node_params.node_type = node_type;
-            free(tmp_nodes);
-
-            // WLAN code & Linking
-            tmp_nodes = strdup(line_nodes);
-            const char *wlan_code_aux = GetField(tmp_nodes, IX_WLAN_CODE);
-            std::string wlan_code;
-            wlan_code.append(ToString(wlan_code_aux));
-            node_container[node_ix].node_params.wlan_code = wlan_code;
-            free(tmp_nodes);
-
-            // Read channel bounds early so they are available for the WLAN-STA link logic below.
-            // (node_params.min/max_channel_allowed are populated later in this loop, so we must
-            //  read directly from the CSV here to avoid storing stale zeros.)
-            int early_min_ch, early_max_ch;
-            {
-                char *tmp_ch = strdup(line_nodes);
-                early_min_ch = atoi(GetField(tmp_ch, IX_MIN_CH_ALLOWED));
-                free(tmp_ch);
-                tmp_ch = strdup(line_nodes);
-                early_max_ch = atoi(GetField(tmp_ch, IX_MAX_CH_ALLOWED));
-                free(tmp_ch);
-            }
+        // Node ID (auto-assigned)
+        params.node_id = node_ix;
 
-            // Link logic
-            for(int w = 0; w < total_wlans_number; ++w){
-                if(strcmp(wlan_code.c_str(), wlan_container[w].wlan_code.c_str()) == 0){
-                    if(node_container[node_ix].node_params.node_type == NODE_TYPE_AP){
-                        wlan_container[w].ap_id = node_container[node_ix].node_params.node_id;
-                    } else if (node_container[node_ix].node_params.node_type == NODE_TYPE_STA){
-                        for(int s = 0; s < wlan_container[w].num_stas; ++s){
-                            if(wlan_container[w].list_sta_id[s] == NODE_ID_NONE){
-                                wlan_container[w].list_sta_id[s]     = node_container[node_ix].node_params.node_id;
-                                wlan_container[w].sta_min_channel[s] = early_min_ch;
-                                wlan_container[w].sta_max_channel[s] = early_max_ch;
-                                break;
-                            }
-                        }
-                    }
-                }
-            }
+        // Node code, type and WLAN code
+        params.node_code = CsvFieldString(nodes_table, r, IX_NODE_CODE);
+        int node_type = CsvFieldInt(nodes_table, r, IX_NODE_TYPE);
+        params.node_type = node_type;
+        params.wlan_code = CsvFieldString(nodes_table, r, IX_WLAN_CODE);
 
-            // Position
-            tmp_nodes = strdup(line_nodes);
-            node_container[node_ix].node_params.x = atof(GetField(tmp_nodes, IX_POSITION_X));
-            free(tmp_nodes);
-            tmp_nodes = strdup(line_nodes);
-            node_container[node_ix].node_params.y = atof(GetField(tmp_nodes, IX_POSITION_Y));
-            free(tmp_nodes);
-            tmp_nodes = strdup(line_nodes);
-            node_container[node_ix].node_params.z = atof(GetField(tmp_nodes, IX_POSITION_Z));
-            free(tmp_nodes);
-
-            // Frequency
-            tmp_nodes = strdup(line_nodes);
-            const char* central_frequency_char = GetField(tmp_nodes, IX_CENTRAL_FREQ);
-            node_container[node_ix].node_params.central_frequency = atof(central_frequency_char) * pow(10,9);
-            free(tmp_nodes);
-
-            // Channel Bonding Model
-            tmp_nodes = strdup(line_nodes);
-            node_container[node_ix].node_params.current_dcb_policy = atoi(GetField(tmp_nodes, IX_CHANNEL_BONDING_MODEL));
-            free(tmp_nodes);
-
-            // Channels
-            tmp_nodes = strdup(line_nodes);
-            node_container[node_ix].node_params.current_primary_channel = atoi(GetField(tmp_nodes, IX_PRIMARY_CHANNEL));
-            free(tmp_nodes);
-            tmp_nodes = strdup(line_nodes);
-            node_container[node_ix].node_params.min_channel_allowed = atoi(GetField(tmp_nodes, IX_MIN_CH_ALLOWED));
-            free(tmp_nodes);
-            tmp_nodes = strdup(line_nodes);
-            node_container[node_ix].node_params.max_channel_allowed = atoi(GetField(tmp_nodes, IX_MAX_CH_ALLOWED));
-            free(tmp_nodes);
-
-            // Powers
-            tmp_nodes = strdup(line_nodes);
-            double tx_power_default_dbm = atof(GetField(tmp_nodes, IX_TX_POWER_DEFAULT));
-            node_container[node_ix].node_params.tx_power_default = ConvertPower(DBM_TO_PW, tx_power_default_dbm);
-            free(tmp_nodes);
-            
-            tmp_nodes = strdup(line_nodes);
-            double sensitivity_default_dbm = atoi(GetField(tmp_nodes, IX_PD_DEFAULT));
-            node_container[node_ix].node_params.sensitivity_default = ConvertPower(DBM_TO_PW, sensitivity_default_dbm);
-            free(tmp_nodes);
-
-            // Traffic
-            tmp_nodes = strdup(line_nodes);
-            const char* traffic_model_char = GetField(tmp_nodes, IX_TRAFFIC_MODEL);
-            int traffic_model_val = atoi(traffic_model_char);
-            free(tmp_nodes);
-
-            tmp_nodes = strdup(line_nodes);
-            const char* traffic_load_char = GetField(tmp_nodes, IX_TRAFFIC_LOAD);
-            double traffic_load_val = atof(traffic_load_char);
-            free(tmp_nodes);
-
-            // Packet Length
-            tmp_nodes = strdup(line_nodes);
-            node_container[node_ix].node_params.frame_length = atoi(GetField(tmp_nodes, IX_PACKET_LENGTH));
-            free(tmp_nodes);
-
-            // Aggregation
-            tmp_nodes = strdup(line_nodes);
-            node_container[node_ix].node_params.max_num_packets_aggregated = atoi(GetField(tmp_nodes, IX_NUM_PACKETS_AGG));
-            free(tmp_nodes);
-
-            // Capture Effect
-            tmp_nodes = strdup(line_nodes);
-            node_container[node_ix].node_params.capture_effect_model = atoi(GetField(tmp_nodes, IX_CAPTURE_EFFECT_MODEL));
-            free(tmp_nodes);
-            tmp_nodes = strdup(line_nodes);
-            node_container[node_ix].node_params.capture_effect = ConvertPower(DB_TO_LINEAR, atof(GetField(tmp_nodes, IX_CAPTURE_EFFECT_THR)));
-            free(tmp_nodes);
-
-            // PER & PIFS
-            tmp_nodes = strdup(line_nodes);
-            node_container[node_ix].node_params.constant_per = atof(GetField(tmp_nodes, IX_CONSTANT_PER));
-            free(tmp_nodes);
-            tmp_nodes = strdup(line_nodes);
-            node_container[node_ix].node_params.pifs_activated = atoi(GetField(tmp_nodes, IX_PIFS_ACTIVATED));
-            free(tmp_nodes);
-
-            // Backoff
-            tmp_nodes = strdup(line_nodes);
-            node_container[node_ix].node_params.backoff_type = atoi(GetField(tmp_nodes, IX_BACKOFF_TYPE));
-            free(tmp_nodes);
-            tmp_nodes = strdup(line_nodes);
-            node_container[node_ix].node_params.cw_adaptation = atoi(GetField(tmp_nodes, IX_CW_ADAPTATION_FLAG));
-            free(tmp_nodes);
-            tmp_nodes = strdup(line_nodes);
-            node_container[node_ix].node_params.cw_min_default = atoi(GetField(tmp_nodes, IX_CW_MIN_DEFAULT));
-            free(tmp_nodes);
-            tmp_nodes = strdup(line_nodes);
-            node_container[node_ix].node_params.cw_max_default = atoi(GetField(tmp_nodes, IX_CW_MAX_DEFAULT));
-            free(tmp_nodes);
-            tmp_nodes = strdup(line_nodes);
-            node_container[node_ix].node_params.cw_stage_max = atoi(GetField(tmp_nodes, IX_CW_STAGE_MAX));
-            free(tmp_nodes);
-
-			// RTS/CTS mode
-            tmp_nodes = strdup(line_nodes);
-            const char* rts_cts_char = GetField(tmp_nodes, IX_RTS_CTS_ENABLED);
-            node_container[node_ix].node_params.rts_cts_enabled = (rts_cts_char != NULL) ? atoi(rts_cts_char) : TRUE;
-            free(tmp_nodes);
-
-            // Spatial Reuse
-            tmp_nodes = strdup(line_nodes);
-            const char* bss_color_char = GetField(tmp_nodes, IX_BSS_COLOR);
-            if (bss_color_char != NULL) {
-                node_container[node_ix].node_params.bss_color = atoi(bss_color_char);
-                free(tmp_nodes);
-
-                tmp_nodes = strdup(line_nodes);
-                { const char* srg_char = GetField(tmp_nodes, IX_SRG);
-                  node_container[node_ix].node_params.srg = (srg_char != NULL) ? atoi(srg_char) : -1; }
-                free(tmp_nodes);
-
-                tmp_nodes = strdup(line_nodes);
-                { const char* obss_char = GetField(tmp_nodes, IX_NON_SRG_OBSS_PD);
-                  node_container[node_ix].node_params.non_srg_obss_pd = (obss_char != NULL) ? ConvertPower(DBM_TO_PW, atof(obss_char)) : -1; }
-                free(tmp_nodes);
-
-                tmp_nodes = strdup(line_nodes);
-                { const char* srg_obss_char = GetField(tmp_nodes, IX_SRG_OBSS_PD);
-                  node_container[node_ix].node_params.srg_obss_pd = (srg_obss_char != NULL) ? ConvertPower(DBM_TO_PW, atof(srg_obss_char)) : -1; }
-                free(tmp_nodes);
-            } else {
-                node_container[node_ix].node_params.bss_color = -1;
-                node_container[node_ix].node_params.srg = -1;
-                node_container[node_ix].node_params.non_srg_obss_pd = -1;
-                node_container[node_ix].node_params.srg_obss_pd = -1;
-                free(tmp_nodes);
-            }
+        // AP of its WLAN(s)
+        if (node_type == NODE_TYPE_AP) {
+            std::map<std::string, std::vector<int> >::const_iterator it = wlans_per_code.find(params.wlan_code);
+            for (size_t i = 0; i < it->second.size(); ++i) wlan_container[it->second[i]].ap_id = node_ix;
+        }
 
-            // Beamforming (optional columns)
-            tmp_nodes = strdup(line_nodes);
-            const char* bf_enabled_char = GetField(tmp_nodes, IX_BF_ENABLED);
-            if (bf_enabled_char != NULL) {
-                node_container[node_ix].node_params.beamforming_enabled = atoi(bf_enabled_char);
-                free(tmp_nodes);
-                tmp_nodes = strdup(line_nodes);
-                { const char* _f = GetField(tmp_nodes, IX_BF_N_ELEMENTS);
-                  node_container[node_ix].node_params.beam_N_elements = (_f != NULL) ? atoi(_f) : DEFAULT_BEAM_N_ELEMENTS; }
-                free(tmp_nodes);
-                tmp_nodes = strdup(line_nodes);
-                { const char* _f = GetField(tmp_nodes, IX_BF_D_SPACING);
-                  node_container[node_ix].node_params.beam_d_spacing = (_f != NULL) ? atof(_f) : DEFAULT_BEAM_D_SPACING; }
-                free(tmp_nodes);
-                tmp_nodes = strdup(line_nodes);
-                { const char* _f = GetField(tmp_nodes, IX_BF_AZ_MAIN_DEG);
-                  node_container[node_ix].node_params.beam_az_main_deg = (_f != NULL) ? atof(_f) : 0.0; }
-                free(tmp_nodes);
-            } else {
-                node_container[node_ix].node_params.beamforming_enabled = BEAMFORMING_DISABLED;
-                node_container[node_ix].node_params.beam_N_elements     = DEFAULT_BEAM_N_ELEMENTS;
-                node_container[node_ix].node_params.beam_d_spacing      = DEFAULT_BEAM_D_SPACING;
-                node_container[node_ix].node_params.beam_az_main_deg    = 0.0;
-                free(tmp_nodes);
-            }
+        // Position
+        params.x = CsvFieldDouble(nodes_table, r, IX_POSITION_X);
+        params.y = CsvFieldDouble(nodes_table, r, IX_POSITION_Y);
+        params.z = CsvFieldDouble(nodes_table, r, IX_POSITION_Z);
+
+        // Frequency
+        params.central_frequency = CsvFieldDouble(nodes_table, r, IX_CENTRAL_FREQ) * pow(10,9);
+
+        // Channel Bonding Model
+        params.current_dcb_policy = CsvFieldInt(nodes_table, r, IX_CHANNEL_BONDING_MODEL);
+
+        // Channels
+        params.current_primary_channel = CsvFieldInt(nodes_table, r, IX_PRIMARY_CHANNEL);
+        params.min_channel_allowed = CsvFieldInt(nodes_table, r, IX_MIN_CH_ALLOWED);
+        params.max_channel_allowed = CsvFieldInt(nodes_table, r, IX_MAX_CH_ALLOWED);
+
+        // Powers (the sensitivity is read as an integer number of dBm)
+        double tx_power_default_dbm = CsvFieldDouble(nodes_table, r, IX_TX_POWER_DEFAULT);
+        params.tx_power_default = ConvertPower(DBM_TO_PW, tx_power_default_dbm);
+        double sensitivity_default_dbm = CsvFieldInt(nodes_table, r, IX_PD_DEFAULT);
+        params.sensitivity_default = ConvertPower(DBM_TO_PW, sensitivity_default_dbm);
+
+        // Traffic
+        int traffic_model_val = CsvFieldInt(nodes_table, r, IX_TRAFFIC_MODEL);
+        double traffic_load_val = CsvFieldDouble(nodes_table, r, IX_TRAFFIC_LOAD);
+
+        // Packet Length
+        params.frame_length = CsvFieldInt(nodes_table, r, IX_PACKET_LENGTH);
+
+        // Aggregation
+        params.max_num_packets_aggregated = CsvFieldInt(nodes_table, r, IX_NUM_PACKETS_AGG);
+
+        // Capture Effect
+        params.capture_effect_model = CsvFieldInt(nodes_table, r, IX_CAPTURE_EFFECT_MODEL);
+        params.capture_effect = ConvertPower(DB_TO_LINEAR, CsvFieldDouble(nodes_table, r, IX_CAPTURE_EFFECT_THR));
+
+        // PER & PIFS
+        params.constant_per = CsvFieldDouble(nodes_table, r, IX_CONSTANT_PER);
+        params.pifs_activated = CsvFieldInt(nodes_table, r, IX_PIFS_ACTIVATED);
+
+        // Backoff
+        params.backoff_type = CsvFieldInt(nodes_table, r, IX_BACKOFF_TYPE);
+        params.cw_adaptation = CsvFieldInt(nodes_table, r, IX_CW_ADAPTATION_FLAG);
+        params.cw_min_default = CsvFieldInt(nodes_table, r, IX_CW_MIN_DEFAULT);
+        params.cw_max_default = CsvFieldInt(nodes_table, r, IX_CW_MAX_DEFAULT);
+        params.cw_stage_max = CsvFieldInt(nodes_table, r, IX_CW_STAGE_MAX);
+
+        // RTS/CTS mode
+        params.rts_cts_enabled = CsvFieldInt(nodes_table, r, IX_RTS_CTS_ENABLED, TRUE);
+
+        // Spatial Reuse
+        if (CsvHasField(nodes_table, r, IX_BSS_COLOR)) {
+            params.bss_color = CsvFieldInt(nodes_table, r, IX_BSS_COLOR);
+            params.srg = CsvFieldInt(nodes_table, r, IX_SRG, -1);
+            params.non_srg_obss_pd = CsvHasField(nodes_table, r, IX_NON_SRG_OBSS_PD) ?
+                ConvertPower(DBM_TO_PW, CsvFieldDouble(nodes_table, r, IX_NON_SRG_OBSS_PD)) : -1;
+            params.srg_obss_pd = CsvHasField(nodes_table, r, IX_SRG_OBSS_PD) ?
+                ConvertPower(DBM_TO_PW, CsvFieldDouble(nodes_table, r, IX_SRG_OBSS_PD)) : -1;
+        } else {
+            params.bss_color = -1;
+            params.srg = -1;
+            params.non_srg_obss_pd = -1;
+            params.srg_obss_pd = -1;
+        }
 
-            // EDCA traffic type / access category (optional column, defaults to AC_BE)
-            tmp_nodes = strdup(line_nodes);
-            const char* traffic_type_char = GetField(tmp_nodes, IX_TRAFFIC_TYPE);
-            node_container[node_ix].node_params.traffic_type =
-                (traffic_type_char != NULL) ? atoi(traffic_type_char) : DEFAULT_TRAFFIC_TYPE;
-            free(tmp_nodes);
-
-            // DSO: Dynamic Subband Operation enable flag (optional column 37)
-            tmp_nodes = strdup(line_nodes);
-            const char* dso_enabled_char = GetField(tmp_nodes, IX_DSO_ENABLED);
-            node_container[node_ix].node_params.dso_enabled =
-                (dso_enabled_char != NULL) ? atoi(dso_enabled_char) : FALSE;
-            free(tmp_nodes);
-
-            // NPCA: optional columns 38-43
-            tmp_nodes = strdup(line_nodes);
-            const char* npca_en_char = GetField(tmp_nodes, IX_NPCA_ENABLED);
-            node_container[node_ix].node_params.npca_enabled =
-                (npca_en_char != NULL) ? atoi(npca_en_char) : FALSE;
-            free(tmp_nodes);
-
-            tmp_nodes = strdup(line_nodes);
-            const char* npca_pch_char = GetField(tmp_nodes, IX_NPCA_PRIMARY_CH);
-            node_container[node_ix].node_params.npca_primary_channel =
-                (npca_pch_char != NULL) ? atoi(npca_pch_char) : -1;
-            free(tmp_nodes);
-
-            tmp_nodes = strdup(line_nodes);
-            const char* npca_mdt_char = GetField(tmp_nodes, IX_NPCA_MIN_DUR_THRESHOLD);
-            node_container[node_ix].node_params.npca_min_dur_threshold_us =
-                (npca_mdt_char != NULL) ? atoi(npca_mdt_char) : NPCA_MIN_DUR_THRESHOLD_DEFAULT_US;
-            free(tmp_nodes);
-
-            tmp_nodes = strdup(line_nodes);
-            const char* npca_sd_char = GetField(tmp_nodes, IX_NPCA_SWITCHING_DELAY);
-            node_container[node_ix].node_params.npca_switching_delay_us =
-                (npca_sd_char != NULL) ? atoi(npca_sd_char) : NPCA_SWITCHING_DELAY_DEFAULT_US;
-            free(tmp_nodes);
-
-            tmp_nodes = strdup(line_nodes);
-            const char* npca_sbd_char = GetField(tmp_nodes, IX_NPCA_SWITCH_BACK_DELAY);
-            node_container[node_ix].node_params.npca_switch_back_delay_us =
-                (npca_sbd_char != NULL) ? atoi(npca_sbd_char) : NPCA_SWITCH_BACK_DELAY_DEFAULT_US;
-            free(tmp_nodes);
-
-            tmp_nodes = strdup(line_nodes);
-            const char* npca_qsrc_char = GetField(tmp_nodes, IX_NPCA_INIT_QSRC);
-            node_container[node_ix].node_params.npca_init_qsrc =
-                (npca_qsrc_char != NULL) ? atoi(npca_qsrc_char) : NPCA_INIT_QSRC_DEFAULT;
-            free(tmp_nodes);
-
-            // Global Models
-            node_container[node_ix].node_params.simulation_time_komondor = simulation_time_komondor;
-            node_container[node_ix].node_params.total_wlans_number = total_wlans_number;
-            node_container[node_ix].node_params.total_nodes_number = total_nodes_number;
-            node_container[node_ix].node_params.collisions_model = collisions_model;
-            node_container[node_ix].node_params.save_node_logs = save_node_logs;
-            node_container[node_ix].node_params.print_node_logs = print_node_logs;
-            node_container[node_ix].node_params.adjacent_channel_model = adjacent_channel_model;
-            node_container[node_ix].node_params.path_loss_model = path_loss_model;
-            node_container[node_ix].node_params.pdf_tx_time = pdf_tx_time;
-            node_container[node_ix].node_params.simulation_code = simulation_code;
-
-            // Traffic Generator
-            traffic_generator_container[node_ix].node_type = node_type;
-            traffic_generator_container[node_ix].node_id = node_ix;
-            traffic_generator_container[node_ix].traffic_model = traffic_model_val;
-            node_container[node_ix].node_params.traffic_model = traffic_model_val;
-            traffic_generator_container[node_ix].traffic_load = traffic_load_val;
-
-            ++node_ix;
+        // Beamforming (optional columns)
+        if (CsvHasField(nodes_table, r, IX_BF_ENABLED)) {
+            params.beamforming_enabled = CsvFieldInt(nodes_table, r, IX_BF_ENABLED);
+            params.beam_N_elements = CsvFieldInt(nodes_table, r, IX_BF_N_ELEMENTS, DEFAULT_BEAM_N_ELEMENTS);
+            params.beam_d_spacing = CsvFieldDouble(nodes_table, r, IX_BF_D_SPACING, DEFAULT_BEAM_D_SPACING);
+            params.beam_az_main_deg = CsvFieldDouble(nodes_table, r, IX_BF_AZ_MAIN_DEG, 0.0);
+        } else {
+            params.beamforming_enabled = BEAMFORMING_DISABLED;
+            params.beam_N_elements     = DEFAULT_BEAM_N_ELEMENTS;
+            params.beam_d_spacing      = DEFAULT_BEAM_D_SPACING;
+            params.beam_az_main_deg    = 0.0;
         }
+
+        // EDCA traffic type / access category (optional column, defaults to AC_BE)
+        params.traffic_type = CsvFieldInt(nodes_table, r, IX_TRAFFIC_TYPE, DEFAULT_TRAFFIC_TYPE);
+
+        // DSO: Dynamic Subband Operation enable flag (optional column 37)
+        params.dso_enabled = CsvFieldInt(nodes_table, r, IX_DSO_ENABLED, FALSE);
+
+        // NPCA: optional columns 38-43
+        params.npca_enabled = CsvFieldInt(nodes_table, r, IX_NPCA_ENABLED, FALSE);
+        params.npca_primary_channel = CsvFieldInt(nodes_table, r, IX_NPCA_PRIMARY_CH, -1);
+        params.npca_min_dur_threshold_us =
+            CsvFieldInt(nodes_table, r, IX_NPCA_MIN_DUR_THRESHOLD, NPCA_MIN_DUR_THRESHOLD_DEFAULT_US);
+        params.npca_switching_delay_us =
+            CsvFieldInt(nodes_table, r, IX_NPCA_SWITCHING_DELAY, NPCA_SWITCHING_DELAY_DEFAULT_US);
+        params.npca_switch_back_delay_us =
+            CsvFieldInt(nodes_table, r, IX_NPCA_SWITCH_BACK_DELAY, NPCA_SWITCH_BACK_DELAY_DEFAULT_US);
+        params.npca_init_qsrc = CsvFieldInt(nodes_table, r, IX_NPCA_INIT_QSRC, NPCA_INIT_QSRC_DEFAULT);
+
+        // Traffic Generator
+        traffic_generator_container[node_ix].node_type = node_type;
+        traffic_generator_container[node_ix].traffic_model = traffic_model_val;
+        params.traffic_model = traffic_model_val;
+        traffic_generator_container[node_ix].traffic_load = traffic_load_val;
+
+        // Console options, system models and random streams
+        SetNodeRunParameters(node_ix);
     }
-    fclose(stream_nodes);
+
+    CloseCsvTable(&nodes_table);
 
     // ---------------------------------------------------------
-    // 4. FINAL LINKING
+    // 4. FINAL LINKING (the last WLAN of its code, if several)
     // ---------------------------------------------------------
     for(int n = 0; n < total_nodes_number; ++n){
-        for(int w = 0; w < total_wlans_number; ++w){
-            if (strcmp(node_container[n].node_params.wlan_code.c_str(), wlan_container[w].wlan_code.c_str()) == 0) {
-                node_container[n].wlan = wlan_container[w];
-            }
-        }
+        std::map<std::string, std::vector<int> >::const_iterator it =
+            wlans_per_code.find(node_container[n].node_params.wlan_code);
+        if (it != wlans_per_code.end()) node_container[n].wlan = wlan_container[it->second.back()];
     }
 
     if (print_system_logs) printf("%s Nodes generated!\n", LOG_LVL3);
@@ -482,66 +310,6 @@ int Komondor :: GetNumOfLines(const char *filename){
 	return num_lines;
 }
 
-/**
- * Return the number of nodes of a given type (0: AP, 1: STA, 2: Free Node)
- * @param "nodes_filename" [type char*]: nodes configuration filename
- * @param "node_type" [type int]: type of node to consider in the counting
- * @param "wlan_code" [type std::string]: code of the wlan to consider in the counting
- * @return "num_nodes" [type int]: number of nodes of the introduced type in the indicated WLAN
- */
-int Komondor :: GetNumOfNodes(const char *nodes_filename, int node_type, std::string wlan_code){
-
-	int num_nodes(0);
-	char line_nodes[CHAR_BUFFER_SIZE];
-	char* tmp_nodes;
-	first_line_skiped_flag = 0;
-	int type_found;
-	std::string wlan_code_found;
-
-	FILE* stream_nodes = fopen(nodes_filename, "r");
-
-	if (!stream_nodes){
-		printf("[MAIN] ERROR: Nodes configuration file %s not found!\n", nodes_filename);
-		exit(-1);
-	}
-
-	if(node_type == NODE_TYPE_UNKWNOW){	// Count all type of nodes
-
-		num_nodes = GetNumOfLines(nodes_filename);
-
-	} else {	// Count specific nodes
-
-		while (fgets(line_nodes, CHAR_BUFFER_SIZE, stream_nodes)){
-
-			if(!first_line_skiped_flag){
-
-				first_line_skiped_flag = 1;
-
-			} else{
-
-				// Node type
-				tmp_nodes = strdup(line_nodes);
-				type_found = atof(GetField(tmp_nodes, IX_NODE_TYPE));
-				free(tmp_nodes);
-
-				// WLAN code
-				tmp_nodes = strdup(line_nodes);
-				wlan_code_found = ToString(GetField(tmp_nodes, IX_WLAN_CODE));
-				free(tmp_nodes);
-
-				if(wlan_code.compare(ToString("")) > 0){
-					if(type_found == node_type && strcmp(wlan_code_found.c_str(), wlan_code.c_str()) == 0) ++num_nodes;
-				} else {
-					if(type_found == node_type) ++num_nodes;
-				}
-			}
-		}
-	}
-
-	fclose(stream_nodes);
-	return num_nodes;
-}
-
 /**
 * Generate the MAPC configuration, according to the MAPC config file
  * @param "mapc_filename" [type char*]: filename of the MAPC input CSV
@@ -781,6 +549,7 @@ void Komondor :: GenerateAgents(const char *agents_filename, const char *simulat
 			} else {
 				// Agent ID
 				agent_container[agent_ix].agent_id = agent_ix;
+				agent_container[agent_ix].random_stream.Seed(seed, RANDOM_STREAM_AGENT, agent_ix);
 				agent_container[agent_ix].wlan_code = wlan_code.c_str();
 				// WLAN Id — skip agent if no matching WLAN exists (prevents null outport crash)
 				int wlan_found_flag(0);
@@ -925,6 +694,7 @@ void Komondor :: GenerateCentralController(const char *agents_filename) {
 	if (central_controller_flag) central_controller.SetSize(1);
 	if (total_controlled_agents_number > 0) {	// Check that the CC has one or more agents attached
 		central_controller[0].controller_on = TRUE;
+		central_controller[0].random_stream.Seed(seed, RANDOM_STREAM_CONTROLLER, 0);
 		central_controller[0].agents_number = total_controlled_agents_number;
 		central_controller[0].wlans_number = total_wlans_number;
 		int max_number_of_actions(0);
@@ -0,0 +1,94 @@
+/* Kom8ndor IEEE 802.11bn Simulator
+ *
+ * Copyright (c) 2026, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ */
+
+/**
+ * ml_transport_methods.h: transport between the agents and the external ML servers (--ml-transport), and latency of
+ * the decisions of the agents (--decision-latency).
+ *
+ * With the socket transport (default), every agent using LEARNING_MECHANISM_EXTERNAL opens its own connection
+ * and waits for the answer to each of its queries. With the shared-memory transport, the simulation opens a single
+ * ExternalModelBatch per socket path, shared by all the agents using it, so that the requests of the agents that
+ * decide at the same simulated instant reach the server as one batch (see external_model_batch.h).
+ *
+ * With a decision latency, every agent issues its decision request when it receives the report of its AP, and the
+ * decision is applied (i.e., sent to the AP) that simulated time later, as it would be by a real controller. The
+ * simulation goes on meanwhile, and so does the external model, which only has to answer by then.
+ */
+
+#include <string.h>
+#include <vector>
+
+#include "../../list_of_macros.h"
+#include "../../learning_modules/external_model_batch.h"
+
+#ifndef _ML_TRANSPORT_METHODS_
+#define _ML_TRANSPORT_METHODS_
+
+/**
+ * Set up the decisions of the agents (called before Setup())
+ * @param "ml_transport_console" [type int]: transport to the external ML servers (ML_TRANSPORT_SOCKET or
+ *   ML_TRANSPORT_SHM)
+ * @param "decision_latency_console" [type double]: time between a decision request and its application [s]
+ *   (0: the decisions are applied as soon as they are requested)
+ */
+void Komondor :: SetupAgentDecisions(int ml_transport_console, double decision_latency_console){
+	ml_transport = ml_transport_console;
+	decision_latency = decision_latency_console;
+}
+
+/**
+ * Give every agent its decision latency and, with the shared-memory transport, the batch of its socket path
+ * (one per path, opened here). Called once the agents are generated, before they start
+ */
+void Komondor :: ConnectAgentDecisions(){
+	for (int a = 0; a < total_agents_number; ++a) {
+		agent_container[a].decision_latency = decision_latency;
+		if (ml_transport != ML_TRANSPORT_SHM
+				|| agent_container[a].learning_mechanism != LEARNING_MECHANISM_EXTERNAL) continue;
+		ExternalModelBatch *batch = NULL;
+		for (size_t b = 0; b < external_model_batches.size(); ++b) {
+			if (strcmp(external_model_batches[b]->socket_path.c_str(), agent_container[a].external_socket_path) == 0) {
+				batch = external_model_batches[b];
+			}
+		}
+		if (batch == NULL) {
+			batch = new ExternalModelBatch;
+			batch->Open(agent_container[a].external_socket_path);
+			external_model_batches.push_back(batch);
+		}
+		agent_container[a].external_model_batch = batch;
+	}
+}
+
+/**
+ * Close the shared batches and report how the requests were grouped (called when the simulation is done)
+ */
+void Komondor :: CloseExternalModelBatches(){
+	for (size_t b = 0; b < external_model_batches.size(); ++b) {
+		ExternalModelBatch *batch = external_model_batches[b];
+		batch->Close();
+		if (print_system_logs) {
+			printf("\n%s External model %s (shm): %lld requests in %lld batches (%.2f per batch, %d at most)",
+				LOG_LVL2, batch->socket_path.c_str(), batch->num_requests, batch->num_batches,
+				batch->num_batches > 0 ? (double) batch->num_requests / batch->num_batches : 0,
+				batch->max_batch_size);
+		}
+		delete batch;
+	}
+	external_model_batches.clear();
+}
+
+#endif
@@ -90,12 +90,14 @@ void ComputeSimulationStatistics(SimulationStats &stats, Performance *performanc
 
 /**
 * Print and write global statistics to console and log file.
+* @param "partition_enabled" [type int]: the network was split into logical processes (--partition), so that
+*   node 0, which monitors the channel idle time, only senses the nodes of its own
 * @param "stats" [type const SimulationStats&]: pre-computed aggregated metrics
 */
 void PrintAndWriteSimulationStatistics(int print_system_logs, int save_system_logs,
 		Logger &logger_simulation, Performance *performance_report,
 		Configuration *configuration_per_node, int total_nodes_number,
-		int total_wlans_number, double simulation_time_komondor,
+		int total_wlans_number, double simulation_time_komondor, int partition_enabled,
 		const SimulationStats &stats) {
 
 	if (print_system_logs) {
@@ -130,9 +132,13 @@ void PrintAndWriteSimulationStatistics(int print_system_logs, int save_system_lo
 			LOG_LVL3, stats.av_expected_waiting_time * pow(10,3));
 		printf("%s Average bandwidth used for transmitting = %.2f MHz\n",
 			LOG_LVL2, stats.total_bandiwdth_tx / (double) total_wlans_number);
-		printf("%s Time channel was idle = %.2f s (%f%%)\n",  LOG_LVL2,
-			performance_report[0].sum_time_channel_idle,
-			(100 * performance_report[0].sum_time_channel_idle / simulation_time_komondor));
+		if (partition_enabled) {
+			printf("%s Time channel was idle = n/a (partitioned run: no node senses the whole network)\n", LOG_LVL2);
+		} else {
+			printf("%s Time channel was idle = %.2f s (%f%%)\n",  LOG_LVL2,
+				performance_report[0].sum_time_channel_idle,
+				(100 * performance_report[0].sum_time_channel_idle / simulation_time_komondor));
+		}
 		printf("\n\n");
 	}
 
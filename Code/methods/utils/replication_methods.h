@@ -0,0 +1,327 @@
+/* Kom8ndor IEEE 802.11bn Simulator
+ *
+ * Copyright (c) 2026, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ */
+
+/**
+ * replication_methods.h: batch of independent replications of the same scenario, run concurrently
+ * in a single process (one simulation engine per thread), and aggregation of their results.
+ *
+ * Replication "r" is simulated with seed "seed + r" and simulation code "<code>_R<r>". The engine
+ * instance is kept per thread and every component draws from its own random number stream (see
+ * COST/cost.h), while input parsing and output writing are serialized through "simulation_output_mutex".
+ */
+
+#include <pthread.h>
+#include <math.h>
+#include <string>
+
+#include "../../list_of_macros.h"
+
+#ifndef _REPLICATION_METHODS_
+#define _REPLICATION_METHODS_
+
+/**
+ * Arguments and results of a batch of replications
+ */
+struct ReplicationBatch
+{
+	// Simulation arguments (shared by all the replications)
+	double sim_time;
+	int save_node_logs;
+	int save_agent_logs;
+	int print_system_logs;
+	int print_node_logs;
+	int print_agent_logs;
+	std::string nodes_input_filename;
+	std::string script_output_filename;
+	std::string simulation_code;
+	int seed;
+	int agents_enabled;
+	std::string agents_input_filename;
+	int mapc_enabled;
+	std::string mapc_input_filename;
+	double neighbour_margin;
+	int partition_enabled;
+	int lazy_backoff;
+	int slotted;
+	std::string scheduler;
+	std::string profile_filename;	///> Engine profile (empty: no profiling), one file per replication
+	double warmup;					///> Statistics cleared at this time (0: not cleared)
+	double steady_state;			///> Target relative half-width of the CIs of the steady-state detection (0: none)
+	double observation_period;		///> Time between two observations of the network (steady-state detection)
+	int ml_transport;				///> Transport to the external ML servers (--ml-transport)
+	double decision_latency;		///> Time between a decision request of an agent and its application [s]
+	std::string frame_trace_filename;	///> Frame trace (empty: no trace), one file per replication
+	std::string scenario_filename;	///> Scenario snapshot loaded instead of the input files (empty: none)
+	double checkpoint_time;			///> First checkpoint (0: after the first period)
+	double checkpoint_period;		///> Time between two checkpoints (0: a single one)
+	std::string checkpoint_filename;	///> File of the checkpoints (empty: none), one file per replication
+	std::string restore_filename;	///> Checkpoint resumed from (empty: none), one file per replication
+
+	// Replications
+	int num_replications;		///> Number of replications to be simulated
+	int next_replication;		///> Next replication to be picked by a worker thread
+	pthread_mutex_t mutex;		///> Protects "next_replication" and the results
+
+	// Results (per replication and node, stored as [r * total_nodes_number + n])
+	int total_nodes_number;		///> Number of nodes (0 until the first replication is set up)
+	std::string *node_codes;	///> Code of each node
+	int *node_types;			///> Type of each node
+	double *throughput;			///> Throughput [bps]
+	double *average_delay;		///> Average delay [s]
+	double *packets_lost_ratio;	///> Ratio of data packets lost
+};
+
+/**
+ * Two-sided 95% quantile of the Student's t distribution
+ * @param "degrees_of_freedom" [type int]: degrees of freedom
+ * @return "t" [type double]: quantile
+ */
+double StudentT95(int degrees_of_freedom){
+	static const double T95[30] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+		2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+		2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+	if (degrees_of_freedom < 1) return 0;
+	if (degrees_of_freedom <= 30) return T95[degrees_of_freedom - 1];
+	return 1.960;
+}
+
+/**
+ * Compute the mean and the half-width of the 95% confidence interval of a metric across replications
+ * @param "values" [type double*]: values of the metric, stored as [r * stride + offset]
+ * @param "num_replications" [type int]: number of replications
+ * @param "stride" [type int]: distance between the values of consecutive replications
+ * @param "offset" [type int]: position of the value within each replication
+ * @param "mean" [type double*]: mean (output)
+ * @param "ci" [type double*]: half-width of the confidence interval (output)
+ */
+void ComputeConfidenceInterval(double *values, int num_replications, int stride, int offset,
+		double *mean, double *ci){
+	double sum (0), sum_squared_deviations (0);
+	for (int r = 0; r < num_replications; ++r) sum += values[r * stride + offset];
+	*mean = sum / num_replications;
+	for (int r = 0; r < num_replications; ++r) {
+		sum_squared_deviations += pow(values[r * stride + offset] - *mean, 2);
+	}
+	*ci = 0;
+	if (num_replications > 1) {
+		*ci = StudentT95(num_replications - 1) * sqrt(sum_squared_deviations / (num_replications - 1))
+			/ sqrt((double) num_replications);
+	}
+}
+
+/**
+ * Name of the file of a replication: "<name>_R<r>.<extension>"
+ * @param "filename" [type std::string]: file name of the batch (empty if not used)
+ * @param "r" [type int]: index of the replication
+ * @return "replication_filename" [type std::string]: file name of the replication (empty if not used)
+ */
+std::string ReplicationFilename(const std::string &filename, int r){
+	if (filename.empty()) return filename;
+	char suffix[16];
+	snprintf(suffix, sizeof(suffix), "_R%d", r);
+	size_t extension = filename.rfind('.');
+	size_t directory = filename.rfind('/');
+	if (extension == std::string::npos || (directory != std::string::npos && extension < directory)) {
+		extension = filename.size();
+	}
+	return filename.substr(0, extension) + suffix + filename.substr(extension);
+}
+
+/**
+ * Simulate a replication and store its results
+ * @param "batch" [type ReplicationBatch*]: batch of replications
+ * @param "r" [type int]: index of the replication
+ */
+template <class SIMULATION>
+void RunReplication(ReplicationBatch *batch, int r){
+
+	char simulation_code[256];
+	snprintf(simulation_code, sizeof(simulation_code), "%s_R%d", batch->simulation_code.c_str(), r);
+
+	SIMULATION *komondor_simulation = new SIMULATION;
+	komondor_simulation->Seed = batch->seed + r;
+	komondor_simulation->Scheduler(batch->scheduler.c_str());
+	komondor_simulation->StopTime(batch->sim_time);
+	std::string profile_filename = ReplicationFilename(batch->profile_filename, r);
+	if (!profile_filename.empty()) komondor_simulation->Profile(profile_filename.c_str());
+	komondor_simulation->SetupSteadyState(batch->warmup, batch->steady_state, batch->observation_period);
+	komondor_simulation->SetupAgentDecisions(batch->ml_transport, batch->decision_latency);
+	std::string frame_trace_filename = ReplicationFilename(batch->frame_trace_filename, r);
+
+	pthread_mutex_lock(&simulation_output_mutex);
+	komondor_simulation->Setup(batch->sim_time, batch->save_node_logs, batch->save_agent_logs,
+		batch->print_system_logs, batch->print_node_logs, batch->print_agent_logs,
+		batch->nodes_input_filename.c_str(), batch->script_output_filename.c_str(), simulation_code,
+		batch->seed + r, batch->agents_enabled, batch->agents_input_filename.c_str(),
+		batch->mapc_enabled, batch->mapc_input_filename.c_str(), batch->neighbour_margin,
+		batch->partition_enabled, batch->lazy_backoff, batch->slotted, frame_trace_filename.c_str(),
+		batch->scenario_filename.c_str());
+	pthread_mutex_unlock(&simulation_output_mutex);
+	komondor_simulation->SetupCheckpoints(batch->checkpoint_time, batch->checkpoint_period,
+		ReplicationFilename(batch->checkpoint_filename, r).c_str(), ReplicationFilename(batch->restore_filename, r).c_str());
+
+	komondor_simulation->Run();
+
+	// Collect the results
+	pthread_mutex_lock(&batch->mutex);
+	int total_nodes_number = komondor_simulation->total_nodes_number;
+	if (batch->total_nodes_number == 0) {
+		batch->total_nodes_number = total_nodes_number;
+		batch->node_codes = new std::string[total_nodes_number];
+		batch->node_types = new int[total_nodes_number];
+		batch->throughput = new double[batch->num_replications * total_nodes_number];
+		batch->average_delay = new double[batch->num_replications * total_nodes_number];
+		batch->packets_lost_ratio = new double[batch->num_replications * total_nodes_number];
+		for (int n = 0; n < total_nodes_number; ++n) {
+			batch->node_codes[n] = komondor_simulation->node_container[n].node_params.node_code;
+			batch->node_types[n] = komondor_simulation->node_container[n].node_params.node_type;
+		}
+	}
+	for (int n = 0; n < total_nodes_number; ++n) {
+		Performance *performance = &komondor_simulation->node_container[n].simulation_performance;
+		int ix = r * total_nodes_number + n;
+		batch->throughput[ix] = performance->throughput;
+		batch->average_delay[ix] = performance->average_delay;
+		batch->packets_lost_ratio[ix] = 0;
+		if (performance->data_packets_sent > 0) {
+			batch->packets_lost_ratio[ix] = (double) performance->data_packets_lost / performance->data_packets_sent;
+		}
+	}
+	pthread_mutex_unlock(&batch->mutex);
+
+	delete komondor_simulation;
+}
+
+/**
+ * Worker thread: simulate replications until none is left
+ * @param "arg" [type ReplicationBatch*]: batch of replications
+ */
+template <class SIMULATION>
+void *RunReplicationsWorker(void *arg){
+
+	ReplicationBatch *batch = (ReplicationBatch *) arg;
+
+	while (true) {
+		pthread_mutex_lock(&batch->mutex);
+		int r = batch->next_replication;
+		++batch->next_replication;
+		pthread_mutex_unlock(&batch->mutex);
+		if (r >= batch->num_replications) break;
+		RunReplication<SIMULATION>(batch, r);
+	}
+
+	return NULL;
+}
+
+/**
+ * Print (and append to the script output file) the statistics of every AP across the replications
+ * @param "batch" [type ReplicationBatch*]: batch of replications (already simulated)
+ */
+void PrintReplicationsSummary(ReplicationBatch *batch){
+
+	int n_nodes = batch->total_nodes_number;
+	double mean, ci;
+	FILE *script_output_file = fopen(batch->script_output_filename.c_str(), "at");
+
+	printf("\n%s REPLICATIONS SUMMARY '%s' (%d replications, seeds %d-%d, mean +/- 95%% CI)\n", LOG_LVL1,
+		batch->simulation_code.c_str(), batch->num_replications, batch->seed, batch->seed + batch->num_replications - 1);
+	if (script_output_file != NULL) {
+		fprintf(script_output_file, "%s REPLICATIONS SUMMARY '%s' (%d replications, seeds %d-%d, mean +/- 95%% CI)\n",
+			LOG_LVL1, batch->simulation_code.c_str(), batch->num_replications, batch->seed,
+			batch->seed + batch->num_replications - 1);
+	}
+
+	// Network throughput
+	double *network_throughput = new double[batch->num_replications];
+	for (int r = 0; r < batch->num_replications; ++r) {
+		network_throughput[r] = 0;
+		for (int n = 0; n < n_nodes; ++n) network_throughput[r] += batch->throughput[r * n_nodes + n];
+	}
+	ComputeConfidenceInterval(network_throughput, batch->num_replications, 1, 0, &mean, &ci);
+	printf("%s Network throughput = %.2f +/- %.2f Mbps\n", LOG_LVL2, mean * pow(10,-6), ci * pow(10,-6));
+	if (script_output_file != NULL) {
+		fprintf(script_output_file, "%s Network throughput = %.2f +/- %.2f Mbps\n", LOG_LVL2,
+			mean * pow(10,-6), ci * pow(10,-6));
+	}
+	delete[] network_throughput;
+
+	// Per-AP statistics
+	for (int n = 0; n < n_nodes; ++n) {
+		if (batch->node_types[n] != NODE_TYPE_AP) continue;
+		double throughput_mean, throughput_ci, delay_mean, delay_ci, lost_mean, lost_ci;
+		ComputeConfidenceInterval(batch->throughput, batch->num_replications, n_nodes, n, &throughput_mean, &throughput_ci);
+		ComputeConfidenceInterval(batch->average_delay, batch->num_replications, n_nodes, n, &delay_mean, &delay_ci);
+		ComputeConfidenceInterval(batch->packets_lost_ratio, batch->num_replications, n_nodes, n, &lost_mean, &lost_ci);
+		printf("%s %s (N%d): throughput = %.2f +/- %.2f Mbps, delay = %.2f +/- %.2f ms, packets lost = %.2f +/- %.2f %%\n",
+			LOG_LVL3, batch->node_codes[n].c_str(), n, throughput_mean * pow(10,-6), throughput_ci * pow(10,-6),
+			delay_mean * 1000, delay_ci * 1000, lost_mean * 100, lost_ci * 100);
+		if (script_output_file != NULL) {
+			fprintf(script_output_file, "%s %s (N%d): throughput = %.2f +/- %.2f Mbps, delay = %.2f +/- %.2f ms, packets lost = %.2f +/- %.2f %%\n",
+				LOG_LVL3, batch->node_codes[n].c_str(), n, throughput_mean * pow(10,-6), throughput_ci * pow(10,-6),
+				delay_mean * 1000, delay_ci * 1000, lost_mean * 100, lost_ci * 100);
+		}
+	}
+
+	if (script_output_file != NULL) fclose(script_output_file);
+}
+
+/**
+ * Simulate a batch of replications with a pool of worker threads and print their summary. SIMULATION is the
+ * Komondor component, of which every worker thread creates an engine per replication
+ * @param "batch" [type ReplicationBatch*]: batch of replications (arguments already filled)
+ * @param "num_threads" [type int]: number of worker threads
+ */
+template <class SIMULATION>
+void RunReplications(ReplicationBatch *batch, int num_threads){
+
+	batch->next_replication = 0;
+	batch->total_nodes_number = 0;
+	batch->node_codes = NULL;
+	batch->node_types = NULL;
+	batch->throughput = NULL;
+	batch->average_delay = NULL;
+	batch->packets_lost_ratio = NULL;
+	pthread_mutex_init(&batch->mutex, NULL);
+
+	if (num_threads > batch->num_replications) num_threads = batch->num_replications;
+	pthread_t *threads = new pthread_t[num_threads];
+	for (int t = 0; t < num_threads; ++t) {
+		if (pthread_create(&threads[t], NULL, RunReplicationsWorker<SIMULATION>, batch) != 0) {
+			printf("ERROR: Worker thread %d could not be created\n", t);
+			exit(-1);
+		}
+	}
+	for (int t = 0; t < num_threads; ++t) pthread_join(threads[t], NULL);
+	delete[] threads;
+
+	if (batch->total_nodes_number > 0) PrintReplicationsSummary(batch);
+	pthread_mutex_destroy(&batch->mutex);
+
+	// Results of the replications
+	delete[] batch->node_codes;
+	delete[] batch->node_types;
+	delete[] batch->throughput;
+	delete[] batch->average_delay;
+	delete[] batch->packets_lost_ratio;
+	batch->node_codes = NULL;
+	batch->node_types = NULL;
+	batch->throughput = NULL;
+	batch->average_delay = NULL;
+	batch->packets_lost_ratio = NULL;
+	batch->total_nodes_number = 0;
+}
+
+#endif
@@ -0,0 +1,402 @@
+/* Kom8ndor IEEE 802.11bn Simulator
+ *
+ * Copyright (c) 2026, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ */
+
+/**
+ * scenario_snapshot_methods.h: binary snapshot of a scenario built from its input files (--compile-scenario),
+ * loaded instead of them by later runs (--scenario-bin).
+ *
+ * The snapshot holds the system models (config_models), the parameters of the nodes, the WLANs with their
+ * STAs and MAPC groups, and the path gain and received power matrices. It is only written once the input
+ * has been validated, so loading it skips the parsing, the channel computation and the validation. The
+ * matrices are stored with the layout of Topology and mapped in place: the runs (and the replications of
+ * a batch) share the pages of the file, and the rows updated by the nodes are copied on write.
+ *
+ * Shadowing and obstacles of the stochastic path loss models are drawn from the seed: if the seed of the
+ * run differs from the one the snapshot was compiled with, the matrices are recomputed (from the snapshot).
+ *
+ * File format (native byte order, int = int32):
+ *   "KOMSCENE", int version, int byte order mark, int seed, int system models (5), int mapc_enabled,
+ *   int total_nodes_number, int total_wlans_number, int row_stride, int64 matrices offset,
+ *   nodes filename, nodes, WLANs   (strings as int length and characters)
+ *   padding up to the matrices offset (multiple of TOPOLOGY_CACHE_LINE)
+ *   double path_gain[total_nodes_number][row_stride], double received_power[total_nodes_number][row_stride]
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+#include <string>
+
+#include "../../list_of_macros.h"
+
+#ifndef _SCENARIO_SNAPSHOT_METHODS_
+#define _SCENARIO_SNAPSHOT_METHODS_
+
+#define SCENARIO_SNAPSHOT_MAGIC			"KOMSCENE"
+#define SCENARIO_SNAPSHOT_VERSION		1
+#define SCENARIO_SNAPSHOT_BYTE_ORDER	0x01020304	///> Read back differently on machines of another byte order
+
+/**
+ * Sequential writer of the fields of a snapshot
+ */
+struct SnapshotWriter
+{
+	FILE *file;
+	int64_t position;		///> Bytes written
+
+	int Reading() const { return 0; }
+
+	void Bytes(void *value, size_t size){
+		fwrite(value, 1, size, file);
+		position += size;
+	}
+	void Field(int &value){ Bytes(&value, sizeof(value)); }
+	void Field(int64_t &value){ Bytes(&value, sizeof(value)); }
+	void Field(double &value){ Bytes(&value, sizeof(value)); }
+	void Field(std::string &value){
+		int length (value.size());
+		Field(length);
+		fwrite(value.data(), 1, length, file);
+		position += length;
+	}
+	void Array(int *values, int size){ Bytes(values, size * sizeof(int)); }
+};
+
+/**
+ * Sequential reader of the fields of a (mapped) snapshot
+ */
+struct SnapshotReader
+{
+	const char *filename;
+	const char *data;
+	size_t size;
+	size_t position;		///> Bytes read
+
+	int Reading() const { return 1; }
+
+	void Bytes(void *value, size_t length){
+		if (position + length > size) {
+			printf("ERROR: Scenario snapshot %s is truncated\n", filename);
+			exit(-1);
+		}
+		memcpy(value, data + position, length);
+		position += length;
+	}
+	void Field(int &value){ Bytes(&value, sizeof(value)); }
+	void Field(int64_t &value){ Bytes(&value, sizeof(value)); }
+	void Field(double &value){ Bytes(&value, sizeof(value)); }
+	void Field(std::string &value){
+		int length;
+		Field(length);
+		if (length < 0 || position + length > size) {
+			printf("ERROR: Scenario snapshot %s is truncated\n", filename);
+			exit(-1);
+		}
+		value.assign(data + position, length);
+		position += length;
+	}
+	void Array(int *values, int length){ Bytes(values, length * sizeof(int)); }
+};
+
+/**
+ * Write or read the parameters of a node taken from the nodes file (the rest are set per run)
+ * @param "archive" [type Archive&]: SnapshotWriter or SnapshotReader
+ * @param "params" [type NodeParameters&]: parameters of the node
+ * @param "traffic_load" [type double&]: traffic load of its traffic generator [packets/s]
+ */
+template <class Archive>
+void SnapshotNode(Archive &archive, NodeParameters &params, double &traffic_load){
+	archive.Field(params.node_id);
+	archive.Field(params.node_code);
+	archive.Field(params.node_type);
+	archive.Field(params.wlan_code);
+	archive.Field(params.x);
+	archive.Field(params.y);
+	archive.Field(params.z);
+	archive.Field(params.central_frequency);
+	archive.Field(params.current_dcb_policy);
+	archive.Field(params.current_primary_channel);
+	archive.Field(params.min_channel_allowed);
+	archive.Field(params.max_channel_allowed);
+	archive.Field(params.tx_power_default);
+	archive.Field(params.sensitivity_default);
+	archive.Field(params.traffic_model);
+	archive.Field(traffic_load);
+	archive.Field(params.frame_length);
+	archive.Field(params.max_num_packets_aggregated);
+	archive.Field(params.capture_effect_model);
+	archive.Field(params.capture_effect);
+	archive.Field(params.constant_per);
+	archive.Field(params.pifs_activated);
+	archive.Field(params.backoff_type);
+	archive.Field(params.cw_adaptation);
+	archive.Field(params.cw_min_default);
+	archive.Field(params.cw_max_default);
+	archive.Field(params.cw_stage_max);
+	archive.Field(params.rts_cts_enabled);
+	archive.Field(params.bss_color);
+	archive.Field(params.srg);
+	archive.Field(params.non_srg_obss_pd);
+	archive.Field(params.srg_obss_pd);
+	archive.Field(params.beamforming_enabled);
+	archive.Field(params.beam_N_elements);
+	archive.Field(params.beam_d_spacing);
+	archive.Field(params.beam_az_main_deg);
+	archive.Field(params.traffic_type);
+	archive.Field(params.dso_enabled);
+	archive.Field(params.npca_enabled);
+	archive.Field(params.npca_primary_channel);
+	archive.Field(params.npca_min_dur_threshold_us);
+	archive.Field(params.npca_switching_delay_us);
+	archive.Field(params.npca_switch_back_delay_us);
+	archive.Field(params.npca_init_qsrc);
+}
+
+/**
+ * Write or read a WLAN, with its STAs and MAPC groups (the arrays are allocated when reading)
+ * @param "archive" [type Archive&]: SnapshotWriter or SnapshotReader
+ * @param "wlan" [type Wlan&]: WLAN
+ */
+template <class Archive>
+void SnapshotWlan(Archive &archive, Wlan &wlan){
+	archive.Field(wlan.wlan_id);
+	archive.Field(wlan.wlan_code);
+	archive.Field(wlan.ap_id);
+	archive.Field(wlan.num_stas);
+	if (archive.Reading()) wlan.SetSizeOfSTAsArray(wlan.num_stas);
+	archive.Array(wlan.list_sta_id, wlan.num_stas);
+	archive.Array(wlan.sta_min_channel, wlan.num_stas);
+	archive.Array(wlan.sta_max_channel, wlan.num_stas);
+	archive.Field(wlan.mapc_enabled);
+	archive.Field(wlan.num_mapc_groups);
+	for (int g = 0; g < MAX_MAPC_GROUPS_PER_WLAN; ++g) {
+		archive.Field(wlan.mapc_group_ids[g]);
+		archive.Field(wlan.mapc_method_ids[g]);
+		archive.Field(wlan.mapc_txop_splits[g]);
+		archive.Field(wlan.mapc_sr_tx_power_dbm[g]);
+		archive.Field(wlan.mapc_num_peers[g]);
+		int has_peers (wlan.mapc_peer_ap_ids[g] != NULL);
+		archive.Field(has_peers);
+		if (archive.Reading()) wlan.mapc_peer_ap_ids[g] = has_peers ? new int[wlan.mapc_num_peers[g]] : NULL;
+		if (has_peers) archive.Array(wlan.mapc_peer_ap_ids[g], wlan.mapc_num_peers[g]);
+	}
+}
+
+/**
+ * Build a scenario from its input files, validate it and write its snapshot (--compile-scenario)
+ * @param "nodes_filename" [type const char*]: filename of the nodes input CSV
+ * @param "mapc_enabled_console" [type int]: flag indicating that MAPC is enabled
+ * @param "mapc_filename" [type const char*]: filename of the MAPC configuration CSV
+ * @param "seed_console" [type int]: random seed (of the shadowing of stochastic path loss models)
+ * @param "print_system_logs_console" [type int]: flag for activating system prints
+ * @param "snapshot_filename" [type const char*]: filename of the snapshot to be written
+ */
+void Komondor :: CompileScenario(const char *nodes_filename, int mapc_enabled_console, const char *mapc_filename,
+		int seed_console, int print_system_logs_console, const char *snapshot_filename){
+
+	// Parameters of the runs (set again when the snapshot is loaded)
+	simulation_time_komondor = 0;
+	save_node_logs = 0;
+	print_node_logs = 0;
+	lazy_backoff = 0;
+	simulation_code = "";
+
+	seed = seed_console;
+	print_system_logs = print_system_logs_console;
+	mapc_enabled = mapc_enabled_console;
+	GenerateScenario(nodes_filename, mapc_filename);
+	ValidateInput(total_nodes_number, node_container, print_system_logs);
+
+	FILE *file = fopen(snapshot_filename, "wb");
+	if (file == NULL) {
+		printf("ERROR: Scenario snapshot %s could not be created\n", snapshot_filename);
+		exit(-1);
+	}
+	SnapshotWriter writer;
+	writer.file = file;
+	writer.position = 0;
+
+	int version (SCENARIO_SNAPSHOT_VERSION);
+	int byte_order (SCENARIO_SNAPSHOT_BYTE_ORDER);
+	int row_stride (topology.row_stride);
+	writer.Bytes((void *) SCENARIO_SNAPSHOT_MAGIC, 8);
+	writer.Field(version);
+	writer.Field(byte_order);
+	writer.Field(seed);
+	writer.Field(path_loss_model);
+	writer.Field(adjacent_channel_model);
+	writer.Field(collisions_model);
+	writer.Field(pdf_tx_time);
+	writer.Field(simulation_index);
+	writer.Field(mapc_enabled);
+	writer.Field(total_nodes_number);
+	writer.Field(total_wlans_number);
+	writer.Field(row_stride);
+
+	// The offset of the matrices is only known once the variable-length part is written
+	int64_t matrices_offset (0);
+	int64_t matrices_offset_position (writer.position);
+	writer.Field(matrices_offset);
+
+	std::string source (nodes_filename);
+	writer.Field(source);
+	for (int n = 0; n < total_nodes_number; ++n) {
+		SnapshotNode(writer, node_container[n].node_params, traffic_generator_container[n].traffic_load);
+	}
+	for (int w = 0; w < total_wlans_number; ++w) SnapshotWlan(writer, wlan_container[w]);
+
+	char padding[TOPOLOGY_CACHE_LINE];
+	memset(padding, 0, sizeof(padding));
+	matrices_offset = (writer.position + TOPOLOGY_CACHE_LINE - 1) / TOPOLOGY_CACHE_LINE * TOPOLOGY_CACHE_LINE;
+	writer.Bytes(padding, matrices_offset - writer.position);
+	size_t matrix_size ((size_t) total_nodes_number * row_stride * sizeof(double));
+	writer.Bytes(topology.path_gain, matrix_size);
+	writer.Bytes(topology.received_power, matrix_size);
+
+	fseek(file, matrices_offset_position, SEEK_SET);
+	fwrite(&matrices_offset, sizeof(matrices_offset), 1, file);
+	int failed (ferror(file));
+	if (fclose(file) != 0) failed = 1;
+	if (failed) {
+		printf("ERROR: Scenario snapshot %s could not be written\n", snapshot_filename);
+		exit(-1);
+	}
+
+	printf("%s Scenario %s compiled into %s: %d nodes, %d WLANs (%.1f MB)\n", LOG_LVL1, nodes_filename,
+		snapshot_filename, total_nodes_number, total_wlans_number, writer.position / 1e6);
+}
+
+/**
+ * Build the scenario from a snapshot written by CompileScenario (--scenario-bin), instead of reading the
+ * input files. The parameters of the run (seed, logs...) must already be set
+ * @param "snapshot_filename" [type const char*]: filename of the snapshot
+ */
+void Komondor :: LoadScenarioSnapshot(const char *snapshot_filename){
+
+	if (print_system_logs) printf("\n%s Loading scenario snapshot '%s'...\n", LOG_LVL1, snapshot_filename);
+
+	int fd (open(snapshot_filename, O_RDONLY));
+	struct stat file_status;
+	if (fd < 0 || fstat(fd, &file_status) != 0) {
+		printf("ERROR: Scenario snapshot %s not found\n", snapshot_filename);
+		exit(-1);
+	}
+	SnapshotReader reader;
+	reader.filename = snapshot_filename;
+	reader.size = file_status.st_size;
+	reader.position = 0;
+	void *mapping (NULL);
+#ifndef _WIN32
+	mapping = mmap(NULL, reader.size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	if (mapping == MAP_FAILED) mapping = NULL;
+#endif
+	char *buffer (NULL);
+	if (mapping == NULL) {
+		// Read at once into a buffer aligned like the mapping
+		buffer = (char *) AllocateAligned(reader.size);
+		size_t read_bytes (0);
+		while (read_bytes < reader.size) {
+			ssize_t n (read(fd, buffer + read_bytes, reader.size - read_bytes));
+			if (n <= 0) {
+				printf("ERROR: Scenario snapshot %s could not be read\n", snapshot_filename);
+				exit(-1);
+			}
+			read_bytes += n;
+		}
+	}
+	close(fd);
+	reader.data = mapping != NULL ? (const char *) mapping : buffer;
+
+	char magic[8];
+	int version, byte_order, snapshot_seed, row_stride;
+	int64_t matrices_offset;
+	reader.Bytes(magic, 8);
+	reader.Field(version);
+	reader.Field(byte_order);
+	if (memcmp(magic, SCENARIO_SNAPSHOT_MAGIC, 8) != 0 || version != SCENARIO_SNAPSHOT_VERSION
+			|| byte_order != SCENARIO_SNAPSHOT_BYTE_ORDER) {
+		printf("ERROR: %s is not a scenario snapshot of this version of Komondor (compile it again)\n",
+			snapshot_filename);
+		exit(-1);
+	}
+	reader.Field(snapshot_seed);
+	reader.Field(path_loss_model);
+	reader.Field(adjacent_channel_model);
+	reader.Field(collisions_model);
+	reader.Field(pdf_tx_time);
+	reader.Field(simulation_index);
+	reader.Field(mapc_enabled);
+	reader.Field(total_nodes_number);
+	reader.Field(total_wlans_number);
+	reader.Field(row_stride);
+	reader.Field(matrices_offset);
+	size_t matrix_size ((size_t) total_nodes_number * row_stride * sizeof(double));
+	if (row_stride != Topology::RowStride(total_nodes_number) || matrices_offset % TOPOLOGY_CACHE_LINE != 0
+			|| (size_t) matrices_offset + 2 * matrix_size != reader.size) {
+		printf("ERROR: Scenario snapshot %s is corrupted (compile it again)\n", snapshot_filename);
+		exit(-1);
+	}
+
+	std::string source;
+	reader.Field(source);
+	node_container.SetSize(total_nodes_number);
+	traffic_generator_container.SetSize(total_nodes_number);
+	for (int n = 0; n < total_nodes_number; ++n) {
+		SnapshotNode(reader, node_container[n].node_params, traffic_generator_container[n].traffic_load);
+		traffic_generator_container[n].node_type = node_container[n].node_params.node_type;
+		traffic_generator_container[n].traffic_model = node_container[n].node_params.traffic_model;
+		SetNodeRunParameters(n);
+	}
+	wlan_container = new Wlan[total_wlans_number];
+	for (int w = 0; w < total_wlans_number; ++w) SnapshotWlan(reader, wlan_container[w]);
+	LinkNodesToWlans();
+
+	// Channel: mapped from the snapshot, unless the shadowing depends on the seed and this one is different
+	if (PathLossDependsOnSeed(path_loss_model) && seed != snapshot_seed) {
+		if (print_system_logs) printf("%s Path loss model %d depends on the seed (%d, compiled with %d): computing the channel\n",
+			LOG_LVL2, path_loss_model, seed, snapshot_seed);
+		topology.Allocate(total_nodes_number);
+		ComputeChannelMatrices();
+		if (mapping != NULL) {
+#ifndef _WIN32
+			munmap(mapping, reader.size);
+#endif
+		}
+	} else if (mapping != NULL) {
+		topology.Map(total_nodes_number, mapping, reader.size, matrices_offset);
+	} else {
+		topology.Allocate(total_nodes_number);
+		memcpy(topology.path_gain, buffer + matrices_offset, matrix_size);
+		memcpy(topology.received_power, buffer + matrices_offset + matrix_size, matrix_size);
+	}
+	for (int i = 0; i < total_nodes_number; ++i) {
+		topology.x[i] = node_container[i].node_params.x;
+		topology.y[i] = node_container[i].node_params.y;
+		topology.z[i] = node_container[i].node_params.z;
+	}
+	FreeAligned(buffer);
+
+	if (print_system_logs) printf("%s Scenario %s loaded: %d nodes, %d WLANs\n", LOG_LVL2, source.c_str(),
+		total_nodes_number, total_wlans_number);
+}
+
+#endif
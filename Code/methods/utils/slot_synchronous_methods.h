@@ -0,0 +1,258 @@
+/* Kom8ndor IEEE 802.11bn Simulator
+ *
+ * Copyright (c) 2026, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ */
+
+/**
+ * slot_synchronous_methods.h: slot-synchronous engine for saturated DCF/EDCA scenarios (--slotted).
+ *
+ * The nodes are grouped into contention groups, i.e., sets of WLANs whose nodes all sense each other
+ * and sense nobody else. Within a group, the APs resume their countdown after the IFS following every
+ * exchange, so their accesses are decided by slot counters: the APs reaching zero first access the
+ * channel together (all of them succeed under the IEEE 802.11 capture model), and the rest freeze their
+ * counters for the duration of the exchange. When several APs access at once, the rest sense their ACKs
+ * collide and wait for the collision to be over before their IFS, as in the event engine, so that their
+ * countdown is no longer aligned with the slots of the others. The engine thus advances every group from one
+ * channel access to the next in a single batch, instead of simulating each frame, IFS and backoff
+ * interruption with events. The accesses themselves are performed by the nodes (see
+ * node_slotted_methods.h), with the same random draws and statistics as the frame exchanges.
+ *
+ * Scenarios (or parts of them) out of this model (hidden or exposed nodes, SINR-based capture, channel
+ * bonding, spatial reuse, MAPC, agents, non-saturated traffic...) are simulated with events.
+ */
+
+#include <vector>
+
+#include "../../list_of_macros.h"
+
+#ifndef _SLOT_SYNCHRONOUS_METHODS_
+#define _SLOT_SYNCHRONOUS_METHODS_
+
+/**
+ * Check whether the scenario can be simulated by the slot-synchronous engine and, if so, group its nodes
+ * into contention groups. Otherwise, the reason is printed and the simulation falls back to events
+ * @return "eligible" [type int]: 1 if the slot-synchronous engine reproduces the scenario, 0 otherwise
+ */
+int Komondor :: SetupSlotSynchronous(){
+
+	char reason[256] = "";
+
+	if (agents_enabled) snprintf(reason, sizeof(reason), "agents are enabled");
+	if (mapc_enabled) snprintf(reason, sizeof(reason), "MAPC is enabled");
+	if (frame_trace != NULL) snprintf(reason, sizeof(reason), "the frame trace is enabled");
+	if (ClearStatsTime() > 0 || ObservationPeriod() > 0) snprintf(reason, sizeof(reason), "the warm-up is deleted");
+
+	// Nodes: saturated APs, single-channel operation and basic access
+	for (int n = 0; n < total_nodes_number && reason[0] == '\0'; ++n) {
+		NodeParameters &params = node_container[n].node_params;
+		if (params.node_type != NODE_TYPE_AP && params.node_type != NODE_TYPE_STA) {
+			snprintf(reason, sizeof(reason), "N%d is neither an AP nor a STA", n);
+		} else if (params.min_channel_allowed != params.max_channel_allowed
+				|| params.current_primary_channel != params.min_channel_allowed) {
+			snprintf(reason, sizeof(reason), "N%d may use more than one channel", n);
+		} else if (params.capture_effect_model != CE_IEEE_802_11) {
+			snprintf(reason, sizeof(reason), "N%d does not use the IEEE 802.11 capture effect model", n);
+		} else if (params.beamforming_enabled || params.npca_enabled || params.dso_enabled) {
+			snprintf(reason, sizeof(reason), "N%d uses beamforming, NPCA or DSO", n);
+		} else if (params.node_type == NODE_TYPE_AP) {
+			if (params.traffic_model != TRAFFIC_FULL_BUFFER_NO_DIFFERENTIATION) {
+				snprintf(reason, sizeof(reason), "N%d is not saturated", n);
+			} else if (params.backoff_type != BACKOFF_DCF && params.backoff_type != BACKOFF_EDCA) {
+				snprintf(reason, sizeof(reason), "N%d does not use DCF nor EDCA", n);
+			} else if (!params.rts_cts_enabled) {
+				snprintf(reason, sizeof(reason), "N%d does not use RTS/CTS", n);
+			} else if (params.bss_color >= 0) {
+				snprintf(reason, sizeof(reason), "N%d uses spatial reuse", n);
+			} else if (node_container[n].wlan.num_stas == 0) {
+				snprintf(reason, sizeof(reason), "N%d has no STAs", n);
+			}
+		}
+	}
+
+	// Power sensed by each node from each other one in its channel [pW]
+	double *sensed_power = new double[total_nodes_number * total_nodes_number];
+	double mask[NUM_CHANNELS_KOMONDOR];
+	for (int m = 0; m < total_nodes_number && reason[0] == '\0'; ++m) {
+		int channel (node_container[m].node_params.current_primary_channel);
+		ComputeAdjacentChannelLeakageMask(adjacent_channel_model, channel, channel, 0, mask);
+		for (int n = 0; n < total_nodes_number; ++n) {
+			sensed_power[n * total_nodes_number + m] = (n == m) ? 0 :
+				node_container[n].received_power_array[m] * mask[node_container[n].node_params.current_primary_channel];
+		}
+	}
+
+	// Contention groups: nodes sensing each other and WLANs
+	int *parent = new int[total_nodes_number];
+	for (int n = 0; n < total_nodes_number; ++n) parent[n] = n;
+	for (int n = 0; n < total_nodes_number && reason[0] == '\0'; ++n) {
+		for (int m = n + 1; m < total_nodes_number; ++m) {
+			if (sensed_power[n * total_nodes_number + m] > node_container[n].node_params.sensitivity_default
+					|| sensed_power[m * total_nodes_number + n] > node_container[m].node_params.sensitivity_default
+					|| node_container[n].wlan.ap_id == m || node_container[m].wlan.ap_id == n) {
+				JoinSets(parent, n, m);
+			}
+		}
+	}
+	num_slot_groups = 0;
+	slot_group_per_node = new int[total_nodes_number];
+	int *group_per_root = new int[total_nodes_number];
+	for (int n = 0; n < total_nodes_number; ++n) group_per_root[n] = -1;
+	for (int n = 0; n < total_nodes_number; ++n) {
+		int root (FindSetRoot(parent, n));
+		if (group_per_root[root] < 0) group_per_root[root] = num_slot_groups++;
+		slot_group_per_node[n] = group_per_root[root];
+	}
+
+	// Every pair of nodes in a group senses (and decodes) each other in the same channel, every node senses
+	// the other groups (even all of them transmitting at once) below its sensitivity, and the exchanges of
+	// the APs contending in a group all last the same
+	double *exchange_per_group = new double[num_slot_groups];
+	int *aps_per_group = new int[num_slot_groups];
+	for (int g = 0; g < num_slot_groups; ++g) aps_per_group[g] = 0;
+	for (int n = 0; n < total_nodes_number; ++n) {
+		if (node_container[n].node_params.node_type == NODE_TYPE_AP) ++aps_per_group[slot_group_per_node[n]];
+	}
+	for (int n = 0; n < total_nodes_number && reason[0] == '\0'; ++n) {
+		double other_groups_power (0);
+		for (int m = 0; m < total_nodes_number && reason[0] == '\0'; ++m) {
+			if (m == n) continue;
+			if (slot_group_per_node[m] != slot_group_per_node[n]) {
+				other_groups_power += sensed_power[n * total_nodes_number + m];
+			} else if ((aps_per_group[slot_group_per_node[n]] > 1 || node_container[n].wlan.ap_id == m
+					|| node_container[m].wlan.ap_id == n)
+					&& sensed_power[n * total_nodes_number + m] <= node_container[n].node_params.sensitivity_default) {
+				snprintf(reason, sizeof(reason), "N%d does not sense N%d (hidden or exposed nodes)", n, m);
+			}
+		}
+		if (reason[0] == '\0' && other_groups_power > node_container[n].node_params.sensitivity_default) {
+			snprintf(reason, sizeof(reason), "N%d senses other contention groups", n);
+		}
+	}
+	for (int g = 0; g < num_slot_groups; ++g) exchange_per_group[g] = -1;
+	for (int n = 0; n < total_nodes_number && reason[0] == '\0'; ++n) {
+		if (node_container[n].node_params.node_type != NODE_TYPE_AP
+				|| aps_per_group[slot_group_per_node[n]] < 2) continue;
+		for (int s = 0; s < node_container[n].wlan.num_stas; ++s) {
+			int num_packets_aggregated;
+			double durations[4];
+			double exchange_duration (node_container[n].SlottedExchangeDuration(node_container[n].wlan.list_sta_id[s],
+				&num_packets_aggregated, durations));
+			double &group_exchange = exchange_per_group[slot_group_per_node[n]];
+			if (group_exchange < 0) group_exchange = exchange_duration;
+			if (fabs(group_exchange - exchange_duration) > MAX_DIFFERENCE_SAME_TIME) {
+				snprintf(reason, sizeof(reason), "exchanges of N%d last differently from the rest of its group", n);
+			}
+		}
+	}
+
+	delete[] sensed_power;
+	delete[] parent;
+	delete[] group_per_root;
+	delete[] exchange_per_group;
+	delete[] aps_per_group;
+
+	if (reason[0] != '\0') {
+		printf("%s Slot-synchronous engine not applicable (%s): simulating events\n", LOG_LVL2, reason);
+		delete[] slot_group_per_node;
+		slot_group_per_node = NULL;
+		num_slot_groups = 0;
+		return 0;
+	}
+	printf("%s Slot-synchronous engine: %d contention groups\n", LOG_LVL2, num_slot_groups);
+	return 1;
+}
+
+/**
+ * Simulate the whole run with the slot-synchronous engine, if enabled (called by CostSimEng::Run() once
+ * the components have been started, instead of processing the events they scheduled)
+ * @return "simulated" [type bool]: true if the run has been simulated, false to process the events
+ */
+bool Komondor :: RunFastPath(){
+
+	if (!slot_synchronous) return false;
+
+	double stop_time (StopTime());
+	NodeStatistics **stats_per_node = new NodeStatistics*[total_nodes_number];
+	for (int n = 0; n < total_nodes_number; ++n) stats_per_node[n] = &node_container[n].node_stats;
+
+	long num_batches (0);
+	long num_accesses (0);
+	std::vector<int> ap_ids;
+	std::vector<double> ifs;
+	std::vector<int> backoff_slots;
+	std::vector<double> countdown_time;
+	std::vector<int> accessing;
+	for (int g = 0; g < num_slot_groups; ++g) {
+
+		ap_ids.clear();
+		ifs.clear();
+		backoff_slots.clear();
+		for (int n = 0; n < total_nodes_number; ++n) {
+			if (slot_group_per_node[n] == g && node_container[n].node_params.node_type == NODE_TYPE_AP) {
+				ap_ids.push_back(n);
+				ifs.push_back(SIFS + node_container[n].SlottedIfsSlots() * SLOT_TIME);
+				backoff_slots.push_back(node_container[n].SlottedBackoffSlots());
+			}
+		}
+		int num_aps (ap_ids.size());
+		if (num_aps == 0) continue;
+
+		// Every AP starts counting down once its IFS following the end of the last exchange (or the start of the
+		// simulation) is over, and accesses the channel when its counter reaches zero
+		countdown_time.assign(ifs.begin(), ifs.end());
+		accessing.assign(num_aps, 0);
+		while (true) {
+			double tx_time (countdown_time[0] + backoff_slots[0] * SLOT_TIME);
+			for (int i = 1; i < num_aps; ++i) {
+				if (countdown_time[i] + backoff_slots[i] * SLOT_TIME < tx_time) {
+					tx_time = countdown_time[i] + backoff_slots[i] * SLOT_TIME;
+				}
+			}
+			if (tx_time >= stop_time) break;
+
+			double end_time (tx_time);
+			int num_accessing (0);
+			int last_accessing (0);
+			for (int i = 0; i < num_aps; ++i) {
+				double backoff_end (countdown_time[i] + backoff_slots[i] * SLOT_TIME);
+				accessing[i] = (backoff_end - tx_time < MAX_DIFFERENCE_SAME_TIME);
+				if (accessing[i]) {
+					double ap_end_time (node_container[ap_ids[i]].SlottedTransmission(tx_time, stop_time, stats_per_node));
+					if (ap_end_time > end_time) end_time = ap_end_time;
+					backoff_slots[i] = node_container[ap_ids[i]].SlottedBackoffSlots();
+					++num_accessing;
+					last_accessing = i;
+				} else if (tx_time > countdown_time[i]) {	// Frozen once the exchange starts (see PauseBackoff)
+					backoff_slots[i] = (int) floor(ComputeRemainingBackoff(node_container[ap_ids[i]].node_params.backoff_type,
+						backoff_end - tx_time) / SLOT_TIME + 0.5);
+				}
+			}
+
+			// The APs not accessing the channel sense the simultaneous exchanges as a collision
+			double recovery_time (num_accessing > 1 ?
+				node_container[ap_ids[last_accessing]].SlottedRecoveryTime(end_time) : end_time);
+			for (int i = 0; i < num_aps; ++i) countdown_time[i] = (accessing[i] ? end_time : recovery_time) + ifs[i];
+			num_accesses += num_accessing;
+			++num_batches;
+		}
+	}
+
+	if (print_system_logs) printf("%s Slot-synchronous engine: %ld channel accesses in %ld slot batches\n",
+		LOG_LVL2, num_accesses, num_batches);
+
+	delete[] stats_per_node;
+	return true;
+}
+
+#endif
@@ -0,0 +1,182 @@
+/* Kom8ndor IEEE 802.11bn Simulator
+ *
+ * Copyright (c) 2026, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ */
+
+/**
+ * steady_state_methods.h: deletion of the warm-up of a simulation (--warmup) and detection of its steady state
+ * (--steady-state).
+ *
+ * Clearing the statistics (see Node::ClearStats()) discards the counters and times collected so far by every node,
+ * as well as its pending report to the agent, so that the results only cover the rest of the run. This is done at a
+ * given time with --warmup. With --steady-state, the network throughput and the average delay of the delivered
+ * packets are observed periodically and grouped into batches of STEADY_STATE_BATCH_SIZE observations instead:
+ * - The warm-up is over once the MSER-5 truncation point (the number of initial batches whose deletion minimizes the
+ *   standard error of the mean of the rest) falls in the first half of the batches. The statistics are cleared then.
+ * - The run ends as soon as the 95% confidence intervals of both metrics, computed from the batch means observed since
+ *   the end of the warm-up, are narrower than the target (relative to their mean).
+ */
+
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+#include "../../list_of_macros.h"
+
+#ifndef _STEADY_STATE_METHODS_
+#define _STEADY_STATE_METHODS_
+
+/**
+ * Group observations into batches of STEADY_STATE_BATCH_SIZE (the last one, if incomplete, is left out)
+ * @param "observations" [type std::vector<double>&]: observations (negative if missing)
+ * @param "batch_means" [type std::vector<double>&]: mean of the observations of each batch, -1 if all are missing (output)
+ */
+void ComputeBatchMeans(const std::vector<double> &observations, std::vector<double> &batch_means){
+	batch_means.clear();
+	int num_batches (observations.size() / STEADY_STATE_BATCH_SIZE);
+	for (int b = 0; b < num_batches; ++b) {
+		double sum (0);
+		int num_observations (0);
+		for (int i = b * STEADY_STATE_BATCH_SIZE; i < (b + 1) * STEADY_STATE_BATCH_SIZE; ++i) {
+			if (observations[i] < 0) continue;
+			sum += observations[i];
+			++num_observations;
+		}
+		batch_means.push_back(num_observations > 0 ? sum / num_observations : -1);
+	}
+}
+
+/**
+ * MSER truncation point: number of initial batches whose deletion minimizes the standard error of the mean of the rest
+ * @param "batch_means" [type std::vector<double>&]: batch means (at least two)
+ * @return "truncation" [type int]: number of batches to be deleted
+ */
+int ComputeMserTruncation(const std::vector<double> &batch_means){
+	int num_batches (batch_means.size());
+	int truncation (0);
+	double min_mser (-1);
+	for (int d = 0; d <= num_batches - 2; ++d) {
+		double sum (0), sum_squared_deviations (0);
+		for (int b = d; b < num_batches; ++b) sum += batch_means[b];
+		double mean (sum / (num_batches - d));
+		for (int b = d; b < num_batches; ++b) sum_squared_deviations += pow(batch_means[b] - mean, 2);
+		double mser (sum_squared_deviations / pow((double) (num_batches - d), 2));
+		if (min_mser < 0 || mser < min_mser) {
+			min_mser = mser;
+			truncation = d;
+		}
+	}
+	return truncation;
+}
+
+/**
+ * Set up the deletion of the warm-up (called before Setup())
+ * @param "warmup" [type double]: time at which the statistics are cleared [s] (0: not cleared at a given time)
+ * @param "target_ci" [type double]: target half-width of the 95% confidence intervals of the network throughput and
+ *   delay, relative to their mean (0: no steady-state detection)
+ * @param "observation_period" [type double]: time between two observations of the network [s]
+ */
+void Komondor :: SetupSteadyState(double warmup, double target_ci, double observation_period){
+	ClearStatsTime(warmup);
+	ObservationPeriod(target_ci > 0 ? observation_period : 0);
+	statistics_start_time = warmup;
+	steady_state.target_ci = target_ci;
+	steady_state.observation_period = observation_period;
+	steady_state.warmup_deleted = (warmup > 0);
+	steady_state.Restart(0);
+}
+
+/**
+ * Clear the statistics of every node (called by the engine at the end of the warm-up, or once detected)
+ */
+void Komondor :: ClearStats(){
+	CostSimEng::ClearStats();
+	statistics_start_time = SimTime();
+	steady_state.warmup_deleted = 1;
+	steady_state.Restart(SimTime());
+}
+
+/**
+ * Observe the network throughput and delay (called by the engine every observation period), clear the statistics at
+ * the end of the warm-up, and decide whether the confidence target has been met
+ * @return "converged" [type bool]: true to end the run now
+ */
+bool Komondor :: Observe(){
+
+	double bits_acked (0);
+	double sum_delays (0);
+	long num_delay_measurements (0);
+	for (int n = 0; n < total_nodes_number; ++n) {
+		NodeStatistics &stats = node_container[n].node_stats;
+		bits_acked += (double) stats.data_frames_acked * node_container[n].node_params.frame_length;
+		sum_delays += stats.sum_delays;
+		num_delay_measurements += stats.num_delay_measurements;
+	}
+	if (SimTime() > steady_state.last_observation_time) {
+		steady_state.throughput.push_back((bits_acked - steady_state.last_bits_acked)
+			/ (SimTime() - steady_state.last_observation_time));
+		steady_state.delay.push_back(num_delay_measurements > steady_state.last_num_delay_measurements ?
+			(sum_delays - steady_state.last_sum_delays) / (num_delay_measurements - steady_state.last_num_delay_measurements) : -1);
+	}
+	steady_state.last_observation_time = SimTime();
+	steady_state.last_bits_acked = bits_acked;
+	steady_state.last_sum_delays = sum_delays;
+	steady_state.last_num_delay_measurements = num_delay_measurements;
+
+	if (SimTime() <= statistics_start_time) {	// Warm-up of a given duration (--warmup) not over yet
+		steady_state.throughput.clear();
+		steady_state.delay.clear();
+		return false;
+	}
+
+	std::vector<double> throughput_means;
+	std::vector<double> delay_means;
+	ComputeBatchMeans(steady_state.throughput, throughput_means);
+	ComputeBatchMeans(steady_state.delay, delay_means);
+	int num_batches (throughput_means.size());
+	if (num_batches < STEADY_STATE_MIN_BATCHES) return false;
+	bool delay_observed (true);
+	for (int b = 0; b < num_batches; ++b) {
+		if (delay_means[b] < 0) delay_observed = false;
+	}
+
+	// End of the warm-up
+	if (!steady_state.warmup_deleted) {
+		int truncation (ComputeMserTruncation(throughput_means));
+		if (delay_observed) truncation = std::max(truncation, ComputeMserTruncation(delay_means));
+		if (2 * truncation >= num_batches) return false;
+		printf("%s Steady state detected @ %f s (MSER-5 truncation point: %f s): statistics cleared\n", LOG_LVL1,
+			SimTime(), statistics_start_time + truncation * STEADY_STATE_BATCH_SIZE * steady_state.observation_period);
+		ClearStats();
+		return false;
+	}
+
+	// Confidence intervals of the batch means
+	double throughput_mean, throughput_ci;
+	ComputeConfidenceInterval(&throughput_means[0], num_batches, 1, 0, &throughput_mean, &throughput_ci);
+	bool converged (throughput_ci <= steady_state.target_ci * fabs(throughput_mean));
+	double delay_mean (0), delay_ci (0);
+	if (delay_observed) {
+		ComputeConfidenceInterval(&delay_means[0], num_batches, 1, 0, &delay_mean, &delay_ci);
+		converged = converged && (delay_ci <= steady_state.target_ci * delay_mean);
+	}
+	if (converged) {
+		printf("%s Steady state @ %f s: throughput %.2f +/- %.2f Mbps, delay %.3f +/- %.3f ms (%d batches since %f s)\n",
+			LOG_LVL1, SimTime(), throughput_mean * pow(10, -6), throughput_ci * pow(10, -6), delay_mean * pow(10, 3),
+			delay_ci * pow(10, 3), num_batches, statistics_start_time);
+	}
+	return converged;
+}
+
+#endif
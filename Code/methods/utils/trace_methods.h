@@ -0,0 +1,580 @@
+/* Kom8ndor IEEE 802.11bn Simulator
+ *
+ * Copyright (c) 2026, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ */
+
+/**
+ * trace_methods.h: binary trace of the node logs (--save-node 2).
+ *
+ * Instead of formatting each log line, NODE_LOGS (see main/node.h) copies its arguments into a fixed-size
+ * TraceRecord of a per-node ring (single producer: the thread simulating the node, single consumer: a
+ * background thread that writes the records into the binary file). Anything else written on the node log
+ * file (e.g., by PrintOrWriteChannelPower) goes through an unbuffered stdio stream that appends it to the
+ * same ring as text, so that the order of the log is kept. DecodeNodeTrace (--decode-trace) rebuilds the
+ * text log from the binary file.
+ *
+ * File format (native byte order): "KOMTRACE", followed by entries starting with a tag character:
+ *   'F' int id, int length, format                (a format, written before its first record)
+ *   'R' int format id, double time, int node_id, int state, char code[4], int level, int num_args,
+ *       int strings_length, int64 args[num_args], char strings[strings_length]
+ *   'T' int length, text
+ */
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../../list_of_macros.h"
+#include "../../structures/logger.h"
+
+#ifndef _TRACE_METHODS_
+#define _TRACE_METHODS_
+
+#define TRACE_FILE_MAGIC		"KOMTRACE"
+#define TRACE_RING_CAPACITY		512		///> Records buffered per node
+#define TRACE_MAX_ARGS			12		///> Arguments of a record (besides the header of the line)
+#define TRACE_STRINGS_SIZE		96		///> Bytes for the string arguments (or the text) of a record
+#define TRACE_HEADER_ARGS		5		///> Arguments of the header "%.15f;N%d;S%d;%s;%s"
+
+// Types of the conversions of a log format
+#define TRACE_ARG_INT			0
+#define TRACE_ARG_LONG			1
+#define TRACE_ARG_LONG_LONG		2
+#define TRACE_ARG_DOUBLE		3
+#define TRACE_ARG_STRING		4
+#define TRACE_ARG_POINTER		5
+#define TRACE_ARG_UNSUPPORTED	-1
+
+// Log line recorded by a node. The format is kept by address (log formats are string literals)
+struct TraceRecord
+{
+	const char *format;		///> Format of the line (NULL for text written directly on the log file)
+	double time;			///> Header of the line ("%.15f;N%d;S%d;%s;%s ..."): simulation time
+	int node_id;			///> Header: node
+	int state;				///> Header: state of the node
+	char code[4];			///> Header: event code (LOG_<code>)
+	int level;				///> Header: level (LOG_LVL<level>), 0 if the line has no header
+	int num_args;			///> Number of arguments after the header
+	int strings_length;		///> Bytes used in "strings"
+	int64_t args[TRACE_MAX_ARGS];		///> Arguments (integers, bits of doubles or offsets of strings)
+	char strings[TRACE_STRINGS_SIZE];	///> String arguments, or the text of a text record
+};
+
+// Ring of records of a node and the binary file where they are flushed
+struct TraceBuffer
+{
+	TraceRecord records[TRACE_RING_CAPACITY];
+	volatile unsigned head;		///> Records written by the node
+	volatile unsigned tail;		///> Records flushed to the file
+	FILE *file;					///> Binary trace file
+	std::map<const char*, int> format_ids;	///> Formats already written in the file
+};
+
+pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;	///> Protects the list of buffers and their files
+std::vector<TraceBuffer*> trace_buffers;					///> Buffers of the open traces
+int trace_flusher_running = FALSE;							///> Whether the flusher thread is running
+
+/**
+ * Parse the conversion of a format starting at "%"
+ * @param "format" [type char*]: format
+ * @param "position" [type int]: position of the "%"
+ * @param "end" [type int*]: position after the conversion (output)
+ * @return "type" [type int]: TRACE_ARG_* type of the argument
+ */
+int ParseTraceConversion(const char *format, int position, int *end){
+	int i = position + 1;
+	int num_l = 0;
+	while (strchr("-+ #0", format[i]) != NULL && format[i] != '\0') ++i;
+	while (format[i] >= '0' && format[i] <= '9') ++i;
+	if (format[i] == '.') {
+		++i;
+		while (format[i] >= '0' && format[i] <= '9') ++i;
+	}
+	if (format[i] == 'h') {
+		++i;
+		if (format[i] == 'h') ++i;
+	}
+	while (format[i] == 'l') {
+		++num_l;
+		++i;
+	}
+	*end = i + 1;
+	switch (format[i]) {
+		case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+			if (num_l == 0) return TRACE_ARG_INT;
+			return num_l == 1 ? TRACE_ARG_LONG : TRACE_ARG_LONG_LONG;
+		case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+			return TRACE_ARG_DOUBLE;
+		case 's':
+			return num_l == 0 ? TRACE_ARG_STRING : TRACE_ARG_UNSUPPORTED;
+		case 'p':
+			return TRACE_ARG_POINTER;
+		default:
+			*end = i;
+			return TRACE_ARG_UNSUPPORTED;
+	}
+}
+
+/**
+ * Level of a LOG_LVL<n> string
+ * @param "level_string" [type char*]: string
+ * @return "level" [type int]: n, or 0 if it is not a LOG_LVL<n> string
+ */
+int TraceLevel(const char *level_string){
+	static const char *levels[5] = {LOG_LVL1, LOG_LVL2, LOG_LVL3, LOG_LVL4, LOG_LVL5};
+	for (int l = 0; l < 5; ++l) {
+		if (strcmp(level_string, levels[l]) == 0) return l + 1;
+	}
+	return 0;
+}
+
+/**
+ * Write a record into the trace file, defining its format if it is new (flusher side)
+ * @param "trace" [type TraceBuffer*]: trace
+ * @param "record" [type TraceRecord*]: record
+ */
+void WriteTraceRecord(TraceBuffer *trace, const TraceRecord *record){
+	if (record->format == NULL) {
+		fputc('T', trace->file);
+		fwrite(&record->strings_length, sizeof(int), 1, trace->file);
+		fwrite(record->strings, 1, record->strings_length, trace->file);
+		return;
+	}
+	std::map<const char*, int>::iterator it = trace->format_ids.find(record->format);
+	int format_id;
+	if (it == trace->format_ids.end()) {
+		format_id = trace->format_ids.size();
+		trace->format_ids[record->format] = format_id;
+		int length = strlen(record->format);
+		fputc('F', trace->file);
+		fwrite(&format_id, sizeof(int), 1, trace->file);
+		fwrite(&length, sizeof(int), 1, trace->file);
+		fwrite(record->format, 1, length, trace->file);
+	} else {
+		format_id = it->second;
+	}
+	fputc('R', trace->file);
+	fwrite(&format_id, sizeof(int), 1, trace->file);
+	fwrite(&record->time, sizeof(double), 1, trace->file);
+	fwrite(&record->node_id, sizeof(int), 1, trace->file);
+	fwrite(&record->state, sizeof(int), 1, trace->file);
+	fwrite(record->code, 1, 4, trace->file);
+	fwrite(&record->level, sizeof(int), 1, trace->file);
+	fwrite(&record->num_args, sizeof(int), 1, trace->file);
+	fwrite(&record->strings_length, sizeof(int), 1, trace->file);
+	fwrite(record->args, sizeof(int64_t), record->num_args, trace->file);
+	fwrite(record->strings, 1, record->strings_length, trace->file);
+}
+
+/**
+ * Write the pending records of a trace into its file. Must be called with "trace_mutex" locked
+ * @param "trace" [type TraceBuffer*]: trace
+ * @return "num_records" [type int]: number of records written
+ */
+int DrainTraceBuffer(TraceBuffer *trace){
+	int num_records = 0;
+	unsigned head = trace->head;
+	__sync_synchronize();	// read the records after "head"
+	while (trace->tail != head) {
+		WriteTraceRecord(trace, &trace->records[trace->tail % TRACE_RING_CAPACITY]);
+		__sync_synchronize();	// release the slot after reading it
+		trace->tail = trace->tail + 1;
+		++num_records;
+	}
+	return num_records;
+}
+
+/**
+ * Flusher thread: drain the traces until none is open
+ * @param "arg" [type void*]: unused
+ */
+void *TraceFlusherWorker(void *){
+	while (true) {
+		int num_records = 0;
+		pthread_mutex_lock(&trace_mutex);
+		if (trace_buffers.empty()) {
+			trace_flusher_running = FALSE;
+			pthread_mutex_unlock(&trace_mutex);
+			return NULL;
+		}
+		for (unsigned t = 0; t < trace_buffers.size(); ++t) num_records += DrainTraceBuffer(trace_buffers[t]);
+		pthread_mutex_unlock(&trace_mutex);
+		if (num_records == 0) usleep(1000);
+	}
+}
+
+/**
+ * Get the next free record of a trace, waiting for the flusher if the ring is full (node side)
+ * @param "trace" [type TraceBuffer*]: trace
+ * @return "record" [type TraceRecord*]: record to be filled and committed with CommitTraceRecord()
+ */
+TraceRecord *NextTraceRecord(TraceBuffer *trace){
+	while (trace->head - trace->tail >= TRACE_RING_CAPACITY) sched_yield();
+	return &trace->records[trace->head % TRACE_RING_CAPACITY];
+}
+
+/**
+ * Publish the record obtained with NextTraceRecord()
+ * @param "trace" [type TraceBuffer*]: trace
+ */
+void CommitTraceRecord(TraceBuffer *trace){
+	__sync_synchronize();	// write the record before publishing it
+	trace->head = trace->head + 1;
+}
+
+/**
+ * Append text written directly on the log file
+ * @param "trace" [type TraceBuffer*]: trace
+ * @param "text" [type char*]: text
+ * @param "length" [type int]: length of the text
+ */
+void TraceText(TraceBuffer *trace, const char *text, int length){
+	while (length > 0) {
+		TraceRecord *record = NextTraceRecord(trace);
+		record->format = NULL;
+		record->strings_length = length < TRACE_STRINGS_SIZE ? length : TRACE_STRINGS_SIZE;
+		memcpy(record->strings, text, record->strings_length);
+		text += record->strings_length;
+		length -= record->strings_length;
+		CommitTraceRecord(trace);
+	}
+}
+
+/**
+ * Append a log line. Lines that do not fit in a record (too many arguments or strings, or conversions
+ * not supported) are formatted and appended as text
+ * @param "trace" [type TraceBuffer*]: trace
+ * @param "format" [type char*]: format of the line
+ * @param "args" [type va_list]: arguments of the line (consumed)
+ * @return "recorded" [type int]: TRUE if the line was recorded, FALSE if it must be appended as text
+ */
+int TraceLogLine(TraceBuffer *trace, const char *format, va_list args){
+
+	int64_t values[TRACE_HEADER_ARGS + TRACE_MAX_ARGS];
+	const char *strings[TRACE_HEADER_ARGS + TRACE_MAX_ARGS];
+	int types[TRACE_HEADER_ARGS + TRACE_MAX_ARGS];
+	int num_values = 0;
+
+	for (int i = 0, end; format[i] != '\0'; ++i) {
+		if (format[i] != '%') continue;
+		if (format[i + 1] == '%') {
+			++i;
+			continue;
+		}
+		int type = ParseTraceConversion(format, i, &end);
+		if (type == TRACE_ARG_UNSUPPORTED || num_values == TRACE_HEADER_ARGS + TRACE_MAX_ARGS) return FALSE;
+		switch (type) {
+			case TRACE_ARG_INT: values[num_values] = va_arg(args, int); break;
+			case TRACE_ARG_LONG: values[num_values] = va_arg(args, long); break;
+			case TRACE_ARG_LONG_LONG: values[num_values] = va_arg(args, long long); break;
+			case TRACE_ARG_POINTER: values[num_values] = (int64_t) (intptr_t) va_arg(args, void*); break;
+			case TRACE_ARG_DOUBLE: {
+				double value = va_arg(args, double);
+				memcpy(&values[num_values], &value, sizeof(double));
+				break;
+			}
+			case TRACE_ARG_STRING: strings[num_values] = va_arg(args, const char*); break;
+		}
+		types[num_values] = type;
+		++num_values;
+		i = end - 1;
+	}
+
+	// Header "%.15f;N%d;S%d;%s;%s" (time, node, state, code and level)
+	int first_arg = 0;
+	int level = 0;
+	if (num_values >= TRACE_HEADER_ARGS && types[0] == TRACE_ARG_DOUBLE && types[1] == TRACE_ARG_INT
+			&& types[2] == TRACE_ARG_INT && types[3] == TRACE_ARG_STRING && types[4] == TRACE_ARG_STRING
+			&& strlen(strings[3]) < 4) {
+		level = TraceLevel(strings[4]);
+		if (level > 0) first_arg = TRACE_HEADER_ARGS;
+	}
+	if (num_values - first_arg > TRACE_MAX_ARGS) return FALSE;
+
+	TraceRecord *record = NextTraceRecord(trace);
+	record->format = format;
+	record->level = level;
+	if (level > 0) {
+		memcpy(&record->time, &values[0], sizeof(double));
+		record->node_id = (int) values[1];
+		record->state = (int) values[2];
+		memset(record->code, 0, 4);
+		strcpy(record->code, strings[3]);
+	}
+	record->num_args = num_values - first_arg;
+	record->strings_length = 0;
+	for (int v = first_arg; v < num_values; ++v) {
+		if (types[v] == TRACE_ARG_STRING) {
+			int length = strlen(strings[v]) + 1;
+			if (record->strings_length + length > TRACE_STRINGS_SIZE) return FALSE;	// record not committed
+			memcpy(record->strings + record->strings_length, strings[v], length);
+			values[v] = record->strings_length;
+			record->strings_length += length;
+		}
+		record->args[v - first_arg] = values[v];
+	}
+	CommitTraceRecord(trace);
+	return TRUE;
+}
+
+/**
+ * Write a node log line: appended to the binary trace if the logger has one, written on the log file otherwise
+ * @param "logger" [type Logger]: logger of the node
+ * @param "format" [type char*]: format of the line (printf-like)
+ */
+void WriteNodeLog(Logger &logger, const char *format, ...){
+	va_list args;
+	va_start(args, format);
+	if (logger.trace == NULL) {
+		vfprintf(logger.file, format, args);
+		va_end(args);
+		return;
+	}
+	int recorded = TraceLogLine(logger.trace, format, args);
+	va_end(args);
+	if (!recorded) {
+		char line[CHAR_BUFFER_SIZE];
+		va_start(args, format);
+		int length = vsnprintf(line, sizeof(line), format, args);
+		va_end(args);
+		if (length >= (int) sizeof(line)) length = sizeof(line) - 1;
+		if (length > 0) TraceText(logger.trace, line, length);
+	}
+}
+
+#ifdef __GLIBC__
+
+/**
+ * Write function of the stdio stream of a trace: append the text written on the log file
+ */
+ssize_t TraceStreamWrite(void *cookie, const char *buffer, size_t size){
+	TraceText((TraceBuffer *) cookie, buffer, size);
+	return size;
+}
+
+/**
+ * Close function of the stdio stream of a trace: flush the pending records and close the file
+ */
+int TraceStreamClose(void *cookie){
+	TraceBuffer *trace = (TraceBuffer *) cookie;
+	pthread_mutex_lock(&trace_mutex);
+	DrainTraceBuffer(trace);
+	for (unsigned t = 0; t < trace_buffers.size(); ++t) {
+		if (trace_buffers[t] == trace) {
+			trace_buffers.erase(trace_buffers.begin() + t);
+			break;
+		}
+	}
+	pthread_mutex_unlock(&trace_mutex);
+	int result = fclose(trace->file);
+	delete trace;
+	return result;
+}
+
+#endif
+
+/**
+ * Open the binary trace of a node
+ * @param "filename" [type char*]: binary trace file
+ * @param "trace" [type TraceBuffer**]: trace to be used by WriteNodeLog (output)
+ * @return "stream" [type FILE*]: stream replacing the log file (closing it closes the trace), NULL on error
+ */
+FILE *OpenNodeTrace(const char *filename, TraceBuffer **trace){
+#ifdef __GLIBC__
+	FILE *file = fopen(filename, "wb");
+	if (file == NULL) return NULL;
+	fwrite(TRACE_FILE_MAGIC, 1, strlen(TRACE_FILE_MAGIC), file);
+
+	TraceBuffer *new_trace = new TraceBuffer;
+	new_trace->head = 0;
+	new_trace->tail = 0;
+	new_trace->file = file;
+
+	cookie_io_functions_t functions;
+	memset(&functions, 0, sizeof(functions));
+	functions.write = TraceStreamWrite;
+	functions.close = TraceStreamClose;
+	FILE *stream = fopencookie(new_trace, "w", functions);
+	if (stream == NULL) {
+		fclose(file);
+		delete new_trace;
+		return NULL;
+	}
+	setvbuf(stream, NULL, _IONBF, 0);	// keep the order of text and records
+
+	pthread_mutex_lock(&trace_mutex);
+	trace_buffers.push_back(new_trace);
+	if (!trace_flusher_running) {
+		pthread_t flusher;
+		if (pthread_create(&flusher, NULL, TraceFlusherWorker, NULL) != 0) {
+			printf("ERROR: Trace flusher thread could not be created\n");
+			exit(-1);
+		}
+		pthread_detach(flusher);
+		trace_flusher_running = TRUE;
+	}
+	pthread_mutex_unlock(&trace_mutex);
+
+	*trace = new_trace;
+	return stream;
+#else
+	printf("WARNING: Binary node logs are only available with glibc\n");
+	return NULL;
+#endif
+}
+
+/**
+ * Write the text of a decoded record
+ * @param "output" [type FILE*]: text log file
+ * @param "format" [type char*]: format of the record
+ * @param "record" [type TraceRecord*]: record
+ * @return "success" [type int]: FALSE if the record does not match its format
+ */
+int WriteDecodedTraceRecord(FILE *output, const char *format, const TraceRecord *record){
+	static const char *levels[5] = {LOG_LVL1, LOG_LVL2, LOG_LVL3, LOG_LVL4, LOG_LVL5};
+	int arg = record->level > 0 ? -TRACE_HEADER_ARGS : 0;	// negative: header of the line
+	for (int i = 0, end; format[i] != '\0'; ++i) {
+		if (format[i] != '%') {
+			fputc(format[i], output);
+			continue;
+		}
+		if (format[i + 1] == '%') {
+			fputc('%', output);
+			++i;
+			continue;
+		}
+		int type = ParseTraceConversion(format, i, &end);
+		std::string spec(format + i, end - i);
+		i = end - 1;
+		if (arg < 0) {
+			switch (arg + TRACE_HEADER_ARGS) {
+				case 0: fprintf(output, spec.c_str(), record->time); break;
+				case 1: fprintf(output, spec.c_str(), record->node_id); break;
+				case 2: fprintf(output, spec.c_str(), record->state); break;
+				case 3: fprintf(output, spec.c_str(), record->code); break;
+				case 4: fprintf(output, spec.c_str(), levels[record->level - 1]); break;
+			}
+			++arg;
+			continue;
+		}
+		if (arg >= record->num_args) return FALSE;
+		int64_t value = record->args[arg++];
+		switch (type) {
+			case TRACE_ARG_INT: fprintf(output, spec.c_str(), (int) value); break;
+			case TRACE_ARG_LONG: fprintf(output, spec.c_str(), (long) value); break;
+			case TRACE_ARG_LONG_LONG: fprintf(output, spec.c_str(), (long long) value); break;
+			case TRACE_ARG_POINTER: fprintf(output, spec.c_str(), (void *) (intptr_t) value); break;
+			case TRACE_ARG_DOUBLE: {
+				double double_value;
+				memcpy(&double_value, &value, sizeof(double));
+				fprintf(output, spec.c_str(), double_value);
+				break;
+			}
+			case TRACE_ARG_STRING: {
+				if (value < 0 || value >= record->strings_length) return FALSE;
+				fprintf(output, spec.c_str(), record->strings + value);
+				break;
+			}
+			default:
+				return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/**
+ * Rebuild the text log of a node from its binary trace
+ * @param "input_filename" [type char*]: binary trace file
+ * @param "output_filename" [type char*]: text log file
+ * @return "success" [type int]: TRUE if the whole trace was decoded
+ */
+int DecodeNodeTrace(const char *input_filename, const char *output_filename){
+
+	FILE *input = fopen(input_filename, "rb");
+	if (input == NULL) {
+		printf("ERROR: Trace file %s could not be opened\n", input_filename);
+		return FALSE;
+	}
+	char magic[8];
+	if (fread(magic, 1, 8, input) != 8 || memcmp(magic, TRACE_FILE_MAGIC, 8) != 0) {
+		printf("ERROR: %s is not a Komondor trace file\n", input_filename);
+		fclose(input);
+		return FALSE;
+	}
+	FILE *output = fopen(output_filename, "w");
+	if (output == NULL) {
+		printf("ERROR: Output file %s could not be opened\n", output_filename);
+		fclose(input);
+		return FALSE;
+	}
+
+	std::vector<std::string> formats;
+	int tag;
+	int success = TRUE;
+	while ((tag = fgetc(input)) != EOF) {
+		int ok = TRUE;
+		if (tag == 'F') {
+			int id, length;
+			ok = fread(&id, sizeof(int), 1, input) == 1 && fread(&length, sizeof(int), 1, input) == 1
+				&& id == (int) formats.size() && length >= 0;
+			if (ok) {
+				std::string format(length, '\0');
+				ok = fread(&format[0], 1, length, input) == (size_t) length;
+				formats.push_back(format);
+			}
+		} else if (tag == 'T') {
+			int length;
+			char text[TRACE_STRINGS_SIZE];
+			ok = fread(&length, sizeof(int), 1, input) == 1 && length >= 0 && length <= TRACE_STRINGS_SIZE
+				&& fread(text, 1, length, input) == (size_t) length;
+			if (ok) fwrite(text, 1, length, output);
+		} else if (tag == 'R') {
+			TraceRecord record;
+			int format_id;
+			ok = fread(&format_id, sizeof(int), 1, input) == 1 && format_id >= 0 && format_id < (int) formats.size()
+				&& fread(&record.time, sizeof(double), 1, input) == 1 && fread(&record.node_id, sizeof(int), 1, input) == 1
+				&& fread(&record.state, sizeof(int), 1, input) == 1 && fread(record.code, 1, 4, input) == 4
+				&& fread(&record.level, sizeof(int), 1, input) == 1 && fread(&record.num_args, sizeof(int), 1, input) == 1
+				&& fread(&record.strings_length, sizeof(int), 1, input) == 1
+				&& record.num_args >= 0 && record.num_args <= TRACE_MAX_ARGS && record.level >= 0 && record.level <= 5
+				&& record.strings_length >= 0 && record.strings_length <= TRACE_STRINGS_SIZE
+				&& fread(record.args, sizeof(int64_t), record.num_args, input) == (size_t) record.num_args
+				&& fread(record.strings, 1, record.strings_length, input) == (size_t) record.strings_length;
+			if (ok) {
+				record.code[3] = '\0';
+				ok = WriteDecodedTraceRecord(output, formats[format_id].c_str(), &record);
+			}
+		} else {
+			ok = FALSE;
+		}
+		if (!ok) {
+			printf("ERROR: Trace file %s is corrupted or truncated\n", input_filename);
+			success = FALSE;
+			break;
+		}
+	}
+
+	fclose(input);
+	fclose(output);
+	return success;
+}
+
+#endif
@@ -28,6 +28,7 @@ struct ChannelAccessState
 {
     // Live backoff countdown
     double remaining_backoff;           ///> Remaining backoff time [s]
+    double ifs_end_time;                ///> End of the DIFS/AIFS before the countdown (lazy backoff) [s]
 
     // Contention Window
     int    cw_stage_current;            ///> Current BEB stage (0 = initial, max = cw_stage_max)
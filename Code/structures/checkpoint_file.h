@@ -0,0 +1,306 @@
+/* Kom8ndor IEEE 802.11bn Simulator
+ *
+ * Copyright (c) 2026, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ */
+
+/**
+ * checkpoint_file.h: binary file holding the state of a simulation at a checkpoint (see checkpoint_methods.h)
+ *
+ * The same Checkpoint(CheckpointFile&) method of every component writes its state or reads it back, depending
+ * on the mode of the file, so that both sides cannot diverge. Fields are stored in native byte order; the
+ * structures without pointers are stored as they are in memory (their sizes are checked when the file is read).
+ * Pointers are never stored: arrays are stored by value and references among components (e.g., the
+ * performance report of an AP held by its agent) are stored as the index of their owner.
+ */
+
+#ifndef _AUX_CHECKPOINT_FILE_
+#define _AUX_CHECKPOINT_FILE_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "performance.h"
+#include "node_configuration.h"
+
+struct CheckpointFile
+{
+	FILE *file;
+	std::string filename;
+	int reading;								///> 1: restoring the state, 0: saving it
+
+	// Owners of the arrays and structures shared among components
+	std::vector<int*> available_actions;		///> Available actions of every agent
+	std::vector<const Performance*> reports;	///> Performance report of every node
+
+	int Reading() const { return reading; }
+
+	void Bytes(void *value, size_t size){
+		size_t done (reading ? fread(value, 1, size, file) : fwrite(value, 1, size, file));
+		if (done != size) {
+			printf("ERROR: Checkpoint %s is truncated\n", filename.c_str());
+			exit(-1);
+		}
+	}
+	void Field(int &value){ Bytes(&value, sizeof(value)); }
+	void Field(long &value){ Bytes(&value, sizeof(value)); }
+	void Field(long long &value){ Bytes(&value, sizeof(value)); }
+	void Field(uint64_t &value){ Bytes(&value, sizeof(value)); }
+	void Field(double &value){ Bytes(&value, sizeof(value)); }
+	void Field(std::string &value){
+		int length (value.size());
+		Field(length);
+		if (reading) {
+			if (length < 0) {
+				printf("ERROR: Checkpoint %s is corrupted\n", filename.c_str());
+				exit(-1);
+			}
+			std::vector<char> characters(length + 1);
+			Bytes(&characters[0], length);
+			value.assign(&characters[0], length);
+		} else {
+			Bytes((void *) value.data(), length);
+		}
+	}
+
+	/**
+	 * Value that the checkpoint and the simulation reading it must share (e.g., the number of nodes)
+	 * @param "value" [type int]: value of the simulation
+	 * @param "name" [type const char*]: name of the value, for the error message
+	 */
+	void Check(int value, const char *name){
+		int saved (value);
+		Field(saved);
+		if (saved != value) {
+			printf("ERROR: Checkpoint %s does not match the simulation (%s: %d instead of %d)\n",
+				filename.c_str(), name, saved, value);
+			exit(-1);
+		}
+	}
+	void Check(const std::string &value, const char *name){
+		std::string saved (value);
+		Field(saved);
+		if (saved != value) {
+			printf("ERROR: Checkpoint %s does not match the simulation (%s: '%s' instead of '%s')\n",
+				filename.c_str(), name, saved.c_str(), value.c_str());
+			exit(-1);
+		}
+	}
+
+	void Array(int *values, int size){ Bytes(values, size * sizeof(int)); }
+	void Array(double *values, int size){ Bytes(values, size * sizeof(double)); }
+	void Field(std::vector<double> &values){
+		int size (values.size());
+		Field(size);
+		if (reading) {
+			if (size < 0) {
+				printf("ERROR: Checkpoint %s is corrupted\n", filename.c_str());
+				exit(-1);
+			}
+			values.resize(size);
+		}
+		if (size > 0) Array(&values[0], size);
+	}
+
+	/**
+	 * Structure without pointers, stored as it is in memory
+	 * @param "value" [type T&]: structure
+	 */
+	template <class T>
+	void Raw(T &value){ Bytes(&value, sizeof(T)); }
+
+	/**
+	 * Random number stream of a component (or of the engine)
+	 * @param "stream" [type CostRandomStream&]: stream
+	 */
+	template <class Stream>
+	void RandomStream(Stream &stream){
+		uint64_t key (stream.Key());
+		uint64_t counter (stream.Counter());
+		Field(key);
+		Field(counter);
+		if (reading) stream.Restore(key, counter);
+	}
+
+	/**
+	 * Index of the owner of a pointer among those of a list (-1: NULL or not found), and pointer back
+	 * @param "owners" [type std::vector<T*>&]: owners (e.g., available_actions)
+	 * @param "pointer" [type T*&]: pointer
+	 */
+	template <class T>
+	void Owner(const std::vector<T*> &owners, T* &pointer){
+		int owner (-1);
+		for (size_t i = 0; i < owners.size() && !reading; ++i) {
+			if (owners[i] == pointer && pointer != NULL) owner = i;
+		}
+		Field(owner);
+		if (reading) {
+			if (owner >= (int) owners.size()) {
+				printf("ERROR: Checkpoint %s is corrupted\n", filename.c_str());
+				exit(-1);
+			}
+			pointer = owner < 0 ? NULL : owners[owner];
+		}
+	}
+
+	/**
+	 * Performance report held by another component: its fields, and the node whose arrays it points to
+	 * @param "performance" [type Performance&]: copy of the performance report of a node
+	 */
+	void Report(Performance &performance){
+		int owner (-1);
+		for (size_t i = 0; i < reports.size() && !reading; ++i) {
+			if (performance.total_time_transmitting_per_channel != NULL
+					&& reports[i]->total_time_transmitting_per_channel == performance.total_time_transmitting_per_channel) {
+				owner = i;
+			}
+		}
+		Field(owner);
+		Performance pointers (performance);
+		Raw(performance);
+		if (reading) {
+			if (owner >= (int) reports.size()) {
+				printf("ERROR: Checkpoint %s is corrupted\n", filename.c_str());
+				exit(-1);
+			}
+			KeepPointers(performance, owner < 0 ? pointers : *reports[owner]);
+		}
+	}
+
+	/**
+	 * Arrays of a performance report read as raw bytes, taken from another one
+	 * @param "performance" [type Performance&]: performance report
+	 * @param "pointers" [type Performance&]: performance report holding the arrays
+	 */
+	static void KeepPointers(Performance &performance, const Performance &pointers){
+		performance.max_received_power_in_ap_per_wlan = pointers.max_received_power_in_ap_per_wlan;
+		performance.rssi_list = pointers.rssi_list;
+		performance.received_power_array = pointers.received_power_array;
+		performance.num_trials_tx_per_num_channels = pointers.num_trials_tx_per_num_channels;
+		performance.total_time_transmitting_per_channel = pointers.total_time_transmitting_per_channel;
+		performance.total_time_transmitting_in_num_channels = pointers.total_time_transmitting_in_num_channels;
+		performance.total_time_lost_per_channel = pointers.total_time_lost_per_channel;
+		performance.total_time_lost_in_num_channels = pointers.total_time_lost_in_num_channels;
+		performance.total_time_channel_busy_per_channel = pointers.total_time_channel_busy_per_channel;
+		performance.last_total_time_transmitting_per_channel = pointers.last_total_time_transmitting_per_channel;
+		performance.last_total_time_lost_per_channel = pointers.last_total_time_lost_per_channel;
+		performance.throughput_per_sta = pointers.throughput_per_sta;
+		performance.data_packets_sent_per_sta = pointers.data_packets_sent_per_sta;
+		performance.rts_cts_sent_per_sta = pointers.rts_cts_sent_per_sta;
+		performance.data_packets_lost_per_sta = pointers.data_packets_lost_per_sta;
+		performance.rts_cts_lost_per_sta = pointers.rts_cts_lost_per_sta;
+		performance.data_packets_acked_per_sta = pointers.data_packets_acked_per_sta;
+		performance.data_frames_acked_per_sta = pointers.data_frames_acked_per_sta;
+		performance.rssi_list_per_sta = pointers.rssi_list_per_sta;
+	}
+
+	/**
+	 * Parameters of a node (all of them: see Node::Checkpoint for those of the run)
+	 * @param "params" [type NodeParameters&]: parameters
+	 */
+	void Parameters(NodeParameters &params){
+		Field(params.simulation_time_komondor);
+		Field(params.total_wlans_number);
+		Field(params.total_nodes_number);
+		Field(params.collisions_model);
+		Field(params.capture_effect);
+		Field(params.constant_per);
+		Field(params.save_node_logs);
+		Field(params.print_node_logs);
+		Field(params.simulation_code);
+		Field(params.capture_effect_model);
+		Field(params.nack_activated);
+		Field(params.lazy_backoff);
+		Field(params.wlan_code);
+		Field(params.node_id);
+		Field(params.node_code);
+		Field(params.node_type);
+		Field(params.x);
+		Field(params.y);
+		Field(params.z);
+		Field(params.pdf_tx_time);
+		Field(params.frame_length);
+		Field(params.max_num_packets_aggregated);
+		Field(params.traffic_model);
+		Field(params.traffic_type);
+		Field(params.adjacent_channel_model);
+		Field(params.pifs_activated);
+		Field(params.central_frequency);
+		Field(params.path_loss_model);
+		Field(params.min_channel_allowed);
+		Field(params.max_channel_allowed);
+		Field(params.num_channels_allowed);
+		Field(params.tx_power_default);
+		Field(params.sensitivity_default);
+		Field(params.backoff_type);
+		Field(params.cw_adaptation);
+		Field(params.cw_min_default);
+		Field(params.cw_max_default);
+		Field(params.cw_stage_max);
+		Field(params.bss_color);
+		Field(params.srg);
+		Field(params.rts_cts_enabled);
+		Field(params.dso_enabled);
+		Field(params.npca_enabled);
+		Field(params.npca_primary_channel);
+		Field(params.npca_min_dur_threshold_us);
+		Field(params.npca_switching_delay_us);
+		Field(params.npca_switch_back_delay_us);
+		Field(params.npca_init_qsrc);
+		Field(params.beamforming_enabled);
+		Field(params.beam_N_elements);
+		Field(params.beam_d_spacing);
+		Field(params.beam_az_main_deg);
+		Field(params.current_primary_channel);
+		Field(params.current_max_bandwidth);
+		Field(params.current_dcb_policy);
+		Field(params.non_srg_obss_pd);
+		Field(params.srg_obss_pd);
+	}
+
+	/**
+	 * Configuration of a node, as held by the node, its agent or the central controller
+	 * @param "configuration" [type Configuration&]: configuration
+	 */
+	void Config(Configuration &configuration){
+		Field(configuration.timestamp);
+		Field(configuration.selected_primary_channel);
+		Field(configuration.selected_pd);
+		Field(configuration.selected_tx_power);
+		Field(configuration.selected_max_bandwidth);
+		Field(configuration.spatial_reuse_enabled);
+		Field(configuration.non_srg_obss_pd);
+		Field(configuration.srg_obss_pd);
+		Parameters(configuration.capabilities);
+		Field(configuration.agent_capabilities.agent_id);
+		Field(configuration.agent_capabilities.time_between_requests);
+		Field(configuration.agent_capabilities.num_arms);
+		Owner(available_actions, configuration.agent_capabilities.available_actions);
+	}
+};
+
+/* Timer of a component: whether it is active, its time and its place among the events of that time */
+#define CHECKPOINT_TIMER(checkpoint_file, timer) { \
+		int active (timer.Active()); \
+		double time (timer.GetTime()); \
+		long seq (timer.GetSeq()); \
+		checkpoint_file.Field(active); \
+		checkpoint_file.Field(time); \
+		checkpoint_file.Field(seq); \
+		if (checkpoint_file.Reading()) timer.Restore(active, time, seq); \
+	}
+
+#endif
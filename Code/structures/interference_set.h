@@ -0,0 +1,150 @@
+/* Kom8ndor IEEE 802.11bn Simulator
+ *
+ * Copyright (c) 2026, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ */
+
+ /**
+ * interference_set.h: power received by a node from each of the nodes it is currently sensing. A sparse set
+ * (dense arrays of node ids and powers plus the position of each node id in them) gives O(1) lookups,
+ * insertions and removals without any allocation after the set is created, and keeps the total power
+ * received so that the interference of any transmission is obtained in O(1).
+ */
+
+#ifndef _AUX_INTERFERENCE_SET_
+#define _AUX_INTERFERENCE_SET_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../list_of_macros.h"
+
+// Power received from each node being sensed
+struct InterferenceSet
+{
+	int *position;			///> Position of each node id in the dense arrays (-1 if not in the set)
+	int *node_ids;			///> Nodes in the set
+	double *power;			///> Power received from each node in the set [pW]
+	int size;				///> Number of nodes in the set
+	double total_power;		///> Sum of the power received from all the nodes in the set [pW]
+
+	/**
+	 * Allocate an empty set
+	 * @param "total_nodes_number" [type int]: number of nodes
+	 */
+	void Allocate(int total_nodes_number){
+		position = new int[total_nodes_number];
+		node_ids = new int[total_nodes_number];
+		power = new double[total_nodes_number];
+		for(int n = 0; n < total_nodes_number; ++n) position[n] = -1;
+		size = 0;
+		total_power = 0;
+	}
+
+	void Free(){
+		delete[] position;
+		delete[] node_ids;
+		delete[] power;
+		position = node_ids = NULL;
+		power = NULL;
+		size = 0;
+		total_power = 0;
+	}
+
+	/**
+	 * Power received from a node
+	 * @param "node_id" [type int]: node id
+	 * @return "power" [type double]: power received from the node [pW] (0 if it is not in the set)
+	 */
+	double Power(int node_id) const {
+		return position[node_id] >= 0 ? power[position[node_id]] : 0;
+	}
+
+	/**
+	 * Set the power received from a node (adding it to the set if needed)
+	 * @param "node_id" [type int]: node id
+	 * @param "power_received" [type double]: power received from the node [pW]
+	 */
+	void Set(int node_id, double power_received){
+		int p (position[node_id]);
+		if (p < 0) {
+			p = size++;
+			position[node_id] = p;
+			node_ids[p] = node_id;
+		} else {
+			total_power -= power[p];
+		}
+		power[p] = power_received;
+		total_power += power_received;
+	}
+
+	/**
+	 * Remove a node from the set (if it is in it)
+	 * @param "node_id" [type int]: node id
+	 */
+	void Erase(int node_id){
+		int p (position[node_id]);
+		if (p < 0) return;
+		total_power -= power[p];
+		// Move the last node to the freed position
+		int last (--size);
+		node_ids[p] = node_ids[last];
+		power[p] = power[last];
+		position[node_ids[p]] = p;
+		position[node_id] = -1;
+		// Start over from an exact zero, so that rounding errors do not outlive the transmissions
+		if (size == 0) total_power = 0;
+	}
+
+	/**
+	 * Total power received from all the nodes but one (i.e., the interference on a transmission)
+	 * @param "node_id" [type int]: node whose power is excluded
+	 * @return "interference" [type double]: power received from the rest of nodes [pW]
+	 */
+	double TotalPowerExcept(int node_id) const {
+		if (position[node_id] < 0) return total_power;
+		if (size == 1) return 0;
+		double interference (total_power - power[position[node_id]]);
+		return interference > 0 ? interference : 0;
+	}
+};
+
+#endif
@@ -50,10 +50,13 @@
 #ifndef _AUX_LOGGER_
 #define _AUX_LOGGER_
 
+struct TraceBuffer;
+
 struct Logger
 {
 	int save_logs;					///> Flag for activating the log writting
 	FILE *file;						///> File for writting logs
+	TraceBuffer *trace;				///> Binary trace of the logs (NULL: logs written as text on "file"), see trace_methods.h
 	char head_string[INTEGER_SIZE];	///> Header string (to be passed as argument when it is needed to write info from other class or component)
 
 	/**
@@ -25,6 +25,7 @@ struct NodeParameters {
 	std::string simulation_code;			///> Komondor simulation code
 	int         capture_effect_model;		///> Capture effect model
 	int         nack_activated;				///> Flag: NACK mechanism enabled
+	int         lazy_backoff;				///> Flag: DIFS/AIFS and backoff countdown share a single event
 
 	// --- Node identity ---
 	std::string wlan_code;					///> WLAN code this node belongs to
@@ -101,6 +101,9 @@ struct NodeStatistics {
 	int    num_measures_utilization;			///> Number of measures for computing the utilization metric
 	int    num_measures_buffer_with_packets;	///> Number of measures where the buffer had packets
 
+	// --- Observation period ---
+	double stats_start_time;					///> Time since which the statistics are collected (end of the warm-up, if any)
+
 	// --- Waiting-time measurement state (was private in node.h) ---
 	double sum_waiting_time;					///> Sum of time waiting before transmitting
 	double timestamp_new_trial_started;			///> Timestamp at which the current transmission trial started
@@ -47,6 +47,8 @@
  * notification.h: this file defines a NOTIFICATION and provides basic displaying methods
  */
 
+#include <new>
+
 #ifndef _AUX_NOTIFICATION_
 #define _AUX_NOTIFICATION_
 
@@ -55,8 +57,6 @@ struct TxInfo
 {
 
 	int num_packets_aggregated;				///> Number of frames aggregated
-	int *list_id_aggregated;				///> List of frame IDs aggregated
-	double *timestamp_frames_aggregated;	///> List of timestamps of the frames aggregated
 
 	// For RTS/CTS management
 	double data_duration;		///> Duration of the data packet
@@ -118,28 +118,6 @@ struct TxInfo
 			packet_id, destination_id, tx_duration, tx_power, x, y, z);
 	}
 
-	/**
-	 * Set the size of the array list_id_aggregated
-	 * @param "num_packets_aggregated" [type int]: number of packets aggregated
-	 */
-	void SetSizeOfIdsAggregatedArray(int num_packets_aggregated){
-		list_id_aggregated = new int[num_packets_aggregated];
-		for(int t = 0; t < num_packets_aggregated; ++t){
-			list_id_aggregated[t] = 0;
-		}
-	}
-
-	/**
-	 * Set the size of the array timestamp_frames_aggregated
-	 * @param "num_packets_aggregated" [type int]: number of packets aggregated
-	 */
-	void SetSizeOfTimestampAggregatedArray(int num_packets_aggregated){
-		timestamp_frames_aggregated = new double[num_packets_aggregated];
-		for(int t = 0; t < num_packets_aggregated; ++t){
-			timestamp_frames_aggregated[t] = 0;
-		}
-	}
-
 	/**
 	 * Set the size of the array modulation_schemes
 	 * @param "channels_groups" [type int]: groups of channels that can be used
@@ -185,4 +163,111 @@ struct Notification
 
 };
 
+// Weights of the ULA of a beamformed transmission (see beamforming_methods.h)
+struct BeamWeights
+{
+	int num_elements;					///> Number of elements (0: not computed)
+	double real[BF_MAX_N_ELEMENTS];		///> Real part of the weight of each element
+	double imag[BF_MAX_N_ELEMENTS];		///> Imaginary part of the weight of each element
+};
+
+// Notification shared by all the receivers of a transmission
+struct NotificationFrame : public Notification
+{
+	mutable int references;		///> Number of NotificationRef holding the frame
+	CorsaAllocator *pool;		///> Pool of the transmitter, where the frame returns when it is released
+
+	// Beamformed DATA frames: computed once by the transmitter instead of by every receiver. Both point to the
+	// transmitter and are only valid while the start of the frame is being delivered
+	const BeamWeights *beam_weights;	///> Weights of the ULA of the transmitter (NULL: not attached)
+	const double *beam_gain_per_node;	///> Gain toward each node sensing the frame, indexed by node id (NULL: not
+										///> evaluated)
+};
+
+/**
+ * Reference-counted handle to a NotificationFrame. The transmitter copies a notification once into a frame
+ * of its pool (Create) and every receiver keeps the frame it needs by assigning it to a handle, instead of
+ * copying the whole notification. Frames are never modified once created. An empty handle reads as a
+ * zero-filled notification.
+ */
+class NotificationRef
+{
+	public:
+
+		NotificationRef() : frame(NULL) {}
+
+		NotificationRef(const NotificationRef &other) : frame(other.frame) {
+			if (frame != NULL) ++frame->references;
+		}
+
+		~NotificationRef() { Release(); }
+
+		NotificationRef &operator=(const NotificationRef &other) {
+			if (other.frame != NULL) ++other.frame->references;
+			Release();
+			frame = other.frame;
+			return *this;
+		}
+
+		/**
+		 * Keep the frame being delivered to the node
+		 * @param "delivered_frame" [type NotificationFrame]: frame received through a port
+		 */
+		NotificationRef &operator=(const NotificationFrame &delivered_frame) {
+			++delivered_frame.references;
+			Release();
+			frame = &delivered_frame;
+			return *this;
+		}
+
+		/**
+		 * Copy a notification into a new frame
+		 * @param "pool" [type CorsaAllocator*]: pool of the transmitter (allocating sizeof(NotificationFrame))
+		 * @param "notification" [type Notification]: notification to be copied
+		 */
+		void Create(CorsaAllocator *pool, const Notification &notification) {
+			Create(pool, notification, NULL, NULL);
+		}
+
+		/**
+		 * Copy a notification into a new frame, attaching the beamforming of the transmitter
+		 * @param "pool" [type CorsaAllocator*]: pool of the transmitter (allocating sizeof(NotificationFrame))
+		 * @param "notification" [type Notification]: notification to be copied
+		 * @param "beam_weights" [type BeamWeights*]: weights of the ULA of the transmitter (NULL: none)
+		 * @param "beam_gain_per_node" [type double*]: gain toward each node sensing the frame (NULL: none)
+		 */
+		void Create(CorsaAllocator *pool, const Notification &notification, const BeamWeights *beam_weights,
+				const double *beam_gain_per_node) {
+			NotificationFrame *new_frame = new (pool->alloc()) NotificationFrame;
+			*static_cast<Notification *>(new_frame) = notification;
+			new_frame->references = 1;
+			new_frame->pool = pool;
+			new_frame->beam_weights = beam_weights;
+			new_frame->beam_gain_per_node = beam_gain_per_node;
+			Release();
+			frame = new_frame;
+		}
+
+		/**
+		 * Drop the frame, returning it to its pool if this was its last reference
+		 */
+		void Release() {
+			if (frame != NULL && --frame->references == 0) frame->pool->free((void *) frame);
+			frame = NULL;
+		}
+
+		int Held() const { return frame != NULL; }
+		const NotificationFrame &operator*() const { return frame != NULL ? *frame : EmptyFrame(); }
+		const NotificationFrame *operator->() const { return &**this; }
+
+	private:
+
+		static const NotificationFrame &EmptyFrame() {
+			static const NotificationFrame empty_frame = NotificationFrame();
+			return empty_frame;
+		}
+
+		const NotificationFrame *frame;
+};
+
 #endif
@@ -0,0 +1,227 @@
+/* Kom8ndor IEEE 802.11bn Simulator
+ *
+ * Copyright (c) 2026, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ */
+
+ /**
+ * phy_timing.h: durations of the frames of the nodes, tabulated at start-up for every MCS and channel width
+ * and every number of aggregated packets, so that preparing a transmission does not re-evaluate them (nor
+ * decrease the number of aggregated packets one by one until the A-MPDU fits). A table is built per data
+ * packet length and shared (read-only) by all the nodes with that length. Punctured transmissions and
+ * A-MPDUs larger than the table are computed as before (see frame_duration_methods.h).
+ */
+
+#ifndef _AUX_PHY_TIMING_
+#define _AUX_PHY_TIMING_
+
+#include <math.h>
+#include <vector>
+#include "../list_of_macros.h"
+#include "modulations.h"
+
+// MCS and channel width of a transmission, as looked up in a timing table
+struct PhyRate
+{
+	int row;				///> Row of the table (-1 if not tabulated)
+	double bits_ofdm_sym;	///> Bits of an OFDM symbol
+};
+
+// Durations of the frames of the nodes with a given data packet length
+struct PhyTiming
+{
+	int frame_length;					///> Length of the data packets [bits]
+	int max_num_packets_aggregated;		///> Largest A-MPDU tabulated
+	int row_length;						///> Durations per row (max_num_packets_aggregated + 1)
+
+	double rts_duration;				///> Duration of an RTS [s]
+	double cts_duration;				///> Duration of a CTS [s]
+	double ack_duration;				///> Duration of an ACK [s]
+	double block_ack_duration;			///> Duration of a block ACK [s]
+
+	double bits_ofdm_sym[NUM_MODULATIONS * NUM_OPTIONS_CHANNEL_LENGTH];		///> Bits of an OFDM symbol per row
+	int max_packets_fitting[NUM_MODULATIONS * NUM_OPTIONS_CHANNEL_LENGTH];	///> Largest A-MPDU within IEEE_AX_MAX_PPDU_DURATION per row
+	std::vector<double> data_duration;	///> Duration of the DATA frame, [row * row_length + packets aggregated]
+
+	/**
+	 * Return the bits of an OFDM symbol, as computed when preparing a transmission
+	 * @param "modulation" [type int]: MCS
+	 * @param "num_channels" [type int]: number of channels of the transmission
+	 */
+	static double ComputeBitsOfdmSym(int modulation, int num_channels){
+		return GetNumberSubcarriers(num_channels) * Mcs_array::modulation_bits[modulation-1] *
+			Mcs_array::coding_rates[modulation-1] * IEEE_AX_SU_SPATIAL_STREAMS;
+	}
+
+	/**
+	 * Build the table
+	 * @param "data_packet_length" [type int]: length of the data packets [bits]
+	 * @param "max_packets" [type int]: largest A-MPDU to be tabulated
+	 */
+	void Build(int data_packet_length, int max_packets){
+
+		frame_length = data_packet_length;
+		max_num_packets_aggregated = max_packets;
+		row_length = max_packets + 1;
+
+		rts_duration = ComputeRtsTxTime80211ax(IEEE_BITS_OFDM_SYM_LEGACY);
+		cts_duration = ComputeCtsTxTime80211ax(IEEE_BITS_OFDM_SYM_LEGACY);
+		ack_duration = ComputeAckTxTime80211ax(1, IEEE_BITS_OFDM_SYM_LEGACY);
+		block_ack_duration = ComputeAckTxTime80211ax(2, IEEE_BITS_OFDM_SYM_LEGACY);
+
+		data_duration.assign((size_t) NUM_MODULATIONS * NUM_OPTIONS_CHANNEL_LENGTH * row_length, 0);
+		for (int m = 0; m < NUM_MODULATIONS; ++m) {
+			for (int w = 0; w < NUM_OPTIONS_CHANNEL_LENGTH; ++w) {
+				int row (m * NUM_OPTIONS_CHANNEL_LENGTH + w);
+				bits_ofdm_sym[row] = ComputeBitsOfdmSym(m + 1, 1 << w);
+				max_packets_fitting[row] = FindMaximumPacketsAggregated(max_packets, frame_length, bits_ofdm_sym[row]);
+				for (int n = 0; n <= max_packets; ++n) {
+					// As in ComputeFramesDuration(), which takes the bits of a symbol as an integer
+					data_duration[row * row_length + n] = ComputeDataTxTime80211ax(n, frame_length, (int) bits_ofdm_sym[row]);
+				}
+			}
+		}
+	}
+
+	/**
+	 * Look up the rate of a transmission
+	 * @param "modulation" [type int]: MCS
+	 * @param "num_channels" [type int]: number of channels of the transmission
+	 * @param "num_active_channels" [type int]: channels actually used (fewer if punctured)
+	 * @return "rate" [type PhyRate]: row of the table and bits of an OFDM symbol
+	 */
+	PhyRate Rate(int modulation, int num_channels, int num_active_channels) const {
+		PhyRate rate;
+		rate.row = -1;
+		int w (0);
+		while (w < NUM_OPTIONS_CHANNEL_LENGTH - 1 && (1 << w) < num_channels) ++w;
+		if (modulation >= 1 && modulation <= NUM_MODULATIONS && (1 << w) == num_channels
+				&& num_active_channels == num_channels) {
+			rate.row = (modulation - 1) * NUM_OPTIONS_CHANNEL_LENGTH + w;
+			rate.bits_ofdm_sym = bits_ofdm_sym[rate.row];
+		} else {
+			rate.bits_ofdm_sym = ComputeBitsOfdmSym(modulation, num_channels) *
+				((double) num_active_channels / (double) num_channels);
+		}
+		return rate;
+	}
+
+	PhyRate Rate(int modulation, int num_channels) const {
+		return Rate(modulation, num_channels, num_channels);
+	}
+
+	/**
+	 * Limit an A-MPDU to IEEE_AX_MAX_PPDU_DURATION (as FindMaximumPacketsAggregated() does)
+	 * @param "rate" [type PhyRate]: rate of the transmission
+	 * @param "num_packets_aggregated" [type int]: packets to be aggregated
+	 * @return "limited_num_packets_aggregated" [type int]: packets that fit
+	 */
+	int MaximumPacketsAggregated(const PhyRate &rate, int num_packets_aggregated) const {
+		if (rate.row < 0 || num_packets_aggregated > max_num_packets_aggregated) {
+			return FindMaximumPacketsAggregated(num_packets_aggregated, frame_length, rate.bits_ofdm_sym);
+		}
+		return std::min(num_packets_aggregated, max_packets_fitting[rate.row]);
+	}
+
+	/**
+	 * Return the duration of a DATA frame (as ComputeDataTxTime80211ax() does)
+	 * @param "rate" [type PhyRate]: rate of the transmission
+	 * @param "num_packets_aggregated" [type int]: packets aggregated
+	 */
+	double DataDuration(const PhyRate &rate, int num_packets_aggregated) const {
+		if (rate.row < 0 || num_packets_aggregated < 0 || num_packets_aggregated > max_num_packets_aggregated) {
+			return ComputeDataTxTime80211ax(num_packets_aggregated, frame_length, (int) rate.bits_ofdm_sym);
+		}
+		return data_duration[rate.row * row_length + num_packets_aggregated];
+	}
+
+	/**
+	 * Return the durations of the frames of an exchange (as ComputeFramesDuration() does)
+	 * @param "rate" [type PhyRate]: rate of the transmission
+	 * @param "num_packets_aggregated" [type int]: packets aggregated
+	 * @param "rts" [type double*]: duration of the RTS (output)
+	 * @param "cts" [type double*]: duration of the CTS (output)
+	 * @param "data" [type double*]: duration of the DATA frame (output)
+	 * @param "ack" [type double*]: duration of the ACK (output)
+	 */
+	void FramesDuration(const PhyRate &rate, int num_packets_aggregated,
+			double *rts, double *cts, double *data, double *ack) const {
+		*rts = rts_duration;
+		*cts = cts_duration;
+		*data = DataDuration(rate, num_packets_aggregated);
+		*ack = (num_packets_aggregated == 1) ? ack_duration : block_ack_duration;
+	}
+
+	/**
+	 * Reduce an A-MPDU (to one packet at least) until its DATA frame lasts at most a given time. Equivalent to
+	 * removing packets one by one, since the duration does not decrease with the number of packets
+	 * @param "rate" [type PhyRate]: rate of the transmission
+	 * @param "num_packets_aggregated" [type int]: packets to be aggregated
+	 * @param "max_duration" [type double]: maximum duration of the DATA frame [s]
+	 * @return "limited_num_packets_aggregated" [type int]: packets that fit
+	 */
+	int PacketsAggregatedWithin(const PhyRate &rate, int num_packets_aggregated, double max_duration) const {
+		if (num_packets_aggregated <= 1 || DataDuration(rate, num_packets_aggregated) <= max_duration) {
+			return num_packets_aggregated;
+		}
+		if (rate.row < 0 || num_packets_aggregated > max_num_packets_aggregated) {
+			while (num_packets_aggregated > 1 && DataDuration(rate, num_packets_aggregated) > max_duration) {
+				--num_packets_aggregated;
+			}
+			return num_packets_aggregated;
+		}
+		// Largest number of packets in [1, num_packets_aggregated) whose DATA frame fits (or 1)
+		const double *durations = &data_duration[rate.row * row_length];
+		int low (1), high (num_packets_aggregated - 1);
+		while (low < high) {
+			int middle ((low + high + 1) / 2);
+			if (durations[middle] <= max_duration) {
+				low = middle;
+			} else {
+				high = middle - 1;
+			}
+		}
+		return low;
+	}
+};
+
+#endif
@@ -0,0 +1,85 @@
+/* Kom8ndor IEEE 802.11bn Simulator
+ *
+ * Copyright (c) 2026, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ */
+
+ /**
+ * steady_state.h: state of the detection of the steady state of a simulation (see steady_state_methods.h)
+ */
+
+#ifndef _AUX_STEADY_STATE_
+#define _AUX_STEADY_STATE_
+
+#include <vector>
+
+struct SteadyState
+{
+	double target_ci;					///> Target half-width of the 95% confidence intervals, relative to the mean (0: no detection)
+	double observation_period;			///> Time between two observations of the network [s]
+	int warmup_deleted;					///> Whether the statistics of the warm-up have already been discarded
+
+	// Observations since the start or the end of the warm-up
+	std::vector<double> throughput;		///> Network throughput during each observation period [bps]
+	std::vector<double> delay;			///> Average delay of the packets delivered during each period [s] (-1: none)
+
+	// Network counters at the previous observation
+	double last_observation_time;		///> Time of the previous observation (or of the start of the statistics) [s]
+	double last_bits_acked;				///> Bits acknowledged by all the nodes
+	double last_sum_delays;				///> Sum of the delays of the packets delivered by all the nodes [s]
+	long last_num_delay_measurements;	///> Number of packets delivered by all the nodes
+
+	/**
+	 * Forget the observations and the counters (e.g., once the statistics of the nodes are cleared)
+	 * @param "sim_time" [type double]: current time [s]
+	 */
+	void Restart(double sim_time){
+		throughput.clear();
+		delay.clear();
+		last_observation_time = sim_time;
+		last_bits_acked = 0;
+		last_sum_delays = 0;
+		last_num_delay_measurements = 0;
+	}
+};
+
+#endif
@@ -0,0 +1,236 @@
+/* Kom8ndor IEEE 802.11bn Simulator
+ *
+ * Copyright (c) 2026, Universitat Pompeu Fabra.
+ * GNU GENERAL PUBLIC LICENSE
+ * Version 3, 29 June 2007
+
+ * Copyright (C) 2007 Free Software Foundation, Inc. <http://fsf.org/>
+ * Everyone is permitted to copy and distribute verbatim copies
+ * of this license document, but changing it is not allowed.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *
+ * -----------------------------------------------------------------
+ *
+ * Author  : Sergio Barrachina-Muñoz and Francesc Wilhelmi
+ * Created : 2016-12-05
+ * Updated : $Date: 2017/03/20 10:32:36 $
+ *           $Revision: 1.0 $
+ *
+ * -----------------------------------------------------------------
+ */
+
+ /**
+ * topology.h: simulation-wide store of the positions of the nodes and of the channel between each pair
+ * of them, kept as a structure of arrays. A single copy is shared by all the nodes: they read the positions
+ * and the path gains, and each one only updates its own row of the received power matrix. Rows are padded
+ * to a cache line, so that the rows of nodes running concurrently (see --partition) never share one.
+ */
+
+#ifndef _AUX_TOPOLOGY_
+#define _AUX_TOPOLOGY_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#else
+#include <malloc.h>
+#endif
+#include "../list_of_macros.h"
+
+#define TOPOLOGY_CACHE_LINE	64	///> Alignment of the arrays and of the rows of the matrices [bytes]
+
+/**
+ * Allocate a zeroed array aligned to a cache line
+ * @param "size" [type size_t]: size of the array [bytes]
+ * @return "array" [type void*]: array (to be released with FreeAligned())
+ */
+void *AllocateAligned(size_t size){
+	void *array (NULL);
+	if (size == 0) size = TOPOLOGY_CACHE_LINE;
+#ifndef _WIN32
+	if (posix_memalign(&array, TOPOLOGY_CACHE_LINE, size) != 0) array = NULL;
+#else
+	array = _aligned_malloc(size, TOPOLOGY_CACHE_LINE);
+#endif
+	if (array == NULL) {
+		printf("ERROR: %lu bytes could not be allocated\n", (unsigned long) size);
+		exit(-1);
+	}
+	memset(array, 0, size);
+	return array;
+}
+
+/**
+ * Release an array allocated with AllocateAligned() (nothing if NULL)
+ */
+void FreeAligned(void *array){
+#ifndef _WIN32
+	free(array);
+#else
+	_aligned_free(array);
+#endif
+}
+
+// Set of nodes (bitset indexed by node id)
+struct NodeSet
+{
+	uint64_t *words;	///> Node "n" is in the set if bit n % 64 of words[n / 64] is set
+	int num_words;		///> Number of words
+	int size;			///> Number of nodes in the set
+
+	/**
+	 * Allocate an empty set
+	 * @param "total_nodes_number" [type int]: number of nodes
+	 */
+	void Allocate(int total_nodes_number){
+		num_words = (total_nodes_number + 63) / 64;
+		words = (uint64_t *) AllocateAligned(num_words * sizeof(uint64_t));
+		size = 0;
+	}
+
+	void Free(){
+		FreeAligned(words);
+		words = NULL;
+		num_words = 0;
+		size = 0;
+	}
+
+	int Contains(int node_id) const {
+		return (words[node_id >> 6] >> (node_id & 63)) & 1;
+	}
+
+	void Insert(int node_id){
+		if (!Contains(node_id)) {
+			words[node_id >> 6] |= (uint64_t) 1 << (node_id & 63);
+			++size;
+		}
+	}
+
+	void Remove(int node_id){
+		if (Contains(node_id)) {
+			words[node_id >> 6] &= ~((uint64_t) 1 << (node_id & 63));
+			--size;
+		}
+	}
+};
+
+// Positions of the nodes and channel between each pair of them
+struct Topology
+{
+	int total_nodes_number;		///> Number of nodes
+	int row_stride;				///> Elements per row of the matrices (padded to a cache line)
+
+	double *x;					///> X position of each node [m]
+	double *y;					///> Y position of each node [m]
+	double *z;					///> Z position of each node [m]
+	int *first_sta_id;			///> For APs: first associated STA (NODE_ID_NONE for STAs and APs without STAs)
+
+	double *path_gain;			///> Path gain (linear) between each pair of nodes, [rx * row_stride + tx]
+	double *received_power;		///> Power received by each node from each other node [pW], [rx * row_stride + tx]
+
+	void *mapping;				///> Scenario snapshot holding the matrices (NULL if they are allocated)
+	size_t mapping_size;		///> Size of the mapped snapshot [bytes]
+
+	/**
+	 * Return the number of elements per row of the matrices of a topology
+	 * @param "num_nodes" [type int]: number of nodes
+	 */
+	static int RowStride(int num_nodes){
+		int doubles_per_line (TOPOLOGY_CACHE_LINE / sizeof(double));
+		return (num_nodes + doubles_per_line - 1) / doubles_per_line * doubles_per_line;
+	}
+
+	/**
+	 * Allocate the (zeroed) arrays of a topology
+	 * @param "num_nodes" [type int]: number of nodes
+	 */
+	void Allocate(int num_nodes){
+		Map(num_nodes, NULL, 0, 0);
+		path_gain = (double *) AllocateAligned((size_t) num_nodes * row_stride * sizeof(double));
+		received_power = (double *) AllocateAligned((size_t) num_nodes * row_stride * sizeof(double));
+	}
+
+	/**
+	 * Allocate the (zeroed) positions of a topology whose matrices are taken from a mapped scenario snapshot
+	 * (see scenario_snapshot_methods.h). The matrices are mapped privately: the rows written by the nodes
+	 * are copied on write and the snapshot is unmapped by Free()
+	 * @param "num_nodes" [type int]: number of nodes
+	 * @param "snapshot" [type void*]: mapped snapshot (NULL: no matrices)
+	 * @param "snapshot_size" [type size_t]: size of the snapshot [bytes]
+	 * @param "matrices_offset" [type size_t]: offset of the path gain matrix, followed by the received power one
+	 */
+	void Map(int num_nodes, void *snapshot, size_t snapshot_size, size_t matrices_offset){
+		total_nodes_number = num_nodes;
+		row_stride = RowStride(num_nodes);
+		x = (double *) AllocateAligned(num_nodes * sizeof(double));
+		y = (double *) AllocateAligned(num_nodes * sizeof(double));
+		z = (double *) AllocateAligned(num_nodes * sizeof(double));
+		first_sta_id = (int *) AllocateAligned(num_nodes * sizeof(int));
+		mapping = snapshot;
+		mapping_size = snapshot_size;
+		path_gain = received_power = NULL;
+		if (snapshot != NULL) {
+			path_gain = (double *) ((char *) snapshot + matrices_offset);
+			received_power = path_gain + (size_t) num_nodes * row_stride;
+		}
+	}
+
+	void Free(){
+		FreeAligned(x);
+		FreeAligned(y);
+		FreeAligned(z);
+		FreeAligned(first_sta_id);
+		if (mapping != NULL) {
+#ifndef _WIN32
+			munmap(mapping, mapping_size);
+#endif
+		} else {
+			FreeAligned(path_gain);
+			FreeAligned(received_power);
+		}
+		x = y = z = path_gain = received_power = NULL;
+		first_sta_id = NULL;
+		mapping = NULL;
+		mapping_size = 0;
+		total_nodes_number = 0;
+	}
+
+	// Row of the path gains from every node to node "rx_id"
+	double *PathGainRow(int rx_id) const {
+		return &path_gain[(size_t) rx_id * row_stride];
+	}
+
+	// Row of the power received by node "rx_id" from every node
+	double *ReceivedPowerRow(int rx_id) const {
+		return &received_power[(size_t) rx_id * row_stride];
+	}
+};
+
+#endif